@@ -0,0 +1,26 @@
+// Texture2InstancedEffectVS.glsl : Texture2EffectVS with the world matrix
+// of each instance read from a shader storage buffer.
+
+uniform PVMatrix
+{
+    mat4 pvMatrix;
+};
+
+buffer worldMatrices
+{
+    mat4 worldMatrix[];
+};
+
+layout(location = 0) in vec3 modelPosition;
+layout(location = 1) in vec2 modelTCoord;
+layout(location = 0) out vec2 vertexTCoord;
+
+void main()
+{
+    vertexTCoord = modelTCoord;
+#if GE_USE_MAT_VEC
+    gl_Position = pvMatrix * (worldMatrix[gl_InstanceID] * vec4(modelPosition, 1.0f));
+#else
+    gl_Position = (vec4(modelPosition, 1.0f) * worldMatrix[gl_InstanceID]) * pvMatrix;
+#endif
+}
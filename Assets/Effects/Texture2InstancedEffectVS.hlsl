@@ -0,0 +1,35 @@
+// Texture2InstancedEffectVS.hlsl : Texture2EffectVS with the world matrix
+// of each instance read from a structured buffer.
+
+cbuffer PVMatrix
+{
+    float4x4 pvMatrix;
+};
+
+StructuredBuffer<float4x4> worldMatrices;
+
+struct VS_INPUT
+{
+    float3 modelPosition : POSITION;
+    float2 modelTCoord : TEXCOORD0;
+    uint instanceID : SV_InstanceID;
+};
+
+struct VS_OUTPUT
+{
+    float2 vertexTCoord : TEXCOORD0;
+    float4 clipPosition : SV_POSITION;
+};
+
+VS_OUTPUT VSMain(VS_INPUT input)
+{
+    VS_OUTPUT output;
+    float4x4 worldMatrix = worldMatrices[input.instanceID];
+#if GE_USE_MAT_VEC
+    output.clipPosition = mul(pvMatrix, mul(worldMatrix, float4(input.modelPosition, 1.0f)));
+#else
+    output.clipPosition = mul(mul(float4(input.modelPosition, 1.0f), worldMatrix), pvMatrix);
+#endif
+    output.vertexTCoord = input.modelTCoord;
+    return output;
+}
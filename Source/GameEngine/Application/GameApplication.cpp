@@ -17,6 +17,10 @@
 #include "Core/IO/XmlResource.h"
 
 #include "Graphic/UI/UserInterface.h"
+#include "Graphic/Scene/Element/Mesh/MeshPoseCache.h"
+#include "Graphic/Shader/ProgramCache.h"
+#include "Graphic/Image/TextureCooker.h"
+#include "Graphic/Scene/Element/Mesh/SkinnedMesh.h"
 #include "Game/View/HumanView.h"
 
 // All event type headers
@@ -47,7 +51,8 @@ GameApplication::GameApplication(const char* windowTitle, int xPosition,
     int yPosition, int width, int height, const eastl::array<float, 4>& clearColor)
 :	mTitle(windowTitle), mXOrigin(xPosition), mYOrigin(yPosition), mWidth(width), 
 	mHeight(height), mClearColor(clearColor), mAllowResize(true), mWindowID(0), 
-	mFramesPerSecond(0), mTimer(0), mSystem(0), mRenderer(0)
+	mFramesPerSecond(0), mTimer(0), mSystem(0), mRenderer(0), mLogicTimeStep(0.f),
+	mLogicAccumulator(0.f), mLogicTick(0), mInterpolation(1.f)
 {
 	mIsRunning = false;
 	mIsEditorRunning = false;
@@ -78,6 +83,10 @@ void GameApplication::InitTime()
 	// Called to get the real time
 	Timer::InitTimer();
 	mTimer = (unsigned int)Timer::GetRealTime();
+
+	mLogicTimeStep = mOption.mLogicTickRate > 0 ? 1000.f / mOption.mLogicTickRate : 0.f;
+	mLogicAccumulator = 0.f;
+	mInterpolation = 1.f;
 }
 
 //----------------------------------------------------------------------------
@@ -237,6 +246,43 @@ bool GameApplication::OnInitialize()
 		return false;
 	}
 
+	// The job system goes before the game logic since physics and other
+	// subsystems split their work over its threads.
+	mJobSystem = eastl::shared_ptr<JobSystem>(
+		new JobSystem(mOption.mWorkerThreads, true));
+
+	if (mOption.mPoseCacheSize > 0)
+	{
+		mMeshPoseCache = eastl::shared_ptr<MeshPoseCache>(
+			new MeshPoseCache(mOption.mPoseCacheSize * 1024, true));
+	}
+
+	// The cached programs are read on the job system while the game loads,
+	// so that the effects created by the loading don't compile them.
+	if (mOption.mProgramCache)
+	{
+		mProgramCache = eastl::shared_ptr<ProgramCache>(new ProgramCache(
+			mOption.mProgramCachePath + "programs.cache",
+			mProgramFactory->GetBackendVersion(), true));
+		mProgramCache->Preload();
+	}
+
+	// The cooked textures are written next to their images and replace them
+	// from then on, until an image changes.
+	MipGenerator::Filter mipFilter =
+		mOption.mTextureMipFilter == "kaiser" ? MipGenerator::MF_KAISER : MipGenerator::MF_BOX;
+	if (!mOption.mTextureCookPattern.empty())
+		TextureCooker::CookResources(mOption.mTextureCookPattern, mipFilter);
+
+	if (!mOption.mTextureBenchmark.empty())
+		TextureCooker::Benchmark(mOption.mTextureBenchmark, mipFilter);
+
+	if (mOption.mSkinningBenchmark > 0)
+		SkinnedMesh::BenchmarkSkinning(mOption.mSkinningBenchmark);
+
+	if (mOption.mBindBenchmark > 0)
+		mRenderer->BenchmarkBind(mOption.mBindBenchmark);
+
 	// Create the game logic
 	CreateGame();
 
@@ -265,6 +311,12 @@ void GameApplication::OnTerminate()
 
 	GameLogic::mGame = nullptr;
 
+	if (mMeshPoseCache)
+		mMeshPoseCache->LogStatistics();
+
+	if (mProgramCache)
+		mProgramCache->LogStatistics();
+
 	DestroyNetworkEventForwarder();
 }
 
@@ -323,7 +375,7 @@ void GameApplication::OnRun()
 			const unsigned int elapsedTime = UpdateTime();
 
 			// game logic execution
-			OnUpdateGame(elapsedTime);
+			UpdateLogic(elapsedTime);
 
 			// update all game views
 			OnUpdateView(Timer::GetTime(), elapsedTime);
@@ -380,7 +432,7 @@ void GameApplication::OnRender(unsigned int elapsedTime)
 	application to handle updates to the scene, but is not intended to contain actual rendering calls, 
 	which should instead be placed in the OnFrameRender callback.
 */
-void GameApplication::OnUpdateGame(unsigned int elapsedTime)
+void GameApplication::OnUpdateGame(float elapsedTime)
 {
 	if (GameLogic::mGame)
 	{
@@ -389,8 +441,47 @@ void GameApplication::OnUpdateGame(unsigned int elapsedTime)
 		if (mBaseSocketManager)
 			mBaseSocketManager->DoSelect(0);	// pause 0 microseconds
 
-		GameLogic::mGame->OnUpdate((float)Timer::GetTime(), (float)elapsedTime);
+		GameLogic::mGame->OnUpdate((float)Timer::GetTime(), elapsedTime);
+	}
+}
+
+/*
+	The logic and the physics tick at a fixed rate so that a long frame doesn't turn into
+	a huge step. The time left over after the ticks is carried to the next frame and tells
+	the views how far the game is in between the last two ticks.
+*/
+void GameApplication::UpdateLogic(unsigned int elapsedTime)
+{
+	if (mLogicTimeStep <= 0.f)
+	{
+		// the logic steps by whatever the frame took
+		mLogicTick++;
+		OnUpdateGame((float)elapsedTime);
+		mInterpolation = 1.f;
+		return;
+	}
+
+	mLogicAccumulator += (float)elapsedTime;
+
+	unsigned int numTicks = 0;
+	const unsigned int maxTicks = eastl::max(mOption.mMaxLogicTicks, 1u);
+	while (mLogicAccumulator >= mLogicTimeStep && numTicks < maxTicks)
+	{
+		// the tick is counted first so that the actors synced during the tick
+		// are tagged with it
+		mLogicTick++;
+		OnUpdateGame(mLogicTimeStep);
+
+		mLogicAccumulator -= mLogicTimeStep;
+		numTicks++;
 	}
+
+	// drop the time we can't catch up with, the game slows down instead of
+	// spending every frame running more ticks
+	if (mLogicAccumulator >= mLogicTimeStep)
+		mLogicAccumulator = Function<float>::FMod(mLogicAccumulator, mLogicTimeStep);
+
+	mInterpolation = mLogicAccumulator / mLogicTimeStep;
 }
 
 //----------------------------------------------------------
@@ -523,13 +614,7 @@ void GameApplication::CreateNetworkEventForwarder(void)
 	pGlobalEventManager->AddListener(MakeDelegate(
 		mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataEnvironmentLoaded::skEventType);
 	pGlobalEventManager->AddListener(MakeDelegate(
-		mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataPhysTriggerEnter::skEventType);
-	pGlobalEventManager->AddListener(MakeDelegate(
-		mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataPhysTriggerLeave::skEventType);
-	pGlobalEventManager->AddListener(MakeDelegate(
-		mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataPhysCollision::skEventType);
-	pGlobalEventManager->AddListener(MakeDelegate(
-		mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataPhysSeparation::skEventType);
+		mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataPhysContacts::skEventType);
 }
 
 void GameApplication::DestroyNetworkEventForwarder(void)
@@ -542,13 +627,7 @@ void GameApplication::DestroyNetworkEventForwarder(void)
 		pGlobalEventManager->RemoveListener(MakeDelegate(
 			mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataEnvironmentLoaded::skEventType);
 		pGlobalEventManager->RemoveListener(MakeDelegate(
-			mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataPhysTriggerEnter::skEventType);
-		pGlobalEventManager->RemoveListener(MakeDelegate(
-			mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataPhysTriggerLeave::skEventType);
-		pGlobalEventManager->RemoveListener(MakeDelegate(
-			mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataPhysCollision::skEventType);
-		pGlobalEventManager->RemoveListener(MakeDelegate(
-			mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataPhysSeparation::skEventType);
+			mNetworkEventForwarder.get(), &NetworkEventForwarder::ForwardEvent), EventDataPhysContacts::skEventType);
 
 		//delete mNetworkEventForwarder;
     }
@@ -22,6 +22,9 @@
 
 class BaseSocketManager;
 class NetworkEventForwarder;
+class JobSystem;
+class MeshPoseCache;
+class ProgramCache;
 
 class GameApplication : public Application, public EventListener
 {
@@ -47,6 +50,14 @@ public:
 	virtual eastl::wstring GetGameAppDirectory() = 0;
 
 	int GetFPS() { return mFramesPerSecond; }
+
+	//! Logic step in milliseconds, 0 if the logic steps by the frame time
+	float GetLogicTimeStep() const { return mLogicTimeStep; }
+	//! Number of logic ticks run so far
+	unsigned int GetLogicTick() const { return mLogicTick; }
+	//! Fraction of the next logic tick already elapsed when rendering, used to
+	//! draw the actors in between the last two logic ticks
+	float GetInterpolation() const { return mInterpolation; }
 	void AbortGame() { mQuitting = true; }
 	bool IsRunning() { return mIsRunning; }
 	void SetQuitting(bool quitting) { mQuitting = quitting; }
@@ -75,6 +86,15 @@ public:
 	// Event manager
 	eastl::shared_ptr<EventManager> mEventManager;
 
+	// Job system - worker threads shared by the engine subsystems
+	eastl::shared_ptr<JobSystem> mJobSystem;
+
+	// Pose cache - animated mesh poses shared by identical models
+	eastl::shared_ptr<MeshPoseCache> mMeshPoseCache;
+
+	// Program cache - compiled shader programs saved between runs
+	eastl::shared_ptr<ProgramCache> mProgramCache;
+
 	// Socket manager - could be server or client
 	eastl::shared_ptr<BaseSocketManager> mBaseSocketManager;
 	eastl::shared_ptr<NetworkEventForwarder> mNetworkEventForwarder;
@@ -116,7 +136,13 @@ protected:
 	@param elapsedTime Running time in milliseconds since the last updating of
 	the logic
 	*/
-	void OnUpdateGame(unsigned int elapsedTime);
+	void OnUpdateGame(float elapsedTime);
+
+	/*
+	Runs as many fixed logic ticks as the elapsed time allows, up to the maximum
+	catch up set in the options, and keeps the remaining time for the next frame
+	*/
+	void UpdateLogic(unsigned int elapsedTime);
 	void OnUpdateView(unsigned int timeMs, unsigned int elapsedTime);
 
 	/*
@@ -131,6 +157,12 @@ protected:
 
 	int mFramesPerSecond, mTimer;
 
+	// fixed step logic, all in milliseconds
+	float mLogicTimeStep;
+	float mLogicAccumulator;
+	unsigned int mLogicTick;
+	float mInterpolation;
+
     // Window parameters (from the constructor).
     eastl::wstring mTitle;
     int mXOrigin, mYOrigin, mWidth, mHeight;
@@ -44,6 +44,7 @@
 #include "Process/RealtimeProcess.h"
 
 //Threading
+#include "Threading/JobSystem.h"
 #include "Threading/ThreadSafeMap.h"
 #include "Threading/ThreadSafeQueue.h"
 
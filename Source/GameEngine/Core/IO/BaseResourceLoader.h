@@ -20,6 +20,20 @@ public:
 	virtual unsigned int GetLoadedResourceSize(void *rawBuffer, unsigned int rawSize) = 0;
 	virtual bool LoadResource(
 		void *rawBuffer, unsigned int rawSize, const eastl::shared_ptr<ResHandle>& handle) = 0;
+
+	// Loaders using the raw file can decode their resources on the job system
+	// when the cache preloads them. PrepareResource runs first on the loading
+	// thread, where it may use the cache, and returns true if it loaded the
+	// resource by itself. Otherwise DecodeResource runs on a worker and must
+	// not use the cache.
+	virtual bool CanDecodeInParallel() { return false; }
+	virtual bool PrepareResource(
+		void *rawBuffer, unsigned int rawSize, const eastl::shared_ptr<ResHandle>& handle) { return false; }
+	virtual bool DecodeResource(
+		void *rawBuffer, unsigned int rawSize, const eastl::shared_ptr<ResHandle>& handle)
+	{
+		return LoadResource(rawBuffer, rawSize, handle);
+	}
 };
 
 #endif
@@ -38,8 +38,12 @@
 
 #include "ResourceCache.h"
 
+#include "Core/OS/OS.h"
+#include "Core/Threading/JobSystem.h"
 #include "Core/Utility/StringUtil.h"
 
+#include <condition_variable>
+
 //
 //  Resource::Resource
 //
@@ -179,20 +183,9 @@ eastl::shared_ptr<ResHandle> ResCache::GetHandle(BaseResource * r)
 eastl::shared_ptr<ResHandle> ResCache::Load(BaseResource *r)
 {
 	// Create a new resource and add it to the lru list and map
-	BaseResourceLoader* loader = 0;
+	BaseResourceLoader* loader = FindLoader(r->mName);
 	eastl::shared_ptr<ResHandle> handle = 0;
 
-	for (ResourceLoaders::iterator it = mResourceLoaders.begin(); it != mResourceLoaders.end(); ++it)
-	{
-		BaseResourceLoader* testLoader = (*it).get();
-
-		if (testLoader->MatchResourceFormat(r->mName))
-		{
-			loader = testLoader;
-			break;
-		}
-	}
-
 	if (!loader)
 	{
 		LogAssert(loader, "Default resource loader not found!");
@@ -217,6 +210,7 @@ eastl::shared_ptr<ResHandle> ResCache::Load(BaseResource *r)
 		rawBuffer = new char[file->GetSize()];
 		memset(rawBuffer, 0, file->GetSize());
 		rawSize = file->Read(rawBuffer, file->GetSize());
+		delete file;
 
 		size = loader->GetLoadedResourceSize(rawBuffer, rawSize);
 		buffer = Allocate(size);
@@ -244,15 +238,30 @@ eastl::shared_ptr<ResHandle> ResCache::Load(BaseResource *r)
 	}
 
 	if (handle)
-	{
-		mLRU.push_front(eastl::shared_ptr<ResHandle>(handle));
-		mResources[r->mName] = mLRU.front();
-	}
+		Insert(handle);
 
 	LogAssert(loader, "Default resource loader not found!");
 	return handle;		// ResCache is out of memory!
 }
 
+BaseResourceLoader* ResCache::FindLoader(const eastl::wstring& name)
+{
+	for (ResourceLoaders::iterator it = mResourceLoaders.begin(); it != mResourceLoaders.end(); ++it)
+	{
+		BaseResourceLoader* testLoader = (*it).get();
+
+		if (testLoader->MatchResourceFormat(name))
+			return testLoader;
+	}
+	return nullptr;
+}
+
+void ResCache::Insert(const eastl::shared_ptr<ResHandle>& handle)
+{
+	mLRU.push_front(eastl::shared_ptr<ResHandle>(handle));
+	mResources[handle->mResource.mName] = mLRU.front();
+}
+
 bool ResCache::ExistResource(BaseResource * r) 
 { 
 	if (Find(r))
@@ -427,6 +436,36 @@ eastl::vector<eastl::wstring> ResCache::Match(const eastl::wstring pattern)
 }
 
 
+namespace
+{
+	// The raw files read ahead of the decoding are bounded by their size and
+	// by the number of decodes in flight, which also bounds the decoded
+	// resources waiting to be added to the cache.
+	const unsigned int PreloadMaxBytesInFlight = 64 * 1024 * 1024;
+	const unsigned int PreloadDecodesPerWorker = 2;
+
+	struct PreloadedResource
+	{
+		eastl::shared_ptr<ResHandle> mHandle;
+		BaseResourceLoader* mLoader;
+		char* mRawBuffer;
+		unsigned int mRawSize;
+		unsigned int mDecodeTime;
+		bool mLoaded;
+	};
+
+	struct PreloadQueue
+	{
+		PreloadQueue() : mNumInFlight(0), mBytesInFlight(0) { }
+
+		std::mutex mMutex;
+		std::condition_variable mDecoded;
+		eastl::vector<PreloadedResource> mFinished;
+		unsigned int mNumInFlight;
+		unsigned int mBytesInFlight;
+	};
+}
+
 //
 // ResCache::Preload								- Chapter 8, page 236
 //
@@ -435,19 +474,148 @@ int ResCache::Preload(const eastl::wstring pattern, void (*progressCallback)(int
 	if (mFile==NULL)
 		return 0;
 
+	// without a job system or its workers the resources load one by one
+	JobSystem* jobSystem = nullptr;
+	if (JobSystem::Exists() && JobSystem::Get()->GetNumWorkers() > 0)
+		jobSystem = JobSystem::Get();
+
 	int numFiles = mFile->GetNumResources();
 	int loaded = 0;
 	bool cancel = false;
 
-	for (int i=0; i<numFiles; ++i)
+	PreloadQueue queue;
+	unsigned int numDecoded = 0, decodeTime = 0, slowestTime = 0;
+	uint64_t decodedBytes = 0;
+	eastl::wstring slowestName;
+	const unsigned int startTime = Timer::GetRealTime();
+
+	// The decoded resources are added to the cache on this thread only.
+	auto FinishResources = [&](eastl::vector<PreloadedResource>& finished)
+	{
+		for (auto& resource : finished)
+		{
+			if (resource.mLoaded)
+				Insert(resource.mHandle);
+			else
+				LogWarning(L"Failed to decode " + resource.mHandle->GetName());
+
+			if (resource.mLoader->DiscardRawBufferAfterLoad())
+				delete[] resource.mRawBuffer;
+
+			numDecoded++;
+			decodedBytes += resource.mRawSize;
+			decodeTime += resource.mDecodeTime;
+			if (resource.mDecodeTime >= slowestTime)
+			{
+				slowestTime = resource.mDecodeTime;
+				slowestName = resource.mHandle->GetName();
+			}
+		}
+		finished.clear();
+	};
+
+	// Waits until fewer than numInFlight decodes and maxBytes raw bytes are
+	// in flight, handing back the decoded resources meanwhile.
+	auto WaitDecodes = [&](unsigned int numInFlight, unsigned int maxBytes)
+	{
+		eastl::vector<PreloadedResource> finished;
+		std::unique_lock<std::mutex> lock(queue.mMutex);
+		for (;;)
+		{
+			finished.swap(queue.mFinished);
+			bool wait = queue.mNumInFlight > 0 &&
+				(queue.mNumInFlight >= numInFlight || queue.mBytesInFlight > maxBytes);
+
+			lock.unlock();
+			FinishResources(finished);
+			lock.lock();
+
+			if (!wait)
+				break;
+			if (queue.mFinished.empty())
+				queue.mDecoded.wait(lock);
+		}
+	};
+
+	for (int i=0; i<numFiles && !cancel; ++i)
 	{
 		BaseResource resource(mFile->GetResourceName(i));
 
 		if (WildcardMatch(pattern.c_str(), resource.mName.c_str()))
 		{
-			const eastl::shared_ptr<ResHandle>& handle = 
-				ResCache::Get()->GetHandle(&resource);
-			++loaded;
+			BaseResourceLoader* loader = FindLoader(resource.mName);
+			if (!jobSystem || !loader || !loader->CanDecodeInParallel() ||
+				!loader->UseRawFile() || Find(&resource))
+			{
+				const eastl::shared_ptr<ResHandle>& handle = 
+					ResCache::Get()->GetHandle(&resource);
+				++loaded;
+			}
+			else
+			{
+				void* rawFile = NULL;
+				int rawSize = mFile->GetRawResource(resource, &rawFile);
+				if (rawFile == NULL || rawSize < 0)
+				{
+					LogWarning(L"Resource not found " + resource.mName);
+					continue;
+				}
+
+				BaseReadFile* file = (BaseReadFile*)rawFile;
+				char* rawBuffer = new char[file->GetSize()];
+				rawSize = file->Read(rawBuffer, file->GetSize());
+				delete file;
+
+				unsigned int size = loader->GetLoadedResourceSize(rawBuffer, rawSize);
+				char* buffer = Allocate(size);
+				if (!buffer)
+				{
+					// resource cache out of memory
+					delete[] rawBuffer;
+					continue;
+				}
+
+				PreloadedResource preloaded;
+				preloaded.mHandle = eastl::shared_ptr<ResHandle>(
+					new ResHandle(resource, buffer, size, true, this));
+				preloaded.mLoader = loader;
+				preloaded.mRawBuffer = rawBuffer;
+				preloaded.mRawSize = rawSize;
+				preloaded.mDecodeTime = 0;
+				preloaded.mLoaded = false;
+				++loaded;
+
+				if (loader->PrepareResource(rawBuffer, rawSize, preloaded.mHandle))
+				{
+					Insert(preloaded.mHandle);
+					if (loader->DiscardRawBufferAfterLoad())
+						delete[] rawBuffer;
+				}
+				else
+				{
+					WaitDecodes(PreloadDecodesPerWorker * jobSystem->GetNumWorkers(),
+						PreloadMaxBytesInFlight - eastl::min(PreloadMaxBytesInFlight, (unsigned int)rawSize));
+					{
+						std::lock_guard<std::mutex> lock(queue.mMutex);
+						queue.mNumInFlight++;
+						queue.mBytesInFlight += rawSize;
+					}
+
+					jobSystem->Submit([preloaded, &queue]() mutable
+					{
+						const unsigned int decodeStart = Timer::GetRealTime();
+						preloaded.mLoaded = preloaded.mLoader->DecodeResource(
+							preloaded.mRawBuffer, preloaded.mRawSize, preloaded.mHandle);
+						preloaded.mDecodeTime = Timer::GetRealTime() - decodeStart;
+
+						std::lock_guard<std::mutex> lock(queue.mMutex);
+						queue.mNumInFlight--;
+						queue.mBytesInFlight -= preloaded.mRawSize;
+						queue.mFinished.push_back(eastl::move(preloaded));
+						queue.mDecoded.notify_one();
+					});
+				}
+			}
 		}
 
 		if (progressCallback != NULL)
@@ -455,5 +623,20 @@ int ResCache::Preload(const eastl::wstring pattern, void (*progressCallback)(int
 			progressCallback(i * 100/numFiles, cancel);
 		}
 	}
+
+	// the jobs refer to the queue, all of them finish before returning
+	WaitDecodes(1, 0);
+
+	if (numDecoded > 0)
+	{
+		const unsigned int totalTime = eastl::max(Timer::GetRealTime() - startTime, 1u);
+		LogInformation(L"Preloaded " + eastl::to_wstring(loaded) + L" resources matching " + pattern +
+			L" in " + eastl::to_wstring(totalTime) + L" ms, " + eastl::to_wstring(numDecoded) +
+			L" decoded on " + eastl::to_wstring(jobSystem->GetNumWorkers()) + L" workers");
+		LogInformation(L"  decode: " + eastl::to_wstring(decodeTime / numDecoded) +
+			L" ms per resource, slowest " + slowestName + L" " + eastl::to_wstring(slowestTime) +
+			L" ms, " + eastl::to_wstring(numDecoded * 1000 / totalTime) + L" resources/s, " +
+			eastl::to_wstring((unsigned int)(decodedBytes * 1000 / 1024 / totalTime)) + L" KB/s");
+	}
 	return loaded;
 }
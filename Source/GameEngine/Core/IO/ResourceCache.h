@@ -166,6 +166,10 @@ public:
 	int GetResource(BaseResource* r, void** buffer);
 	eastl::shared_ptr<ResHandle> GetHandle(BaseResource * r);
 
+	// Loads every resource matching the pattern. The resources of the loaders
+	// which can decode in parallel are decoded on the job system while the
+	// next files are read, with a bounded amount of them in flight, and are
+	// added to the cache on the calling thread.
 	int Preload(const eastl::wstring pattern, void (*progressCallback)(int, bool &));
 	eastl::vector<eastl::wstring> Match(const eastl::wstring pattern);
 
@@ -192,6 +196,8 @@ protected:
 
 	eastl::shared_ptr<ResHandle> Load(BaseResource * r);
 	eastl::shared_ptr<ResHandle> Find(BaseResource * r);
+	BaseResourceLoader* FindLoader(const eastl::wstring& name);
+	void Insert(const eastl::shared_ptr<ResHandle>& handle);
 	void Update(const eastl::shared_ptr<ResHandle>& handle);
 
 	void FreeOneResource();
@@ -0,0 +1,175 @@
+//========================================================================
+// JobSystem.cpp : Defines a pool of worker threads which runs jobs and
+// parallel loops for the engine subsystems.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "JobSystem.h"
+
+#include "Core/Logger/Logger.h"
+
+JobSystem* JobSystem::mJobSystem = nullptr;
+
+static thread_local unsigned int CurrentThreadIndex = 0;
+
+JobSystem* JobSystem::Get()
+{
+	LogAssert(JobSystem::mJobSystem, "Job system doesn't exist");
+	return JobSystem::mJobSystem;
+}
+
+bool JobSystem::Exists()
+{
+	return JobSystem::mJobSystem != nullptr;
+}
+
+JobSystem::JobSystem(unsigned int numWorkers, bool setAsGlobal)
+	: mQuit(false)
+{
+	if (numWorkers == 0)
+	{
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		numWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	mWorkers.reserve(numWorkers);
+	for (unsigned int i = 1; i <= numWorkers; ++i)
+		mWorkers.push_back(std::thread(&JobSystem::WorkerThread, this, i));
+
+	if (setAsGlobal)
+	{
+		if (JobSystem::mJobSystem)
+		{
+			LogError("Attempting to create two global job systems! \
+					The old one will be destroyed and overwritten with this one.");
+			delete JobSystem::mJobSystem;
+		}
+
+		JobSystem::mJobSystem = this;
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	mMutex.lock();
+	{
+		mQuit = true;
+	}
+	mMutex.unlock();
+	mJobPushed.notify_all();
+
+	for (auto& worker : mWorkers)
+		worker.join();
+
+	if (JobSystem::mJobSystem == this)
+		JobSystem::mJobSystem = nullptr;
+}
+
+unsigned int JobSystem::GetNumThreads() const
+{
+	return (unsigned int)mWorkers.size() + 1;
+}
+
+unsigned int JobSystem::GetNumWorkers() const
+{
+	return (unsigned int)mWorkers.size();
+}
+
+unsigned int JobSystem::GetThreadIndex()
+{
+	return CurrentThreadIndex;
+}
+
+void JobSystem::Submit(Job const& job)
+{
+	mMutex.lock();
+	{
+		mJobs.push(job);
+	}
+	mMutex.unlock();
+	mJobPushed.notify_one();
+}
+
+void JobSystem::ParallelFor(unsigned int begin, unsigned int end,
+	unsigned int grainSize, RangeJob const& job)
+{
+	if (begin >= end)
+		return;
+
+	if (grainSize == 0)
+		grainSize = 1;
+
+	unsigned int numChunks = (end - begin + grainSize - 1) / grainSize;
+	if (numChunks == 1 || mWorkers.empty())
+	{
+		// not worth waking up the workers
+		for (unsigned int chunk = begin; chunk < end; chunk += grainSize)
+			job(chunk, eastl::min(chunk + grainSize, end));
+		return;
+	}
+
+	eastl::shared_ptr<ParallelRange> range = eastl::make_shared<ParallelRange>();
+	range->mJob = job;
+	range->mBegin = begin;
+	range->mEnd = end;
+	range->mGrainSize = grainSize;
+	range->mNumChunks = numChunks;
+	range->mNextChunk = 0;
+	range->mRemainingChunks = numChunks;
+
+	// wake up as many workers as chunks the calling thread won't take
+	unsigned int numHelpers = eastl::min(numChunks - 1, (unsigned int)mWorkers.size());
+	mMutex.lock();
+	{
+		for (unsigned int i = 0; i < numHelpers; ++i)
+			mJobs.push([range]() { ProcessChunks(*range); });
+	}
+	mMutex.unlock();
+	mJobPushed.notify_all();
+
+	// the calling thread works too, so the loop always completes even if
+	// all the workers are busy (or if we are already running on a worker)
+	ProcessChunks(*range);
+
+	std::unique_lock<std::mutex> lock(range->mMutex);
+	range->mFinished.wait(lock, [&range]() { return range->mRemainingChunks == 0; });
+}
+
+void JobSystem::ProcessChunks(ParallelRange& range)
+{
+	unsigned int chunk;
+	while ((chunk = range.mNextChunk++) < range.mNumChunks)
+	{
+		unsigned int chunkBegin = range.mBegin + chunk * range.mGrainSize;
+		unsigned int chunkEnd = eastl::min(chunkBegin + range.mGrainSize, range.mEnd);
+		range.mJob(chunkBegin, chunkEnd);
+
+		if (--range.mRemainingChunks == 0)
+		{
+			std::lock_guard<std::mutex> lock(range.mMutex);
+			range.mFinished.notify_all();
+		}
+	}
+}
+
+void JobSystem::WorkerThread(unsigned int threadIndex)
+{
+	CurrentThreadIndex = threadIndex;
+
+	for (;;)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mJobPushed.wait(lock, [this]() { return mQuit || !mJobs.empty(); });
+			if (mQuit && mJobs.empty())
+				return;
+
+			job = mJobs.front();
+			mJobs.pop();
+		}
+		job();
+	}
+}
@@ -0,0 +1,86 @@
+//========================================================================
+// JobSystem.h : Defines a pool of worker threads which runs jobs and
+// parallel loops for the engine subsystems.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include "Core/CoreStd.h"
+
+#include "EASTL/functional.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// The job system owns a fixed set of worker threads that are created once
+// and live as long as the application. Subsystems can either push
+// independent jobs with Submit, or split a range of work with ParallelFor
+// where the calling thread takes part in the work and returns once every
+// chunk has been processed. The chunk boundaries only depend on the range
+// and the grain size, so work which writes disjoint outputs per index gives
+// the same results regardless of which thread runs each chunk.
+class JobSystem
+{
+public:
+	typedef eastl::function<void()> Job;
+	typedef eastl::function<void(unsigned int, unsigned int)> RangeJob;
+
+	// Construction and destruction. A number of workers of zero creates one
+	// worker per hardware thread minus the calling one. The job system can
+	// be set as global so that it is reachable through JobSystem::Get.
+	JobSystem(unsigned int numWorkers = 0, bool setAsGlobal = true);
+	~JobSystem();
+
+	static JobSystem* Get();
+
+	// Whether the global job system exists, for the callers which fall back
+	// to running their work on the calling thread without it.
+	static bool Exists();
+
+	// Number of threads which take part in a parallel loop, that is the
+	// workers plus the calling thread.
+	unsigned int GetNumThreads() const;
+	unsigned int GetNumWorkers() const;
+
+	// Index of the current thread: 0 for any thread which isn't a worker
+	// (typically the main thread) and 1..numWorkers for the workers.
+	static unsigned int GetThreadIndex();
+
+	// Queue a job to be run by any of the workers.
+	void Submit(Job const& job);
+
+	// Run job(chunkBegin, chunkEnd) over [begin, end) split in chunks of
+	// grainSize elements and wait until all of them are finished.
+	void ParallelFor(unsigned int begin, unsigned int end,
+		unsigned int grainSize, RangeJob const& job);
+
+private:
+	struct ParallelRange
+	{
+		RangeJob mJob;
+		unsigned int mBegin, mEnd, mGrainSize, mNumChunks;
+		std::atomic<unsigned int> mNextChunk;
+		std::atomic<unsigned int> mRemainingChunks;
+		std::mutex mMutex;
+		std::condition_variable mFinished;
+	};
+
+	static void ProcessChunks(ParallelRange& range);
+	void WorkerThread(unsigned int threadIndex);
+
+	eastl::vector<std::thread> mWorkers;
+	eastl::queue<Job> mJobs;
+	std::mutex mMutex;
+	std::condition_variable mJobPushed;
+	bool mQuit;
+
+	static JobSystem* mJobSystem;
+};
+
+#endif
@@ -30,6 +30,7 @@ public:
 	void RemoveAll();
 	bool Get(Key key, Value& value) const;
 	void GatherAll(eastl::vector<Value>& values) const;
+	void GatherKeys(eastl::vector<Key>& keys) const;
 
 protected:
 	eastl::map<Key, Value> mMap;
@@ -155,4 +156,19 @@ void ThreadSafeMap<Key, Value>::GatherAll(eastl::vector<Value>& values) const
 	mMutex.unlock();
 }
 
+template <typename Key, typename Value>
+void ThreadSafeMap<Key, Value>::GatherKeys(eastl::vector<Key>& keys) const
+{
+	mMutex.lock();
+	{
+		keys.clear();
+		keys.reserve(mMap.size());
+		for (auto const& m : mMap)
+		{
+			keys.push_back(m.first);
+		}
+	}
+	mMutex.unlock();
+}
+
 #endif
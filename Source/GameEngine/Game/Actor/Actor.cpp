@@ -52,6 +52,7 @@ Actor::Actor(ActorId id)
 {
     mID = id;
     mType = "Unknown";
+	mNumParallelComponents = 0;
 
 	// [mrmike] added post press - this is an editor helper
 	mResource = "Unknown";
@@ -85,6 +86,7 @@ void Actor::PostInit(void)
 void Actor::Destroy(void)
 {
     mComponents.clear();
+	mNumParallelComponents = 0;
 }
 
 void Actor::Update(float deltaMs)
@@ -96,6 +98,16 @@ void Actor::Update(float deltaMs)
     }
 }
 
+void Actor::UpdateComponents(float deltaMs, bool parallelSafe)
+{
+	ActorComponents::iterator it = mComponents.begin();
+    for (; it != mComponents.end(); ++it)
+    {
+		if (it->second->IsParallelUpdateSafe() == parallelSafe)
+			it->second->Update(deltaMs);
+    }
+}
+
 eastl::string Actor::ToXML()
 {
     tinyxml2::XMLDocument outDoc;
@@ -126,5 +138,8 @@ void Actor::AddComponent(eastl::shared_ptr<ActorComponent> pComponent)
     eastl::pair<ActorComponents::iterator, bool> success = 
 		mComponents.insert(eastl::make_pair(pComponent->GetId(), pComponent));
     LogAssert(success.second, "error add component");
+
+	if (success.second && pComponent->IsParallelUpdateSafe())
+		mNumParallelComponents++;
 }
 
@@ -61,6 +61,7 @@ private:
 
 	// all components this actor has
 	ActorComponents mComponents;
+	unsigned int mNumParallelComponents;
 
 	// [mrmike] - these were added post press as editor helpers, 
 	// but will also be great for save game files if we ever make them.
@@ -76,6 +77,12 @@ public:
     void Destroy(void);
     virtual void Update(float deltaMs);
 
+	// updates either the components which are safe to update in parallel with
+	// other actors or the ones which are not
+	void UpdateComponents(float deltaMs, bool parallelSafe);
+	bool HasParallelComponents(void) const { return mNumParallelComponents > 0; }
+	bool HasSerialComponents(void) const { return mNumParallelComponents < mComponents.size(); }
+
     // editor functions
 	//[mrmike] - we can delete this.
     //bool SaveActorFromEditor(const char* path);
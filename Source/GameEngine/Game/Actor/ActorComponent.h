@@ -69,6 +69,12 @@ public:
 	virtual void Update(float deltaMs) { }
 	virtual void OnChanged(void) { }				// [mrmike] - added post-press
 
+	// Components whose Update only changes their own actor (or goes through thread
+	// safe systems) can be updated in parallel with the other actors. They must
+	// not create or destroy actors directly but through the deferred calls of
+	// the GameLogic, which are applied once the parallel update is done.
+	virtual bool IsParallelUpdateSafe(void) const { return false; }
+
     // for the editor
     virtual tinyxml2::XMLElement* GenerateXml(void) = 0;
 
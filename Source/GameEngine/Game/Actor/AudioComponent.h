@@ -68,6 +68,7 @@ public:
     // ActorComponent interface
     virtual bool Init(tinyxml2::XMLElement* pData) override;
     virtual void PostInit(void) override;
+	virtual bool IsParallelUpdateSafe(void) const override { return true; }
 };
 
 
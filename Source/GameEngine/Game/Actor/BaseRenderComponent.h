@@ -67,6 +67,7 @@ public:
     virtual void PostInit(void) override;
 	virtual void OnChanged(void) override;
     virtual tinyxml2::XMLElement* GenerateXml(void) override;
+	virtual bool IsParallelUpdateSafe(void) const override { return true; }
 	//const Color GetColor() const { return mColor; }
 
 protected:
@@ -1466,6 +1466,8 @@ ParticleEffectRenderComponent::ParticleEffectRenderComponent(void)
 	mMaterialType = 0;
 	mEmitterType = PET_NONE;
 	mAffectorType = PAT_NONE;
+	mMaxParticles = 16250;
+	mSortByDepth = false;
 }
 
 bool ParticleEffectRenderComponent::DelegateInit(tinyxml2::XMLElement* pData)
@@ -1622,6 +1624,24 @@ bool ParticleEffectRenderComponent::DelegateInit(tinyxml2::XMLElement* pData)
 		mMaxStartSize = Vector2<float>{ x, y };
 	}
 
+	tinyxml2::XMLElement* pMaxParticles = pData->FirstChildElement("MaxParticles");
+	if (pMaxParticles)
+	{
+		unsigned int count = 16250;
+		count = pMaxParticles->UnsignedAttribute("count", count);
+
+		mMaxParticles = count;
+	}
+
+	tinyxml2::XMLElement* pSortByDepth = pData->FirstChildElement("SortByDepth");
+	if (pSortByDepth)
+	{
+		bool enabled = false;
+		enabled = pSortByDepth->BoolAttribute("enabled", enabled);
+
+		mSortByDepth = enabled;
+	}
+
 	return true;
 }
 
@@ -1642,6 +1662,8 @@ eastl::shared_ptr<Node> ParticleEffectRenderComponent::CreateSceneNode(void)
 			eastl::shared_ptr<ParticleSystemNode> particleSystem = 
 				eastl::dynamic_shared_pointer_cast<ParticleSystemNode>(node);
 			particleSystem->GetRelativeTransform() = transform;
+			particleSystem->SetMaxParticles(mMaxParticles);
+			particleSystem->SetSortByDepth(mSortByDepth);
 
 			switch (mEmitterType)
 			{
@@ -1848,6 +1870,14 @@ void ParticleEffectRenderComponent::CreateInheritedXMLElements(
 	pSizeMaximum->SetAttribute("x", eastl::to_string(mMaxStartSize[0]).c_str());
 	pSizeMaximum->SetAttribute("y", eastl::to_string(mMaxStartSize[1]).c_str());
 	pBaseElement->LinkEndChild(pSizeMaximum);
+
+	tinyxml2::XMLElement* pMaxParticles = doc.NewElement("MaxParticles");
+	pMaxParticles->SetAttribute("count", eastl::to_string(mMaxParticles).c_str());
+	pBaseElement->LinkEndChild(pMaxParticles);
+
+	tinyxml2::XMLElement* pSortByDepth = doc.NewElement("SortByDepth");
+	pSortByDepth->SetAttribute("enabled", mSortByDepth);
+	pBaseElement->LinkEndChild(pSortByDepth);
 }
 
 
@@ -265,6 +265,8 @@ class ParticleEffectRenderComponent : public BaseRenderComponent
 	int mMaxAngle;
 	Vector2<float> mMaxStartSize;        // min size
 	Vector2<float> mMinStartSize;       // max size
+	unsigned int mMaxParticles;         // alive at once
+	bool mSortByDepth;                  // back to front
 
 public:
 	static const char *Name;
@@ -58,6 +58,7 @@ public:
 	TransformComponent(void) { mTransform.MakeIdentity(); }
     virtual bool Init(tinyxml2::XMLElement* pData) override;
     virtual tinyxml2::XMLElement* GenerateXml(void) override;
+	virtual bool IsParallelUpdateSafe(void) const override { return true; }
 
     // transform functions
 	Transform GetTransform(void) const { return mTransform; }
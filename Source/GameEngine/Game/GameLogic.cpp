@@ -42,6 +42,7 @@
 #include "Core/Event/Event.h"				// only for EventDataGame_State
 #include "Core/Process/Process.h"
 #include "Core/IO/XmlResource.h"
+#include "Core/Threading/JobSystem.h"
 
 #include "Network/Network.h"
 #include "Physic/Physic.h"
@@ -74,6 +75,7 @@ GameLogic::GameLogic()
 {
 	mLastActorId = 0;
 	mLifetime = 0;
+	mUpdatingActorsInParallel = false;
 
 	//mRandom.Randomize();
 	mGameState = BGS_INITIALIZING;
@@ -183,6 +185,16 @@ bool GameLogic::LoadGame(const char* levelResource)
         postLoadScript = pScriptElement->Attribute("postLoad");
     }
 
+	// preload the resources the level lists, so that the actors find their
+	// images already decoded by the job system
+	tinyxml2::XMLElement* pPreloadElement = pRoot->FirstChildElement("Preload");
+	for (; pPreloadElement; pPreloadElement = pPreloadElement->NextSiblingElement("Preload"))
+	{
+		const char* resources = pPreloadElement->Attribute("resources");
+		if (resources)
+			ResCache::Get()->Preload(ToWideString(resources), NULL);
+	}
+
     // load all initial actors
 	tinyxml2::XMLElement* pActorsNode = pRoot->FirstChildElement("StaticActors");
     if (pActorsNode)
@@ -249,6 +261,7 @@ eastl::shared_ptr<Actor> GameLogic::CreateActor(const eastl::string &actorResour
 	tinyxml2::XMLElement *overrides, const Transform *initialTransform, const ActorId serversActorId)
 {
     LogAssert(mActorFactory, "actor factory is not initialized");
+	LogAssert(!mUpdatingActorsInParallel, "actors created during the parallel update must be deferred");
 	if (!mIsProxy && serversActorId != INVALID_ACTOR_ID)
 		return eastl::shared_ptr<Actor>();
 
@@ -277,6 +290,12 @@ eastl::shared_ptr<Actor> GameLogic::CreateActor(const eastl::string &actorResour
 
 void GameLogic::DestroyActor(const ActorId actorId)
 {
+	if (mUpdatingActorsInParallel)
+	{
+		DeferDestroyActor(actorId);
+		return;
+	}
+
     //	We need to trigger a synchronous event to ensure that any systems responding to this 
 	//	event can still access a valid actor if need to be. The actor will be destroyed after this.
     eastl::shared_ptr<EventDataDestroyActor> pEvent(new EventDataDestroyActor(actorId));
@@ -384,11 +403,96 @@ void GameLogic::OnUpdate(float time, float elapsedTime)
 	}
 
     // update game actors
-    for (ActorMap::const_iterator it = mActors.begin(); it != mActors.end(); ++it)
-    {
-        it->second->Update(elapsedTime);
-    }
+	UpdateActors(elapsedTime);
+}
+
+void GameLogic::UpdateActors(float elapsedTime)
+{
+	mParallelActors.clear();
+	mSerialActors.clear();
+	for (ActorMap::const_iterator it = mActors.begin(); it != mActors.end(); ++it)
+	{
+		if (it->second->HasParallelComponents())
+			mParallelActors.push_back(it->second.get());
+		if (it->second->HasSerialComponents())
+			mSerialActors.push_back(it->second);
+	}
+
+	if (!mParallelActors.empty())
+	{
+		// no actor is created or destroyed until the parallel phase is over, so
+		// the raw pointers stay valid
+		mUpdatingActorsInParallel = true;
+		JobSystem::Get()->ParallelFor(0, (unsigned int)mParallelActors.size(), 32,
+			[this, elapsedTime](unsigned int begin, unsigned int end)
+			{
+				for (unsigned int i = begin; i < end; ++i)
+					mParallelActors[i]->UpdateComponents(elapsedTime, true);
+			});
+		mUpdatingActorsInParallel = false;
+
+		ApplyActorCommands();
+	}
+
+	for (const eastl::shared_ptr<Actor>& pActor : mSerialActors)
+		pActor->UpdateComponents(elapsedTime, false);
+	mSerialActors.clear();
+}
+
+void GameLogic::DeferCreateActor(const eastl::string &actorResource, const Transform *initialTransform)
+{
+	if (initialTransform)
+	{
+		Transform transform = *initialTransform;
+		DeferActorCommand([this, actorResource, transform]()
+		{
+			CreateActor(actorResource, nullptr, &transform);
+		});
+	}
+	else
+	{
+		DeferActorCommand([this, actorResource]()
+		{
+			CreateActor(actorResource, nullptr);
+		});
+	}
+}
+
+void GameLogic::DeferDestroyActor(const ActorId actorId)
+{
+	DeferActorCommand([this, actorId]() { DestroyActor(actorId); });
+}
+
+void GameLogic::DeferActorCommand(const eastl::function<void()>& command)
+{
+	if (!mUpdatingActorsInParallel)
+	{
+		command();
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mActorCommandsMutex);
+	mActorCommands.push_back(command);
+}
+
+void GameLogic::ApplyActorCommands(void)
+{
+	// the commands run on the calling thread once no actor is being updated,
+	// the buffer is swapped first since they may defer new commands
+	eastl::vector<eastl::function<void()>> actorCommands;
+	{
+		std::lock_guard<std::mutex> lock(mActorCommandsMutex);
+		actorCommands.swap(mActorCommands);
+	}
+
+	for (const eastl::function<void()>& command : actorCommands)
+		command();
 
+	// give the storage back to the buffer for the next frame
+	actorCommands.clear();
+	std::lock_guard<std::mutex> lock(mActorCommandsMutex);
+	if (mActorCommands.empty())
+		mActorCommands.swap(actorCommands);
 }
 
 //
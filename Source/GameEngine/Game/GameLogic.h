@@ -48,6 +48,10 @@
 #include "Mathematic/Algebra/Transform.h"
 #include "Mathematic/Algebra/Matrix4x4.h"
 
+#include "EASTL/functional.h"
+
+#include <mutex>
+
 class ActorFactory;
 class LevelManager;
 class AIManager;
@@ -120,6 +124,13 @@ public:
 
 	virtual void SyncActor(const ActorId id, Transform const &transform) {}
 
+	// Structural changes requested by the components updated in parallel. They
+	// are recorded in a command buffer and applied in order once the parallel
+	// update is done. DestroyActor defers itself when called during that phase.
+	void DeferCreateActor(const eastl::string &actorResource, const Transform *initialTransform = NULL);
+	void DeferDestroyActor(const ActorId actorId);
+	void DeferActorCommand(const eastl::function<void()>& command);
+
 	// editor functions
 	eastl::string GetActorXml(const ActorId id);
 
@@ -172,10 +183,24 @@ protected:
 	void SyncActorDelegate(BaseEventDataPtr pEventData);
 	void RequestNewActorDelegate(BaseEventDataPtr pEventData);
 
+	// The components which are safe to update in parallel are updated first over
+	// the job system, then the remaining ones are updated on the calling thread.
+	void UpdateActors(float elapsedTime);
+	void ApplyActorCommands(void);
+
 	float mLifetime;								//indicates how long this game has been in session
 
 	ActorMap mActors;
 	ActorId mLastActorId;
+
+	// per frame actor lists, kept to avoid reallocating them on every update
+	eastl::vector<Actor*> mParallelActors;
+	eastl::vector<eastl::shared_ptr<Actor>> mSerialActors;
+
+	// command buffer of the parallel actor update
+	bool mUpdatingActorsInParallel;
+	std::mutex mActorCommandsMutex;
+	eastl::vector<eastl::function<void()>> mActorCommands;
 	BaseGameState mGameState;							// game state: loading, running, etc.
 	int mExpectedPlayers;							// how many local human players
 	int mExpectedRemotePlayers;					// expected remote human players
@@ -39,6 +39,7 @@
 #include "GameOption.h"
 
 #include "Core/IO/XmlResource.h"
+#include "Core/Utility/StringUtil.h"
 
 GameOption::GameOption()
 {
@@ -60,6 +61,24 @@ GameOption::GameOption()
 	mMaxAIs = 4;
 	mMaxPlayers = 4;
 
+	mLogicTickRate = 60;
+	mMaxLogicTicks = 5;
+
+	mWorkerThreads = 0;
+	mRenderGrainSize = 0;
+
+	mPoseCacheSize = 8192;
+
+	mStaticBatchCellSize = 1024.f;
+	mStaticBatchCache = true;
+
+	mProgramCache = true;
+
+	mTextureMipFilter = "box";
+
+	mSkinningBenchmark = 0;
+	mBindBenchmark = 0;
+
 	mRoot = NULL;
 }
 
@@ -109,5 +128,82 @@ void GameOption::Init(const wchar_t* xmlFileName)
 			mListenPort = atoi(pNode->Attribute("ListenPort"));
 			mGameHost = pNode->Attribute("GameHost");
 		}
+
+		pNode = mRoot->FirstChildElement("GameLoop");
+		if (pNode)
+		{
+			if (pNode->Attribute("TickRate"))
+				mLogicTickRate = pNode->UnsignedAttribute("TickRate", mLogicTickRate);
+			if (pNode->Attribute("MaxTicks"))
+				mMaxLogicTicks = pNode->UnsignedAttribute("MaxTicks", mMaxLogicTicks);
+		}
+
+		pNode = mRoot->FirstChildElement("Threading");
+		if (pNode)
+		{
+			if (pNode->Attribute("Workers"))
+				mWorkerThreads = pNode->UnsignedAttribute("Workers", mWorkerThreads);
+			if (pNode->Attribute("RenderGrainSize"))
+				mRenderGrainSize = pNode->UnsignedAttribute("RenderGrainSize", mRenderGrainSize);
+		}
+
+		pNode = mRoot->FirstChildElement("Animation");
+		if (pNode)
+		{
+			if (pNode->Attribute("PoseCacheSize"))
+				mPoseCacheSize = pNode->UnsignedAttribute("PoseCacheSize", mPoseCacheSize);
+		}
+
+		pNode = mRoot->FirstChildElement("StaticBatch");
+		if (pNode)
+		{
+			if (pNode->Attribute("CellSize"))
+			{
+				float cellSize = pNode->FloatAttribute("CellSize", mStaticBatchCellSize);
+				if (cellSize >= 0.f) mStaticBatchCellSize = cellSize;
+			}
+
+			if (pNode->Attribute("Cache"))
+			{
+				eastl::string attribute(pNode->Attribute("Cache"));
+				mStaticBatchCache = (attribute == "true");
+			}
+
+			if (pNode->Attribute("CachePath"))
+				mStaticBatchCachePath = pNode->Attribute("CachePath");
+		}
+
+		pNode = mRoot->FirstChildElement("Shaders");
+		if (pNode)
+		{
+			if (pNode->Attribute("Cache"))
+			{
+				eastl::string attribute(pNode->Attribute("Cache"));
+				mProgramCache = (attribute == "true");
+			}
+
+			if (pNode->Attribute("CachePath"))
+				mProgramCachePath = pNode->Attribute("CachePath");
+		}
+
+		pNode = mRoot->FirstChildElement("Textures");
+		if (pNode)
+		{
+			if (pNode->Attribute("Cook"))
+				mTextureCookPattern = ToWideString(pNode->Attribute("Cook"));
+			if (pNode->Attribute("MipFilter"))
+				mTextureMipFilter = pNode->Attribute("MipFilter");
+		}
+
+		pNode = mRoot->FirstChildElement("Benchmark");
+		if (pNode)
+		{
+			if (pNode->Attribute("Skinning"))
+				mSkinningBenchmark = pNode->UnsignedAttribute("Skinning", mSkinningBenchmark);
+			if (pNode->Attribute("Binds"))
+				mBindBenchmark = pNode->UnsignedAttribute("Binds", mBindBenchmark);
+			if (pNode->Attribute("Textures"))
+				mTextureBenchmark = ToWideString(pNode->Attribute("Textures"));
+		}
 	}
 }
\ No newline at end of file
@@ -79,6 +79,57 @@ struct GameOption
 	int mMaxAIs;
 	int mMaxPlayers;
 
+	// Game loop options
+
+	//! Rate at which the logic ticks with a fixed step. Default: 60 - 0 steps by the frame time
+	unsigned int mLogicTickRate;
+	//! Most logic ticks run in a frame to catch up with the time. Default: 5
+	unsigned int mMaxLogicTicks;
+
+	// Threading options
+
+	//! Number of worker threads of the job system. Default: 0 - one per hardware thread
+	unsigned int mWorkerThreads;
+	//! Nodes of a render pass recorded by each worker in a command list. Default: 0 - the calling thread renders the passes
+	unsigned int mRenderGrainSize;
+
+	// Animation options
+
+	//! Memory in KB of the poses shared by the instances of animated meshes. Default: 8192 - 0 disables the cache
+	unsigned int mPoseCacheSize;
+
+	// Static mesh options
+
+	//! Size of the grid cells the static meshes are split in to cull their parts. Default: 1024 - 0 disables the split
+	float mStaticBatchCellSize;
+	//! Should the merged static meshes be saved and loaded back. Default: true
+	bool mStaticBatchCache;
+	//! Folder of the merged static mesh files. Default: "" - working directory
+	eastl::string mStaticBatchCachePath;
+
+	// Shader options
+
+	//! Should the compiled shader programs be saved and loaded back. Default: true
+	bool mProgramCache;
+	//! Folder of the compiled shader programs file. Default: "" - working directory
+	eastl::string mProgramCachePath;
+
+	// Texture options
+
+	//! Images of the resource cache cooked with their mipmaps at startup, as "art/*.png". Default: "" - disabled
+	eastl::wstring mTextureCookPattern;
+	//! Filter of the cooked mipmaps, "box" or "kaiser". Default: "box"
+	eastl::string mTextureMipFilter;
+
+	// Benchmark options
+
+	//! Vertices of the rig skinned at startup to measure the skinning. Default: 0 - disabled
+	unsigned int mSkinningBenchmark;
+	//! Binds per frame run at startup to measure the renderer bridge lookups. Default: 0 - disabled
+	unsigned int mBindBenchmark;
+	//! Images of the resource cache loaded at startup to compare decoding and cooked textures. Default: "" - disabled
+	eastl::wstring mTextureBenchmark;
+
 	// XMLElement - look at this to find other options added by the developer
 	tinyxml2::XMLElement *mRoot;
 
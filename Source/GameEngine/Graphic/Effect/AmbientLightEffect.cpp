@@ -15,26 +15,26 @@ AmbientLightEffect::AmbientLightEffect(eastl::shared_ptr<ProgramFactory> const&
     LightingEffect(factory, updater, path, material, lighting, nullptr)
 {
     mMaterialConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalMaterial), true);
-    UpdateMaterialConstant();
     mProgram->GetVShader()->Set("Material", mMaterialConstant);
 
     mLightingConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalLighting), true);
-    UpdateLightingConstant();
     mProgram->GetVShader()->Set("Lighting", mLightingConstant);
+
+    GetMemberHandles();
+    UpdateMaterialConstant();
+    UpdateLightingConstant();
 }
 
 void AmbientLightEffect::UpdateMaterialConstant()
 {
-    InternalMaterial* internalMaterial = mMaterialConstant->Get<InternalMaterial>();
-    internalMaterial->emissive = mMaterial->mEmissive;
-    internalMaterial->ambient = mMaterial->mAmbient;
+    mMaterialConstant->Set(mMaterialEmissive, mMaterial->mEmissive);
+    mMaterialConstant->Set(mMaterialAmbient, mMaterial->mAmbient);
     LightingEffect::UpdateMaterialConstant();
 }
 
 void AmbientLightEffect::UpdateLightingConstant()
 {
-    InternalLighting* internalLighting = mLightingConstant->Get<InternalLighting>();
-    internalLighting->ambient = mLighting->mAmbient;
-    internalLighting->attenuation = mLighting->mAttenuation;
+    mLightingConstant->Set(mLightingAmbient, mLighting->mAmbient);
+    mLightingConstant->Set(mLightingAttenuation, mLighting->mAttenuation);
     LightingEffect::UpdateLightingConstant();
 }
\ No newline at end of file
@@ -14,13 +14,8 @@ DirectionalLightEffect::DirectionalLightEffect(eastl::shared_ptr<ProgramFactory>
     LightingEffect(factory, updater, path, material, lighting, geometry)
 {
     mMaterialConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalMaterial), true);
-    UpdateMaterialConstant();
-
     mLightingConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalLighting), true);
-    UpdateLightingConstant();
-
     mGeometryConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalGeometry), true);
-    UpdateGeometryConstant();
 
     if ((select & 1) == 0)
     {
@@ -34,32 +29,34 @@ DirectionalLightEffect::DirectionalLightEffect(eastl::shared_ptr<ProgramFactory>
         mProgram->GetPShader()->Set("Lighting", mLightingConstant);
         mProgram->GetPShader()->Set("LightCameraGeometry", mGeometryConstant);
     }
+
+    GetMemberHandles();
+    UpdateMaterialConstant();
+    UpdateLightingConstant();
+    UpdateGeometryConstant();
 }
 
 void DirectionalLightEffect::UpdateMaterialConstant()
 {
-    InternalMaterial* internalMaterial = mMaterialConstant->Get<InternalMaterial>();
-    internalMaterial->emissive = mMaterial->mEmissive;
-    internalMaterial->ambient = mMaterial->mAmbient;
-    internalMaterial->diffuse = mMaterial->mDiffuse;
-    internalMaterial->specular = mMaterial->mSpecular;
+    mMaterialConstant->Set(mMaterialEmissive, mMaterial->mEmissive);
+    mMaterialConstant->Set(mMaterialAmbient, mMaterial->mAmbient);
+    mMaterialConstant->Set(mMaterialDiffuse, mMaterial->mDiffuse);
+    mMaterialConstant->Set(mMaterialSpecular, mMaterial->mSpecular);
     LightingEffect::UpdateMaterialConstant();
 }
 
 void DirectionalLightEffect::UpdateLightingConstant()
 {
-    InternalLighting* internalLighting = mLightingConstant->Get<InternalLighting>();
-    internalLighting->ambient = mLighting->mAmbient;
-    internalLighting->diffuse = mLighting->mDiffuse;
-    internalLighting->specular = mLighting->mSpecular;
-    internalLighting->attenuation = mLighting->mAttenuation;
+    mLightingConstant->Set(mLightingAmbient, mLighting->mAmbient);
+    mLightingConstant->Set(mLightingDiffuse, mLighting->mDiffuse);
+    mLightingConstant->Set(mLightingSpecular, mLighting->mSpecular);
+    mLightingConstant->Set(mLightingAttenuation, mLighting->mAttenuation);
     LightingEffect::UpdateLightingConstant();
 }
 
 void DirectionalLightEffect::UpdateGeometryConstant()
 {
-    InternalGeometry* internalGeometry = mGeometryConstant->Get<InternalGeometry>();
-    internalGeometry->lightModelDirection = mGeometry->lightModelDirection;
-    internalGeometry->cameraModelPosition = mGeometry->cameraModelPosition;
+    mGeometryConstant->Set(mLightModelDirection, mGeometry->lightModelDirection);
+    mGeometryConstant->Set(mCameraModelPosition, mGeometry->cameraModelPosition);
     LightingEffect::UpdateGeometryConstant();
 }
\ No newline at end of file
@@ -23,17 +23,18 @@ DirectionalLightTextureEffect::DirectionalLightTextureEffect(
     mSampler->mMode[1] = mode1;
 
     mMaterialConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalMaterial), true);
-    UpdateMaterialConstant();
-
     mLightingConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalLighting), true);
-    UpdateLightingConstant();
-
     mGeometryConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalGeometry), true);
-    UpdateGeometryConstant();
 
     mProgram->GetPShader()->Set("Material", mMaterialConstant);
     mProgram->GetPShader()->Set("Lighting", mLightingConstant);
     mProgram->GetPShader()->Set("LightCameraGeometry", mGeometryConstant);
+
+    GetMemberHandles();
+    UpdateMaterialConstant();
+    UpdateLightingConstant();
+    UpdateGeometryConstant();
+
 #if defined(_OPENGL_)
     mProgram->GetPShader()->Set("baseSampler", mTexture);
 #else
@@ -54,28 +55,25 @@ void DirectionalLightTextureEffect::SetTexture(eastl::shared_ptr<Texture2> const
 
 void DirectionalLightTextureEffect::UpdateMaterialConstant()
 {
-    InternalMaterial* internalMaterial = mMaterialConstant->Get<InternalMaterial>();
-    internalMaterial->emissive = mMaterial->mEmissive;
-    internalMaterial->ambient = mMaterial->mAmbient;
-    internalMaterial->diffuse = mMaterial->mDiffuse;
-    internalMaterial->specular = mMaterial->mSpecular;
+    mMaterialConstant->Set(mMaterialEmissive, mMaterial->mEmissive);
+    mMaterialConstant->Set(mMaterialAmbient, mMaterial->mAmbient);
+    mMaterialConstant->Set(mMaterialDiffuse, mMaterial->mDiffuse);
+    mMaterialConstant->Set(mMaterialSpecular, mMaterial->mSpecular);
     LightingEffect::UpdateMaterialConstant();
 }
 
 void DirectionalLightTextureEffect::UpdateLightingConstant()
 {
-    InternalLighting* internalLighting = mLightingConstant->Get<InternalLighting>();
-    internalLighting->ambient = mLighting->mAmbient;
-    internalLighting->diffuse = mLighting->mDiffuse;
-    internalLighting->specular = mLighting->mSpecular;
-    internalLighting->attenuation = mLighting->mAttenuation;
+    mLightingConstant->Set(mLightingAmbient, mLighting->mAmbient);
+    mLightingConstant->Set(mLightingDiffuse, mLighting->mDiffuse);
+    mLightingConstant->Set(mLightingSpecular, mLighting->mSpecular);
+    mLightingConstant->Set(mLightingAttenuation, mLighting->mAttenuation);
     LightingEffect::UpdateLightingConstant();
 }
 
 void DirectionalLightTextureEffect::UpdateGeometryConstant()
 {
-    InternalGeometry* internalGeometry = mGeometryConstant->Get<InternalGeometry>();
-    internalGeometry->lightModelDirection = mGeometry->lightModelDirection;
-    internalGeometry->cameraModelPosition = mGeometry->cameraModelPosition;
+    mGeometryConstant->Set(mLightModelDirection, mGeometry->lightModelDirection);
+    mGeometryConstant->Set(mCameraModelPosition, mGeometry->cameraModelPosition);
     LightingEffect::UpdateGeometryConstant();
 }
\ No newline at end of file
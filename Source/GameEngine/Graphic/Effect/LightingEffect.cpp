@@ -35,6 +35,30 @@ void LightingEffect::SetPVWMatrixConstant(eastl::shared_ptr<ConstantBuffer> cons
     mProgram->GetVShader()->Set("PVWMatrix", mPVWMatrixConstant);
 }
 
+void LightingEffect::GetMemberHandles()
+{
+    auto getHandle = [](eastl::shared_ptr<ConstantBuffer> const& cbuffer, char const* name)
+    {
+        return cbuffer && cbuffer->HasMember(name) ?
+            cbuffer->GetMemberHandle(name) : ConstantBuffer::MemberHandle();
+    };
+
+    mMaterialEmissive = getHandle(mMaterialConstant, "materialEmissive");
+    mMaterialAmbient = getHandle(mMaterialConstant, "materialAmbient");
+    mMaterialDiffuse = getHandle(mMaterialConstant, "materialDiffuse");
+    mMaterialSpecular = getHandle(mMaterialConstant, "materialSpecular");
+
+    mLightingAmbient = getHandle(mLightingConstant, "lightingAmbient");
+    mLightingDiffuse = getHandle(mLightingConstant, "lightingDiffuse");
+    mLightingSpecular = getHandle(mLightingConstant, "lightingSpecular");
+    mLightingSpotCutoff = getHandle(mLightingConstant, "lightingSpotCutoff");
+    mLightingAttenuation = getHandle(mLightingConstant, "lightingAttenuation");
+
+    mLightModelPosition = getHandle(mGeometryConstant, "lightModelPosition");
+    mLightModelDirection = getHandle(mGeometryConstant, "lightModelDirection");
+    mCameraModelPosition = getHandle(mGeometryConstant, "cameraModelPosition");
+}
+
 void LightingEffect::UpdateMaterialConstant()
 {
     if (mMaterialConstant)
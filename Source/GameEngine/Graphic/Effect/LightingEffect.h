@@ -62,6 +62,25 @@ protected:
 	eastl::shared_ptr<ConstantBuffer> mMaterialConstant;
 	eastl::shared_ptr<ConstantBuffer> mLightingConstant;
 	eastl::shared_ptr<ConstantBuffer> mGeometryConstant;
+
+    // The derived-class constructors resolve the members once the constant
+    // buffers are attached to the shaders, so that the updates write them
+    // without any name lookup. The members missing from the buffers of an
+    // effect keep invalid handles.
+    void GetMemberHandles();
+
+    ConstantBuffer::MemberHandle mMaterialEmissive;
+    ConstantBuffer::MemberHandle mMaterialAmbient;
+    ConstantBuffer::MemberHandle mMaterialDiffuse;
+    ConstantBuffer::MemberHandle mMaterialSpecular;
+    ConstantBuffer::MemberHandle mLightingAmbient;
+    ConstantBuffer::MemberHandle mLightingDiffuse;
+    ConstantBuffer::MemberHandle mLightingSpecular;
+    ConstantBuffer::MemberHandle mLightingSpotCutoff;
+    ConstantBuffer::MemberHandle mLightingAttenuation;
+    ConstantBuffer::MemberHandle mLightModelPosition;
+    ConstantBuffer::MemberHandle mLightModelDirection;
+    ConstantBuffer::MemberHandle mCameraModelPosition;
 };
 
 inline void LightingEffect::SetMaterial(eastl::shared_ptr<Material> const& material)
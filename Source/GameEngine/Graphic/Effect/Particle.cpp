@@ -0,0 +1,114 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "Particle.h"
+
+ParticleArray::ParticleArray()
+	: mNumParticles(0), mCapacity(0)
+{
+
+}
+
+void ParticleArray::Reserve(unsigned int capacity)
+{
+	capacity = (capacity + 3) & ~3u;
+	if (capacity <= mCapacity)
+		return;
+
+	for (int k = 0; k < 3; ++k)
+	{
+		mPos[k].resize(capacity, 0.f);
+		mVector[k].resize(capacity, 0.f);
+		mStartVector[k].resize(capacity, 0.f);
+	}
+	for (int k = 0; k < 4; ++k)
+	{
+		mColor[k].resize(capacity, 0.f);
+		mStartColor[k].resize(capacity, 0.f);
+	}
+	for (int k = 0; k < 2; ++k)
+	{
+		mSize[k].resize(capacity, 0.f);
+		mStartSize[k].resize(capacity, 0.f);
+	}
+	mStartTime.resize(capacity, 0);
+	mEndTime.resize(capacity, 0);
+
+	mCapacity = capacity;
+}
+
+void ParticleArray::Add(const Particle& particle)
+{
+	const unsigned int i = mNumParticles++;
+	for (int k = 0; k < 3; ++k)
+	{
+		mPos[k][i] = particle.mPos[k];
+		mVector[k][i] = particle.mVector[k];
+		mStartVector[k][i] = particle.mStartVector[k];
+	}
+	for (int k = 0; k < 4; ++k)
+	{
+		mColor[k][i] = particle.mColor[k];
+		mStartColor[k][i] = particle.mStartColor[k];
+	}
+	for (int k = 0; k < 2; ++k)
+	{
+		mSize[k][i] = particle.mSize[k];
+		mStartSize[k][i] = particle.mStartSize[k];
+	}
+	mStartTime[i] = particle.mStartTime;
+	mEndTime[i] = particle.mEndTime;
+}
+
+void ParticleArray::Remove(unsigned int i)
+{
+	// Particle order does not matter, so the last particle takes the place
+	// of the removed one instead of shifting the rest of the arrays.
+	const unsigned int last = --mNumParticles;
+	if (i == last)
+		return;
+
+	for (int k = 0; k < 3; ++k)
+	{
+		mPos[k][i] = mPos[k][last];
+		mVector[k][i] = mVector[k][last];
+		mStartVector[k][i] = mStartVector[k][last];
+	}
+	for (int k = 0; k < 4; ++k)
+	{
+		mColor[k][i] = mColor[k][last];
+		mStartColor[k][i] = mStartColor[k][last];
+	}
+	for (int k = 0; k < 2; ++k)
+	{
+		mSize[k][i] = mSize[k][last];
+		mStartSize[k][i] = mStartSize[k][last];
+	}
+	mStartTime[i] = mStartTime[last];
+	mEndTime[i] = mEndTime[last];
+}
+
+Particle ParticleArray::Get(unsigned int i) const
+{
+	Particle particle;
+	for (int k = 0; k < 3; ++k)
+	{
+		particle.mPos[k] = mPos[k][i];
+		particle.mVector[k] = mVector[k][i];
+		particle.mStartVector[k] = mStartVector[k][i];
+	}
+	for (int k = 0; k < 4; ++k)
+	{
+		particle.mColor[k] = mColor[k][i];
+		particle.mStartColor[k] = mStartColor[k][i];
+	}
+	for (int k = 0; k < 2; ++k)
+	{
+		particle.mSize[k] = mSize[k][i];
+		particle.mStartSize[k] = mStartSize[k][i];
+	}
+	particle.mStartTime = mStartTime[i];
+	particle.mEndTime = mEndTime[i];
+	return particle;
+}
@@ -46,5 +46,50 @@ struct GRAPHIC_ITEM Particle
 	Vector2<float> mStartSize;
 };
 
+//! Particles stored as structure of arrays
+/** Every component of the particles lives in its own array so that the
+simulation can run over four particles at once. The capacity is always a
+multiple of four, the lanes past the size are free to be computed and
+ignored. */
+struct GRAPHIC_ITEM ParticleArray
+{
+	ParticleArray();
+
+	//! Amount of particles in the array
+	unsigned int GetSize() const { return mNumParticles; }
+
+	//! Amount of particles the array can hold without growing
+	unsigned int GetCapacity() const { return mCapacity; }
+
+	//! Grows the arrays to hold at least capacity particles
+	void Reserve(unsigned int capacity);
+
+	//! Removes all particles, the capacity is kept
+	void Clear() { mNumParticles = 0; }
+
+	//! Appends a particle. There must be room for it.
+	void Add(const Particle& particle);
+
+	//! Removes a particle by moving the last one in its place
+	void Remove(unsigned int i);
+
+	//! Gathers the components of a particle
+	Particle Get(unsigned int i) const;
+
+	eastl::vector<float> mPos[3];
+	eastl::vector<float> mVector[3];
+	eastl::vector<float> mStartVector[3];
+	eastl::vector<float> mColor[4];
+	eastl::vector<float> mStartColor[4];
+	eastl::vector<float> mSize[2];
+	eastl::vector<float> mStartSize[2];
+	eastl::vector<unsigned int> mStartTime;
+	eastl::vector<unsigned int> mEndTime;
+
+private:
+	unsigned int mNumParticles;
+	unsigned int mCapacity;
+};
+
 #endif
 
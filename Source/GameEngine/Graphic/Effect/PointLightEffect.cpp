@@ -16,13 +16,8 @@ PointLightEffect::PointLightEffect(eastl::shared_ptr<ProgramFactory> const& fact
     LightingEffect(factory, updater, path, material, lighting, geometry)
 {
     mMaterialConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalMaterial), true);
-    UpdateMaterialConstant();
-
     mLightingConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalLighting), true);
-    UpdateLightingConstant();
-
     mGeometryConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalGeometry), true);
-    UpdateGeometryConstant();
 
     if ((select & 1) == 0)
     {
@@ -36,32 +31,34 @@ PointLightEffect::PointLightEffect(eastl::shared_ptr<ProgramFactory> const& fact
         mProgram->GetPShader()->Set("Lighting", mLightingConstant);
         mProgram->GetPShader()->Set("LightCameraGeometry", mGeometryConstant);
     }
+
+    GetMemberHandles();
+    UpdateMaterialConstant();
+    UpdateLightingConstant();
+    UpdateGeometryConstant();
 }
 
 void PointLightEffect::UpdateMaterialConstant()
 {
-    InternalMaterial* internalMaterial = mMaterialConstant->Get<InternalMaterial>();
-    internalMaterial->emissive = mMaterial->mEmissive;
-    internalMaterial->ambient = mMaterial->mAmbient;
-    internalMaterial->diffuse = mMaterial->mDiffuse;
-    internalMaterial->specular = mMaterial->mSpecular;
+    mMaterialConstant->Set(mMaterialEmissive, mMaterial->mEmissive);
+    mMaterialConstant->Set(mMaterialAmbient, mMaterial->mAmbient);
+    mMaterialConstant->Set(mMaterialDiffuse, mMaterial->mDiffuse);
+    mMaterialConstant->Set(mMaterialSpecular, mMaterial->mSpecular);
     LightingEffect::UpdateMaterialConstant();
 }
 
 void PointLightEffect::UpdateLightingConstant()
 {
-    InternalLighting* internalLighting = mLightingConstant->Get<InternalLighting>();
-    internalLighting->ambient = mLighting->mAmbient;
-    internalLighting->diffuse = mLighting->mDiffuse;
-    internalLighting->specular = mLighting->mSpecular;
-    internalLighting->attenuation = mLighting->mAttenuation;
+    mLightingConstant->Set(mLightingAmbient, mLighting->mAmbient);
+    mLightingConstant->Set(mLightingDiffuse, mLighting->mDiffuse);
+    mLightingConstant->Set(mLightingSpecular, mLighting->mSpecular);
+    mLightingConstant->Set(mLightingAttenuation, mLighting->mAttenuation);
     LightingEffect::UpdateLightingConstant();
 }
 
 void PointLightEffect::UpdateGeometryConstant()
 {
-    InternalGeometry* internalGeometry = mGeometryConstant->Get<InternalGeometry>();
-    internalGeometry->lightModelPosition = mGeometry->lightModelPosition;
-    internalGeometry->cameraModelPosition = mGeometry->cameraModelPosition;
+    mGeometryConstant->Set(mLightModelPosition, mGeometry->lightModelPosition);
+    mGeometryConstant->Set(mCameraModelPosition, mGeometry->cameraModelPosition);
     LightingEffect::UpdateGeometryConstant();
 }
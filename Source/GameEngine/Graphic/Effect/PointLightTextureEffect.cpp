@@ -21,17 +21,18 @@ PointLightTextureEffect::PointLightTextureEffect(eastl::shared_ptr<ProgramFactor
     mSampler->mMode[1] = mode1;
 
     mMaterialConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalMaterial), true);
-    UpdateMaterialConstant();
-
     mLightingConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalLighting), true);
-    UpdateLightingConstant();
-
     mGeometryConstant = eastl::make_shared<ConstantBuffer>(sizeof(InternalGeometry), true);
-    UpdateGeometryConstant();
 
     mProgram->GetPShader()->Set("Material", mMaterialConstant);
     mProgram->GetPShader()->Set("Lighting", mLightingConstant);
     mProgram->GetPShader()->Set("LightCameraGeometry", mGeometryConstant);
+
+    GetMemberHandles();
+    UpdateMaterialConstant();
+    UpdateLightingConstant();
+    UpdateGeometryConstant();
+
 #if defined(_OPENGL_)
     mProgram->GetPShader()->Set("baseSampler", mTexture);
 #else
@@ -52,28 +53,25 @@ void PointLightTextureEffect::SetTexture(eastl::shared_ptr<Texture2> const& text
 
 void PointLightTextureEffect::UpdateMaterialConstant()
 {
-    InternalMaterial* internalMaterial = mMaterialConstant->Get<InternalMaterial>();
-    internalMaterial->emissive = mMaterial->mEmissive;
-    internalMaterial->ambient = mMaterial->mAmbient;
-    internalMaterial->diffuse = mMaterial->mDiffuse;
-    internalMaterial->specular = mMaterial->mSpecular;
+    mMaterialConstant->Set(mMaterialEmissive, mMaterial->mEmissive);
+    mMaterialConstant->Set(mMaterialAmbient, mMaterial->mAmbient);
+    mMaterialConstant->Set(mMaterialDiffuse, mMaterial->mDiffuse);
+    mMaterialConstant->Set(mMaterialSpecular, mMaterial->mSpecular);
     LightingEffect::UpdateMaterialConstant();
 }
 
 void PointLightTextureEffect::UpdateLightingConstant()
 {
-    InternalLighting* internalLighting = mLightingConstant->Get<InternalLighting>();
-    internalLighting->ambient = mLighting->mAmbient;
-    internalLighting->diffuse = mLighting->mDiffuse;
-    internalLighting->specular = mLighting->mSpecular;
-    internalLighting->attenuation = mLighting->mAttenuation;
+    mLightingConstant->Set(mLightingAmbient, mLighting->mAmbient);
+    mLightingConstant->Set(mLightingDiffuse, mLighting->mDiffuse);
+    mLightingConstant->Set(mLightingSpecular, mLighting->mSpecular);
+    mLightingConstant->Set(mLightingAttenuation, mLighting->mAttenuation);
     LightingEffect::UpdateLightingConstant();
 }
 
 void PointLightTextureEffect::UpdateGeometryConstant()
 {
-    InternalGeometry* internalGeometry = mGeometryConstant->Get<InternalGeometry>();
-    internalGeometry->lightModelPosition = mGeometry->lightModelPosition;
-    internalGeometry->cameraModelPosition = mGeometry->cameraModelPosition;
+    mGeometryConstant->Set(mLightModelPosition, mGeometry->lightModelPosition);
+    mGeometryConstant->Set(mCameraModelPosition, mGeometry->cameraModelPosition);
     LightingEffect::UpdateGeometryConstant();
 }
\ No newline at end of file
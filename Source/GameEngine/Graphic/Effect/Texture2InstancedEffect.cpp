@@ -0,0 +1,67 @@
+//========================================================================
+// Texture2InstancedEffect.cpp : Texture2Effect drawing many instances of a
+// mesh in one call, each with its own world matrix.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "Texture2InstancedEffect.h"
+
+Texture2InstancedEffect::Texture2InstancedEffect(eastl::shared_ptr<ProgramFactory> const& factory,
+	eastl::vector<eastl::string> path, eastl::shared_ptr<Texture2> const& texture,
+	SamplerState::Filter filter, SamplerState::Mode mode0, SamplerState::Mode mode1,
+	unsigned int maxInstances)
+	:
+	mMaxInstances(eastl::max(maxInstances, 1u)),
+	mTexture(texture)
+{
+	eastl::string vsPath = path[0];
+	eastl::string psPath = path[1];
+	eastl::string gsPath = "";
+	mProgram = factory->CreateFromFiles(vsPath, psPath, gsPath);
+	if (mProgram)
+	{
+		mSampler = eastl::make_shared<SamplerState>();
+		mSampler->mFilter = filter;
+		mSampler->mMode[0] = mode0;
+		mSampler->mMode[1] = mode1;
+
+		mWorldMatrices = eastl::make_shared<StructuredBuffer>(
+			mMaxInstances, sizeof(Matrix4x4<float>));
+		mWorldMatrices->SetUsage(Resource::DYNAMIC_UPDATE);
+
+		mProgram->GetVShader()->Set("PVMatrix", mPVWMatrixConstant);
+		mProgram->GetVShader()->Set("worldMatrices", mWorldMatrices);
+#if defined(_OPENGL_)
+		mProgram->GetPShader()->Set("baseSampler", texture);
+#else
+		mProgram->GetPShader()->Set("baseTexture", texture);
+#endif
+		mProgram->GetPShader()->Set("baseSampler", mSampler);
+	}
+}
+
+void Texture2InstancedEffect::SetTexture(eastl::shared_ptr<Texture2> const& texture)
+{
+	mTexture = texture;
+#if defined(_OPENGL_)
+	mProgram->GetPShader()->Set("baseSampler", mTexture);
+#else
+	mProgram->GetPShader()->Set("baseTexture", mTexture);
+#endif
+}
+
+void Texture2InstancedEffect::SetPVMatrix(Matrix4x4<float> const& pvMatrix)
+{
+	SetPVWMatrix(pvMatrix);
+}
+
+eastl::shared_ptr<StructuredBuffer> const& Texture2InstancedEffect::SetWorldMatrices(
+	Matrix4x4<float> const* worldMatrices, unsigned int numInstances)
+{
+	numInstances = eastl::min(numInstances, mMaxInstances);
+	memcpy(mWorldMatrices->GetData(), worldMatrices, numInstances * sizeof(Matrix4x4<float>));
+	mWorldMatrices->SetNumActiveElements(numInstances);
+	return mWorldMatrices;
+}
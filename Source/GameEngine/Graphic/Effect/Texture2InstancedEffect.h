@@ -0,0 +1,71 @@
+//========================================================================
+// Texture2InstancedEffect.h : Texture2Effect drawing many instances of a
+// mesh in one call, each with its own world matrix.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef TEXTURE2INSTANCEDEFFECT_H
+#define TEXTURE2INSTANCEDEFFECT_H
+
+#include "Mathematic/Algebra/Matrix4x4.h"
+
+#include "Graphic/Resource/Buffer/StructuredBuffer.h"
+#include "Graphic/Resource/Texture/Texture2.h"
+#include "Graphic/Effect/VisualEffect.h"
+
+// The vertex shader reads the world matrix of the instance from the
+// structured buffer "worldMatrices" by the instance id and multiplies it
+// with the projection-view matrix, which replaces the projection-view-world
+// matrix of the other effects. The pixel shader is the Texture2Effect one.
+class GRAPHIC_ITEM Texture2InstancedEffect : public VisualEffect
+{
+public:
+	// Construction.
+	Texture2InstancedEffect(eastl::shared_ptr<ProgramFactory> const& factory,
+		eastl::vector<eastl::string> path, eastl::shared_ptr<Texture2> const& texture,
+		SamplerState::Filter filter, SamplerState::Mode mode0, SamplerState::Mode mode1,
+		unsigned int maxInstances = 256);
+
+	inline eastl::shared_ptr<Texture2> const& GetTexture() const;
+	inline eastl::shared_ptr<SamplerState> const& GetSampler() const;
+	inline unsigned int GetMaxInstances() const;
+
+	void SetTexture(eastl::shared_ptr<Texture2> const& texture);
+
+	// The projection-view matrix shared by the instances.
+	void SetPVMatrix(Matrix4x4<float> const& pvMatrix);
+
+	// Copies the world matrices of the instances to draw, at most
+	// GetMaxInstances(), and returns the buffer to upload.
+	eastl::shared_ptr<StructuredBuffer> const& SetWorldMatrices(
+		Matrix4x4<float> const* worldMatrices, unsigned int numInstances);
+
+private:
+	unsigned int mMaxInstances;
+
+	// Vertex shader parameters.
+	eastl::shared_ptr<StructuredBuffer> mWorldMatrices;
+
+	// Pixel shader parameters.
+	eastl::shared_ptr<Texture2> mTexture;
+	eastl::shared_ptr<SamplerState> mSampler;
+};
+
+inline eastl::shared_ptr<Texture2> const& Texture2InstancedEffect::GetTexture() const
+{
+	return mTexture;
+}
+
+inline eastl::shared_ptr<SamplerState> const& Texture2InstancedEffect::GetSampler() const
+{
+	return mSampler;
+}
+
+inline unsigned int Texture2InstancedEffect::GetMaxInstances() const
+{
+	return mMaxInstances;
+}
+
+#endif
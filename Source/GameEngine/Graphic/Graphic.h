@@ -34,6 +34,7 @@
 #include "Effect/SpotLightTextureEffect.h"
 #include "Effect/Texture2ArrayEffect.h"
 #include "Effect/Texture2Effect.h"
+#include "Effect/Texture2InstancedEffect.h"
 #include "Effect/TextEffect.h"
 #include "Effect/ColorEffect.h"
 #include "Effect/VisualEffect.h"
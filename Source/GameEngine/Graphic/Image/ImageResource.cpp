@@ -37,6 +37,7 @@
 //========================================================================
 
 #include "ImageResource.h"
+#include "TextureCooker.h"
 
 #include "Graphic/3rdParty/stb/stb_image.h"
 
@@ -53,27 +54,53 @@ bool ImageResourceLoader::IsALoadableFileExtension(const eastl::wstring& fileNam
 		return fileExtension.compare(L"bmp") == 0 || fileExtension.compare(L"psd") == 0 ||
 			fileExtension.compare(L"hdr") == 0 || fileExtension.compare(L"jpeg") == 0 || 
 			fileExtension.compare(L"jpg") == 0 || fileExtension.compare(L"pic") == 0 ||
-			fileExtension.compare(L"png") == 0 || fileExtension.compare(L"tga") == 0;
+			fileExtension.compare(L"png") == 0 || fileExtension.compare(L"tga") == 0 ||
+			fileExtension.compare(L"ctex") == 0;
 	}
 	else return false;
 }
 
 bool ImageResourceLoader::LoadResource(
 	void *rawBuffer, unsigned int rawSize, const eastl::shared_ptr<ResHandle>& handle)
+{
+	return PrepareResource(rawBuffer, rawSize, handle) || DecodeResource(rawBuffer, rawSize, handle);
+}
+
+bool ImageResourceLoader::PrepareResource(
+	void *rawBuffer, unsigned int rawSize, const eastl::shared_ptr<ResHandle>& handle)
+{
+	// the cooked texture next to the image skips its decoding and the
+	// generation of its mipmaps, it is read from the cache on this thread
+	if (TextureCooker::IsCookedName(handle->GetName()) || !IsALoadableFileExtension(handle->GetName()))
+		return false;
+
+	eastl::shared_ptr<ImageResourceExtraData> pExtraData(new ImageResourceExtraData());
+	pExtraData->SetImage(LoadCooked(handle->GetName(), (const char*)rawBuffer, rawSize));
+	if (pExtraData->GetImage())
+	{
+		handle->SetExtra(eastl::shared_ptr<ImageResourceExtraData>(pExtraData));
+		return true;
+	}
+
+	return false;
+}
+
+bool ImageResourceLoader::DecodeResource(
+	void *rawBuffer, unsigned int rawSize, const eastl::shared_ptr<ResHandle>& handle)
 {
 	eastl::shared_ptr<ImageResourceExtraData> pExtraData(new ImageResourceExtraData());
 	pExtraData->SetImage(0);
 
 	// try to load file based on file extension
-	BaseReadFile* file = (BaseReadFile*)rawBuffer;
-	if (IsALoadableFileExtension(file->GetFileName()))
+	if (TextureCooker::IsCookedName(handle->GetName()))
+		pExtraData->SetImage(TextureCooker::Load((const char*)rawBuffer, rawSize));
+	else if (IsALoadableFileExtension(handle->GetName()))
+		pExtraData->SetImage(Load((const char*)rawBuffer, rawSize, true));
+
+	if (pExtraData->GetImage())
 	{
-		pExtraData->SetImage(Load(file->GetFileName(), true));
-		if (pExtraData->GetImage())
-		{
-			handle->SetExtra(eastl::shared_ptr<ImageResourceExtraData>(pExtraData));
-			return true;
-		}
+		handle->SetExtra(eastl::shared_ptr<ImageResourceExtraData>(pExtraData));
+		return true;
 	}
 
 	return false;
@@ -85,12 +112,31 @@ eastl::shared_ptr<BaseResourceLoader> CreateImageResourceLoader()
     return eastl::shared_ptr<BaseResourceLoader>(new ImageResourceLoader());
 }
 
-eastl::shared_ptr<Texture2> ImageResourceLoader::Load(eastl::wstring const& fileName, bool wantMipMaps)
+eastl::shared_ptr<Texture2> ImageResourceLoader::LoadCooked(
+	eastl::wstring const& imageName, const char* image, unsigned int imageSize)
+{
+	BaseResource resource(TextureCooker::GetCookedName(imageName));
+	if (!ResCache::Get()->ExistResource(&resource))
+		return nullptr;
+
+	void* rawBuffer = nullptr;
+	ResCache::Get()->GetResource(&resource, &rawBuffer);
+	BaseReadFile* file = (BaseReadFile*)rawBuffer;
+	if (file == nullptr)
+		return nullptr;
+
+	// a cooked texture of another version of the image is left aside
+	eastl::shared_ptr<Texture2> texture = TextureCooker::Load(file, image, imageSize);
+	delete file;
+	return texture;
+}
+
+eastl::shared_ptr<Texture2> ImageResourceLoader::Load(const char* image, unsigned int imageSize, bool wantMipMaps)
 {
 	int width, height, components;
 
-	unsigned char *imageData = stbi_load(
-		ToString(fileName.c_str()).c_str(), &width, &height, &components, STBI_rgb_alpha);
+	unsigned char *imageData = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(image),
+		imageSize, &width, &height, &components, STBI_rgb_alpha);
 	if (imageData == nullptr)
 	{
 		LogError("load texture failed.");
@@ -106,18 +152,16 @@ eastl::shared_ptr<Texture2> ImageResourceLoader::Load(eastl::wstring const& file
 	// R8G8B8A8 format with texels converted from the source format.
 	DFType gtformat = DF_R8G8B8A8_UNORM;
 
-    // Create the 2D texture and compute the stride and image size.
+    // Create the 2D texture and compute the stride and texel bytes.
     eastl::shared_ptr<Texture2> texture =
         eastl::make_shared<Texture2>(gtformat, width, height, wantMipMaps);
 
     UINT const stride = width * texture->GetElementSize();
-    UINT const imageSize = stride * height;
+    UINT const numTexelBytes = stride * height;
 
     // Copy the pixels from the decoder to the texture.
-    std::memcpy(texture->Get<BYTE>(), imageData, imageSize);
+    std::memcpy(texture->Get<BYTE>(), imageData, numTexelBytes);
     stbi_image_free(imageData);
 
     return texture;
-
-	return texture;
 }
\ No newline at end of file
@@ -61,10 +61,17 @@ protected:
 class ImageResourceLoader : public BaseResourceLoader
 {
 public:
-    virtual bool UseRawFile() { return false; }
-	virtual bool DiscardRawBufferAfterLoad() { return false; }
-    virtual unsigned int GetLoadedResourceSize(void *rawBuffer, unsigned int rawSize) { return rawSize; }
+    virtual bool UseRawFile() { return true; }
+	virtual bool DiscardRawBufferAfterLoad() { return true; }
+	// The images are decoded from the raw buffer to textures which hold their
+	// own storage, the handle doesn't keep any buffer.
+    virtual unsigned int GetLoadedResourceSize(void *rawBuffer, unsigned int rawSize) { return 0; }
     virtual bool LoadResource(void *rawBuffer, unsigned int rawSize, const eastl::shared_ptr<ResHandle>& handle);
+
+	// The images are decoded on the job system when they are preloaded.
+	virtual bool CanDecodeInParallel() { return true; }
+	virtual bool PrepareResource(void *rawBuffer, unsigned int rawSize, const eastl::shared_ptr<ResHandle>& handle);
+	virtual bool DecodeResource(void *rawBuffer, unsigned int rawSize, const eastl::shared_ptr<ResHandle>& handle);
 	virtual bool MatchResourceFormat(eastl::wstring name) { return IsALoadableFileExtension(name.c_str()); }
 
 protected:
@@ -75,7 +82,12 @@ protected:
 	// The returned texture has a format that matches as close as possible
 	// the format on disk.  If the load is not successful, the function
 	// returns a null object.
-	eastl::shared_ptr<Texture2> Load(eastl::wstring const& filename, bool wantMipmaps);
+	eastl::shared_ptr<Texture2> Load(const char* image, unsigned int imageSize, bool wantMipmaps);
+
+	// Loads the cooked texture of an image if it was cooked from the same
+	// image, otherwise returns a null object.
+	eastl::shared_ptr<Texture2> LoadCooked(
+		eastl::wstring const& imageName, const char* image, unsigned int imageSize);
 
 };
 
@@ -0,0 +1,220 @@
+//========================================================================
+// MipGenerator.cpp : Computes the mipmap levels of a texture on the CPU.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "MipGenerator.h"
+
+#include "Core/Logger/Logger.h"
+
+#include "Mathematic/Function/Constants.h"
+
+#include <emmintrin.h>
+
+namespace
+{
+	const float KaiserAlpha = 4.f;
+	const float KaiserRadius = 1.5f;	// in target texels
+
+	// modified Bessel function of the first kind of order 0
+	float BesselI0(float x)
+	{
+		float sum = 1.f, term = 1.f;
+		const float halfX = x * 0.5f;
+		for (int k = 1; k < 32 && term > sum * 1e-8f; ++k)
+		{
+			const float factor = halfX / k;
+			term *= factor * factor;
+			sum += term;
+		}
+		return sum;
+	}
+
+	inline __m128 LoadTexel(const unsigned char* texel)
+	{
+		int bits;
+		memcpy(&bits, texel, sizeof(bits));
+		const __m128i zero = _mm_setzero_si128();
+		__m128i value = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bits), zero);
+		return _mm_cvtepi32_ps(_mm_unpacklo_epi16(value, zero));
+	}
+
+	inline void StoreTexel(unsigned char* texel, __m128 value)
+	{
+		// rounded to nearest, the lobes of the sinc saturate to [0, 255]
+		__m128i bits = _mm_cvtps_epi32(value);
+		bits = _mm_packs_epi32(bits, bits);
+		bits = _mm_packus_epi16(bits, bits);
+		int texelBits = _mm_cvtsi128_si32(bits);
+		memcpy(texel, &texelBits, sizeof(texelBits));
+	}
+
+	inline int ClampTexel(int texel, unsigned int size)
+	{
+		return texel < 0 ? 0 : (texel >= (int)size ? (int)size - 1 : texel);
+	}
+}
+
+void MipGenerator::GetKaiserWeights(float weights[KaiserTaps])
+{
+	float total = 0.f;
+	for (int k = 0; k < KaiserTaps; ++k)
+	{
+		// distance of the source texel center to the target texel
+		// center, in target texels: -1.25, -0.75, ..., 1.25
+		const float t = ((float)k - KaiserTaps / 2 + 0.5f) * 0.5f;
+		const float x = (float)GE_C_PI * t;
+		const float sinc = t != 0.f ? sin(x) / x : 1.f;
+		const float r = t / KaiserRadius;
+		const float window = BesselI0(KaiserAlpha * sqrt(1.f - r * r)) / BesselI0(KaiserAlpha);
+		weights[k] = sinc * window;
+		total += weights[k];
+	}
+
+	for (int k = 0; k < KaiserTaps; ++k)
+		weights[k] /= total;
+}
+
+bool MipGenerator::Generate(Texture2& texture, Filter filter)
+{
+	if (!texture.HasMipmaps() || texture.GetFormat() != DF_R8G8B8A8_UNORM || !texture.GetData())
+	{
+		LogError("The mipmaps are generated for RGBA8 textures with mipmaps.");
+		return false;
+	}
+
+	for (unsigned int level = 1; level < texture.GetNumLevels(); ++level)
+	{
+		const unsigned char* source = reinterpret_cast<const unsigned char*>(
+			texture.GetDataFor(level - 1));
+		unsigned char* target = reinterpret_cast<unsigned char*>(
+			texture.GetDataFor(level));
+		const unsigned int sourceWidth = texture.GetDimensionFor(level - 1, 0);
+		const unsigned int sourceHeight = texture.GetDimensionFor(level - 1, 1);
+		const unsigned int targetWidth = texture.GetDimensionFor(level, 0);
+		const unsigned int targetHeight = texture.GetDimensionFor(level, 1);
+
+		if (filter == MF_KAISER)
+			DownsampleKaiser(source, sourceWidth, sourceHeight, target, targetWidth, targetHeight);
+		else
+			DownsampleBox(source, sourceWidth, sourceHeight, target, targetWidth, targetHeight);
+	}
+	return true;
+}
+
+void MipGenerator::DownsampleBox(const unsigned char* source,
+	unsigned int sourceWidth, unsigned int sourceHeight,
+	unsigned char* target, unsigned int targetWidth, unsigned int targetHeight)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rounding = _mm_set1_epi16(2);
+
+	for (unsigned int y = 0; y < targetHeight; ++y)
+	{
+		// a source of one texel is averaged with itself, the last row or
+		// column of an odd size is dropped
+		const unsigned char* row0 = source + 4 * sourceWidth * (2 * y);
+		const unsigned char* row1 = sourceHeight > 1 ? row0 + 4 * sourceWidth : row0;
+		unsigned char* targetRow = target + 4 * targetWidth * y;
+
+		unsigned int x = 0;
+		if (sourceWidth > 1)
+		{
+			// 2 target texels from 4 texels of each source row
+			for (; x + 2 <= targetWidth; x += 2)
+			{
+				__m128i texels0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8 * x));
+				__m128i texels1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8 * x));
+				__m128i low = _mm_add_epi16(
+					_mm_unpacklo_epi8(texels0, zero), _mm_unpacklo_epi8(texels1, zero));
+				__m128i high = _mm_add_epi16(
+					_mm_unpackhi_epi8(texels0, zero), _mm_unpackhi_epi8(texels1, zero));
+				low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+				high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+
+				__m128i sum = _mm_unpacklo_epi64(low, high);
+				sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(targetRow + 4 * x),
+					_mm_packus_epi16(sum, sum));
+			}
+		}
+
+		for (; x < targetWidth; ++x)
+		{
+			const unsigned int x0 = 2 * x;
+			const unsigned int x1 = sourceWidth > 1 ? x0 + 1 : x0;
+			for (unsigned int c = 0; c < 4; ++c)
+			{
+				targetRow[4 * x + c] = (unsigned char)((
+					row0[4 * x0 + c] + row0[4 * x1 + c] +
+					row1[4 * x0 + c] + row1[4 * x1 + c] + 2) >> 2);
+			}
+		}
+	}
+}
+
+void MipGenerator::DownsampleKaiser(const unsigned char* source,
+	unsigned int sourceWidth, unsigned int sourceHeight,
+	unsigned char* target, unsigned int targetWidth, unsigned int targetHeight)
+{
+	float weights[KaiserTaps];
+	GetKaiserWeights(weights);
+
+	__m128 tapWeights[KaiserTaps];
+	for (int k = 0; k < KaiserTaps; ++k)
+		tapWeights[k] = _mm_set1_ps(weights[k]);
+
+	// Horizontal pass on every source row, the texels are kept in floats
+	// for the vertical pass.
+	eastl::vector<float> rows(4 * targetWidth * sourceHeight);
+	for (unsigned int y = 0; y < sourceHeight; ++y)
+	{
+		const unsigned char* sourceRow = source + 4 * sourceWidth * y;
+		float* row = rows.data() + 4 * targetWidth * y;
+		for (unsigned int x = 0; x < targetWidth; ++x)
+		{
+			__m128 sum;
+			if (sourceWidth == targetWidth)
+			{
+				sum = LoadTexel(sourceRow + 4 * x);
+			}
+			else
+			{
+				sum = _mm_setzero_ps();
+				for (int k = 0; k < KaiserTaps; ++k)
+				{
+					int sx = ClampTexel(2 * (int)x - KaiserTaps / 2 + 1 + k, sourceWidth);
+					sum = _mm_add_ps(sum, _mm_mul_ps(tapWeights[k], LoadTexel(sourceRow + 4 * sx)));
+				}
+			}
+			_mm_storeu_ps(row + 4 * x, sum);
+		}
+	}
+
+	// Vertical pass.
+	for (unsigned int y = 0; y < targetHeight; ++y)
+	{
+		unsigned char* targetRow = target + 4 * targetWidth * y;
+		for (unsigned int x = 0; x < targetWidth; ++x)
+		{
+			__m128 sum;
+			if (sourceHeight == targetHeight)
+			{
+				sum = _mm_loadu_ps(rows.data() + 4 * (targetWidth * y + x));
+			}
+			else
+			{
+				sum = _mm_setzero_ps();
+				for (int k = 0; k < KaiserTaps; ++k)
+				{
+					int sy = ClampTexel(2 * (int)y - KaiserTaps / 2 + 1 + k, sourceHeight);
+					sum = _mm_add_ps(sum, _mm_mul_ps(tapWeights[k],
+						_mm_loadu_ps(rows.data() + 4 * (targetWidth * sy + x))));
+				}
+			}
+			StoreTexel(targetRow + 4 * x, sum);
+		}
+	}
+}
@@ -0,0 +1,47 @@
+//========================================================================
+// MipGenerator.h : Computes the mipmap levels of a texture on the CPU.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef MIPGENERATOR_H
+#define MIPGENERATOR_H
+
+#include "Graphic/Resource/Texture/Texture2.h"
+
+// Each level is reduced from the previous one by half in each dimension, a
+// dimension of one texel stays as it is. The box filter averages the 2x2
+// texels of the previous level, the Kaiser filter weights the 6x6 texels
+// around them with a Kaiser windowed sinc, which keeps the small details of
+// the textures sharper. Both run with SSE2 on RGBA8 textures and give the
+// same result on any machine.
+class MipGenerator
+{
+public:
+	enum Filter
+	{
+		MF_BOX,
+		MF_KAISER
+	};
+
+	// Fills the levels 1 and up of the texture from its level 0. The texture
+	// must have mipmaps and the DF_R8G8B8A8_UNORM format.
+	static bool Generate(Texture2& texture, Filter filter);
+
+	// Reduces an RGBA8 image, the destination being half the source size.
+	static void DownsampleBox(const unsigned char* source,
+		unsigned int sourceWidth, unsigned int sourceHeight,
+		unsigned char* target, unsigned int targetWidth, unsigned int targetHeight);
+	static void DownsampleKaiser(const unsigned char* source,
+		unsigned int sourceWidth, unsigned int sourceHeight,
+		unsigned char* target, unsigned int targetWidth, unsigned int targetHeight);
+
+	// The Kaiser filter weights the source texels around the 2 which are
+	// averaged by the box filter, at the same distances for every target
+	// texel since the size is always halved. The weights sum to one.
+	static const int KaiserTaps = 6;
+	static void GetKaiserWeights(float weights[KaiserTaps]);
+};
+
+#endif
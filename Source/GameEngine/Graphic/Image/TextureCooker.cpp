@@ -0,0 +1,341 @@
+//========================================================================
+// TextureCooker.cpp : Converts images to cooked textures which hold all
+// their mipmap levels and load without decoding.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "TextureCooker.h"
+
+#include "Core/Logger/Logger.h"
+#include "Core/IO/FileSystem.h"
+#include "Core/IO/ResourceCache.h"
+#include "Core/OS/OS.h"
+#include "Core/Utility/StringUtil.h"
+
+#include "Graphic/3rdParty/stb/stb_image.h"
+
+#include <fstream>
+
+namespace
+{
+	const unsigned int CookedMagic = 0x58455443; // "CTEX"
+	const unsigned int CookedVersion = 2;
+
+	struct CookedHeader
+	{
+		unsigned int mMagic;
+		unsigned int mVersion;
+		uint64_t mSourceHash;
+		unsigned int mFormat;
+		unsigned int mWidth;
+		unsigned int mHeight;
+		unsigned int mNumLevels;
+		unsigned int mNumBytes;
+		unsigned int mReserved;
+	};
+
+	// FNV-1a hash of the image the texture is cooked from
+	uint64_t HashSource(const char* source, unsigned int sourceSize)
+	{
+		uint64_t hash = 14695981039346656037ULL;
+		for (unsigned int i = 0; i < sourceSize; ++i)
+		{
+			hash ^= (unsigned char)source[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	bool IsValidHeader(const CookedHeader& header)
+	{
+		if (header.mMagic != CookedMagic || header.mVersion != CookedVersion)
+		{
+			LogError("Invalid cooked texture.");
+			return false;
+		}
+		return true;
+	}
+
+	// Creates the texture the header describes, null if the header doesn't
+	// match the texture layout or was cooked from another image.
+	eastl::shared_ptr<Texture2> CreateTexture(const CookedHeader& header,
+		const char* source, unsigned int sourceSize)
+	{
+		if (source != nullptr && header.mSourceHash != HashSource(source, sourceSize))
+		{
+			LogInformation("Outdated cooked texture.");
+			return nullptr;
+		}
+
+		DFType format = (DFType)header.mFormat;
+		if (format >= DF_NUM_FORMATS || DataFormat::GetNumBytesPerStruct(format) == 0 ||
+			header.mWidth == 0 || header.mHeight == 0 || header.mNumLevels == 0)
+		{
+			LogError("Unsupported cooked texture format.");
+			return nullptr;
+		}
+
+		// the first level alone can't hold more than all the levels
+		if ((uint64_t)header.mWidth * header.mHeight * DataFormat::GetNumBytesPerStruct(format) > header.mNumBytes)
+		{
+			LogError("Invalid cooked texture levels.");
+			return nullptr;
+		}
+
+		eastl::shared_ptr<Texture2> texture = eastl::make_shared<Texture2>(
+			format, header.mWidth, header.mHeight, header.mNumLevels > 1);
+		if (texture->GetNumLevels() != header.mNumLevels ||
+			texture->GetNumBytes() != header.mNumBytes)
+		{
+			LogError("Invalid cooked texture levels.");
+			return nullptr;
+		}
+
+		if (texture->HasMipmaps())
+			texture->SetPrecomputedMipmaps();
+		return texture;
+	}
+
+	bool ReadImage(const eastl::wstring& name, eastl::vector<char>& image)
+	{
+		BaseReadFile* file = FileSystem::Get()->CreateReadFile(
+			ToWideString(FileSystem::Get()->GetPath(ToString(name.c_str())).c_str()));
+		if (file == nullptr)
+			return false;
+
+		image.resize(file->GetSize());
+		bool read = image.empty() || file->Read(image.data(), (unsigned int)image.size()) == (int)image.size();
+		delete file;
+		return read;
+	}
+
+	bool IsImageName(const eastl::wstring& fileName)
+	{
+		size_t dot = fileName.rfind('.');
+		if (dot == eastl::wstring::npos)
+			return false;
+
+		eastl::wstring extension = fileName.substr(dot + 1);
+		return extension == L"bmp" || extension == L"psd" || extension == L"hdr" ||
+			extension == L"jpeg" || extension == L"jpg" || extension == L"pic" ||
+			extension == L"png" || extension == L"tga";
+	}
+}
+
+bool TextureCooker::Cook(const char* image, unsigned int imageSize,
+	MipGenerator::Filter filter, eastl::vector<char>& cooked)
+{
+	int width, height, components;
+	unsigned char* imageData = stbi_load_from_memory(
+		reinterpret_cast<const stbi_uc*>(image), imageSize, &width, &height, &components, STBI_rgb_alpha);
+	if (imageData == nullptr)
+	{
+		LogError("cook texture failed.");
+		return false;
+	}
+
+	Texture2 texture(DF_R8G8B8A8_UNORM, width, height, true);
+	std::memcpy(texture.GetData(), imageData, width * height * texture.GetElementSize());
+	stbi_image_free(imageData);
+
+	MipGenerator::Generate(texture, filter);
+
+	CookedHeader header;
+	std::memset(&header, 0, sizeof(header));
+	header.mMagic = CookedMagic;
+	header.mVersion = CookedVersion;
+	header.mSourceHash = HashSource(image, imageSize);
+	header.mFormat = texture.GetFormat();
+	header.mWidth = texture.GetWidth();
+	header.mHeight = texture.GetHeight();
+	header.mNumLevels = texture.GetNumLevels();
+	header.mNumBytes = texture.GetNumBytes();
+
+	cooked.resize(sizeof(header) + header.mNumBytes);
+	std::memcpy(cooked.data(), &header, sizeof(header));
+	std::memcpy(cooked.data() + sizeof(header), texture.GetData(), header.mNumBytes);
+	return true;
+}
+
+unsigned int TextureCooker::CookResources(const eastl::wstring& pattern, MipGenerator::Filter filter)
+{
+	unsigned int numCooked = 0;
+	eastl::vector<eastl::wstring> names = ResCache::Get()->Match(pattern);
+	for (auto const& name : names)
+	{
+		if (!IsImageName(name))
+			continue;
+
+		eastl::vector<char> image, cooked;
+		if (!ReadImage(name, image) || !Cook(image.data(), (unsigned int)image.size(), filter, cooked))
+		{
+			LogWarning(L"Couldn't cook texture " + name);
+			continue;
+		}
+
+		eastl::string cookedFile = FileSystem::Get()->GetPath(ToString(name.c_str()));
+		cookedFile = cookedFile.substr(0, cookedFile.rfind('.')) + ".ctex";
+		std::ofstream file(cookedFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (file.is_open())
+			file.write(cooked.data(), cooked.size());
+		if (!file.good())
+		{
+			LogWarning("Couldn't write cooked texture " + cookedFile);
+			continue;
+		}
+		numCooked++;
+	}
+
+	LogInformation("Cooked " + eastl::to_string(numCooked) + " textures of " +
+		eastl::to_string(names.size()) + " files");
+	return numCooked;
+}
+
+eastl::shared_ptr<Texture2> TextureCooker::Load(BaseReadFile* file,
+	const char* source, unsigned int sourceSize)
+{
+	CookedHeader header;
+	if (file->Read(&header, sizeof(header)) != sizeof(header))
+	{
+		LogError("Invalid cooked texture.");
+		return nullptr;
+	}
+	if (!IsValidHeader(header))
+		return nullptr;
+
+	// a corrupted header mustn't allocate a texture bigger than the file
+	if ((unsigned int)file->GetSize() - sizeof(header) < header.mNumBytes)
+	{
+		LogError("Truncated cooked texture.");
+		return nullptr;
+	}
+
+	// the levels are read straight into the texture storage
+	eastl::shared_ptr<Texture2> texture = CreateTexture(header, source, sourceSize);
+	if (!texture)
+		return nullptr;
+
+	if (file->Read(texture->GetData(), header.mNumBytes) != (int)header.mNumBytes)
+	{
+		LogError("Truncated cooked texture.");
+		return nullptr;
+	}
+	return texture;
+}
+
+eastl::shared_ptr<Texture2> TextureCooker::Load(const char* cooked, unsigned int cookedSize,
+	const char* source, unsigned int sourceSize)
+{
+	CookedHeader header;
+	if (cookedSize < sizeof(header))
+	{
+		LogError("Invalid cooked texture.");
+		return nullptr;
+	}
+	std::memcpy(&header, cooked, sizeof(header));
+	if (!IsValidHeader(header))
+		return nullptr;
+
+	// a corrupted header mustn't allocate a texture bigger than the file
+	if (cookedSize - sizeof(header) < header.mNumBytes)
+	{
+		LogError("Truncated cooked texture.");
+		return nullptr;
+	}
+
+	eastl::shared_ptr<Texture2> texture = CreateTexture(header, source, sourceSize);
+	if (!texture)
+		return nullptr;
+
+	std::memcpy(texture->GetData(), cooked + sizeof(header), header.mNumBytes);
+	return texture;
+}
+
+eastl::wstring TextureCooker::GetCookedName(const eastl::wstring& imageName)
+{
+	return imageName.substr(0, imageName.rfind('.')) + L".ctex";
+}
+
+bool TextureCooker::IsCookedName(const eastl::wstring& fileName)
+{
+	size_t dot = fileName.rfind('.');
+	return dot != eastl::wstring::npos && fileName.substr(dot + 1) == L"ctex";
+}
+
+void TextureCooker::Benchmark(const eastl::wstring& pattern, MipGenerator::Filter filter)
+{
+	// The files are read and cooked beforehand, only the decoding and the
+	// copy to the textures are timed.
+	eastl::vector<eastl::vector<char>> images, cookedImages;
+	for (auto const& name : ResCache::Get()->Match(pattern))
+	{
+		eastl::vector<char> image, cooked;
+		if (IsImageName(name) && ReadImage(name, image) &&
+			Cook(image.data(), (unsigned int)image.size(), filter, cooked))
+		{
+			images.push_back(eastl::move(image));
+			cookedImages.push_back(eastl::move(cooked));
+		}
+	}
+
+	if (images.empty())
+	{
+		LogWarning(L"No texture to benchmark in " + pattern);
+		return;
+	}
+
+	size_t numTexels = 0;
+	unsigned int startTime = Timer::GetRealTime();
+	for (auto const& image : images)
+	{
+		int width, height, components;
+		unsigned char* imageData = stbi_load_from_memory(
+			reinterpret_cast<const stbi_uc*>(image.data()), (int)image.size(),
+			&width, &height, &components, STBI_rgb_alpha);
+		if (imageData == nullptr)
+			continue;
+
+		Texture2 texture(DF_R8G8B8A8_UNORM, width, height, true);
+		std::memcpy(texture.GetData(), imageData, width * height * texture.GetElementSize());
+		stbi_image_free(imageData);
+		numTexels += width * height;
+	}
+	const unsigned int decodeTime = Timer::GetRealTime() - startTime;
+
+	startTime = Timer::GetRealTime();
+	for (auto const& image : images)
+	{
+		int width, height, components;
+		unsigned char* imageData = stbi_load_from_memory(
+			reinterpret_cast<const stbi_uc*>(image.data()), (int)image.size(),
+			&width, &height, &components, STBI_rgb_alpha);
+		if (imageData == nullptr)
+			continue;
+
+		Texture2 texture(DF_R8G8B8A8_UNORM, width, height, true);
+		std::memcpy(texture.GetData(), imageData, width * height * texture.GetElementSize());
+		stbi_image_free(imageData);
+		MipGenerator::Generate(texture, filter);
+	}
+	const unsigned int mipmapTime = Timer::GetRealTime() - startTime;
+
+	size_t numCookedBytes = 0;
+	startTime = Timer::GetRealTime();
+	for (auto const& cooked : cookedImages)
+	{
+		eastl::shared_ptr<Texture2> texture = Load(cooked.data(), (unsigned int)cooked.size());
+		if (texture)
+			numCookedBytes += texture->GetNumBytes();
+	}
+	const unsigned int cookedTime = Timer::GetRealTime() - startTime;
+
+	LogInformation("Texture loading of " + eastl::to_string(images.size()) + " textures, " +
+		eastl::to_string((unsigned int)(numTexels / 1024)) + " K texels");
+	LogInformation("  stb decoding: " + eastl::to_string(decodeTime) + " ms");
+	LogInformation("  stb decoding and " + eastl::string(filter == MipGenerator::MF_KAISER ? "kaiser" : "box") +
+		" mipmaps: " + eastl::to_string(mipmapTime) + " ms");
+	LogInformation("  cooked textures: " + eastl::to_string(cookedTime) + " ms for " +
+		eastl::to_string((unsigned int)(numCookedBytes / 1024)) + " KB with all levels");
+}
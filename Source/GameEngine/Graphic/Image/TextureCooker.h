@@ -0,0 +1,51 @@
+//========================================================================
+// TextureCooker.h : Converts images to cooked textures which hold all
+// their mipmap levels and load without decoding.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef TEXTURECOOKER_H
+#define TEXTURECOOKER_H
+
+#include "Graphic/Image/MipGenerator.h"
+
+#include "Core/IO/BaseReadFile.h"
+
+// A cooked texture file (.ctex) is a header followed by the texels of every
+// level, laid out as the storage of a Texture2 with mipmaps, so that it is
+// loaded with a single read into the texture. The header records the format,
+// which leaves room for block compressed formats, but the engine textures
+// only hold formats of whole texels and the images are cooked to RGBA8. It
+// also records a hash of the image the texture was cooked from: a cooked
+// file next to an image is only used instead of it while the image is the
+// same.
+class TextureCooker
+{
+public:
+	// Decodes an image file in memory and computes its mipmaps.
+	static bool Cook(const char* image, unsigned int imageSize,
+		MipGenerator::Filter filter, eastl::vector<char>& cooked);
+
+	// Cooks every image of the resource cache matching the pattern, each
+	// cooked file written next to its image. Returns the number of textures.
+	static unsigned int CookResources(const eastl::wstring& pattern, MipGenerator::Filter filter);
+
+	// Without a source image, the texture is loaded whatever image it was
+	// cooked from.
+	static eastl::shared_ptr<Texture2> Load(BaseReadFile* file,
+		const char* source = nullptr, unsigned int sourceSize = 0);
+	static eastl::shared_ptr<Texture2> Load(const char* cooked, unsigned int cookedSize,
+		const char* source = nullptr, unsigned int sourceSize = 0);
+
+	// The name of the cooked file of an image.
+	static eastl::wstring GetCookedName(const eastl::wstring& imageName);
+	static bool IsCookedName(const eastl::wstring& fileName);
+
+	// Loads the images of the resource cache matching the pattern with stb
+	// and from their cooked textures, and logs the times of both.
+	static void Benchmark(const eastl::wstring& pattern, MipGenerator::Filter filter);
+};
+
+#endif
@@ -0,0 +1,157 @@
+//========================================================================
+// CommandList.cpp : Renderer calls recorded on any thread and submitted
+// later to the renderer.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "CommandList.h"
+
+#include "Core/Logger/Logger.h"
+
+CommandList::CommandList()
+{
+}
+
+void CommandList::Clear()
+{
+	mCommands.clear();
+	mStates.clear();
+	mUploads.clear();
+	mBytes.clear();
+	mTextureUploads.clear();
+	mUnbinds.clear();
+	mDraws.clear();
+}
+
+void CommandList::Add(CommandType type, unsigned int index,
+	int arg0, int arg1, int arg2, int arg3)
+{
+	Command command;
+	command.mType = type;
+	command.mIndex = index;
+	command.mArgs[0] = arg0;
+	command.mArgs[1] = arg1;
+	command.mArgs[2] = arg2;
+	command.mArgs[3] = arg3;
+	mCommands.push_back(command);
+}
+
+void CommandList::SetBlendState(eastl::shared_ptr<BlendState> const& state)
+{
+	Add(CT_BLEND_STATE, (unsigned int)mStates.size());
+	mStates.push_back(state);
+}
+
+void CommandList::SetDepthStencilState(eastl::shared_ptr<DepthStencilState> const& state)
+{
+	Add(CT_DEPTH_STENCIL_STATE, (unsigned int)mStates.size());
+	mStates.push_back(state);
+}
+
+void CommandList::SetRasterizerState(eastl::shared_ptr<RasterizerState> const& state)
+{
+	Add(CT_RASTERIZER_STATE, (unsigned int)mStates.size());
+	mStates.push_back(state);
+}
+
+void CommandList::SetViewport(int x, int y, int w, int h)
+{
+	Add(CT_VIEWPORT, 0, x, y, w, h);
+}
+
+void CommandList::SetDepthRange(float zmin, float zmax)
+{
+	int bits[2];
+	memcpy(&bits[0], &zmin, sizeof(float));
+	memcpy(&bits[1], &zmax, sizeof(float));
+	Add(CT_DEPTH_RANGE, 0, bits[0], bits[1]);
+}
+
+void CommandList::Clear(unsigned int clearFlags)
+{
+	Add(CT_CLEAR, 0, (int)clearFlags);
+}
+
+void CommandList::Update(eastl::shared_ptr<Buffer> const& buffer)
+{
+	if (!buffer->GetData())
+	{
+		LogWarning("Buffer does not have system memory, creating it.");
+		buffer->CreateStorage();
+	}
+
+	// The constant buffers are copied whole, the other buffers up to the
+	// end of their active range. The dirty range is taken over by the list,
+	// as the renderer would upload and clear it.
+	Upload upload;
+	upload.mBuffer = buffer;
+	upload.mOffset = (unsigned int)mBytes.size();
+	upload.mNumBytes = buffer->GetNumBytes();
+	upload.mDirtyOffset = 0;
+	upload.mNumDirtyBytes = 0;
+	if (buffer->GetType() == GE_CONSTANT_BUFFER)
+	{
+		ConstantBuffer* cbuffer = static_cast<ConstantBuffer*>(buffer.get());
+		if (cbuffer->HasDirtyRange())
+		{
+			upload.mDirtyOffset = cbuffer->GetDirtyOffset();
+			upload.mNumDirtyBytes = cbuffer->GetNumDirtyBytes();
+		}
+		cbuffer->ClearDirtyRange();
+	}
+	else
+	{
+		upload.mNumBytes = eastl::min(upload.mNumBytes,
+			(buffer->GetOffset() + buffer->GetNumActiveElements()) * buffer->GetElementSize());
+	}
+
+	mBytes.insert(mBytes.end(), buffer->GetData(), buffer->GetData() + upload.mNumBytes);
+	Add(CT_UPDATE_BUFFER, (unsigned int)mUploads.size());
+	mUploads.push_back(upload);
+}
+
+void CommandList::Update(eastl::shared_ptr<TextureSingle> const& texture, unsigned int level)
+{
+	TextureUpload upload;
+	upload.mTexture = texture;
+	upload.mItem = AllSubresources;
+	upload.mLevel = level;
+	Add(CT_UPDATE_TEXTURE, (unsigned int)mTextureUploads.size());
+	mTextureUploads.push_back(upload);
+}
+
+void CommandList::Update(eastl::shared_ptr<TextureArray> const& textureArray,
+	unsigned int item, unsigned int level)
+{
+	TextureUpload upload;
+	upload.mTexture = textureArray;
+	upload.mItem = item;
+	upload.mLevel = level;
+	Add(CT_UPDATE_TEXTURE, (unsigned int)mTextureUploads.size());
+	mTextureUploads.push_back(upload);
+}
+
+void CommandList::Unbind(GraphicObject const* object)
+{
+	Add(CT_UNBIND, (unsigned int)mUnbinds.size());
+	mUnbinds.push_back(object);
+}
+
+void CommandList::Draw(eastl::shared_ptr<VertexBuffer> const& vbuffer,
+	eastl::shared_ptr<IndexBuffer> const& ibuffer,
+	eastl::shared_ptr<VisualEffect> const& effect, unsigned int numInstances)
+{
+	DrawCall draw;
+	draw.mVBuffer = vbuffer;
+	draw.mIBuffer = ibuffer;
+	draw.mEffect = effect;
+	draw.mNumInstances = numInstances;
+	draw.mVertexOffset = vbuffer->GetOffset();
+	draw.mNumVertices = vbuffer->GetNumActiveElements();
+	draw.mFirstPrimitive = ibuffer->GetFirstPrimitive();
+	draw.mNumPrimitives = ibuffer->GetNumActivePrimitives();
+	Add(CT_DRAW, (unsigned int)mDraws.size());
+	mDraws.push_back(draw);
+}
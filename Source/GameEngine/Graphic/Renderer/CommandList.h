@@ -0,0 +1,142 @@
+//========================================================================
+// CommandList.h : Renderer calls recorded on any thread and submitted
+// later to the renderer.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef COMMANDLIST_H
+#define COMMANDLIST_H
+
+#include "Graphic/Graphic.h"
+
+// A command list holds the state changes, uploads and draws of a part of a
+// frame, in the order they were made. Recording a command never calls the
+// graphics API, so that lists are recorded by several threads at once and
+// submitted in order by the thread which owns the renderer (Renderer::Submit).
+// The uploads keep a copy of the data they upload, which the buffer holds
+// only while it is uploaded at submission: it may change again before, and
+// keeps its live data after.
+// The draws keep the active range of their vertex and index buffers for the
+// same reason. The textures are uploaded with their data at submission.
+class GRAPHIC_ITEM CommandList
+{
+public:
+	enum CommandType
+	{
+		CT_BLEND_STATE,			// state
+		CT_DEPTH_STENCIL_STATE,	// state
+		CT_RASTERIZER_STATE,	// state
+		CT_VIEWPORT,			// x, y, width, height
+		CT_DEPTH_RANGE,			// bits of zmin, bits of zmax
+		CT_CLEAR,				// clear flags
+		CT_UPDATE_BUFFER,		// upload
+		CT_UPDATE_TEXTURE,		// texture upload
+		CT_UNBIND,				// object
+		CT_DRAW,				// draw
+		CT_COUNT
+	};
+
+	enum ClearFlag
+	{
+		CF_COLOR = 1,
+		CF_DEPTH = 2,
+		CF_STENCIL = 4
+	};
+
+	// Items and levels of a texture upload standing for all of them.
+	static unsigned int const AllSubresources = 0xFFFFFFFFu;
+
+	CommandList();
+
+	// Forgets the commands, the memory is kept for the next recording.
+	void Clear();
+
+	void SetBlendState(eastl::shared_ptr<BlendState> const& state);
+	void SetDepthStencilState(eastl::shared_ptr<DepthStencilState> const& state);
+	void SetRasterizerState(eastl::shared_ptr<RasterizerState> const& state);
+	void SetViewport(int x, int y, int w, int h);
+	void SetDepthRange(float zmin, float zmax);
+	void Clear(unsigned int clearFlags);
+
+	void Update(eastl::shared_ptr<Buffer> const& buffer);
+	void Update(eastl::shared_ptr<TextureSingle> const& texture,
+		unsigned int level = AllSubresources);
+	void Update(eastl::shared_ptr<TextureArray> const& textureArray,
+		unsigned int item = AllSubresources, unsigned int level = AllSubresources);
+	void Unbind(GraphicObject const* object);
+
+	// A number of instances of zero is a draw without instancing.
+	void Draw(eastl::shared_ptr<VertexBuffer> const& vbuffer,
+		eastl::shared_ptr<IndexBuffer> const& ibuffer,
+		eastl::shared_ptr<VisualEffect> const& effect, unsigned int numInstances);
+
+	inline unsigned int GetNumCommands() const;
+	inline unsigned int GetNumDraws() const;
+	inline unsigned int GetNumBytes() const;
+
+private:
+	friend class Renderer;
+
+	struct Command
+	{
+		CommandType mType;
+		unsigned int mIndex;
+		int mArgs[4];
+	};
+
+	struct Upload
+	{
+		eastl::shared_ptr<Buffer> mBuffer;
+		unsigned int mOffset;
+		unsigned int mNumBytes;
+		unsigned int mDirtyOffset;
+		unsigned int mNumDirtyBytes;
+	};
+
+	struct TextureUpload
+	{
+		eastl::shared_ptr<Texture> mTexture;
+		unsigned int mItem;
+		unsigned int mLevel;
+	};
+
+	struct DrawCall
+	{
+		eastl::shared_ptr<VertexBuffer> mVBuffer;
+		eastl::shared_ptr<IndexBuffer> mIBuffer;
+		eastl::shared_ptr<VisualEffect> mEffect;
+		unsigned int mNumInstances;
+		unsigned int mVertexOffset, mNumVertices;
+		unsigned int mFirstPrimitive, mNumPrimitives;
+	};
+
+	void Add(CommandType type, unsigned int index,
+		int arg0 = 0, int arg1 = 0, int arg2 = 0, int arg3 = 0);
+
+	eastl::vector<Command> mCommands;
+	eastl::vector<eastl::shared_ptr<DrawingState>> mStates;
+	eastl::vector<Upload> mUploads;
+	eastl::vector<char> mBytes;
+	eastl::vector<TextureUpload> mTextureUploads;
+	eastl::vector<GraphicObject const*> mUnbinds;
+	eastl::vector<DrawCall> mDraws;
+};
+
+inline unsigned int CommandList::GetNumCommands() const
+{
+	return (unsigned int)mCommands.size();
+}
+
+inline unsigned int CommandList::GetNumDraws() const
+{
+	return (unsigned int)mDraws.size();
+}
+
+inline unsigned int CommandList::GetNumBytes() const
+{
+	return (unsigned int)mBytes.size();
+}
+
+#endif
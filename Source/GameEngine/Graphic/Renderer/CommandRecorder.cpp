@@ -0,0 +1,237 @@
+//========================================================================
+// CommandRecorder.cpp : Stands in for the renderer on a thread and records
+// its calls in a command list.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "CommandRecorder.h"
+
+#include "Core/Logger/Logger.h"
+
+CommandRecorder::CommandRecorder()
+	:
+	Renderer(false),
+	mViewportX(0), mViewportY(0), mViewportWidth(0), mViewportHeight(0),
+	mDepthRangeMin(0.f), mDepthRangeMax(1.f)
+{
+}
+
+CommandRecorder::~CommandRecorder()
+{
+}
+
+void CommandRecorder::Reset(Renderer* renderer)
+{
+	mCommandList.Clear();
+
+	mScreenSize = renderer->GetScreenSize();
+	mClearColor = renderer->GetClearColor();
+	mClearDepth = renderer->GetClearDepth();
+	mClearStencil = renderer->GetClearStencil();
+	renderer->GetViewport(mViewportX, mViewportY, mViewportWidth, mViewportHeight);
+	renderer->GetDepthRange(mDepthRangeMin, mDepthRangeMax);
+
+	mDefaultFont = renderer->GetDefaultFont();
+	mActiveFont = renderer->GetFont();
+	mDefaultBlendState = renderer->GetDefaultBlendState();
+	mDefaultDepthStencilState = renderer->GetDefaultDepthStencilState();
+	mDefaultRasterizerState = renderer->GetDefaultRasterizerState();
+
+	// The list starts with the states it was recorded with, whatever the
+	// lists submitted before it left.
+	mActiveBlendState = renderer->GetBlendState();
+	mActiveDepthStencilState = renderer->GetDepthStencilState();
+	mActiveRasterizerState = renderer->GetRasterizerState();
+	if (mActiveBlendState)
+		mCommandList.SetBlendState(mActiveBlendState);
+	if (mActiveDepthStencilState)
+		mCommandList.SetDepthStencilState(mActiveDepthStencilState);
+	if (mActiveRasterizerState)
+		mCommandList.SetRasterizerState(mActiveRasterizerState);
+}
+
+void CommandRecorder::Begin()
+{
+	SetThreadRenderer(this);
+}
+
+void CommandRecorder::End()
+{
+	SetThreadRenderer(nullptr);
+}
+
+void CommandRecorder::Enable(eastl::shared_ptr<DrawTarget> const&)
+{
+	LogError("Draw targets can't be recorded.");
+}
+
+void CommandRecorder::Disable(eastl::shared_ptr<DrawTarget> const&)
+{
+	LogError("Draw targets can't be recorded.");
+}
+
+void CommandRecorder::SetViewport(int x, int y, int w, int h)
+{
+	mViewportX = x;
+	mViewportY = y;
+	mViewportWidth = w;
+	mViewportHeight = h;
+	mCommandList.SetViewport(x, y, w, h);
+}
+
+void CommandRecorder::GetViewport(int& x, int& y, int& w, int& h) const
+{
+	x = mViewportX;
+	y = mViewportY;
+	w = mViewportWidth;
+	h = mViewportHeight;
+}
+
+void CommandRecorder::SetDepthRange(float zmin, float zmax)
+{
+	mDepthRangeMin = zmin;
+	mDepthRangeMax = zmax;
+	mCommandList.SetDepthRange(zmin, zmax);
+}
+
+void CommandRecorder::GetDepthRange(float& zmin, float& zmax) const
+{
+	zmin = mDepthRangeMin;
+	zmax = mDepthRangeMax;
+}
+
+bool CommandRecorder::Resize(unsigned int, unsigned int)
+{
+	LogError("The renderer can't be resized while recording.");
+	return false;
+}
+
+void CommandRecorder::ClearColorBuffer()
+{
+	mCommandList.Clear(CommandList::CF_COLOR);
+}
+
+void CommandRecorder::ClearDepthBuffer()
+{
+	mCommandList.Clear(CommandList::CF_DEPTH);
+}
+
+void CommandRecorder::ClearStencilBuffer()
+{
+	mCommandList.Clear(CommandList::CF_STENCIL);
+}
+
+void CommandRecorder::ClearBuffers()
+{
+	mCommandList.Clear(CommandList::CF_COLOR | CommandList::CF_DEPTH | CommandList::CF_STENCIL);
+}
+
+void CommandRecorder::DisplayColorBuffer(unsigned int)
+{
+	LogError("The color buffer can't be displayed while recording.");
+}
+
+void CommandRecorder::SetBlendState(eastl::shared_ptr<BlendState> const& state)
+{
+	if (state)
+	{
+		if (state != mActiveBlendState)
+		{
+			mCommandList.SetBlendState(state);
+			mActiveBlendState = state;
+		}
+	}
+	else
+	{
+		LogError("Input state is null.");
+	}
+}
+
+void CommandRecorder::SetDepthStencilState(eastl::shared_ptr<DepthStencilState> const& state)
+{
+	if (state)
+	{
+		if (state != mActiveDepthStencilState)
+		{
+			mCommandList.SetDepthStencilState(state);
+			mActiveDepthStencilState = state;
+		}
+	}
+	else
+	{
+		LogError("Input state is null.");
+	}
+}
+
+void CommandRecorder::SetRasterizerState(eastl::shared_ptr<RasterizerState> const& state)
+{
+	if (state)
+	{
+		if (state != mActiveRasterizerState)
+		{
+			mCommandList.SetRasterizerState(state);
+			mActiveRasterizerState = state;
+		}
+	}
+	else
+	{
+		LogError("Input state is null.");
+	}
+}
+
+bool CommandRecorder::Update(eastl::shared_ptr<Buffer> const& buffer)
+{
+	mCommandList.Update(buffer);
+	return true;
+}
+
+bool CommandRecorder::Update(eastl::shared_ptr<TextureSingle> const& texture)
+{
+	mCommandList.Update(texture);
+	return true;
+}
+
+bool CommandRecorder::Update(eastl::shared_ptr<TextureSingle> const& texture, unsigned int level)
+{
+	mCommandList.Update(texture, level);
+	return true;
+}
+
+bool CommandRecorder::Update(eastl::shared_ptr<TextureArray> const& textureArray)
+{
+	mCommandList.Update(textureArray);
+	return true;
+}
+
+bool CommandRecorder::Update(eastl::shared_ptr<TextureArray> const& textureArray, unsigned int item, unsigned int level)
+{
+	mCommandList.Update(textureArray, item, level);
+	return true;
+}
+
+uint64_t CommandRecorder::DrawPrimitive(
+	eastl::shared_ptr<VertexBuffer> const& vbuffer,
+	eastl::shared_ptr<IndexBuffer> const& ibuffer,
+	eastl::shared_ptr<VisualEffect> const& effect)
+{
+	mCommandList.Draw(vbuffer, ibuffer, effect, 0);
+	return 0;
+}
+
+uint64_t CommandRecorder::DrawInstancedPrimitive(
+	eastl::shared_ptr<VertexBuffer> const& vbuffer,
+	eastl::shared_ptr<IndexBuffer> const& ibuffer,
+	eastl::shared_ptr<VisualEffect> const& effect,
+	unsigned int numInstances)
+{
+	mCommandList.Draw(vbuffer, ibuffer, effect, numInstances);
+	return 0;
+}
+
+bool CommandRecorder::Unbind(GraphicObject const* object)
+{
+	mCommandList.Unbind(object);
+	return true;
+}
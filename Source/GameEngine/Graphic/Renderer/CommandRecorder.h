@@ -0,0 +1,89 @@
+//========================================================================
+// CommandRecorder.h : Stands in for the renderer on a thread and records
+// its calls in a command list.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef COMMANDRECORDER_H
+#define COMMANDRECORDER_H
+
+#include "Graphic/Renderer/Renderer.h"
+#include "Graphic/Renderer/CommandList.h"
+
+// Between Begin and End, Renderer::Get returns the recorder on the calling
+// thread, so the scene nodes record their calls without knowing it. The
+// recorder never calls the graphics API and has no bridge objects: draws,
+// uploads, state changes and unbinds go to its command list. Reset takes
+// the viewport, the fonts and the global states of the renderer, and must
+// run on the thread which owns the renderer, as must the submission of the
+// list. The calls which can't be deferred (draw targets, resizing and
+// presenting) are rejected.
+class GRAPHIC_ITEM CommandRecorder : public Renderer
+{
+public:
+	CommandRecorder();
+	~CommandRecorder();
+
+	// Clears the list and starts it with the global states of the renderer.
+	void Reset(Renderer* renderer);
+
+	void Begin();
+	void End();
+
+	inline CommandList const& GetCommandList() const;
+
+	// Overrides from Renderer.
+	virtual void Enable(eastl::shared_ptr<DrawTarget> const& target) override;
+	virtual void Disable(eastl::shared_ptr<DrawTarget> const& target) override;
+
+	virtual void SetViewport(int x, int y, int w, int h) override;
+	virtual void GetViewport(int& x, int& y, int& w, int& h) const override;
+	virtual void SetDepthRange(float zmin, float zmax) override;
+	virtual void GetDepthRange(float& zmin, float& zmax) const override;
+	virtual bool Resize(unsigned int w, unsigned int h) override;
+
+	virtual void ClearColorBuffer() override;
+	virtual void ClearDepthBuffer() override;
+	virtual void ClearStencilBuffer() override;
+	virtual void ClearBuffers() override;
+	virtual void DisplayColorBuffer(unsigned int syncInterval) override;
+
+	virtual void SetBlendState(eastl::shared_ptr<BlendState> const& state) override;
+	virtual void SetDepthStencilState(eastl::shared_ptr<DepthStencilState> const& state) override;
+	virtual void SetRasterizerState(eastl::shared_ptr<RasterizerState> const& state) override;
+
+	virtual bool Update(eastl::shared_ptr<Buffer> const& buffer) override;
+	virtual bool Update(eastl::shared_ptr<TextureSingle> const& texture) override;
+	virtual bool Update(eastl::shared_ptr<TextureSingle> const& texture, unsigned int level) override;
+	virtual bool Update(eastl::shared_ptr<TextureArray> const& textureArray) override;
+	virtual bool Update(eastl::shared_ptr<TextureArray> const& textureArray, unsigned int item, unsigned int level) override;
+
+protected:
+	virtual uint64_t DrawPrimitive(
+		eastl::shared_ptr<VertexBuffer> const& vbuffer,
+		eastl::shared_ptr<IndexBuffer> const& ibuffer,
+		eastl::shared_ptr<VisualEffect> const& effect) override;
+
+	virtual uint64_t DrawInstancedPrimitive(
+		eastl::shared_ptr<VertexBuffer> const& vbuffer,
+		eastl::shared_ptr<IndexBuffer> const& ibuffer,
+		eastl::shared_ptr<VisualEffect> const& effect,
+		unsigned int numInstances) override;
+
+	virtual bool Unbind(GraphicObject const* object) override;
+
+private:
+	CommandList mCommandList;
+
+	int mViewportX, mViewportY, mViewportWidth, mViewportHeight;
+	float mDepthRangeMin, mDepthRangeMax;
+};
+
+inline CommandList const& CommandRecorder::GetCommandList() const
+{
+	return mCommandList;
+}
+
+#endif
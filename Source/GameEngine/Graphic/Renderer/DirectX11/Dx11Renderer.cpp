@@ -13,6 +13,7 @@
 #include "Resource/Buffer/DX11ConstantBuffer.h"
 #include "Resource/Buffer/DX11IndexBuffer.h"
 #include "Resource/Buffer/DX11RawBuffer.h"
+#include "Resource/Buffer/DX11StreamBuffer.h"
 #include "Resource/Buffer/DX11StructuredBuffer.h"
 #include "Resource/Buffer/DX11TextureBuffer.h"
 #include "Resource/Buffer/DX11VertexBuffer.h"
@@ -140,7 +141,7 @@ Dx11Renderer::~Dx11Renderer()
 			LogWarning("Bridge map is nonempty on destruction.");
 		}
 
-		mGraphicObjects.RemoveAll();
+		RemoveAllGraphicObjects();
 	}
 
 	if (mDrawTargets.HasElements())
@@ -583,6 +584,12 @@ bool Dx11Renderer::CreateBackBuffer(UINT xSize, UINT ySize)
 void Dx11Renderer::CreateDefaultObjects()
 {
 	CreateDefaultGlobalState();
+
+	mStreamBuffer = eastl::make_unique<DX11StreamBuffer>(mDevice, StreamBufferSize);
+	if (!mStreamBuffer->IsValid())
+	{
+		mStreamBuffer = nullptr;
+	}
 }
 
 void Dx11Renderer::DestroyDefaultObjects()
@@ -594,6 +601,8 @@ void Dx11Renderer::DestroyDefaultObjects()
 	}
 
 	DestroyDefaultGlobalState();
+
+	mStreamBuffer = nullptr;
 }
 
 bool Dx11Renderer::DestroyDevice()
@@ -638,7 +647,8 @@ bool Dx11Renderer::DestroyBackBuffer()
 		&& FinalRelease(mDepthStencilBuffer) == 0;
 }
 
-uint64_t Dx11Renderer::DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer const* ibuffer)
+uint64_t Dx11Renderer::DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer const* ibuffer,
+	unsigned int numInstances)
 {
 	UINT numActiveVertices = vbuffer->GetNumActiveElements();
 	UINT vertexOffset = vbuffer->GetOffset();
@@ -689,14 +699,29 @@ uint64_t Dx11Renderer::DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer co
 	{
 		if (numActiveIndices > 0)
 		{
-			mDeviceContext->DrawIndexed(numActiveIndices, firstIndex, vertexOffset);
+			if (numInstances > 1)
+			{
+				mDeviceContext->DrawIndexedInstanced(
+					numActiveIndices, numInstances, firstIndex, vertexOffset, 0);
+			}
+			else
+			{
+				mDeviceContext->DrawIndexed(numActiveIndices, firstIndex, vertexOffset);
+			}
 		}
 	}
 	else
 	{
 		if (numActiveVertices > 0)
 		{
-			mDeviceContext->Draw(numActiveVertices, vertexOffset);
+			if (numInstances > 1)
+			{
+				mDeviceContext->DrawInstanced(numActiveVertices, numInstances, vertexOffset, 0);
+			}
+			else
+			{
+				mDeviceContext->Draw(numActiveVertices, vertexOffset);
+			}
 		}
 	}
 
@@ -1079,9 +1104,42 @@ bool Dx11Renderer::Update(eastl::shared_ptr<Buffer> const& buffer)
 	}
 
 	DX11Buffer* dxBuffer = static_cast<DX11Buffer*>(Bind(buffer));
+	if (mStreamBuffer && buffer->GetUsage() == Resource::DYNAMIC_UPDATE &&
+		(buffer->GetType() == GE_VERTEX_BUFFER || buffer->GetType() == GE_INDEX_BUFFER))
+	{
+		if (StreamBuffer(dxBuffer))
+		{
+			return true;
+		}
+	}
+
+	// The whole buffer is copied, the data written to the stream buffer
+	// included.
+	dxBuffer->SetStreamSlice(StreamRing::Slice(), nullptr);
 	return dxBuffer->Update(mDeviceContext);
 }
 
+bool Dx11Renderer::StreamBuffer(DX11Buffer* dxBuffer)
+{
+	// The slice holds the data from the start of the buffer, so that the
+	// offsets of the draw calls keep their meaning.
+	Buffer* buffer = dxBuffer->GetBuffer();
+	UINT numBytes = (buffer->GetOffset() + buffer->GetNumActiveElements()) * buffer->GetElementSize();
+	if (numBytes == 0)
+	{
+		return false;
+	}
+
+	StreamRing::Slice slice = mStreamBuffer->Write(mDeviceContext, buffer->GetData(), numBytes, 16);
+	if (slice.mOffset == StreamRing::Invalid)
+	{
+		return false;
+	}
+
+	dxBuffer->SetStreamSlice(slice, mStreamBuffer->GetDXBuffer());
+	return true;
+}
+
 bool Dx11Renderer::Update(eastl::shared_ptr<TextureSingle> const& texture)
 {
 	if (!texture->GetData())
@@ -1136,6 +1194,13 @@ bool Dx11Renderer::Update(eastl::shared_ptr<TextureArray> const& textureArray,
 
 uint64_t Dx11Renderer::DrawPrimitive(eastl::shared_ptr<VertexBuffer> const& vbuffer,
 	eastl::shared_ptr<IndexBuffer> const& ibuffer, eastl::shared_ptr<VisualEffect> const& effect)
+{
+	return DrawInstancedPrimitive(vbuffer, ibuffer, effect, 1);
+}
+
+uint64_t Dx11Renderer::DrawInstancedPrimitive(eastl::shared_ptr<VertexBuffer> const& vbuffer,
+	eastl::shared_ptr<IndexBuffer> const& ibuffer, eastl::shared_ptr<VisualEffect> const& effect,
+	unsigned int numInstances)
 {
 	uint64_t numPixelsDrawn = 0;
 	DX11VertexShader* dxVShader;
@@ -1149,6 +1214,13 @@ uint64_t Dx11Renderer::DrawPrimitive(eastl::shared_ptr<VertexBuffer> const& vbuf
 		if (vbuffer->StandardUsage())
 		{
 			dxVBuffer = static_cast<DX11VertexBuffer*>(Bind(vbuffer));
+			if (dxVBuffer->GetStreamSlice().mOffset != StreamRing::Invalid &&
+				!mStreamBuffer->GetRing().IsCurrent(dxVBuffer->GetStreamSlice()))
+			{
+				// The stream buffer has started over since the slice was written.
+				Update(vbuffer);
+			}
+
 			DX11InputLayoutManager* manager = static_cast<DX11InputLayoutManager*>(mInputLayouts.get());
 			dxLayout = manager->Bind(mDevice, vbuffer.get(), effect->GetVertexShader().get());
 			dxVBuffer->Enable(mDeviceContext);
@@ -1164,10 +1236,15 @@ uint64_t Dx11Renderer::DrawPrimitive(eastl::shared_ptr<VertexBuffer> const& vbuf
 		if (ibuffer->IsIndexed())
 		{
 			dxIBuffer = static_cast<DX11IndexBuffer*>(Bind(ibuffer));
+			if (dxIBuffer->GetStreamSlice().mOffset != StreamRing::Invalid &&
+				!mStreamBuffer->GetRing().IsCurrent(dxIBuffer->GetStreamSlice()))
+			{
+				Update(ibuffer);
+			}
 			dxIBuffer->Enable(mDeviceContext);
 		}
 
-		numPixelsDrawn = DrawPrimitive(vbuffer.get(), ibuffer.get());
+		numPixelsDrawn = DrawPrimitive(vbuffer.get(), ibuffer.get(), numInstances);
 
 		// Disable the vertex buffer and input layout.
 		if (vbuffer->StandardUsage())
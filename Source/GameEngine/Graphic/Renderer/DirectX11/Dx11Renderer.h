@@ -12,7 +12,9 @@
 #include "Graphic/GraphicStd.h"
 #include "Graphic/Graphic.h"
 
+class DX11Buffer;
 class DX11InputLayoutManager;
+class DX11StreamBuffer;
 class DX11GeometryShader;
 class DX11PixelShader;
 class DX11Shader;
@@ -102,7 +104,8 @@ public:
 	virtual void DisplayColorBuffer(unsigned int syncInterval) override;
 
 	// Support for drawing.
-	uint64_t DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer const* ibuffer);
+	uint64_t DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer const* ibuffer,
+		unsigned int numInstances = 1);
 
 	// Support for enabling and disabling resources used by shaders.
 	bool EnableShaders(eastl::shared_ptr<VisualEffect> const& effect,
@@ -158,6 +161,12 @@ protected:
 		eastl::shared_ptr<IndexBuffer> const& ibuffer,
 		eastl::shared_ptr<VisualEffect> const& effect) override;
 
+	virtual uint64_t DrawInstancedPrimitive(
+		eastl::shared_ptr<VertexBuffer> const& vbuffer,
+		eastl::shared_ptr<IndexBuffer> const& ibuffer,
+		eastl::shared_ptr<VisualEffect> const& effect,
+		unsigned int numInstances) override;
+
 private:
 	// Helpers for construction and destruction.
 	void Initialize(D3D_DRIVER_TYPE driverType,
@@ -172,6 +181,10 @@ private:
 	bool DestroySwapChain();
 	bool DestroyBackBuffer();
 
+	// Support for streaming the dynamic vertex and index buffers.  It
+	// returns false when the buffer has to be updated directly.
+	bool StreamBuffer(DX11Buffer* dxBuffer);
+
 	// Inputs to the constructors.
 	D3D_DRIVER_TYPE mDriverType;
 	HMODULE mSoftwareModule;
@@ -205,6 +218,14 @@ private:
 	D3D11_VIEWPORT mSaveViewport;
 	eastl::array<ID3D11RenderTargetView*, D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT> mSaveRT;
 	ID3D11DepthStencilView* mSaveDS;
+
+	// The dynamic vertex and index buffers are written to slices of the
+	// stream buffer, bound in place of the buffers.  A slice is written
+	// again when the stream buffer has started over since.  The constant
+	// buffers keep their own buffer: binding a range of a constant buffer
+	// requires D3D11.1.
+	static unsigned int const StreamBufferSize = 8 * 1024 * 1024;
+	eastl::unique_ptr<DX11StreamBuffer> mStreamBuffer;
 };
 
 #endif
@@ -43,6 +43,11 @@ int HLSLProgramFactory::GetAPI() const
     return PF_HLSL;
 }
 
+eastl::string HLSLProgramFactory::GetBackendVersion() const
+{
+    return "D3DCompiler " + eastl::to_string(D3D_COMPILER_VERSION);
+}
+
 eastl::shared_ptr<VisualProgram> HLSLProgramFactory::CreateFromByteCode(
 	eastl::vector<unsigned char> const& vsBytecode,
 	eastl::vector<unsigned char> const& psBytecode,
@@ -33,6 +33,9 @@ public:
     // corresponding to shader programs.
     virtual int GetAPI() const;
 
+    // The version of the shader compiler.
+    virtual eastl::string GetBackendVersion() const;
+
     // Create a program for GPU display.
 	eastl::shared_ptr<VisualProgram> CreateFromByteCode(
 		eastl::vector<unsigned char> const& vsBytecode,
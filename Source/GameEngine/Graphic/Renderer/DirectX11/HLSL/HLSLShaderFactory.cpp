@@ -11,9 +11,14 @@
 #include "Core/IO/FileSystem.h"
 #include "Core/IO/ResourceCache.h"
 
+#include "Graphic/Shader/ProgramCache.h"
+#include "Graphic/Shader/ProgramFactory.h"
+
 #include "HLSLShaderFactory.h"
 #include "HLSLShaderResource.h"
 
+#include <fstream>
+#include <sstream>
 #include <string>
 
 HLSLShader HLSLShaderFactory::CreateFromFile(eastl::string const& name, 
@@ -31,12 +36,30 @@ HLSLShader HLSLShaderFactory::CreateFromFile(eastl::string const& name,
 			eastl::static_pointer_cast<HLSLShaderResourceExtraData>(resHandle->GetExtra());
 		if (!extra->GetShader().IsValid())
 		{
-			ID3DBlob* compiledCode = CompileShader(
-				FileSystem::Get()->GetPath(filepath), entry, target, compileFlags, defines);
+			eastl::string path = FileSystem::Get()->GetPath(filepath);
+			uint64_t key = 0;
+			ID3DBlob* compiledCode = nullptr;
+			if (ProgramCache::Get())
+			{
+				std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+				std::stringstream source;
+				source << file.rdbuf();
+				key = GetShaderKey(path, source.str().c_str(), entry, target, compileFlags, defines);
+				if (key)
+					compiledCode = FindByteCode(key);
+			}
+
 			if (!compiledCode)
 			{
-				// Errors are recorded to a logfile by CompileShader.
-				return HLSLShader();
+				compiledCode = CompileShader(path, entry, target, compileFlags, defines);
+				if (!compiledCode)
+				{
+					// Errors are recorded to a logfile by CompileShader.
+					return HLSLShader();
+				}
+
+				if (key)
+					StoreByteCode(key, compiledCode);
 			}
 
 			HLSLShader shader;
@@ -44,6 +67,8 @@ HLSLShader HLSLShaderFactory::CreateFromFile(eastl::string const& name,
 			{
 				// Errors are recorded to a logfile by ReflectShader.
 				shader = HLSLShader();
+				if (key)
+					ProgramCache::Get()->Remove(key);
 			}
 			compiledCode->Release();
 
@@ -67,12 +92,26 @@ HLSLShader HLSLShaderFactory::CreateFromString(eastl::string const& name,
 	eastl::string type = target.substr(0, 3);
 	if (type == "vs_" || type == "gs_" || type == "ps_" || type == "cs_")
 	{
-		ID3DBlob* compiledCode = CompileShader(
-			name, source, entry, target, compileFlags, defines);
+		uint64_t key = 0;
+		ID3DBlob* compiledCode = nullptr;
+		if (ProgramCache::Get())
+		{
+			key = GetShaderKey(name, source, entry, target, compileFlags, defines);
+			if (key)
+				compiledCode = FindByteCode(key);
+		}
+
 		if (!compiledCode)
 		{
-			// Errors are recorded to a logfile by CompileShader.
-			return HLSLShader();
+			compiledCode = CompileShader(name, source, entry, target, compileFlags, defines);
+			if (!compiledCode)
+			{
+				// Errors are recorded to a logfile by CompileShader.
+				return HLSLShader();
+			}
+
+			if (key)
+				StoreByteCode(key, compiledCode);
 		}
 
 		HLSLShader shader;
@@ -80,6 +119,8 @@ HLSLShader HLSLShaderFactory::CreateFromString(eastl::string const& name,
 		{
 			// Errors are recorded to a logfile by ReflectShader.
 			shader = HLSLShader();
+			if (key)
+				ProgramCache::Get()->Remove(key);
 		}
 		compiledCode->Release();
 		return shader;
@@ -645,3 +686,87 @@ bool HLSLShaderFactory::IsTextureArray(D3D_SRV_DIMENSION dim)
         || dim == D3D_SRV_DIMENSION_TEXTURECUBEARRAY;
 }
 
+
+uint64_t HLSLShaderFactory::GetShaderKey(eastl::string const& name,
+	eastl::string const& source, eastl::string const& entry,
+	eastl::string const& target, unsigned int compileFlags,
+	ProgramDefines const& defines)
+{
+	// The source is preprocessed with the defines CompileShader passes, so
+	// that the files it includes are part of the key.
+	auto const& definitions = defines.Get();
+	eastl::vector<D3D_SHADER_MACRO> localDefinitions(definitions.size() + 2);
+	localDefinitions.front().Name = "GE_USE_MAT_VEC";
+#if defined(GE_USE_MAT_VEC)
+	localDefinitions.front().Definition = "1";
+#else
+	localDefinitions.front().Definition = "0";
+#endif
+	for (size_t i = 0; i < definitions.size(); ++i)
+	{
+		localDefinitions[i + 1].Name = definitions[i].first.c_str();
+		localDefinitions[i + 1].Definition = definitions[i].second.c_str();
+	}
+	localDefinitions.back().Name = nullptr;
+	localDefinitions.back().Definition = nullptr;
+
+	ID3DBlob* preprocessed = nullptr;
+	ID3DBlob* errors = nullptr;
+	HRESULT hr = D3DPreprocess(source.c_str(), source.length(), name.c_str(),
+		localDefinitions.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE, &preprocessed, &errors);
+	if (errors)
+	{
+		errors->Release();
+	}
+	if (FAILED(hr))
+	{
+		// The shader isn't cached, CompileShader reports the errors.
+		return 0;
+	}
+
+	// The conventions CompileShader adds to the defines and the flags.
+	unsigned int conventions = 0;
+#if defined(GE_USE_MAT_VEC)
+	conventions |= 1;
+#endif
+#if defined(GE_USE_ROW_MAJOR)
+	conventions |= 2;
+#endif
+
+	uint64_t key = ProgramCache::KeyBasis;
+	key = ProgramCache::HashKey(key, static_cast<unsigned int>(ProgramFactory::PF_HLSL));
+	key = ProgramCache::HashKey(key, conventions);
+	key = ProgramCache::HashKey(key, entry);
+	key = ProgramCache::HashKey(key, target);
+	key = ProgramCache::HashKey(key, compileFlags);
+	key = ProgramCache::HashKey(key, defines);
+	key = ProgramCache::HashKey(key,
+		preprocessed->GetBufferPointer(), preprocessed->GetBufferSize());
+	preprocessed->Release();
+	return key;
+}
+
+ID3DBlob* HLSLShaderFactory::FindByteCode(uint64_t key)
+{
+	ProgramCache::Program bytecode;
+	if (!ProgramCache::Get()->Find(key, bytecode) || bytecode.empty())
+		return nullptr;
+
+	ID3DBlob* compiledCode = nullptr;
+	HRESULT hr = D3DCreateBlob(bytecode.size(), &compiledCode);
+	if (FAILED(hr))
+	{
+		LogError("FindByteCode failed to create blob.");
+		return nullptr;
+	}
+
+	std::memcpy(compiledCode->GetBufferPointer(), bytecode.data(), bytecode.size());
+	return compiledCode;
+}
+
+void HLSLShaderFactory::StoreByteCode(uint64_t key, ID3DBlob* compiledCode)
+{
+	ProgramCache::Get()->Store(key,
+		static_cast<char const*>(compiledCode->GetBufferPointer()),
+		compiledCode->GetBufferSize());
+}
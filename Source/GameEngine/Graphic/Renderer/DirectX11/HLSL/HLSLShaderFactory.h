@@ -81,6 +81,23 @@ private:
         unsigned int numMembers, HLSLShaderType& stype);
 
     static bool IsTextureArray(D3D_SRV_DIMENSION dim);
+
+	// Support for the program cache.  The bytecode of each shader is cached
+	// by the hash of its preprocessed source, which takes in the files it
+	// includes, and of its entry, target, flags and defines.  The key is 0
+	// when the source can't be preprocessed, and the shader isn't cached.
+	// The reflection is made again from the bytecode, which doesn't need the
+	// compiler.
+	static uint64_t GetShaderKey(
+		eastl::string const& name,
+		eastl::string const& source,
+		eastl::string const& entry,
+		eastl::string const& target,
+		unsigned int compileFlags,
+		ProgramDefines const& defines);
+
+	static ID3DBlob* FindByteCode(uint64_t key);
+	static void StoreByteCode(uint64_t key, ID3DBlob* compiledCode);
 };
 
 #endif
\ No newline at end of file
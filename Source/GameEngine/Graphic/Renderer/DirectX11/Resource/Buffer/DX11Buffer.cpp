@@ -12,7 +12,8 @@
 DX11Buffer::DX11Buffer(Buffer const* buffer)
     :
     DX11Resource(buffer),
-    mUpdateMapMode(D3D11_MAP_WRITE_DISCARD)
+    mUpdateMapMode(D3D11_MAP_WRITE_DISCARD),
+    mStreamBuffer(nullptr)
 {
 }
 
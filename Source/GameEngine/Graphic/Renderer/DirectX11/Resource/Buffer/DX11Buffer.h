@@ -9,6 +9,7 @@
 #define DX11BUFFER_H
 
 #include "Graphic/Resource/Buffer/Buffer.h"
+#include "Graphic/Renderer/StreamRing.h"
 #include "Graphic/Renderer/DirectX11/Resource/DX11Resource.h"
 
 class GRAPHIC_ITEM DX11Buffer : public DX11Resource
@@ -32,6 +33,12 @@ public:
     // subresource.  The second function copies all subresources.
     virtual void CopyGpuToGpu(ID3D11DeviceContext* context, ID3D11Resource* target) override;
 
+    // The slice of the renderer stream buffer holding the data of a dynamic
+    // vertex or index buffer.  The slice is bound instead of the buffer,
+    // whose data is out of date while the slice is valid.
+    inline void SetStreamSlice(StreamRing::Slice const& slice, ID3D11Buffer* streamBuffer);
+    inline StreamRing::Slice const& GetStreamSlice() const;
+
 private:
     // Buffers use only subresource 0, so these overrides are stubbed out.
     virtual bool Update(ID3D11DeviceContext* context, unsigned int sri) override;
@@ -62,6 +69,9 @@ protected:
     // when the feature level is found to be D3D_FEATURE_LEVEL_11_1 or
     // later.
     D3D11_MAP mUpdateMapMode;
+
+    StreamRing::Slice mStreamSlice;
+    ID3D11Buffer* mStreamBuffer;
 };
 
 inline Buffer* DX11Buffer::GetBuffer() const
@@ -74,4 +84,15 @@ inline ID3D11Buffer* DX11Buffer::GetDXBuffer() const
     return static_cast<ID3D11Buffer*>(mDXObject);
 }
 
+inline void DX11Buffer::SetStreamSlice(StreamRing::Slice const& slice, ID3D11Buffer* streamBuffer)
+{
+    mStreamSlice = slice;
+    mStreamBuffer = streamBuffer;
+}
+
+inline StreamRing::Slice const& DX11Buffer::GetStreamSlice() const
+{
+    return mStreamSlice;
+}
+
 #endif
\ No newline at end of file
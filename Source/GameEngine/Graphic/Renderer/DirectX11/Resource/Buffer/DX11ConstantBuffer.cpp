@@ -76,3 +76,14 @@ eastl::shared_ptr<GraphicObject> DX11ConstantBuffer::Create(void* device, Graphi
     LogError("Invalid object type.");
     return nullptr;
 }
+
+bool DX11ConstantBuffer::Update(ID3D11DeviceContext* context)
+{
+    if (!DX11Buffer::Update(context))
+    {
+        return false;
+    }
+
+    GetConstantBuffer()->ClearDirtyRange();
+    return true;
+}
@@ -20,6 +20,11 @@ public:
 
     // Member access.
     inline ConstantBuffer* GetConstantBuffer() const;
+
+    // Mapping with discard invalidates the whole buffer, so the dirty range
+    // of the constant buffer can't narrow the copy; it is only reset.
+    using DX11Buffer::Update;
+    virtual bool Update(ID3D11DeviceContext* context) override;
 };
 
 inline ConstantBuffer* DX11ConstantBuffer::GetConstantBuffer() const
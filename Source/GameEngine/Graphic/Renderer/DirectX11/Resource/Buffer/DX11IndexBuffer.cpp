@@ -84,8 +84,16 @@ void DX11IndexBuffer::Enable(ID3D11DeviceContext* context)
 {
     if (mDXObject)
     {
-        ID3D11Buffer* dxBuffer = static_cast<ID3D11Buffer*>(mDXObject);
-        context->IASetIndexBuffer(dxBuffer, mFormat, 0);
+        // The slice starts with the first index of the buffer.
+        if (mStreamSlice.mOffset != StreamRing::Invalid)
+        {
+            context->IASetIndexBuffer(mStreamBuffer, mFormat, mStreamSlice.mOffset);
+        }
+        else
+        {
+            ID3D11Buffer* dxBuffer = static_cast<ID3D11Buffer*>(mDXObject);
+            context->IASetIndexBuffer(dxBuffer, mFormat, 0);
+        }
     }
 }
 
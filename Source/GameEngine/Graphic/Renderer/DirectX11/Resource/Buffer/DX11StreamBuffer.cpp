@@ -0,0 +1,63 @@
+//========================================================================
+// DX11StreamBuffer.cpp : Dynamic buffer the dynamic vertices and indices of
+// each frame are written to.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "DX11StreamBuffer.h"
+
+DX11StreamBuffer::DX11StreamBuffer(ID3D11Device* device, unsigned int numBytes)
+	:
+	mBuffer(nullptr),
+	mRing(numBytes)
+{
+	D3D11_BUFFER_DESC desc;
+	desc.ByteWidth = numBytes;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_INDEX_BUFFER;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_NONE;
+	desc.StructureByteStride = 0;
+
+	HRESULT hr = device->CreateBuffer(&desc, nullptr, &mBuffer);
+	if (FAILED(hr))
+	{
+		LogError("Failed to create stream buffer, hr = " + GetErrorMessage(hr));
+		mBuffer = nullptr;
+	}
+}
+
+DX11StreamBuffer::~DX11StreamBuffer()
+{
+	FinalRelease(mBuffer);
+}
+
+StreamRing::Slice DX11StreamBuffer::Write(ID3D11DeviceContext* context,
+	void const* data, unsigned int numBytes, unsigned int alignment)
+{
+	D3D11_MAP mapMode = D3D11_MAP_WRITE_NO_OVERWRITE;
+	StreamRing::Slice slice = mRing.Allocate(numBytes, alignment);
+	if (slice.mOffset == StreamRing::Invalid)
+	{
+		mRing.Reset();
+		slice = mRing.Allocate(numBytes, alignment);
+		if (slice.mOffset == StreamRing::Invalid)
+			return slice;
+
+		mapMode = D3D11_MAP_WRITE_DISCARD;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE sub;
+	HRESULT hr = context->Map(mBuffer, 0, mapMode, 0, &sub);
+	if (FAILED(hr))
+	{
+		LogError("Failed to map stream buffer, hr = " + GetErrorMessage(hr));
+		return StreamRing::Slice();
+	}
+
+	memcpy(static_cast<char*>(sub.pData) + slice.mOffset, data, numBytes);
+	context->Unmap(mBuffer, 0);
+	return slice;
+}
@@ -0,0 +1,57 @@
+//========================================================================
+// DX11StreamBuffer.h : Dynamic buffer the dynamic vertices and indices of
+// each frame are written to.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef DX11STREAMBUFFER_H
+#define DX11STREAMBUFFER_H
+
+#include "Graphic/Renderer/StreamRing.h"
+#include "Graphic/Renderer/DirectX11/Resource/DX11GraphicObject.h"
+
+// The slices are written with D3D11_MAP_WRITE_NO_OVERWRITE, which promises
+// the driver that the bytes in use by the GPU are left alone. When the ring
+// is full, it starts over with D3D11_MAP_WRITE_DISCARD: the driver renames
+// the memory, so there are no fences to wait for but the slices written so
+// far are no longer current. The buffer can be bound both as a vertex and
+// as an index buffer.
+class GRAPHIC_ITEM DX11StreamBuffer
+{
+public:
+	DX11StreamBuffer(ID3D11Device* device, unsigned int numBytes);
+	~DX11StreamBuffer();
+
+	// False when the buffer couldn't be created.
+	inline bool IsValid() const;
+	inline ID3D11Buffer* GetDXBuffer() const;
+	inline StreamRing const& GetRing() const;
+
+	// Copies the data to a slice of the ring. The offset of the slice is
+	// StreamRing::Invalid when the data doesn't fit in the ring.
+	StreamRing::Slice Write(ID3D11DeviceContext* context,
+		void const* data, unsigned int numBytes, unsigned int alignment);
+
+private:
+	ID3D11Buffer* mBuffer;
+	StreamRing mRing;
+};
+
+inline bool DX11StreamBuffer::IsValid() const
+{
+	return mBuffer != nullptr;
+}
+
+inline ID3D11Buffer* DX11StreamBuffer::GetDXBuffer() const
+{
+	return mBuffer;
+}
+
+inline StreamRing const& DX11StreamBuffer::GetRing() const
+{
+	return mRing;
+}
+
+#endif
@@ -98,6 +98,13 @@ void DX11VertexBuffer::Enable(ID3D11DeviceContext* context)
         VertexBuffer* vbuffer = GetVertexBuffer();
         UINT strides[1] = { vbuffer->GetElementSize() };
         UINT offsets[1] = { 0 };
+
+        // The slice starts with the first vertex of the buffer.
+        if (mStreamSlice.mOffset != StreamRing::Invalid)
+        {
+            buffers[0] = mStreamBuffer;
+            offsets[0] = mStreamSlice.mOffset;
+        }
         context->IASetVertexBuffers(0, 1, buffers, strides, offsets);
     }
 }
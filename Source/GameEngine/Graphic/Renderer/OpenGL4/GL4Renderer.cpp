@@ -54,7 +54,9 @@ GL4Renderer::GL4Renderer()
     :
     mMajor(0),
     mMinor(0),
-    mMeetsRequirements(false)
+    mMeetsRequirements(false),
+    mTrackedGeneration(0),
+    mUniformOffsetAlignment(256)
 {
     // Initialization of GraphicsEngine members that depend on GL4.
 	mInputLayouts = eastl::make_unique<GL4InputLayoutManager>();
@@ -110,6 +112,23 @@ bool GL4Renderer::Initialize(int requiredMajor, int requiredMinor)
         SetViewport(0, 0, mScreenSize[0], mScreenSize[1]);
         SetDepthRange(0.0f, 1.0f);
         CreateDefaultGlobalState();
+
+        // The persistent mapping of the stream buffer requires OpenGL 4.4.
+        if (mMajor > 4 || (mMajor == 4 && mMinor >= 4))
+        {
+            GLint alignment = 0;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            if (alignment > 0)
+            {
+                mUniformOffsetAlignment = static_cast<GLuint>(alignment);
+            }
+
+            mStreamBuffer = eastl::make_unique<GL4StreamBuffer>(StreamBufferSize);
+            if (!mStreamBuffer->IsValid())
+            {
+                mStreamBuffer = nullptr;
+            }
+        }
     }
 	
 #if defined(NDEBUG)
@@ -139,6 +158,8 @@ void GL4Renderer::Terminate()
     // counter buffers.
     mAtomicCounterRawBuffers.clear();
 
+    mStreamBuffer = nullptr;
+
     GraphicObject::UnsubscribeForDestruction(mGOListener);
     mGOListener = nullptr;
 
@@ -152,7 +173,7 @@ void GL4Renderer::Terminate()
             LogWarning("Bridge map is nonempty on destruction.");
         }
 
-        mGraphicObjects.RemoveAll();
+        RemoveAllGraphicObjects();
     }
 
     if (mDrawTargets.HasElements())
@@ -177,7 +198,8 @@ void GL4Renderer::Terminate()
     mInputLayouts = nullptr;
 }
 
-uint64_t GL4Renderer::DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer const* ibuffer)
+uint64_t GL4Renderer::DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer const* ibuffer,
+    unsigned int numInstances)
 {
     unsigned int numActiveVertices = vbuffer->GetNumActiveElements();
     unsigned int vertexOffset = vbuffer->GetOffset();
@@ -222,12 +244,21 @@ uint64_t GL4Renderer::DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer con
         return 0;
     }
 
-    unsigned int offset = ibuffer->GetOffset();
+    // The draw starts at the first active primitive, as in Direct3D.
+    unsigned int offset = ibuffer->GetOffset() + ibuffer->GetFirstIndex();
     if (ibuffer->IsIndexed())
     {
         void const* data = (char*)0 + indexSize * offset;
-        glDrawRangeElements(topology, 0, numActiveVertices - 1,
-            static_cast<GLsizei>(numActiveIndices), indexType, data);
+        if (numInstances > 1)
+        {
+            glDrawElementsInstanced(topology, static_cast<GLsizei>(numActiveIndices),
+                indexType, data, static_cast<GLsizei>(numInstances));
+        }
+        else
+        {
+            glDrawRangeElements(topology, 0, numActiveVertices - 1,
+                static_cast<GLsizei>(numActiveIndices), indexType, data);
+        }
     }
     else
     {
@@ -237,8 +268,16 @@ uint64_t GL4Renderer::DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer con
         // commands that do not reference the content of the GL_ELEMENT_ARRAY_BUFFER,
         // or explicitly generated from the content of the GL_ELEMENT_ARRAY_BUFFER
         // by commands such as glDrawElements."
-        glDrawArrays(topology, static_cast<GLint>(vertexOffset),
-            static_cast<GLint>(numActiveVertices));
+        if (numInstances > 1)
+        {
+            glDrawArraysInstanced(topology, static_cast<GLint>(vertexOffset),
+                static_cast<GLint>(numActiveVertices), static_cast<GLsizei>(numInstances));
+        }
+        else
+        {
+            glDrawArrays(topology, static_cast<GLint>(vertexOffset),
+                static_cast<GLint>(numActiveVertices));
+        }
     }
     return 0;
 }
@@ -322,8 +361,25 @@ void GL4Renderer::EnableCBuffers(Shader const* shader, GLuint program)
                 if (GL_INVALID_INDEX != static_cast<unsigned int>(blockIndex))
                 {
                     auto const unit = mUniformUnitMap.AcquireUnit(program, blockIndex);
-                    glUniformBlockBinding(program, blockIndex, unit);
-                    gl4CB->AttachToUnit(unit);
+                    mStateTracker.UniformBlockBinding(blockIndex, unit);
+
+                    // The slice of a previous frame may have been reused.
+                    if (gl4CB->GetStreamSlice().mOffset != StreamRing::Invalid &&
+                        !mStreamBuffer->GetRing().IsCurrent(gl4CB->GetStreamSlice()))
+                    {
+                        StreamConstantBuffer(gl4CB);
+                    }
+
+                    StreamRing::Slice const& slice = gl4CB->GetStreamSlice();
+                    if (slice.mOffset != StreamRing::Invalid)
+                    {
+                        mStateTracker.BindUniformBufferRange(unit,
+                            mStreamBuffer->GetGLHandle(), slice.mOffset, slice.mNumBytes);
+                    }
+                    else
+                    {
+                        mStateTracker.BindUniformBuffer(unit, gl4CB->GetGLHandle());
+                    }
                 }
             }
             else
@@ -346,8 +402,8 @@ void GL4Renderer::DisableCBuffers(Shader const* shader, GLuint program)
         auto const blockIndex = cb.bindPoint;
         if (GL_INVALID_INDEX != static_cast<unsigned int>(blockIndex))
         {
+            // The buffer stays bound to its unit for the next draws.
             auto const unit = mUniformUnitMap.GetUnit(program, blockIndex);
-            glBindBufferBase(GL_UNIFORM_BUFFER, unit, 0);
             mUniformUnitMap.ReleaseUnit(unit);
         }
     }
@@ -568,7 +624,7 @@ void GL4Renderer::EnableTextures(Shader const* shader, GLuint program)
             // using shader compiler and then connect as GL_READ_WRITE here.
             // Always bind level 0 and all layers.
             GLint unit = mTextureImageUnitMap.AcquireUnit(program, ts.bindPoint);
-            glUniform1i(ts.bindPoint, unit);
+            mStateTracker.Uniform1i(ts.bindPoint, unit);
             DFType format = texture->GetTexture()->GetFormat();
             GLuint internalFormat = texture->GetInternalFormat(format);
             glBindImageTexture(unit, handle, 0, GL_TRUE, 0, GL_READ_WRITE, internalFormat);
@@ -576,9 +632,8 @@ void GL4Renderer::EnableTextures(Shader const* shader, GLuint program)
         else
         {
             GLint unit = mTextureSamplerUnitMap.AcquireUnit(program, ts.bindPoint);
-            glUniform1i(ts.bindPoint, unit);
-            glActiveTexture(GL_TEXTURE0 + unit);
-            glBindTexture(texture->GetTarget(), handle);
+            mStateTracker.Uniform1i(ts.bindPoint, unit);
+            mStateTracker.BindTexture(unit, texture->GetTarget(), handle);
         }
     }
 }
@@ -616,9 +671,8 @@ void GL4Renderer::DisableTextures(Shader const* shader, GLuint program)
         }
         else
         {
+            // The texture stays bound to its unit for the next draws.
             GLint unit = mTextureSamplerUnitMap.GetUnit(program, ts.bindPoint);
-            glActiveTexture(GL_TEXTURE0 + unit);
-            glBindTexture(texture->GetTarget(), 0);
             mTextureSamplerUnitMap.ReleaseUnit(unit);
         }
     }
@@ -652,7 +706,7 @@ void GL4Renderer::EnableTextureArrays(Shader const* shader, GLuint program)
             // using shader compiler and then connect as GL_READ_WRITE here.
             // Always bind level 0 and all layers.
             GLint unit = mTextureImageUnitMap.AcquireUnit(program, ta.bindPoint);
-            glUniform1i(ta.bindPoint, unit);
+            mStateTracker.Uniform1i(ta.bindPoint, unit);
             DFType format = texture->GetTexture()->GetFormat();
             GLuint internalFormat = texture->GetInternalFormat(format);
             glBindImageTexture(unit, handle, 0, GL_TRUE, 0, GL_READ_WRITE, internalFormat);
@@ -660,9 +714,8 @@ void GL4Renderer::EnableTextureArrays(Shader const* shader, GLuint program)
         else
         {
             GLint unit = mTextureSamplerUnitMap.AcquireUnit(program, ta.bindPoint);
-            glUniform1i(ta.bindPoint, unit);
-            glActiveTexture(GL_TEXTURE0 + unit);
-            glBindTexture(texture->GetTarget(), handle);
+            mStateTracker.Uniform1i(ta.bindPoint, unit);
+            mStateTracker.BindTexture(unit, texture->GetTarget(), handle);
         }
     }
 }
@@ -700,9 +753,8 @@ void GL4Renderer::DisableTextureArrays(Shader const* shader, GLuint program)
         }
         else
         {
+            // The texture stays bound to its unit for the next draws.
             GLint unit = mTextureSamplerUnitMap.GetUnit(program, ta.bindPoint);
-            glActiveTexture(GL_TEXTURE0 + unit);
-            glBindTexture(texture->GetTarget(), 0);
             mTextureSamplerUnitMap.ReleaseUnit(unit);
         }
     }
@@ -720,7 +772,7 @@ void GL4Renderer::EnableSamplers(Shader const* shader, GLuint program)
             {
                 auto const location = ts.bindPoint;
                 auto const unit = mTextureSamplerUnitMap.AcquireUnit(program, location);
-                glBindSampler(unit, gl4Sampler->GetGLHandle());
+                mStateTracker.BindSampler(unit, gl4Sampler->GetGLHandle());
             }
             else
             {
@@ -746,8 +798,8 @@ void GL4Renderer::DisableSamplers(Shader const* shader, GLuint program)
             if (gl4Sampler)
             {
                 auto const location = ts.bindPoint;
+                // The sampler stays bound to its unit for the next draws.
                 auto const unit = mTextureSamplerUnitMap.GetUnit(program, location);
-                glBindSampler(unit, 0);
                 mTextureSamplerUnitMap.ReleaseUnit(unit);
             }
             else
@@ -1009,7 +1061,9 @@ void GL4Renderer::Disable(eastl::shared_ptr<DrawTarget> const& target)
     auto gl4Target = static_cast<GL4DrawTarget*>(Get(target));
     if (gl4Target)
     {
+        // Generating the mipmaps of the targets goes through the active unit.
         gl4Target->Disable();
+        mStateTracker.InvalidateActiveTexture();
     }
 }
 
@@ -1021,10 +1075,85 @@ bool GL4Renderer::Update(eastl::shared_ptr<Buffer> const& buffer)
         buffer->CreateStorage();
     }
 
+    if (buffer->GetType() == GE_CONSTANT_BUFFER)
+    {
+        auto gl4CBuffer = static_cast<GL4ConstantBuffer*>(Bind(buffer));
+        return StreamConstantBuffer(gl4CBuffer);
+    }
+
+    if (mStreamBuffer && buffer->GetUsage() == Resource::DYNAMIC_UPDATE &&
+        (buffer->GetType() == GE_VERTEX_BUFFER || buffer->GetType() == GE_INDEX_BUFFER))
+    {
+        if (StreamBuffer(static_cast<GL4Buffer*>(Bind(buffer))))
+        {
+            return true;
+        }
+    }
+
+    // Uploading an index buffer binds it to the current vertex array.
+    if (buffer->GetType() == GE_INDEX_BUFFER)
+    {
+        mStateTracker.InvalidateVertexArray();
+    }
+
     auto glBuffer = static_cast<GL4Buffer*>(Bind(buffer));
     return glBuffer->Update();
 }
 
+bool GL4Renderer::StreamConstantBuffer(GL4ConstantBuffer* gl4CBuffer)
+{
+    ConstantBuffer* cbuffer = gl4CBuffer->GetConstantBuffer();
+    if (mStreamBuffer && cbuffer->GetUsage() == Resource::DYNAMIC_UPDATE)
+    {
+        // The constant buffers are small, the new slice gets the whole data.
+        StreamRing::Slice slice = mStreamBuffer->Write(
+            cbuffer->GetData(), cbuffer->GetNumBytes(), mUniformOffsetAlignment);
+        if (slice.mOffset != StreamRing::Invalid)
+        {
+            gl4CBuffer->SetStreamSlice(slice);
+            cbuffer->ClearDirtyRange();
+            return true;
+        }
+    }
+
+    // The buffer storage missed the writes made to the stream buffer, the
+    // dirty range doesn't cover them.
+    if (gl4CBuffer->GetStreamSlice().mOffset != StreamRing::Invalid)
+    {
+        gl4CBuffer->SetStreamSlice(StreamRing::Slice());
+        cbuffer->ClearDirtyRange();
+    }
+    return gl4CBuffer->Update();
+}
+
+bool GL4Renderer::StreamBuffer(GL4Buffer* gl4Buffer)
+{
+    Buffer* buffer = gl4Buffer->GetBuffer();
+    GLuint numActiveBytes = buffer->GetNumActiveBytes();
+    if (numActiveBytes == 0)
+    {
+        return false;
+    }
+
+    GLintptr offsetInBytes = buffer->GetOffset() * buffer->GetElementSize();
+    StreamRing::Slice slice = mStreamBuffer->Write(
+        buffer->GetData() + offsetInBytes, numActiveBytes, 16);
+    if (slice.mOffset == StreamRing::Invalid)
+    {
+        return false;
+    }
+
+    // The copy runs on the GPU in order with the draws.  The copy targets
+    // leave the vertex array bindings alone.
+    glBindBuffer(GL_COPY_READ_BUFFER, mStreamBuffer->GetGLHandle());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, gl4Buffer->GetGLHandle());
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+        slice.mOffset, offsetInBytes, numActiveBytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return true;
+}
+
 bool GL4Renderer::Update(eastl::shared_ptr<TextureSingle> const& texture)
 {
     if (!texture->GetData())
@@ -1034,6 +1163,7 @@ bool GL4Renderer::Update(eastl::shared_ptr<TextureSingle> const& texture)
     }
 
     auto glTexture = static_cast<GL4TextureSingle*>(Bind(texture));
+    mStateTracker.InvalidateActiveTexture();
     return glTexture->Update();
 }
 
@@ -1046,6 +1176,7 @@ bool GL4Renderer::Update(eastl::shared_ptr<TextureSingle> const& texture, unsign
     }
 
     auto glTexture = static_cast<GL4TextureSingle*>(Bind(texture));
+    mStateTracker.InvalidateActiveTexture();
     return glTexture->Update(level);
 }
 
@@ -1058,6 +1189,7 @@ bool GL4Renderer::Update(eastl::shared_ptr<TextureArray> const& textureArray)
     }
 
     auto glTextureArray = static_cast<GL4TextureArray*>(Bind(textureArray));
+    mStateTracker.InvalidateActiveTexture();
     return glTextureArray->Update();
 }
 
@@ -1070,13 +1202,22 @@ bool GL4Renderer::Update(eastl::shared_ptr<TextureArray> const& textureArray, un
     }
 
     auto glTextureArray = static_cast<GL4TextureArray*>(Bind(textureArray));
+    mStateTracker.InvalidateActiveTexture();
     return glTextureArray->Update(item, level);
 }
 
 uint64_t GL4Renderer::DrawPrimitive(eastl::shared_ptr<VertexBuffer> const& vbuffer,
     eastl::shared_ptr<IndexBuffer> const& ibuffer, eastl::shared_ptr<VisualEffect> const& effect)
 {
-    GLSLVisualProgram* gl4program = dynamic_cast<GLSLVisualProgram*>(effect->GetProgram().get());
+    return DrawInstancedPrimitive(vbuffer, ibuffer, effect, 1);
+}
+
+uint64_t GL4Renderer::DrawInstancedPrimitive(eastl::shared_ptr<VertexBuffer> const& vbuffer,
+    eastl::shared_ptr<IndexBuffer> const& ibuffer, eastl::shared_ptr<VisualEffect> const& effect,
+    unsigned int numInstances)
+{
+    // The programs of this renderer are created by the GLSL factory.
+    GLSLVisualProgram* gl4program = static_cast<GLSLVisualProgram*>(effect->GetProgram().get());
     if (!gl4program)
     {
         LogError("GLSL program effect doesn't exist.");
@@ -1085,47 +1226,74 @@ uint64_t GL4Renderer::DrawPrimitive(eastl::shared_ptr<VertexBuffer> const& vbuff
 
     uint64_t numPixelsDrawn = 0;
     auto programHandle = gl4program->GetProgramHandle();
-    glUseProgram(programHandle);
 
+    // Create the missing objects before any binding is made.  Creating or
+    // destroying objects may change the bindings behind the state tracker,
+    // in which case it starts over.
+    GL4VertexBuffer* gl4VBuffer = nullptr;
+    GL4InputLayout* gl4Layout = nullptr;
+    if (vbuffer->StandardUsage())
+    {
+        gl4VBuffer = static_cast<GL4VertexBuffer*>(Bind(vbuffer));
+        GL4InputLayoutManager* manager = static_cast<GL4InputLayoutManager*>(mInputLayouts.get());
+        gl4Layout = manager->Bind(programHandle, gl4VBuffer->GetGLHandle(), vbuffer.get());
+    }
+
+    GL4IndexBuffer* gl4IBuffer = nullptr;
+    if (ibuffer->IsIndexed())
+    {
+        gl4IBuffer = static_cast<GL4IndexBuffer*>(Bind(ibuffer));
+    }
+
+    BindResources(effect);
+    if (mTrackedGeneration != mObjectGeneration)
+    {
+        mStateTracker.Invalidate();
+        mTrackedGeneration = mObjectGeneration;
+    }
+
+    mStateTracker.UseProgram(programHandle);
     if (EnableShaders(effect, programHandle))
     {
-        // Enable the vertex buffer and input layout.
-        GL4VertexBuffer* gl4VBuffer = nullptr;
-        GL4InputLayout* gl4Layout = nullptr;
-        if (vbuffer->StandardUsage())
+        // Enable the input layout and the index buffer.  They stay bound
+        // after the draw, so a run of draws sharing them sets them once.
+        mStateTracker.BindVertexArray(gl4Layout ? gl4Layout->GetVertexArrayHandle() : 0);
+        if (gl4IBuffer)
         {
-            gl4VBuffer = static_cast<GL4VertexBuffer*>(Bind(vbuffer));
-            GL4InputLayoutManager* manager = static_cast<GL4InputLayoutManager*>(mInputLayouts.get());
-            gl4Layout = manager->Bind(programHandle, gl4VBuffer->GetGLHandle(), vbuffer.get());
-            gl4Layout->Enable();
+            mStateTracker.BindElementBuffer(gl4IBuffer->GetGLHandle());
         }
 
-        // Enable the index buffer.
-        GL4IndexBuffer* gl4IBuffer = nullptr;
-        if (ibuffer->IsIndexed())
-        {
-            gl4IBuffer = static_cast<GL4IndexBuffer*>(Bind(ibuffer));
-            gl4IBuffer->Enable();
-        }
+        numPixelsDrawn = DrawPrimitive(vbuffer.get(), ibuffer.get(), numInstances);
 
-        numPixelsDrawn = DrawPrimitive(vbuffer.get(), ibuffer.get());
+        DisableShaders(effect, programHandle);
+    }
+
+    return numPixelsDrawn;
+}
 
-        // Disable the vertex buffer and input layout.
-        if (vbuffer->StandardUsage())
+void GL4Renderer::BindResources(eastl::shared_ptr<VisualEffect> const& effect)
+{
+    Shader const* shaders[] = { effect->GetVertexShader().get(),
+        effect->GetPixelShader().get(), effect->GetGeometryShader().get() };
+    int const lookups[] = { ConstantBuffer::mShaderDataLookup,
+        TextureSingle::mShaderDataLookup, TextureArray::mShaderDataLookup,
+        SamplerState::mShaderDataLookup, StructuredBuffer::mShaderDataLookup };
+    for (auto shader : shaders)
+    {
+        if (!shader)
         {
-            gl4Layout->Disable();
+            continue;
         }
 
-        // Disable the index buffer.
-        if (gl4IBuffer)
+        for (auto lookup : lookups)
         {
-            gl4IBuffer->Disable();
+            for (auto const& data : shader->GetData(lookup))
+            {
+                if (data.object)
+                {
+                    Bind(data.object);
+                }
+            }
         }
-
-        DisableShaders(effect, programHandle);
     }
-
-    glUseProgram(0);
-
-    return numPixelsDrawn;
 }
@@ -10,8 +10,12 @@
 
 #include "Graphic/Renderer/Renderer.h"
 #include "Graphic/Renderer/OpenGL4/InputLayout/GL4InputLayoutManager.h"
+#include "Graphic/Renderer/OpenGL4/GL4StateTracker.h"
+#include "Graphic/Renderer/OpenGL4/Resource/Buffer/GL4StreamBuffer.h"
 
 class GL4GraphicObject;
+class GL4Buffer;
+class GL4ConstantBuffer;
 class GL4DrawTarget;
 
 class GRAPHIC_ITEM GL4Renderer : public Renderer
@@ -36,6 +40,13 @@ public:
     virtual bool IsActive() const = 0;
     virtual void MakeActive() = 0;
 
+    // The bindings made by the draws and the calls skipped per frame.
+    inline GL4StateTracker const& GetStateTracker() const;
+
+    // The buffer the dynamic buffers are streamed through, null when the
+    // OpenGL version has no persistent mapping.
+    inline GL4StreamBuffer const* GetStreamBuffer() const;
+
 protected:
     // Helpers for construction and destruction.
     virtual bool Initialize(int requiredMajor, int requiredMinor);
@@ -45,9 +56,31 @@ protected:
     int mMajor, mMinor;
     bool mMeetsRequirements;
 
+    // The tracker starts over whenever objects were created or destroyed
+    // since the last draw.
+    GL4StateTracker mStateTracker;
+    unsigned int mTrackedGeneration;
+
+    // Each update of a dynamic constant buffer writes the buffer to a new
+    // slice of the stream buffer, which is bound as a range of the stream
+    // buffer. The slice is written again when the buffer is bound in a
+    // later frame. The dynamic vertex and index buffers keep their storage,
+    // so that the vertex arrays stay valid: their active range is written to
+    // the stream buffer then copied by the GPU to the buffer storage.
+    static unsigned int const StreamBufferSize = 8 * 1024 * 1024;
+    eastl::unique_ptr<GL4StreamBuffer> mStreamBuffer;
+    GLuint mUniformOffsetAlignment;
+
 private:
     // Support for drawing.
-    uint64_t DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer const* ibuffer);
+    uint64_t DrawPrimitive(VertexBuffer const* vbuffer, IndexBuffer const* ibuffer,
+        unsigned int numInstances = 1);
+    void BindResources(eastl::shared_ptr<VisualEffect> const& effect);
+
+    // Support for streaming the dynamic buffers.  They return false when
+    // the stream buffer is full and the buffer has to be updated directly.
+    bool StreamConstantBuffer(GL4ConstantBuffer* gl4CBuffer);
+    bool StreamBuffer(GL4Buffer* gl4Buffer);
 
     // Support for enabling and disabling resources used by shaders.
     bool EnableShaders(eastl::shared_ptr<VisualEffect> const& effect, GLuint program);
@@ -160,6 +193,12 @@ protected:
         eastl::shared_ptr<VertexBuffer> const& vbuffer,
         eastl::shared_ptr<IndexBuffer> const& ibuffer,
         eastl::shared_ptr<VisualEffect> const& effect) override;
+
+    virtual uint64_t DrawInstancedPrimitive(
+        eastl::shared_ptr<VertexBuffer> const& vbuffer,
+        eastl::shared_ptr<IndexBuffer> const& ibuffer,
+        eastl::shared_ptr<VisualEffect> const& effect,
+        unsigned int numInstances) override;
 };
 
 
@@ -168,4 +207,14 @@ inline bool GL4Renderer::MeetsRequirements() const
     return mMeetsRequirements;
 }
 
+inline GL4StateTracker const& GL4Renderer::GetStateTracker() const
+{
+    return mStateTracker;
+}
+
+inline GL4StreamBuffer const* GL4Renderer::GetStreamBuffer() const
+{
+    return mStreamBuffer.get();
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+//========================================================================
+// GL4StateTracker.cpp : Remembers the OpenGL bindings made by the renderer
+// so that redundant calls are skipped between consecutive draws.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "GL4StateTracker.h"
+
+#include "Core/Logger/Logger.h"
+
+GL4StateTracker::Statistics::Statistics()
+{
+	memset(mIssued, 0, sizeof(mIssued));
+	memset(mSkipped, 0, sizeof(mSkipped));
+}
+
+GL4StateTracker::GL4StateTracker()
+	: mProgram(Unknown), mVertexArray(Unknown), mActiveTexture(Unknown)
+{
+}
+
+void GL4StateTracker::Invalidate()
+{
+	mProgram = Unknown;
+	mActiveTexture = Unknown;
+	mBlockBindings.clear();
+	mUniforms.clear();
+	mUniformBuffers.clear();
+	mUniformOffsets.clear();
+	mUniformSizes.clear();
+	mTextureTargets.clear();
+	mTextures.clear();
+	mSamplers.clear();
+	InvalidateVertexArray();
+}
+
+void GL4StateTracker::InvalidateVertexArray()
+{
+	mVertexArray = Unknown;
+	mElementBuffers.clear();
+}
+
+void GL4StateTracker::InvalidateActiveTexture()
+{
+	if (mActiveTexture != Unknown && mActiveTexture < mTextures.size())
+		mTextures[mActiveTexture] = Unknown;
+}
+
+bool GL4StateTracker::Track(CallType type, GLuint& current, GLuint value)
+{
+	if (current == value)
+	{
+		mFrameStatistics.mSkipped[type]++;
+		return false;
+	}
+
+	current = value;
+	mFrameStatistics.mIssued[type]++;
+	return true;
+}
+
+GLuint& GL4StateTracker::GetUnit(eastl::vector<GLuint>& units, GLuint unit)
+{
+	if (unit >= units.size())
+		units.resize(unit + 1, Unknown);
+	return units[unit];
+}
+
+void GL4StateTracker::UseProgram(GLuint program)
+{
+	if (Track(CT_PROGRAM, mProgram, program))
+	{
+		glUseProgram(program);
+
+		// the cached program state belonged to the previous program
+		mBlockBindings.clear();
+		mUniforms.clear();
+	}
+}
+
+void GL4StateTracker::UniformBlockBinding(GLuint blockIndex, GLuint unit)
+{
+	if (Track(CT_BLOCK_BINDING, GetUnit(mBlockBindings, blockIndex), unit))
+		glUniformBlockBinding(mProgram, blockIndex, unit);
+}
+
+void GL4StateTracker::Uniform1i(GLint location, GLint value)
+{
+	auto itUniform = mUniforms.find(location);
+	if (itUniform == mUniforms.end())
+		itUniform = mUniforms.insert(eastl::make_pair(location, Unknown)).first;
+
+	if (Track(CT_UNIFORM, itUniform->second, (GLuint)value))
+		glUniform1i(location, value);
+}
+
+void GL4StateTracker::BindUniformBuffer(GLuint unit, GLuint buffer)
+{
+	BindUniformBufferRange(unit, buffer, 0, 0);
+}
+
+void GL4StateTracker::BindUniformBufferRange(GLuint unit, GLuint buffer, GLuint offset, GLuint size)
+{
+	GLuint& currentBuffer = GetUnit(mUniformBuffers, unit);
+	GLuint& currentOffset = GetUnit(mUniformOffsets, unit);
+	GLuint& currentSize = GetUnit(mUniformSizes, unit);
+	if (currentBuffer == buffer && currentOffset == offset && currentSize == size)
+	{
+		mFrameStatistics.mSkipped[CT_UNIFORM_BUFFER]++;
+		return;
+	}
+
+	currentBuffer = buffer;
+	currentOffset = offset;
+	currentSize = size;
+	mFrameStatistics.mIssued[CT_UNIFORM_BUFFER]++;
+	if (size > 0)
+		glBindBufferRange(GL_UNIFORM_BUFFER, unit, buffer, offset, size);
+	else
+		glBindBufferBase(GL_UNIFORM_BUFFER, unit, buffer);
+}
+
+void GL4StateTracker::BindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+	// a unit holds one texture per target, only the last one is mirrored
+	GLuint& currentTarget = GetUnit(mTextureTargets, unit);
+	GLuint& currentTexture = GetUnit(mTextures, unit);
+	if (currentTarget != target)
+		currentTexture = Unknown;
+	currentTarget = target;
+
+	if (Track(CT_TEXTURE, currentTexture, texture))
+	{
+		if (mActiveTexture != unit)
+		{
+			glActiveTexture(GL_TEXTURE0 + unit);
+			mActiveTexture = unit;
+		}
+		glBindTexture(target, texture);
+	}
+}
+
+void GL4StateTracker::BindSampler(GLuint unit, GLuint sampler)
+{
+	if (Track(CT_SAMPLER, GetUnit(mSamplers, unit), sampler))
+		glBindSampler(unit, sampler);
+}
+
+void GL4StateTracker::BindVertexArray(GLuint vertexArray)
+{
+	if (Track(CT_VERTEX_ARRAY, mVertexArray, vertexArray))
+		glBindVertexArray(vertexArray);
+}
+
+void GL4StateTracker::BindElementBuffer(GLuint buffer)
+{
+	// the index buffer binding is part of the vertex array state
+	auto itElementBuffer = mElementBuffers.find(mVertexArray);
+	if (itElementBuffer == mElementBuffers.end())
+		itElementBuffer = mElementBuffers.insert(eastl::make_pair(mVertexArray, Unknown)).first;
+
+	if (Track(CT_ELEMENT_BUFFER, itElementBuffer->second, buffer))
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+}
+
+void GL4StateTracker::EndFrame()
+{
+	mLastFrameStatistics = mFrameStatistics;
+	mFrameStatistics = Statistics();
+}
+
+const GL4StateTracker::Statistics& GL4StateTracker::GetLastFrameStatistics() const
+{
+	return mLastFrameStatistics;
+}
+
+void GL4StateTracker::LogStatistics() const
+{
+	static const char* callNames[CT_COUNT] = {
+		"programs", "vertex arrays", "element buffers", "block bindings",
+		"uniform buffers", "uniforms", "textures", "samplers" };
+
+	unsigned int issued = 0, skipped = 0;
+	eastl::string calls;
+	for (int type = 0; type < CT_COUNT; ++type)
+	{
+		issued += mLastFrameStatistics.mIssued[type];
+		skipped += mLastFrameStatistics.mSkipped[type];
+		calls += eastl::string(", ") + callNames[type] + " " +
+			eastl::to_string(mLastFrameStatistics.mSkipped[type]) + "/" +
+			eastl::to_string(mLastFrameStatistics.mIssued[type] + mLastFrameStatistics.mSkipped[type]);
+	}
+	LogInformation("GL state: " + eastl::to_string(skipped) + " of " +
+		eastl::to_string(issued + skipped) + " calls skipped" + calls);
+}
@@ -0,0 +1,92 @@
+//========================================================================
+// GL4StateTracker.h : Remembers the OpenGL bindings made by the renderer
+// so that redundant calls are skipped between consecutive draws.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef GL4STATETRACKER_H
+#define GL4STATETRACKER_H
+
+#include "GameEngineStd.h"
+#include "Graphic/Renderer/OpenGL4/OpenGL.h"
+
+// The tracker mirrors the program, the vertex array, its index buffer, the
+// uniform buffer units and the texture and sampler units. A call is only
+// issued when it changes the mirrored value. The uniform block bindings and
+// the sampler uniforms belong to the program, so they are only remembered
+// while the program stays in use: a deleted program handle may be reused.
+// A uniform buffer unit mirrors the range bound along with the buffer, the
+// whole buffer being a range of size 0.
+// Whoever changes a binding behind the tracker has to invalidate it; after
+// Invalidate every binding is issued again.
+class GRAPHIC_ITEM GL4StateTracker
+{
+public:
+	enum CallType
+	{
+		CT_PROGRAM,
+		CT_VERTEX_ARRAY,
+		CT_ELEMENT_BUFFER,
+		CT_BLOCK_BINDING,
+		CT_UNIFORM_BUFFER,
+		CT_UNIFORM,
+		CT_TEXTURE,
+		CT_SAMPLER,
+		CT_COUNT
+	};
+
+	struct Statistics
+	{
+		Statistics();
+
+		unsigned int mIssued[CT_COUNT];
+		unsigned int mSkipped[CT_COUNT];
+	};
+
+	GL4StateTracker();
+
+	void Invalidate();
+	void InvalidateVertexArray();
+	void InvalidateActiveTexture();
+
+	void UseProgram(GLuint program);
+	void UniformBlockBinding(GLuint blockIndex, GLuint unit);
+	void Uniform1i(GLint location, GLint value);
+	void BindUniformBuffer(GLuint unit, GLuint buffer);
+	void BindUniformBufferRange(GLuint unit, GLuint buffer, GLuint offset, GLuint size);
+	void BindTexture(GLuint unit, GLenum target, GLuint texture);
+	void BindSampler(GLuint unit, GLuint sampler);
+	void BindVertexArray(GLuint vertexArray);
+	void BindElementBuffer(GLuint buffer);
+
+	// The counters of the frame in progress move to the last frame ones.
+	void EndFrame();
+	const Statistics& GetLastFrameStatistics() const;
+	void LogStatistics() const;
+
+private:
+	static const GLuint Unknown = 0xFFFFFFFF;
+
+	bool Track(CallType type, GLuint& current, GLuint value);
+	GLuint& GetUnit(eastl::vector<GLuint>& units, GLuint unit);
+
+	GLuint mProgram;
+	GLuint mVertexArray;
+	GLuint mActiveTexture;
+	eastl::hash_map<GLuint, GLuint> mElementBuffers;
+	eastl::vector<GLuint> mBlockBindings;
+	eastl::hash_map<GLint, GLuint> mUniforms;
+	eastl::vector<GLuint> mUniformBuffers;
+	eastl::vector<GLuint> mUniformOffsets;
+	eastl::vector<GLuint> mUniformSizes;
+	eastl::vector<GLuint> mTextureTargets;
+	eastl::vector<GLuint> mTextures;
+	eastl::vector<GLuint> mSamplers;
+
+	Statistics mFrameStatistics;
+	Statistics mLastFrameStatistics;
+};
+
+#endif
@@ -21,6 +21,10 @@ GL4InputLayout::GL4InputLayout(GLuint programHandle, GLuint vbufferHandle,
     mVBufferHandle(vbufferHandle),
     mNumAttributes(0)
 {
+    // Restore the binding afterwards, the renderer tracks it between draws.
+    GLint prevBinding = 0;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevBinding);
+
     glGenVertexArrays(1, &mVArrayHandle);
     glBindVertexArray(mVArrayHandle);
 
@@ -60,7 +64,7 @@ GL4InputLayout::GL4InputLayout(GLuint programHandle, GLuint vbufferHandle,
         LogError("Invalid inputs to GL4InputLayout constructor.");
     }
 
-    glBindVertexArray(0);
+    glBindVertexArray(static_cast<GLuint>(prevBinding));
 }
 
 void GL4InputLayout::Enable()
@@ -23,6 +23,8 @@ public:
     void Enable();
     void Disable();
 
+    inline GLuint GetVertexArrayHandle() const;
+
 private:
     GLuint mProgramHandle;
     GLuint mVBufferHandle;
@@ -46,4 +48,9 @@ private:
     static GLenum const msChannelType[];
 };
 
+inline GLuint GL4InputLayout::GetVertexArrayHandle() const
+{
+    return mVArrayHandle;
+}
+
 #endif
\ No newline at end of file
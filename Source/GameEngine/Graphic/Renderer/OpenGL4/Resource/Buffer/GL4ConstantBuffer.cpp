@@ -32,3 +32,28 @@ void GL4ConstantBuffer::AttachToUnit(GLint uniformBufferUnit)
 {
     glBindBufferBase(GL_UNIFORM_BUFFER, uniformBufferUnit, mGLHandle);
 }
+
+bool GL4ConstantBuffer::Update()
+{
+    ConstantBuffer* cbuffer = GetConstantBuffer();
+    if (!cbuffer->HasDirtyRange())
+    {
+        return GL4Buffer::Update();
+    }
+
+    if (cbuffer->GetUsage() != Resource::DYNAMIC_UPDATE)
+    {
+        LogWarning("Buffer usage is not DYNAMIC_UPDATE.");
+        return false;
+    }
+
+    // Copy from CPU memory to GPU memory.
+    GLintptr offsetInBytes = cbuffer->GetDirtyOffset();
+    char const* source = cbuffer->GetData() + offsetInBytes;
+    glBindBuffer(mType, mGLHandle);
+    glBufferSubData(mType, offsetInBytes, cbuffer->GetNumDirtyBytes(), source);
+    glBindBuffer(mType, 0);
+
+    cbuffer->ClearDirtyRange();
+    return true;
+}
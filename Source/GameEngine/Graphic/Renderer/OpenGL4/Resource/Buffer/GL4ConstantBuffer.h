@@ -9,6 +9,7 @@
 #define GL4CONSTANTBUFFER_H
 
 #include "Graphic/Resource/Buffer/ConstantBuffer.h"
+#include "Graphic/Renderer/StreamRing.h"
 #include "GL4Buffer.h"
 
 class GRAPHIC_ITEM GL4ConstantBuffer : public GL4Buffer
@@ -23,6 +24,18 @@ public:
 
     // Bind the constant buffer data to the specified uniform buffer unit.
     void AttachToUnit(GLint uniformBufferUnit);
+
+    // Copies only the dirty range of the constant buffer when it has one,
+    // otherwise the whole active range.
+    virtual bool Update() override;
+
+    // The slice of the renderer stream buffer holding the data of a dynamic
+    // buffer. The buffer storage is out of date while the slice is valid.
+    inline void SetStreamSlice(StreamRing::Slice const& slice);
+    inline StreamRing::Slice const& GetStreamSlice() const;
+
+private:
+    StreamRing::Slice mStreamSlice;
 };
 
 inline ConstantBuffer* GL4ConstantBuffer::GetConstantBuffer() const
@@ -30,4 +43,14 @@ inline ConstantBuffer* GL4ConstantBuffer::GetConstantBuffer() const
     return static_cast<ConstantBuffer*>(mGObject);
 }
 
+inline void GL4ConstantBuffer::SetStreamSlice(StreamRing::Slice const& slice)
+{
+    mStreamSlice = slice;
+}
+
+inline StreamRing::Slice const& GL4ConstantBuffer::GetStreamSlice() const
+{
+    return mStreamSlice;
+}
+
 #endif
\ No newline at end of file
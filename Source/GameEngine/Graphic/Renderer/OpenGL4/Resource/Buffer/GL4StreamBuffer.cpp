@@ -0,0 +1,104 @@
+//========================================================================
+// GL4StreamBuffer.cpp : Persistently mapped buffer the dynamic data of each
+// frame is written to.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "GL4StreamBuffer.h"
+
+#include "Core/Logger/Logger.h"
+
+namespace
+{
+	GLbitfield const StreamFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	// nanoseconds a wait lasts before checking the fence again
+	GLuint64 const WaitTimeout = 1000000000;
+}
+
+GL4StreamBuffer::GL4StreamBuffer(unsigned int numBytes)
+	:
+	mGLHandle(0),
+	mMappedData(nullptr),
+	mRing(numBytes),
+	mFrameWaits(0),
+	mLastFrameWaits(0)
+{
+	// The copy target doesn't change the bindings used by the draws.
+	glGenBuffers(1, &mGLHandle);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, mGLHandle);
+	glBufferStorage(GL_COPY_WRITE_BUFFER, numBytes, nullptr, StreamFlags);
+	mMappedData = static_cast<char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, numBytes, StreamFlags));
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	if (!mMappedData)
+		LogWarning("Failed to map the stream buffer, dynamic buffers are uploaded one by one.");
+}
+
+GL4StreamBuffer::~GL4StreamBuffer()
+{
+	for (Fence const& fence : mFences)
+		glDeleteSync(fence.mSync);
+
+	if (mMappedData)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, mGLHandle);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+	glDeleteBuffers(1, &mGLHandle);
+}
+
+StreamRing::Slice GL4StreamBuffer::Write(void const* data, unsigned int numBytes, unsigned int alignment)
+{
+	StreamRing::Slice slice = mRing.Allocate(numBytes, alignment);
+	if (slice.mOffset == StreamRing::Invalid && !mFences.empty())
+	{
+		// The GPU is behind, the ring is made room by retiring the frames
+		// in flight one after the other.
+		mFrameWaits++;
+		while (slice.mOffset == StreamRing::Invalid && RetireOldestFrame(true))
+			slice = mRing.Allocate(numBytes, alignment);
+	}
+
+	if (slice.mOffset != StreamRing::Invalid)
+		memcpy(mMappedData + slice.mOffset, data, numBytes);
+	return slice;
+}
+
+void GL4StreamBuffer::EndFrame()
+{
+	Fence fence;
+	fence.mSync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	fence.mFrame = mRing.EndFrame();
+	mFences.push_back(fence);
+
+	while (RetireOldestFrame(false));
+
+	mLastFrameWaits = mFrameWaits;
+	mFrameWaits = 0;
+}
+
+bool GL4StreamBuffer::RetireOldestFrame(bool wait)
+{
+	if (mFences.empty())
+		return false;
+
+	Fence const& fence = mFences.front();
+	GLenum result = glClientWaitSync(fence.mSync, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? WaitTimeout : 0);
+	while (wait && result == GL_TIMEOUT_EXPIRED)
+		result = glClientWaitSync(fence.mSync, 0, WaitTimeout);
+
+	if (result == GL_TIMEOUT_EXPIRED)
+		return false;
+
+	if (result == GL_WAIT_FAILED)
+		LogError("Failed to wait for the stream buffer fence.");
+
+	mRing.Retire(fence.mFrame);
+	glDeleteSync(fence.mSync);
+	mFences.erase(mFences.begin());
+	return true;
+}
@@ -0,0 +1,80 @@
+//========================================================================
+// GL4StreamBuffer.h : Persistently mapped buffer the dynamic data of each
+// frame is written to.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef GL4STREAMBUFFER_H
+#define GL4STREAMBUFFER_H
+
+#include "Graphic/Renderer/StreamRing.h"
+#include "Graphic/Renderer/OpenGL4/OpenGL.h"
+
+// The buffer storage is mapped once for writing, coherently, so the data
+// copied to a slice is seen by the commands issued afterwards. A fence
+// follows the draws of each frame: the slices of a frame are reused once
+// its fence is signaled. When the ring is full the oldest frames are waited
+// for. The buffer storage requires OpenGL 4.4.
+class GRAPHIC_ITEM GL4StreamBuffer
+{
+public:
+	GL4StreamBuffer(unsigned int numBytes);
+	~GL4StreamBuffer();
+
+	// False when the storage couldn't be created or mapped.
+	inline bool IsValid() const;
+	inline GLuint GetGLHandle() const;
+	inline StreamRing const& GetRing() const;
+
+	// Copies the data to a slice of the ring. The offset of the slice is
+	// StreamRing::Invalid when the frame in progress has filled the ring.
+	StreamRing::Slice Write(void const* data, unsigned int numBytes, unsigned int alignment);
+
+	// Fences the commands of the frame and retires the frames already done.
+	void EndFrame();
+
+	// Allocations of the last frame which had to wait for the GPU.
+	inline unsigned int GetLastFrameWaits() const;
+
+private:
+	struct Fence
+	{
+		uint64_t mFrame;
+		GLsync mSync;
+	};
+
+	// Retires the oldest frame, waiting for it or only if it is done.
+	bool RetireOldestFrame(bool wait);
+
+	GLuint mGLHandle;
+	char* mMappedData;
+	StreamRing mRing;
+	eastl::vector<Fence> mFences;
+
+	unsigned int mFrameWaits;
+	unsigned int mLastFrameWaits;
+};
+
+inline bool GL4StreamBuffer::IsValid() const
+{
+	return mMappedData != nullptr;
+}
+
+inline GLuint GL4StreamBuffer::GetGLHandle() const
+{
+	return mGLHandle;
+}
+
+inline StreamRing const& GL4StreamBuffer::GetRing() const
+{
+	return mRing;
+}
+
+inline unsigned int GL4StreamBuffer::GetLastFrameWaits() const
+{
+	return mLastFrameWaits;
+}
+
+#endif
@@ -64,8 +64,8 @@ void GL4Texture2::LoadTextureLevel(unsigned int level, void const* data)
     auto texture = GetTexture();
     if (texture && level < texture->GetNumLevels())
     {
-        auto width = texture->GetDimension(0);
-        auto height = texture->GetDimension(1);
+        auto width = texture->GetDimensionFor(level, 0);
+        auto height = texture->GetDimensionFor(level, 1);
 
         glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height,
             mExternalFormat, mExternalType, data);
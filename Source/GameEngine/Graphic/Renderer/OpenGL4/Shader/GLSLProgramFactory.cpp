@@ -11,6 +11,8 @@
 #include "Core/IO/ResourceCache.h"
 #include "Core/Utility/StringUtil.h"
 
+#include "Graphic/Shader/ProgramCache.h"
+
 #include "GLSLShaderResource.h"
 #include "GLSLComputeProgram.h"
 #include "GLSLProgramFactory.h"
@@ -24,6 +26,27 @@ eastl::string GLSLProgramFactory::defaultGSEntry = "main";
 eastl::string GLSLProgramFactory::defaultCSEntry = "main";
 unsigned int GLSLProgramFactory::defaultFlags = 0;  // unused in GLSL for now
 
+namespace
+{
+    bool ReadSource(eastl::string const& file, eastl::string& source)
+    {
+        BaseReadFile* shaderFile = FileSystem::Get()->CreateReadFile(
+            ToWideString(FileSystem::Get()->GetPath(file).c_str()));
+        if (shaderFile == nullptr)
+        {
+            return false;
+        }
+
+        source.resize(shaderFile->GetSize());
+        if (!source.empty())
+        {
+            shaderFile->Read(&source[0], shaderFile->GetSize());
+        }
+        delete shaderFile;
+        return true;
+    }
+}
+
 GLSLProgramFactory::GLSLProgramFactory()
 {
     version = defaultVersion;
@@ -39,26 +62,41 @@ eastl::shared_ptr<VisualProgram> GLSLProgramFactory::CreateFromNamedFiles(
 	eastl::string const&, eastl::string const& psFile,
 	eastl::string const&, eastl::string const& gsFile)
 {
+	// The sources are read first to look the program up in the cache.
+	eastl::string vsSource, psSource, gsSource;
+	if (!ReadSource(vsFile, vsSource))
+	{
+		LogError("A program must have a vertex shader");
+		return nullptr;
+	}
+	if (!ReadSource(psFile, psSource))
+	{
+		LogError("A program must have a pixel shader.");
+		return nullptr;
+	}
+	if (!gsFile.empty())
+	{
+		ReadSource(gsFile, gsSource);
+	}
+
+	uint64_t key = 0;
+	if (ProgramCache::Get())
+	{
+		key = GetProgramKey(vsSource, psSource, gsSource);
+		eastl::shared_ptr<VisualProgram> program = CreateFromCache(key, !gsSource.empty());
+		if (program)
+		{
+			return program;
+		}
+	}
+
 	eastl::shared_ptr<ResHandle> resHandle =
 		ResCache::Get()->GetHandle(&BaseResource(ToWideString(vsFile.c_str())));
 	const eastl::shared_ptr<GLSLShaderResourceExtraData>& vsHandle =
 		eastl::static_pointer_cast<GLSLShaderResourceExtraData>(resHandle->GetExtra());
 	if (!vsHandle->GetShader())
 	{
-		BaseReadFile* vertexFile = FileSystem::Get()->CreateReadFile(
-			ToWideString(FileSystem::Get()->GetPath(vsFile).c_str()));
-		if (vertexFile == nullptr)
-		{
-			LogError("A program must have a vertex shader");
-			delete vertexFile;
-			return nullptr;
-		}
-
-		char* vsSource = new char[vertexFile->GetSize() + 1];
-		memset(vsSource, 0, vertexFile->GetSize() + 1);
-		vertexFile->Read(vsSource, vertexFile->GetSize());
 		vsHandle->GetShader() = Compile(GL_VERTEX_SHADER, vsSource);
-		delete vertexFile;
 		if (!vsHandle->GetShader())
 		{
 			return nullptr;
@@ -70,20 +108,7 @@ eastl::shared_ptr<VisualProgram> GLSLProgramFactory::CreateFromNamedFiles(
 		eastl::static_pointer_cast<GLSLShaderResourceExtraData>(resHandle->GetExtra());
 	if (!psHandle->GetShader())
 	{
-		BaseReadFile* pixelFile = FileSystem::Get()->CreateReadFile(
-			ToWideString(FileSystem::Get()->GetPath(psFile).c_str()));
-		if (pixelFile == nullptr)
-		{
-			LogError("A program must have a pixel shader.");
-			delete pixelFile;
-			return nullptr;
-		}
-
-		char* psSource = new char[pixelFile->GetSize() + 1];
-		memset(psSource, 0, pixelFile->GetSize() + 1);
-		pixelFile->Read(psSource, pixelFile->GetSize());
 		psHandle->GetShader() = Compile(GL_FRAGMENT_SHADER, psSource);
-		delete pixelFile;
 		if (!psHandle->GetShader())
 		{
 			return nullptr;
@@ -96,21 +121,12 @@ eastl::shared_ptr<VisualProgram> GLSLProgramFactory::CreateFromNamedFiles(
 	const eastl::shared_ptr<GLSLShaderResourceExtraData>& gsHandle = resHandle ? 
 		eastl::static_pointer_cast<GLSLShaderResourceExtraData>(resHandle->GetExtra()) : 
 		eastl::make_shared<GLSLShaderResourceExtraData>();
-	if (!gsHandle->GetShader())
+	if (!gsHandle->GetShader() && !gsSource.empty())
 	{
-		BaseReadFile* geometryFile = FileSystem::Get()->CreateReadFile(
-			ToWideString(FileSystem::Get()->GetPath(gsFile).c_str()));
-		if (geometryFile != nullptr)
+		gsHandle->GetShader() = Compile(GL_GEOMETRY_SHADER, gsSource);
+		if (!gsHandle->GetShader())
 		{
-			char* gsSource = new char[geometryFile->GetSize() + 1];
-			memset(gsSource, 0, geometryFile->GetSize() + 1);
-			geometryFile->Read(gsSource, geometryFile->GetSize());
-			gsHandle->GetShader() = Compile(GL_GEOMETRY_SHADER, gsSource);
-			delete geometryFile;
-			if (!gsHandle->GetShader())
-			{
-				return nullptr;
-			}
+			return nullptr;
 		}
 	}
 
@@ -128,6 +144,11 @@ eastl::shared_ptr<VisualProgram> GLSLProgramFactory::CreateFromNamedFiles(
 		glAttachShader(programHandle, gsHandle->GetShader());
 	}
 
+	if (ProgramCache::Get())
+	{
+		glProgramParameteri(programHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
 	if (!Link(programHandle))
 	{
 		glDetachShader(programHandle, vsHandle->GetShader());
@@ -153,6 +174,11 @@ eastl::shared_ptr<VisualProgram> GLSLProgramFactory::CreateFromNamedFiles(
 	{
 		program->SetGShader(eastl::make_shared<GeometryShader>(reflector));
 	}
+
+	if (ProgramCache::Get())
+	{
+		StoreInCache(key, *program);
+	}
 	return program;
 }
 
@@ -167,6 +193,17 @@ eastl::shared_ptr<VisualProgram> GLSLProgramFactory::CreateFromNamedSources(
         return nullptr;
     }
 
+    uint64_t key = 0;
+    if (ProgramCache::Get())
+    {
+        key = GetProgramKey(vsSource, psSource, gsSource);
+        eastl::shared_ptr<VisualProgram> program = CreateFromCache(key, gsSource != "");
+        if (program)
+        {
+            return program;
+        }
+    }
+
     GLuint vsHandle = Compile(GL_VERTEX_SHADER, vsSource);
     if (vsHandle == 0)
     {
@@ -203,6 +240,11 @@ eastl::shared_ptr<VisualProgram> GLSLProgramFactory::CreateFromNamedSources(
         glAttachShader(programHandle, gsHandle);
     }
 
+    if (ProgramCache::Get())
+    {
+        glProgramParameteri(programHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     if (!Link(programHandle))
     {
         glDetachShader(programHandle, vsHandle);
@@ -228,6 +270,11 @@ eastl::shared_ptr<VisualProgram> GLSLProgramFactory::CreateFromNamedSources(
     {
         program->SetGShader(eastl::make_shared<GeometryShader>(reflector));
     }
+
+    if (ProgramCache::Get())
+    {
+        StoreInCache(key, *program);
+    }
     return program;
 }
 
@@ -419,3 +466,142 @@ bool GLSLProgramFactory::Link(GLuint programHandle)
         return true;
     }
 }
+
+eastl::string GLSLProgramFactory::GetBackendVersion() const
+{
+    eastl::string backendVersion;
+    GLenum const names[3] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (int i = 0; i < 3; ++i)
+    {
+        GLubyte const* name = glGetString(names[i]);
+        if (name)
+        {
+            backendVersion += reinterpret_cast<char const*>(name);
+        }
+        backendVersion += "\n";
+    }
+    return backendVersion;
+}
+
+uint64_t GLSLProgramFactory::GetProgramKey(eastl::string const& vsSource,
+    eastl::string const& psSource, eastl::string const& gsSource) const
+{
+    // The conventions Compile prepends to the sources.
+    unsigned int conventions = 0;
+#if defined(GTE_USE_MAT_VEC)
+    conventions |= 1;
+#endif
+#if defined(GTE_USE_ROW_MAJOR)
+    conventions |= 2;
+#endif
+
+    uint64_t key = ProgramCache::KeyBasis;
+    key = ProgramCache::HashKey(key, static_cast<unsigned int>(GetAPI()));
+    key = ProgramCache::HashKey(key, conventions);
+    key = ProgramCache::HashKey(key, version);
+    key = ProgramCache::HashKey(key, flags);
+    key = ProgramCache::HashKey(key, defines);
+    key = ProgramCache::HashKey(key, vsSource);
+    key = ProgramCache::HashKey(key, psSource);
+    key = ProgramCache::HashKey(key, gsSource);
+    return key;
+}
+
+eastl::shared_ptr<VisualProgram> GLSLProgramFactory::CreateFromCache(
+    uint64_t key, bool hasGShader)
+{
+    ProgramCache::Program data;
+    if (!ProgramCache::Get()->Find(key, data))
+    {
+        return nullptr;
+    }
+
+    // The data starts with the binary format and the binary length.
+    GLenum binaryFormat = 0;
+    GLint binaryLength = 0;
+    size_t const headerSize = sizeof(binaryFormat) + sizeof(binaryLength);
+    if (data.size() >= headerSize)
+    {
+        memcpy(&binaryFormat, data.data(), sizeof(binaryFormat));
+        memcpy(&binaryLength, data.data() + sizeof(binaryFormat), sizeof(binaryLength));
+    }
+    if (data.size() < headerSize || binaryLength <= 0 ||
+        static_cast<size_t>(binaryLength) > data.size() - headerSize)
+    {
+        LogWarning("Corrupted program in the program cache.");
+        ProgramCache::Get()->Remove(key);
+        return nullptr;
+    }
+
+    GLuint programHandle = glCreateProgram();
+    if (programHandle == 0)
+    {
+        LogError("Program creation failed.");
+        return nullptr;
+    }
+
+    // A driver update makes the binary unusable, which is reported as a
+    // link failure.
+    glProgramBinary(programHandle, binaryFormat, data.data() + headerSize, binaryLength);
+    GLint status;
+    glGetProgramiv(programHandle, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE)
+    {
+        LogInformation("Outdated program binary, the program is compiled again.");
+        glDeleteProgram(programHandle);
+        ProgramCache::Get()->Remove(key);
+        return nullptr;
+    }
+
+    size_t const reflectionOffset = headerSize + binaryLength;
+    eastl::shared_ptr<GLSLReflection> reflector = GLSLReflection::Deserialize(
+        programHandle, data.data() + reflectionOffset, data.size() - reflectionOffset);
+    if (!reflector)
+    {
+        glDeleteProgram(programHandle);
+        ProgramCache::Get()->Remove(key);
+        return nullptr;
+    }
+
+    eastl::shared_ptr<GLSLVisualProgram> program =
+        eastl::make_shared<GLSLVisualProgram>(programHandle, *reflector);
+
+    program->SetVShader(eastl::make_shared<VertexShader>(*reflector));
+    program->SetPShader(eastl::make_shared<PixelShader>(*reflector));
+    if (hasGShader)
+    {
+        program->SetGShader(eastl::make_shared<GeometryShader>(*reflector));
+    }
+    return program;
+}
+
+void GLSLProgramFactory::StoreInCache(uint64_t key, GLSLVisualProgram const& program)
+{
+    GLuint programHandle = program.GetProgramHandle();
+    GLint binaryLength = 0;
+    glGetProgramiv(programHandle, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+    {
+        // The driver has no binary format.
+        return;
+    }
+
+    GLenum binaryFormat = 0;
+    size_t const headerSize = sizeof(binaryFormat) + sizeof(binaryLength);
+    ProgramCache::Program data(headerSize + binaryLength);
+    GLsizei numWritten = 0;
+    glGetProgramBinary(programHandle, binaryLength, &numWritten, &binaryFormat,
+        data.data() + headerSize);
+    if (numWritten <= 0)
+    {
+        return;
+    }
+
+    binaryLength = numWritten;
+    data.resize(headerSize + binaryLength);
+    memcpy(data.data(), &binaryFormat, sizeof(binaryFormat));
+    memcpy(data.data() + sizeof(binaryFormat), &binaryLength, sizeof(binaryLength));
+    program.GetReflector().Serialize(data);
+
+    ProgramCache::Get()->Store(key, data.data(), data.size());
+}
@@ -11,6 +11,8 @@
 #include "Graphic/Shader/ProgramFactory.h"
 #include "Graphic/Renderer/OpenGL4/OpenGL.h"
 
+class GLSLVisualProgram;
+
 class GRAPHIC_ITEM GLSLProgramFactory : public ProgramFactory
 {
 public:
@@ -32,6 +34,9 @@ public:
     // corresponding to shader programs.
     inline virtual int GetAPI() const override;
 
+    // The vendor, renderer and version strings of the active context.
+    virtual eastl::string GetBackendVersion() const override;
+
     // GLSLVisualProgram and GLSLComputeProgram objects are responsible
     // for destroying the shaders and program.  The factory wraps the
     // program objects as shared pointers to allow automatic clean-up.
@@ -67,6 +72,15 @@ private:
 
     GLuint Compile(GLenum shaderType, eastl::string const& source);
     bool Link(GLuint programHandle);
+
+    // Support for the program cache.  A visual program is saved as the
+    // program binary followed by its reflection.  A binary the driver
+    // refuses is removed from the cache and the program is compiled again.
+    // Compute programs are not cached.
+    uint64_t GetProgramKey(eastl::string const& vsSource,
+        eastl::string const& psSource, eastl::string const& gsSource) const;
+    eastl::shared_ptr<VisualProgram> CreateFromCache(uint64_t key, bool hasGShader);
+    void StoreInCache(uint64_t key, GLSLVisualProgram const& program);
 };
 
 inline int GLSLProgramFactory::GetAPI() const
@@ -11,6 +11,334 @@
 #include "GLSLReflection.h"
 #include <fstream>
 
+namespace
+{
+    // Support for Serialize and Deserialize.  The reader fails instead of
+    // reading past the end of the data.
+    class ReflectionWriter
+    {
+    public:
+        ReflectionWriter(eastl::vector<char>& data) : mData(data) {}
+
+        void Write(void const* values, size_t numBytes)
+        {
+            char const* bytes = static_cast<char const*>(values);
+            mData.insert(mData.end(), bytes, bytes + numBytes);
+        }
+
+        void Write(GLint value)
+        {
+            Write(&value, sizeof(value));
+        }
+
+        void Write(eastl::string const& value)
+        {
+            Write(static_cast<GLint>(value.size()));
+            Write(value.data(), value.size());
+        }
+
+        void Write(eastl::vector<GLint> const& values)
+        {
+            Write(static_cast<GLint>(values.size()));
+            Write(values.data(), values.size() * sizeof(GLint));
+        }
+
+    private:
+        eastl::vector<char>& mData;
+    };
+
+    class ReflectionReader
+    {
+    public:
+        ReflectionReader(char const* data, size_t numBytes)
+            : mData(data), mNumBytes(numBytes), mOffset(0) {}
+
+        bool Read(void* values, size_t numBytes)
+        {
+            if (numBytes > mNumBytes - mOffset)
+            {
+                return false;
+            }
+            memcpy(values, mData + mOffset, numBytes);
+            mOffset += numBytes;
+            return true;
+        }
+
+        bool Read(GLint& value)
+        {
+            return Read(&value, sizeof(value));
+        }
+
+        // The number of items is checked against the remaining bytes, each
+        // item taking at least 'itemBytes' bytes.
+        bool ReadCount(GLint& count, size_t itemBytes)
+        {
+            return Read(count) && count >= 0 &&
+                static_cast<size_t>(count) * itemBytes <= mNumBytes - mOffset;
+        }
+
+        bool Read(eastl::string& value)
+        {
+            GLint size;
+            if (!ReadCount(size, 1))
+            {
+                return false;
+            }
+            value.assign(mData + mOffset, mData + mOffset + size);
+            mOffset += size;
+            return true;
+        }
+
+        bool Read(eastl::vector<GLint>& values)
+        {
+            GLint size;
+            if (!ReadCount(size, sizeof(GLint)))
+            {
+                return false;
+            }
+            values.resize(size);
+            return Read(values.data(), size * sizeof(GLint));
+        }
+
+        inline bool IsAtEnd() const { return mOffset == mNumBytes; }
+
+    private:
+        char const* mData;
+        size_t mNumBytes, mOffset;
+    };
+
+    void WriteItem(ReflectionWriter& writer, eastl::string const& item)
+    {
+        writer.Write(item);
+    }
+
+    bool ReadItem(ReflectionReader& reader, eastl::string& item)
+    {
+        return reader.Read(item);
+    }
+
+    void WriteItem(ReflectionWriter& writer, GLSLReflection::Input const& item)
+    {
+        writer.Write(item.name);
+        writer.Write(item.type);
+        writer.Write(item.location);
+        writer.Write(item.arraySize);
+        writer.Write(item.referencedBy, sizeof(item.referencedBy));
+        writer.Write(item.isPerPatch);
+        writer.Write(item.locationComponent);
+    }
+
+    bool ReadItem(ReflectionReader& reader, GLSLReflection::Input& item)
+    {
+        return reader.Read(item.name)
+            && reader.Read(item.type)
+            && reader.Read(item.location)
+            && reader.Read(item.arraySize)
+            && reader.Read(item.referencedBy, sizeof(item.referencedBy))
+            && reader.Read(item.isPerPatch)
+            && reader.Read(item.locationComponent);
+    }
+
+    void WriteItem(ReflectionWriter& writer, GLSLReflection::Output const& item)
+    {
+        writer.Write(item.name);
+        writer.Write(item.type);
+        writer.Write(item.location);
+        writer.Write(item.arraySize);
+        writer.Write(item.referencedBy, sizeof(item.referencedBy));
+        writer.Write(item.isPerPatch);
+        writer.Write(item.locationComponent);
+        writer.Write(item.locationIndex);
+    }
+
+    bool ReadItem(ReflectionReader& reader, GLSLReflection::Output& item)
+    {
+        return reader.Read(item.name)
+            && reader.Read(item.type)
+            && reader.Read(item.location)
+            && reader.Read(item.arraySize)
+            && reader.Read(item.referencedBy, sizeof(item.referencedBy))
+            && reader.Read(item.isPerPatch)
+            && reader.Read(item.locationComponent)
+            && reader.Read(item.locationIndex);
+    }
+
+    void WriteItem(ReflectionWriter& writer, GLSLReflection::Uniform const& item)
+    {
+        writer.Write(item.fullName);
+        writer.Write(item.name);
+        writer.Write(item.type);
+        writer.Write(item.location);
+        writer.Write(item.arraySize);
+        writer.Write(item.offset);
+        writer.Write(item.blockIndex);
+        writer.Write(item.arrayStride);
+        writer.Write(item.matrixStride);
+        writer.Write(item.isRowMajor);
+        writer.Write(item.atomicCounterBufferIndex);
+        writer.Write(item.referencedBy, sizeof(item.referencedBy));
+    }
+
+    bool ReadItem(ReflectionReader& reader, GLSLReflection::Uniform& item)
+    {
+        return reader.Read(item.fullName)
+            && reader.Read(item.name)
+            && reader.Read(item.type)
+            && reader.Read(item.location)
+            && reader.Read(item.arraySize)
+            && reader.Read(item.offset)
+            && reader.Read(item.blockIndex)
+            && reader.Read(item.arrayStride)
+            && reader.Read(item.matrixStride)
+            && reader.Read(item.isRowMajor)
+            && reader.Read(item.atomicCounterBufferIndex)
+            && reader.Read(item.referencedBy, sizeof(item.referencedBy));
+    }
+
+    void WriteItem(ReflectionWriter& writer, GLSLReflection::DataBlock const& item)
+    {
+        writer.Write(item.name);
+        writer.Write(item.bufferBinding);
+        writer.Write(item.bufferDataSize);
+        writer.Write(item.referencedBy, sizeof(item.referencedBy));
+        writer.Write(item.activeVariables);
+    }
+
+    bool ReadItem(ReflectionReader& reader, GLSLReflection::DataBlock& item)
+    {
+        return reader.Read(item.name)
+            && reader.Read(item.bufferBinding)
+            && reader.Read(item.bufferDataSize)
+            && reader.Read(item.referencedBy, sizeof(item.referencedBy))
+            && reader.Read(item.activeVariables);
+    }
+
+    void WriteItem(ReflectionWriter& writer, GLSLReflection::AtomicCounterBuffer const& item)
+    {
+        writer.Write(item.bufferBinding);
+        writer.Write(item.bufferDataSize);
+        writer.Write(item.referencedBy, sizeof(item.referencedBy));
+        writer.Write(item.activeVariables);
+    }
+
+    bool ReadItem(ReflectionReader& reader, GLSLReflection::AtomicCounterBuffer& item)
+    {
+        return reader.Read(item.bufferBinding)
+            && reader.Read(item.bufferDataSize)
+            && reader.Read(item.referencedBy, sizeof(item.referencedBy))
+            && reader.Read(item.activeVariables);
+    }
+
+    void WriteItem(ReflectionWriter& writer, GLSLReflection::SubroutineUniform const& item)
+    {
+        writer.Write(item.name);
+        writer.Write(item.location);
+        writer.Write(item.arraySize);
+        writer.Write(item.compatibleSubroutines);
+    }
+
+    bool ReadItem(ReflectionReader& reader, GLSLReflection::SubroutineUniform& item)
+    {
+        return reader.Read(item.name)
+            && reader.Read(item.location)
+            && reader.Read(item.arraySize)
+            && reader.Read(item.compatibleSubroutines);
+    }
+
+    void WriteItem(ReflectionWriter& writer, GLSLReflection::BufferVariable const& item)
+    {
+        writer.Write(item.fullName);
+        writer.Write(item.name);
+        writer.Write(item.type);
+        writer.Write(item.arraySize);
+        writer.Write(item.offset);
+        writer.Write(item.blockIndex);
+        writer.Write(item.arrayStride);
+        writer.Write(item.matrixStride);
+        writer.Write(item.isRowMajor);
+        writer.Write(item.topLevelArraySize);
+        writer.Write(item.topLevelArrayStride);
+        writer.Write(item.referencedBy, sizeof(item.referencedBy));
+    }
+
+    bool ReadItem(ReflectionReader& reader, GLSLReflection::BufferVariable& item)
+    {
+        return reader.Read(item.fullName)
+            && reader.Read(item.name)
+            && reader.Read(item.type)
+            && reader.Read(item.arraySize)
+            && reader.Read(item.offset)
+            && reader.Read(item.blockIndex)
+            && reader.Read(item.arrayStride)
+            && reader.Read(item.matrixStride)
+            && reader.Read(item.isRowMajor)
+            && reader.Read(item.topLevelArraySize)
+            && reader.Read(item.topLevelArrayStride)
+            && reader.Read(item.referencedBy, sizeof(item.referencedBy));
+    }
+
+    void WriteItem(ReflectionWriter& writer, GLSLReflection::TransformFeedbackVarying const& item)
+    {
+        writer.Write(item.name);
+        writer.Write(item.type);
+        writer.Write(item.arraySize);
+        writer.Write(item.offset);
+        writer.Write(item.transformFeedbackBufferIndex);
+    }
+
+    bool ReadItem(ReflectionReader& reader, GLSLReflection::TransformFeedbackVarying& item)
+    {
+        return reader.Read(item.name)
+            && reader.Read(item.type)
+            && reader.Read(item.arraySize)
+            && reader.Read(item.offset)
+            && reader.Read(item.transformFeedbackBufferIndex);
+    }
+
+    void WriteItem(ReflectionWriter& writer, GLSLReflection::TransformFeedbackBuffer const& item)
+    {
+        writer.Write(item.bufferBinding);
+        writer.Write(item.transformFeedbackBufferStride);
+        writer.Write(item.activeVariables);
+    }
+
+    bool ReadItem(ReflectionReader& reader, GLSLReflection::TransformFeedbackBuffer& item)
+    {
+        return reader.Read(item.bufferBinding)
+            && reader.Read(item.transformFeedbackBufferStride)
+            && reader.Read(item.activeVariables);
+    }
+
+    template <typename Item>
+    void WriteItems(ReflectionWriter& writer, eastl::vector<Item> const& items)
+    {
+        writer.Write(static_cast<GLint>(items.size()));
+        for (auto const& item : items)
+        {
+            WriteItem(writer, item);
+        }
+    }
+
+    template <typename Item>
+    bool ReadItems(ReflectionReader& reader, eastl::vector<Item>& items)
+    {
+        GLint numItems;
+        if (!reader.ReadCount(numItems, sizeof(GLint)))
+        {
+            return false;
+        }
+        items.resize(numItems);
+        for (auto& item : items)
+        {
+            if (!ReadItem(reader, item))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
 
 GLSLReflection::GLSLReflection(GLuint handle)
     :
@@ -72,6 +400,78 @@ void GLSLReflection::GetComputeShaderWorkGroupSize(GLint &numXThreads, GLint& nu
     numZThreads = workGroupSize[2];
 }
 
+GLSLReflection::GLSLReflection()
+    :
+    mHandle(0),
+    mVendorIsIntel(false)
+{
+}
+
+void GLSLReflection::Serialize(eastl::vector<char>& data) const
+{
+    ReflectionWriter writer(data);
+    WriteItems(writer, mInputs);
+    WriteItems(writer, mOutputs);
+    WriteItems(writer, mUniforms);
+    WriteItems(writer, mUniformBlocks);
+    WriteItems(writer, mShaderStorageBlocks);
+    WriteItems(writer, mAtomicCounterBuffers);
+    WriteItems(writer, mVertexSubroutines);
+    WriteItems(writer, mGeometrySubroutines);
+    WriteItems(writer, mPixelSubroutines);
+    WriteItems(writer, mComputeSubroutines);
+    WriteItems(writer, mTessControlSubroutines);
+    WriteItems(writer, mTessEvaluationSubroutines);
+    WriteItems(writer, mVertexSubroutineUniforms);
+    WriteItems(writer, mGeometrySubroutineUniforms);
+    WriteItems(writer, mPixelSubroutineUniforms);
+    WriteItems(writer, mComputeSubroutineUniforms);
+    WriteItems(writer, mTessControlSubroutineUniforms);
+    WriteItems(writer, mTessEvaluationSubroutineUniforms);
+    WriteItems(writer, mBufferVariables);
+    WriteItems(writer, mTransformFeedbackVaryings);
+    WriteItems(writer, mTransformFeedbackBuffers);
+}
+
+eastl::shared_ptr<GLSLReflection> GLSLReflection::Deserialize(GLuint handle,
+    char const* data, size_t numBytes)
+{
+    eastl::shared_ptr<GLSLReflection> reflection(new GLSLReflection());
+    reflection->mHandle = handle;
+
+    ReflectionReader reader(data, numBytes);
+    bool loaded =
+        ReadItems(reader, reflection->mInputs) &&
+        ReadItems(reader, reflection->mOutputs) &&
+        ReadItems(reader, reflection->mUniforms) &&
+        ReadItems(reader, reflection->mUniformBlocks) &&
+        ReadItems(reader, reflection->mShaderStorageBlocks) &&
+        ReadItems(reader, reflection->mAtomicCounterBuffers) &&
+        ReadItems(reader, reflection->mVertexSubroutines) &&
+        ReadItems(reader, reflection->mGeometrySubroutines) &&
+        ReadItems(reader, reflection->mPixelSubroutines) &&
+        ReadItems(reader, reflection->mComputeSubroutines) &&
+        ReadItems(reader, reflection->mTessControlSubroutines) &&
+        ReadItems(reader, reflection->mTessEvaluationSubroutines) &&
+        ReadItems(reader, reflection->mVertexSubroutineUniforms) &&
+        ReadItems(reader, reflection->mGeometrySubroutineUniforms) &&
+        ReadItems(reader, reflection->mPixelSubroutineUniforms) &&
+        ReadItems(reader, reflection->mComputeSubroutineUniforms) &&
+        ReadItems(reader, reflection->mTessControlSubroutineUniforms) &&
+        ReadItems(reader, reflection->mTessEvaluationSubroutineUniforms) &&
+        ReadItems(reader, reflection->mBufferVariables) &&
+        ReadItems(reader, reflection->mTransformFeedbackVaryings) &&
+        ReadItems(reader, reflection->mTransformFeedbackBuffers) &&
+        reader.IsAtEnd();
+
+    if (!loaded)
+    {
+        LogError("The reflection data is corrupted.");
+        return nullptr;
+    }
+    return reflection;
+}
+
 void GLSLReflection::Print(std::ofstream& ostr) const
 {
     // TODO: need some type of pre-amble
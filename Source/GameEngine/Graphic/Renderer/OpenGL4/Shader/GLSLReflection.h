@@ -145,7 +145,18 @@ public:
     // Print to a text file for human readability.
     void Print(std::ofstream& output) const;
 
+    // Support for saving the reflection with the binary of the program, so
+    // that a program created from its binary is not queried again.  The
+    // handle passed to Deserialize is the program created from the binary.
+    // Deserialize returns nullptr when the data is corrupted.
+    void Serialize(eastl::vector<char>& data) const;
+    static eastl::shared_ptr<GLSLReflection> Deserialize(GLuint handle,
+        char const* data, size_t numBytes);
+
 private:
+    // Construction for Deserialize, the members are read from the data.
+    GLSLReflection();
+
     void ReflectProgramInputs();
     void ReflectProgramOutputs();
     void ReflectUniforms();
@@ -22,3 +22,14 @@ GLSLVisualProgram::GLSLVisualProgram(GLuint programHandle,
     mReflector(programHandle)
 {
 }
+
+GLSLVisualProgram::GLSLVisualProgram(GLuint programHandle,
+    GLSLReflection const& reflector)
+    :
+    mProgramHandle(programHandle),
+    mVShaderHandle(0),
+    mPShaderHandle(0),
+    mGShaderHandle(0),
+    mReflector(reflector)
+{
+}
@@ -26,6 +26,10 @@ public:
     GLSLVisualProgram(GLuint programHandle, GLuint vshaderHandle,
         GLuint pshaderHandle, GLuint gshaderHandle);
 
+    // Construction for a program created from its binary, which has no
+    // shader objects.  The reflection was saved with the binary.
+    GLSLVisualProgram(GLuint programHandle, GLSLReflection const& reflector);
+
     // Member access.  GLEngine needs the program handle for enabling and
     // disabling the program.  TODO: Do we need the Get*ShaderHandle
     // functions?
@@ -48,6 +48,11 @@ void WGLRenderer::DisplayColorBuffer(unsigned int syncInterval)
 {
     wglSwapIntervalEXT(syncInterval > 0 ? 1 : 0);
     SwapBuffers(mDevice);
+    mStateTracker.EndFrame();
+    if (mStreamBuffer)
+    {
+        mStreamBuffer->EndFrame();
+    }
 }
 
 bool WGLRenderer::Initialize(int requiredMajor, int requiredMinor)
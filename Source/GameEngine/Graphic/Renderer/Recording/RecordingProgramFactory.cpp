@@ -0,0 +1,47 @@
+//========================================================================
+// RecordingProgramFactory.cpp : Program factory of the recording renderer,
+// which creates programs without compiling any shader.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "RecordingProgramFactory.h"
+
+#include "Graphic/Shader/VisualProgram.h"
+#include "Graphic/Shader/ComputeProgram.h"
+
+RecordingProgramFactory::RecordingProgramFactory()
+{
+}
+
+eastl::string RecordingProgramFactory::GetBackendVersion() const
+{
+	return "Recording";
+}
+
+eastl::shared_ptr<VisualProgram> RecordingProgramFactory::CreateFromNamedFiles(
+	eastl::string const&, eastl::string const&, eastl::string const&,
+	eastl::string const&, eastl::string const&, eastl::string const&)
+{
+	return eastl::make_shared<VisualProgram>();
+}
+
+eastl::shared_ptr<VisualProgram> RecordingProgramFactory::CreateFromNamedSources(
+	eastl::string const&, eastl::string const&, eastl::string const&,
+	eastl::string const&, eastl::string const&, eastl::string const&)
+{
+	return eastl::make_shared<VisualProgram>();
+}
+
+eastl::shared_ptr<ComputeProgram> RecordingProgramFactory::CreateFromNamedFile(
+	eastl::string const&, eastl::string const&)
+{
+	return eastl::make_shared<ComputeProgram>();
+}
+
+eastl::shared_ptr<ComputeProgram> RecordingProgramFactory::CreateFromNamedSource(
+	eastl::string const&, eastl::string const&)
+{
+	return eastl::make_shared<ComputeProgram>();
+}
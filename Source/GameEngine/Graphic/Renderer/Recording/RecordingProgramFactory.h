@@ -0,0 +1,53 @@
+//========================================================================
+// RecordingProgramFactory.h : Program factory of the recording renderer,
+// which creates programs without compiling any shader.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef RECORDINGPROGRAMFACTORY_H
+#define RECORDINGPROGRAMFACTORY_H
+
+#include "Graphic/Shader/ProgramFactory.h"
+
+// The programs have no shaders, so effects built on VisualEffect or
+// ComputeProgram directly can be drawn by the recording renderer without a
+// shader compiler. Each program is a distinct object and gets its own id in
+// the recorded commands. The effects which set shader constants in their
+// constructor need a real factory.
+class GRAPHIC_ITEM RecordingProgramFactory : public ProgramFactory
+{
+public:
+	RecordingProgramFactory();
+
+	// The shader sources are looked up as the GLSL ones; they are never
+	// compiled.
+	inline virtual int GetAPI() const override;
+
+	virtual eastl::string GetBackendVersion() const override;
+
+private:
+	virtual eastl::shared_ptr<VisualProgram> CreateFromNamedFiles(
+		eastl::string const& vsName, eastl::string const& vsFile,
+		eastl::string const& psName, eastl::string const& psFile,
+		eastl::string const& gsName, eastl::string const& gsFile) override;
+
+	virtual eastl::shared_ptr<VisualProgram> CreateFromNamedSources(
+		eastl::string const& vsName, eastl::string const& vsSource,
+		eastl::string const& psName, eastl::string const& psSource,
+		eastl::string const& gsName, eastl::string const& gsSource) override;
+
+	virtual eastl::shared_ptr<ComputeProgram> CreateFromNamedFile(
+		eastl::string const& csName, eastl::string const& csFile) override;
+
+	virtual eastl::shared_ptr<ComputeProgram> CreateFromNamedSource(
+		eastl::string const& csName, eastl::string const& csSource) override;
+};
+
+inline int RecordingProgramFactory::GetAPI() const
+{
+	return PF_GLSL;
+}
+
+#endif
@@ -0,0 +1,707 @@
+//========================================================================
+// RecordingRenderer.cpp : Renderer without a graphics API which records
+// each frame as a list of compact commands.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "Graphic/Graphic.h"
+
+#include "RecordingRenderer.h"
+
+#include "Core/OS/OS.h"
+
+#include <fstream>
+
+namespace
+{
+	const uint32_t CaptureMagic = 0x43524547; // "GERC"
+	const uint32_t CaptureVersion = 1;
+
+	struct CaptureHeader
+	{
+		uint32_t mMagic;
+		uint32_t mVersion;
+		uint32_t mNumCommands;
+	};
+
+	// There are no input layouts without a graphics API, but the renderer
+	// unbinds vertex buffers and shaders through the manager.
+	class RecordedInputLayoutManager : public InputLayoutManager
+	{
+	public:
+		virtual bool Unbind(VertexBuffer const*) override { return false; }
+		virtual bool Unbind(Shader const*) override { return false; }
+		virtual void UnbindAll() override { }
+		virtual bool HasElements() const override { return false; }
+	};
+
+	inline uint32_t FloatBits(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+}
+
+// The bridge object of a front-end object. It records its destruction.
+class RecordingRenderer::RecordedObject : public GraphicObject
+{
+public:
+	RecordedObject(RecordingRenderer* renderer, GraphicObject const* object, uint32_t id)
+		:
+		mRenderer(renderer),
+		mId(id)
+	{
+		mType = object->GetType();
+	}
+
+	~RecordedObject()
+	{
+		mRenderer->Record(CT_DESTROY, mId);
+	}
+
+	uint32_t GetId() const
+	{
+		return mId;
+	}
+
+private:
+	RecordingRenderer* mRenderer;
+	uint32_t mId;
+};
+
+RecordingRenderer::Statistics::Statistics()
+	:
+	mNumStateChanges(0),
+	mNumPrimitives(0),
+	mNumBytesUploaded(0),
+	mNumBytesStreamed(0),
+	mNumStreamWaits(0)
+{
+	memset(mNumCommands, 0, sizeof(mNumCommands));
+}
+
+RecordingRenderer::RecordingRenderer(unsigned int width, unsigned int height, bool setAsGlobal)
+	:
+	Renderer(setAsGlobal),
+	mNextId(1),
+	mViewportX(0), mViewportY(0), mViewportWidth(0), mViewportHeight(0),
+	mDepthRangeMin(0.f), mDepthRangeMax(1.f),
+	mStreamRing(StreamBufferSize)
+{
+	mLastStates.fill(0);
+	mScreenSize = Vector2<unsigned int>{ width, height };
+
+	// Renderer only listens for the destruction of the front-end objects
+	// when it is the global one, their bridges must go away all the same.
+	if (!setAsGlobal)
+	{
+		mGOListener = eastl::make_shared<GOListener>(this);
+		GraphicObject::SubscribeForDestruction(mGOListener);
+
+		mDTListener = eastl::make_shared<DTListener>(this);
+		DrawTarget::SubscribeForDestruction(mDTListener);
+	}
+
+	mInputLayouts = eastl::make_unique<RecordedInputLayoutManager>();
+
+	// Every concrete type gets a bridge object, the abstract ones none.
+	for (int type = 0; type < GE_NUM_TYPES; ++type)
+	{
+		switch (type)
+		{
+		case GE_GRAPHICS_OBJECT:
+		case GE_RESOURCE:
+		case GE_BUFFER:
+		case GE_TEXTURE:
+		case GE_TEXTURE_SINGLE:
+		case GE_TEXTURE_ARRAY:
+		case GE_SHADER:
+		case GE_DRAWING_STATE:
+			break;
+		default:
+			mCreateGraphicObject[type] = &RecordingRenderer::CreateObject;
+			break;
+		}
+	}
+	mGraphicObjectCreator = this;
+	mCreateDrawTarget = &RecordingRenderer::CreateDrawTarget;
+
+	SetViewport(0, 0, width, height);
+	SetDepthRange(0.f, 1.f);
+	CreateDefaultGlobalState();
+}
+
+RecordingRenderer::~RecordingRenderer()
+{
+	Terminate();
+}
+
+void RecordingRenderer::Terminate()
+{
+	// The render state objects (and fonts) are destroyed first so that the
+	// render state objects are removed from the bridges before they are
+	// cleared.
+	if (mDefaultFont)
+	{
+		mDefaultFont = nullptr;
+		mActiveFont = nullptr;
+	}
+	DestroyDefaultGlobalState();
+
+	GraphicObject::UnsubscribeForDestruction(mGOListener);
+	mGOListener = nullptr;
+
+	DrawTarget::UnsubscribeForDestruction(mDTListener);
+	mDTListener = nullptr;
+
+	if (mGraphicObjects.HasElements())
+	{
+		if (mWarnOnNonemptyBridges)
+		{
+			LogWarning("Bridge map is nonempty on destruction.");
+		}
+
+		RemoveAllGraphicObjects();
+	}
+
+	if (mDrawTargets.HasElements())
+	{
+		if (mWarnOnNonemptyBridges)
+		{
+			LogWarning("Draw target map nonempty on destruction.");
+		}
+
+		mDrawTargets.RemoveAll();
+	}
+	mInputLayouts = nullptr;
+}
+
+eastl::shared_ptr<GraphicObject> RecordingRenderer::CreateObject(void* creator, GraphicObject const* object)
+{
+	RecordingRenderer* renderer = reinterpret_cast<RecordingRenderer*>(creator);
+
+	// Creating a resource with data uploads it.
+	uint32_t numBytes = 0;
+	if (object->IsBuffer() || object->IsTexture() || object->IsTextureArray())
+	{
+		Resource const* resource = static_cast<Resource const*>(object);
+		if (resource->GetData())
+		{
+			numBytes = resource->GetNumBytes();
+		}
+	}
+
+	uint32_t id = renderer->mNextId++;
+	renderer->Record(CT_CREATE, id, object->GetType(), numBytes);
+	return eastl::make_shared<RecordedObject>(renderer, object, id);
+}
+
+eastl::shared_ptr<DrawTarget> RecordingRenderer::CreateDrawTarget(DrawTarget const*,
+	eastl::vector<GraphicObject*>&, GraphicObject*)
+{
+	return eastl::make_shared<DrawTarget>();
+}
+
+void RecordingRenderer::Record(CommandType type, uint32_t object,
+	uint32_t arg0, uint32_t arg1, uint32_t arg2, uint32_t arg3)
+{
+	Command command;
+	command.mType = type;
+	command.mObject = object;
+	command.mArgs[0] = arg0;
+	command.mArgs[1] = arg1;
+	command.mArgs[2] = arg2;
+	command.mArgs[3] = arg3;
+	mCommands.push_back(command);
+
+	Execute(command);
+}
+
+uint32_t RecordingRenderer::GetId(GraphicObject* bridge) const
+{
+	return bridge ? static_cast<RecordedObject*>(bridge)->GetId() : 0;
+}
+
+uint32_t RecordingRenderer::GetId(void const* object)
+{
+	if (!object)
+	{
+		return 0;
+	}
+
+	auto itId = mIds.find(object);
+	if (itId != mIds.end())
+	{
+		return itId->second;
+	}
+
+	uint32_t id = mNextId++;
+	mIds[object] = id;
+	return id;
+}
+
+void RecordingRenderer::Execute(Command const& command)
+{
+	if (command.mType >= CT_COUNT)
+	{
+		LogWarning("Unknown recorded command " + eastl::to_string(command.mType));
+		return;
+	}
+
+	mFrameStatistics.mNumCommands[command.mType]++;
+	switch (command.mType)
+	{
+	case CT_CREATE:
+		mFrameStatistics.mNumBytesUploaded += command.mArgs[1];
+		break;
+	case CT_UPDATE:
+		mFrameStatistics.mNumBytesUploaded += command.mArgs[0];
+		break;
+	case CT_ENABLE_TARGET:
+	case CT_BLEND_STATE:
+	case CT_DEPTH_STENCIL_STATE:
+	case CT_RASTERIZER_STATE:
+	case CT_PROGRAM:
+		if (mLastStates[command.mType] != command.mObject)
+		{
+			mLastStates[command.mType] = command.mObject;
+			mFrameStatistics.mNumStateChanges++;
+		}
+		break;
+	case CT_DISABLE_TARGET:
+		mLastStates[CT_ENABLE_TARGET] = 0;
+		mFrameStatistics.mNumStateChanges++;
+		break;
+	case CT_VIEWPORT:
+	case CT_DEPTH_RANGE:
+		mFrameStatistics.mNumStateChanges++;
+		break;
+	case CT_DRAW:
+		mFrameStatistics.mNumPrimitives += command.mArgs[1] * eastl::max(command.mArgs[3], 1u);
+		break;
+	default:
+		break;
+	}
+}
+
+void RecordingRenderer::Enable(eastl::shared_ptr<DrawTarget> const& target)
+{
+	Bind(target);
+	Record(CT_ENABLE_TARGET, GetId(target.get()));
+}
+
+void RecordingRenderer::Disable(eastl::shared_ptr<DrawTarget> const& target)
+{
+	Record(CT_DISABLE_TARGET, GetId(target.get()));
+}
+
+void RecordingRenderer::SetViewport(int x, int y, int w, int h)
+{
+	mViewportX = x;
+	mViewportY = y;
+	mViewportWidth = w;
+	mViewportHeight = h;
+	Record(CT_VIEWPORT, 0, x, y, w, h);
+}
+
+void RecordingRenderer::GetViewport(int& x, int& y, int& w, int& h) const
+{
+	x = mViewportX;
+	y = mViewportY;
+	w = mViewportWidth;
+	h = mViewportHeight;
+}
+
+void RecordingRenderer::SetDepthRange(float zmin, float zmax)
+{
+	mDepthRangeMin = zmin;
+	mDepthRangeMax = zmax;
+	Record(CT_DEPTH_RANGE, 0, FloatBits(zmin), FloatBits(zmax));
+}
+
+void RecordingRenderer::GetDepthRange(float& zmin, float& zmax) const
+{
+	zmin = mDepthRangeMin;
+	zmax = mDepthRangeMax;
+}
+
+bool RecordingRenderer::Resize(unsigned int w, unsigned int h)
+{
+	mScreenSize[0] = w;
+	mScreenSize[1] = h;
+	mViewportWidth = w;
+	mViewportHeight = h;
+	Record(CT_RESIZE, 0, w, h);
+	return true;
+}
+
+void RecordingRenderer::ClearColorBuffer()
+{
+	Record(CT_CLEAR, 0, CF_COLOR);
+}
+
+void RecordingRenderer::ClearDepthBuffer()
+{
+	Record(CT_CLEAR, 0, CF_DEPTH);
+}
+
+void RecordingRenderer::ClearStencilBuffer()
+{
+	Record(CT_CLEAR, 0, CF_STENCIL);
+}
+
+void RecordingRenderer::ClearBuffers()
+{
+	Record(CT_CLEAR, 0, CF_COLOR | CF_DEPTH | CF_STENCIL);
+}
+
+void RecordingRenderer::DisplayColorBuffer(unsigned int syncInterval)
+{
+	Record(CT_PRESENT, 0, syncInterval);
+
+	// The frames ended StreamLatency frames ago are done on the GPU.
+	uint64_t frame = mStreamRing.EndFrame();
+	while (mStreamRing.HasFramesInFlight() &&
+		mStreamRing.GetOldestFrame() + StreamLatency <= frame)
+	{
+		mStreamRing.Retire(mStreamRing.GetOldestFrame());
+	}
+
+	mCapture.swap(mCommands);
+	mCommands.clear();
+
+	// A destroyed target or program may have its address reused, the ids
+	// by address only hold for a frame.
+	mIds.clear();
+
+	mLastFrameStatistics = mFrameStatistics;
+	mFrameStatistics = Statistics();
+}
+
+void RecordingRenderer::SetBlendState(eastl::shared_ptr<BlendState> const& state)
+{
+	if (state)
+	{
+		if (state != mActiveBlendState)
+		{
+			Record(CT_BLEND_STATE, GetId(Bind(state)));
+			mActiveBlendState = state;
+		}
+	}
+	else
+	{
+		LogError("Input state is null.");
+	}
+}
+
+void RecordingRenderer::SetDepthStencilState(eastl::shared_ptr<DepthStencilState> const& state)
+{
+	if (state)
+	{
+		if (state != mActiveDepthStencilState)
+		{
+			Record(CT_DEPTH_STENCIL_STATE, GetId(Bind(state)));
+			mActiveDepthStencilState = state;
+		}
+	}
+	else
+	{
+		LogError("Input state is null.");
+	}
+}
+
+void RecordingRenderer::SetRasterizerState(eastl::shared_ptr<RasterizerState> const& state)
+{
+	if (state)
+	{
+		if (state != mActiveRasterizerState)
+		{
+			Record(CT_RASTERIZER_STATE, GetId(Bind(state)));
+			mActiveRasterizerState = state;
+		}
+	}
+	else
+	{
+		LogError("Input state is null.");
+	}
+}
+
+bool RecordingRenderer::Update(eastl::shared_ptr<Buffer> const& buffer)
+{
+	if (!buffer->GetData())
+	{
+		LogWarning("Buffer does not have system memory, creating it.");
+		buffer->CreateStorage();
+	}
+
+	// The dynamic constant buffers are streamed whole, the dynamic vertex
+	// and index buffers up to the end of their active range.
+	if (buffer->GetUsage() == Resource::DYNAMIC_UPDATE)
+	{
+		uint32_t numBytes = buffer->GetNumBytes();
+		if (buffer->GetType() != GE_CONSTANT_BUFFER)
+		{
+			numBytes = (buffer->GetOffset() + buffer->GetNumActiveElements()) * buffer->GetElementSize();
+		}
+		if (Stream(numBytes))
+		{
+			if (buffer->GetType() == GE_CONSTANT_BUFFER)
+			{
+				static_cast<ConstantBuffer*>(buffer.get())->ClearDirtyRange();
+			}
+			Record(CT_UPDATE, GetId(Bind(buffer)), numBytes);
+			return true;
+		}
+	}
+
+	// Constant buffers only upload the members written since the last one.
+	uint32_t numBytes = buffer->GetNumActiveBytes();
+	if (buffer->GetType() == GE_CONSTANT_BUFFER)
+	{
+		ConstantBuffer* cbuffer = static_cast<ConstantBuffer*>(buffer.get());
+		if (cbuffer->HasDirtyRange())
+		{
+			numBytes = cbuffer->GetNumDirtyBytes();
+		}
+		cbuffer->ClearDirtyRange();
+	}
+
+	Record(CT_UPDATE, GetId(Bind(buffer)), numBytes);
+	return true;
+}
+
+bool RecordingRenderer::Stream(uint32_t numBytes)
+{
+	if (numBytes == 0 || numBytes > mStreamRing.GetNumBytes())
+	{
+		return false;
+	}
+
+	// A full ring waits for the oldest frame as the GL4 backend does.
+	StreamRing::Slice slice = mStreamRing.Allocate(numBytes, 256);
+	while (slice.mOffset == StreamRing::Invalid && mStreamRing.HasFramesInFlight())
+	{
+		mStreamRing.Retire(mStreamRing.GetOldestFrame());
+		mFrameStatistics.mNumStreamWaits++;
+		slice = mStreamRing.Allocate(numBytes, 256);
+	}
+	if (slice.mOffset == StreamRing::Invalid)
+	{
+		return false;
+	}
+
+	mFrameStatistics.mNumBytesStreamed += numBytes;
+	return true;
+}
+
+bool RecordingRenderer::Update(eastl::shared_ptr<TextureSingle> const& texture)
+{
+	Record(CT_UPDATE, GetId(Bind(texture)), texture->GetNumBytes());
+	return true;
+}
+
+bool RecordingRenderer::Update(eastl::shared_ptr<TextureSingle> const& texture, unsigned int level)
+{
+	Record(CT_UPDATE, GetId(Bind(texture)), texture->GetNumBytesFor(level));
+	return true;
+}
+
+bool RecordingRenderer::Update(eastl::shared_ptr<TextureArray> const& textureArray)
+{
+	Record(CT_UPDATE, GetId(Bind(textureArray)), textureArray->GetNumBytes());
+	return true;
+}
+
+bool RecordingRenderer::Update(eastl::shared_ptr<TextureArray> const& textureArray, unsigned int, unsigned int level)
+{
+	Record(CT_UPDATE, GetId(Bind(textureArray)), textureArray->GetNumBytesFor(level));
+	return true;
+}
+
+uint64_t RecordingRenderer::DrawPrimitive(eastl::shared_ptr<VertexBuffer> const& vbuffer,
+	eastl::shared_ptr<IndexBuffer> const& ibuffer, eastl::shared_ptr<VisualEffect> const& effect)
+{
+	return DrawInstancedPrimitive(vbuffer, ibuffer, effect, 1);
+}
+
+uint64_t RecordingRenderer::DrawInstancedPrimitive(eastl::shared_ptr<VertexBuffer> const& vbuffer,
+	eastl::shared_ptr<IndexBuffer> const& ibuffer, eastl::shared_ptr<VisualEffect> const& effect,
+	unsigned int numInstances)
+{
+	uint32_t vbufferId = GetId(Bind(vbuffer));
+	uint32_t ibufferId = ibuffer->IsIndexed() ? GetId(Bind(ibuffer)) : 0;
+
+	Record(CT_PROGRAM, GetId(effect->GetProgram().get()));
+	RecordResources(effect->GetVertexShader().get());
+	RecordResources(effect->GetPixelShader().get());
+	RecordResources(effect->GetGeometryShader().get());
+
+	Record(CT_DRAW, vbufferId, ibufferId, ibuffer->GetNumActivePrimitives(),
+		ibuffer->GetPrimitiveType(), numInstances);
+	return 0;
+}
+
+void RecordingRenderer::RecordResources(Shader const* shader)
+{
+	if (!shader)
+	{
+		return;
+	}
+
+	int const lookups[] = { ConstantBuffer::mShaderDataLookup,
+		TextureSingle::mShaderDataLookup, TextureArray::mShaderDataLookup,
+		SamplerState::mShaderDataLookup, StructuredBuffer::mShaderDataLookup };
+	for (auto lookup : lookups)
+	{
+		for (auto const& data : shader->GetData(lookup))
+		{
+			if (data.object)
+			{
+				Record(CT_RESOURCE, GetId(Bind(data.object)), lookup, data.bindPoint);
+			}
+		}
+	}
+}
+
+bool RecordingRenderer::SaveCapture(eastl::string const& fileName) const
+{
+	std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		LogWarning("Couldn't write capture " + fileName);
+		return false;
+	}
+
+	CaptureHeader header;
+	header.mMagic = CaptureMagic;
+	header.mVersion = CaptureVersion;
+	header.mNumCommands = (uint32_t)mCapture.size();
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (!mCapture.empty())
+		file.write(reinterpret_cast<const char*>(mCapture.data()), mCapture.size() * sizeof(Command));
+
+	return file.good();
+}
+
+bool RecordingRenderer::LoadCapture(eastl::string const& fileName, eastl::vector<Command>& commands)
+{
+	std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+	{
+		LogWarning("Couldn't read capture " + fileName);
+		return false;
+	}
+
+	CaptureHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file.good() || header.mMagic != CaptureMagic || header.mVersion != CaptureVersion)
+	{
+		LogWarning("Invalid capture " + fileName);
+		return false;
+	}
+
+	commands.resize(header.mNumCommands);
+	if (!commands.empty())
+		file.read(reinterpret_cast<char*>(commands.data()), commands.size() * sizeof(Command));
+
+	if (!file.good())
+	{
+		LogWarning("Truncated capture " + fileName);
+		commands.clear();
+		return false;
+	}
+	return true;
+}
+
+bool RecordingRenderer::DumpCapture(eastl::string const& fileName) const
+{
+	std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+	{
+		LogWarning("Couldn't write capture dump " + fileName);
+		return false;
+	}
+
+	for (unsigned int i = 0; i < mCapture.size(); ++i)
+	{
+		Command const& command = mCapture[i];
+		file << i << " " << GetCommandName(command.mType) << " " << command.mObject;
+		for (unsigned int arg = 0; arg < 4; ++arg)
+			file << " " << command.mArgs[arg];
+		file << "\n";
+	}
+
+	Statistics const& statistics = mLastFrameStatistics;
+	file << "draws " << statistics.mNumCommands[CT_DRAW] <<
+		", state changes " << statistics.mNumStateChanges <<
+		", resource binds " << statistics.mNumCommands[CT_RESOURCE] <<
+		", primitives " << statistics.mNumPrimitives <<
+		", bytes uploaded " << statistics.mNumBytesUploaded <<
+		", bytes streamed " << statistics.mNumBytesStreamed <<
+		", stream waits " << statistics.mNumStreamWaits << "\n";
+
+	return file.good();
+}
+
+void RecordingRenderer::ReplayStatistics(eastl::vector<Command> const& commands, unsigned int numRuns)
+{
+	if (commands.empty() || numRuns == 0)
+	{
+		return;
+	}
+
+	// The replay has its own statistics, the frame in progress keeps its own.
+	Statistics frameStatistics = mFrameStatistics;
+	eastl::array<uint32_t, CT_COUNT> lastStates = mLastStates;
+
+	unsigned int startTime = Timer::GetRealTime();
+	for (unsigned int run = 0; run < numRuns; ++run)
+	{
+		mFrameStatistics = Statistics();
+		mLastStates.fill(0);
+		for (auto const& command : commands)
+		{
+			Execute(command);
+		}
+	}
+	unsigned int const replayTime = Timer::GetRealTime() - startTime;
+
+	Statistics const statistics = mFrameStatistics;
+	mFrameStatistics = frameStatistics;
+	mLastStates = lastStates;
+
+	LogInformation("Replayed " + eastl::to_string(commands.size()) + " commands " +
+		eastl::to_string(numRuns) + " times: " + eastl::to_string(replayTime / (float)numRuns) + " ms per run");
+	LogInformation("  draws " + eastl::to_string(statistics.mNumCommands[CT_DRAW]) +
+		", state changes " + eastl::to_string(statistics.mNumStateChanges) +
+		", resource binds " + eastl::to_string(statistics.mNumCommands[CT_RESOURCE]) +
+		", primitives " + eastl::to_string(statistics.mNumPrimitives) +
+		", bytes uploaded " + eastl::to_string(statistics.mNumBytesUploaded));
+}
+
+char const* RecordingRenderer::GetCommandName(unsigned int type)
+{
+	static char const* names[CT_COUNT] =
+	{
+		"Create",
+		"Destroy",
+		"Update",
+		"EnableTarget",
+		"DisableTarget",
+		"Viewport",
+		"DepthRange",
+		"Resize",
+		"Clear",
+		"BlendState",
+		"DepthStencilState",
+		"RasterizerState",
+		"Program",
+		"Resource",
+		"Draw",
+		"Present"
+	};
+	return type < CT_COUNT ? names[type] : "Unknown";
+}
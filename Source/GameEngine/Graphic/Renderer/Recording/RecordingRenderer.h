@@ -0,0 +1,193 @@
+//========================================================================
+// RecordingRenderer.h : Renderer without a graphics API which records
+// each frame as a list of compact commands.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef RECORDINGRENDERER_H
+#define RECORDINGRENDERER_H
+
+#include "Graphic/Renderer/Renderer.h"
+#include "Graphic/Renderer/StreamRing.h"
+
+// The recording renderer needs no window and no device. Its bridge objects
+// only hold an id, and every creation, upload, state change, target switch
+// and draw appends a command to the frame in progress. DisplayColorBuffer
+// ends the frame: its commands become the capture, which can be saved,
+// dumped as text, loaded back and replayed for its statistics. Culling,
+// render list sorting, PVW updates and effect binding run as they do with a
+// real backend, so the CPU side of the rendering can be profiled and tested
+// on any machine. The effects still get their shaders from a program factory.
+// The dynamic buffers are streamed through a ring as the GL4 backend does,
+// a frame being retired StreamLatency frames after it ended, so the stream
+// buffer sizing and its waits can be checked without a device.
+// It isn't set as the global renderer unless asked, so that it can be
+// created next to a real one; RecordingProgramFactory provides programs
+// without a shader compiler.
+class GRAPHIC_ITEM RecordingRenderer : public Renderer
+{
+public:
+	enum CommandType
+	{
+		CT_CREATE,				// object, object type, bytes
+		CT_DESTROY,				// object
+		CT_UPDATE,				// object, bytes
+		CT_ENABLE_TARGET,		// target
+		CT_DISABLE_TARGET,		// target
+		CT_VIEWPORT,			// x, y, width, height
+		CT_DEPTH_RANGE,			// bits of zmin, bits of zmax
+		CT_RESIZE,				// width, height
+		CT_CLEAR,				// clear flags
+		CT_BLEND_STATE,			// state
+		CT_DEPTH_STENCIL_STATE,	// state
+		CT_RASTERIZER_STATE,	// state
+		CT_PROGRAM,				// program
+		CT_RESOURCE,			// object, shader data lookup, bind point
+		CT_DRAW,				// vertex buffer, index buffer, primitives, primitive type, instances
+		CT_PRESENT,				// sync interval
+		CT_COUNT
+	};
+
+	enum ClearFlag
+	{
+		CF_COLOR = 1,
+		CF_DEPTH = 2,
+		CF_STENCIL = 4
+	};
+
+	// The objects, states, targets and programs are referred by ids, which
+	// are handed out by the renderer and are never 0. The targets and the
+	// programs get a new id in every frame, as they are known by address.
+	struct Command
+	{
+		uint32_t mType;
+		uint32_t mObject;
+		uint32_t mArgs[4];
+	};
+
+	struct Statistics
+	{
+		Statistics();
+
+		unsigned int mNumCommands[CT_COUNT];
+		unsigned int mNumStateChanges;
+		unsigned int mNumPrimitives;
+		uint64_t mNumBytesUploaded;
+		uint64_t mNumBytesStreamed;
+		unsigned int mNumStreamWaits;
+	};
+
+	RecordingRenderer(unsigned int width, unsigned int height, bool setAsGlobal = false);
+	~RecordingRenderer();
+
+	// Overrides from Renderer.
+	virtual void Enable(eastl::shared_ptr<DrawTarget> const& target) override;
+	virtual void Disable(eastl::shared_ptr<DrawTarget> const& target) override;
+
+	virtual void SetViewport(int x, int y, int w, int h) override;
+	virtual void GetViewport(int& x, int& y, int& w, int& h) const override;
+	virtual void SetDepthRange(float zmin, float zmax) override;
+	virtual void GetDepthRange(float& zmin, float& zmax) const override;
+	virtual bool Resize(unsigned int w, unsigned int h) override;
+
+	virtual void ClearColorBuffer() override;
+	virtual void ClearDepthBuffer() override;
+	virtual void ClearStencilBuffer() override;
+	virtual void ClearBuffers() override;
+	virtual void DisplayColorBuffer(unsigned int syncInterval) override;
+
+	virtual void SetBlendState(eastl::shared_ptr<BlendState> const& state) override;
+	virtual void SetDepthStencilState(eastl::shared_ptr<DepthStencilState> const& state) override;
+	virtual void SetRasterizerState(eastl::shared_ptr<RasterizerState> const& state) override;
+
+	virtual bool Update(eastl::shared_ptr<Buffer> const& buffer) override;
+	virtual bool Update(eastl::shared_ptr<TextureSingle> const& texture) override;
+	virtual bool Update(eastl::shared_ptr<TextureSingle> const& texture, unsigned int level) override;
+	virtual bool Update(eastl::shared_ptr<TextureArray> const& textureArray) override;
+	virtual bool Update(eastl::shared_ptr<TextureArray> const& textureArray, unsigned int item, unsigned int level) override;
+
+	// The commands and the statistics of the last frame displayed.
+	inline eastl::vector<Command> const& GetCapture() const;
+	inline Statistics const& GetLastFrameStatistics() const;
+	inline StreamRing const& GetStreamRing() const;
+
+	bool SaveCapture(eastl::string const& fileName) const;
+	bool DumpCapture(eastl::string const& fileName) const;
+	static bool LoadCapture(eastl::string const& fileName, eastl::vector<Command>& commands);
+
+	// Runs the commands through Execute numRuns times and logs the time of a
+	// run along with the statistics of the commands. Nothing is drawn: the
+	// commands only hold ids, so the default Execute recomputes statistics
+	// and the time is that of the command walk, not of a backend.
+	void ReplayStatistics(eastl::vector<Command> const& commands, unsigned int numRuns);
+
+	static char const* GetCommandName(unsigned int type);
+
+protected:
+	virtual uint64_t DrawPrimitive(
+		eastl::shared_ptr<VertexBuffer> const& vbuffer,
+		eastl::shared_ptr<IndexBuffer> const& ibuffer,
+		eastl::shared_ptr<VisualEffect> const& effect) override;
+
+	virtual uint64_t DrawInstancedPrimitive(
+		eastl::shared_ptr<VertexBuffer> const& vbuffer,
+		eastl::shared_ptr<IndexBuffer> const& ibuffer,
+		eastl::shared_ptr<VisualEffect> const& effect,
+		unsigned int numInstances) override;
+
+	// Every command recorded or replayed goes through Execute. The default
+	// one only gathers the statistics; a subclass can translate the commands.
+	virtual void Execute(Command const& command);
+
+private:
+	class RecordedObject;
+
+	static eastl::shared_ptr<GraphicObject> CreateObject(void* creator, GraphicObject const* object);
+	static eastl::shared_ptr<DrawTarget> CreateDrawTarget(DrawTarget const* target,
+		eastl::vector<GraphicObject*>& rtTextures, GraphicObject* dsTexture);
+
+	void Record(CommandType type, uint32_t object,
+		uint32_t arg0 = 0, uint32_t arg1 = 0, uint32_t arg2 = 0, uint32_t arg3 = 0);
+	uint32_t GetId(GraphicObject* bridge) const;
+	uint32_t GetId(void const* object);
+	void RecordResources(Shader const* shader);
+	void Terminate();
+	bool Stream(uint32_t numBytes);
+
+	eastl::vector<Command> mCommands;
+	eastl::vector<Command> mCapture;
+	Statistics mFrameStatistics;
+	Statistics mLastFrameStatistics;
+
+	// Last value of each state command, to count the state changes.
+	eastl::array<uint32_t, CT_COUNT> mLastStates;
+
+	eastl::hash_map<void const*, uint32_t> mIds;
+	uint32_t mNextId;
+
+	int mViewportX, mViewportY, mViewportWidth, mViewportHeight;
+	float mDepthRangeMin, mDepthRangeMax;
+
+	static unsigned int const StreamBufferSize = 8 * 1024 * 1024;
+	static unsigned int const StreamLatency = 2;
+	StreamRing mStreamRing;
+};
+
+inline eastl::vector<RecordingRenderer::Command> const& RecordingRenderer::GetCapture() const
+{
+	return mCapture;
+}
+
+inline RecordingRenderer::Statistics const& RecordingRenderer::GetLastFrameStatistics() const
+{
+	return mLastFrameStatistics;
+}
+
+inline StreamRing const& RecordingRenderer::GetStreamRing() const
+{
+	return mStreamRing;
+}
+
+#endif
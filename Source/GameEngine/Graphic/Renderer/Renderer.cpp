@@ -9,21 +9,35 @@
 #include "Graphic/Graphic.h"
 
 #include "Renderer.h"
+#include "CommandList.h"
+
+#include "Core/OS/OS.h"
 
 Renderer* Renderer::mRenderer = NULL;
 
+static thread_local Renderer* ThreadRenderer = nullptr;
+
 Renderer* Renderer::Get(void)
 {
+	if (ThreadRenderer)
+		return ThreadRenderer;
+
 	LogAssert(Renderer::mRenderer, "Renderer doesn't exist");
 	return Renderer::mRenderer;
 }
 
+void Renderer::SetThreadRenderer(Renderer* renderer)
+{
+	ThreadRenderer = renderer;
+}
+
 //----------------------------------------------------------------------------
-Renderer::Renderer()
+Renderer::Renderer(bool setAsGlobal)
 	:
 	mScreenSize(),
 	mClearDepth(1.0f),
 	mClearStencil(0),
+	mObjectGeneration(0),
 	mCreateDrawTarget(nullptr),
 	mGraphicObjectCreator(nullptr),
 	mWarnOnNonemptyBridges(true)
@@ -31,6 +45,9 @@ Renderer::Renderer()
 	mClearColor.fill(1.0f);
 	mCreateGraphicObject.fill(nullptr);
 
+	if (!setAsGlobal)
+		return;
+
 	mGOListener = eastl::make_shared<GOListener>(this);
 	GraphicObject::SubscribeForDestruction(mGOListener);
 
@@ -167,6 +184,23 @@ uint64_t Renderer::Draw(eastl::vector<eastl::shared_ptr<Visual>> const& visuals)
 	return numPixelsDrawn;
 }
 
+uint64_t Renderer::DrawInstanced(eastl::shared_ptr<Visual> const& visual, unsigned int numInstances)
+{
+	if (visual && numInstances > 0)
+	{
+		auto const& vbuffer = visual->GetVertexBuffer();
+		auto const& ibuffer = visual->GetIndexBuffer();
+		auto const& effect = visual->GetEffect();
+		if (vbuffer && ibuffer && effect)
+		{
+			return DrawInstancedPrimitive(vbuffer, ibuffer, effect, numInstances);
+		}
+	}
+
+	LogError("Null input to DrawInstanced.");
+	return 0;
+}
+
 uint64_t Renderer::Draw(int x, int y, eastl::array<float, 4> const& color, eastl::wstring const& message)
 {
 	uint64_t numPixelsDrawn;
@@ -205,6 +239,146 @@ uint64_t Renderer::Draw(int x, int y, eastl::array<float, 4> const& color, eastl
 	return numPixelsDrawn;
 }
 
+void Renderer::Submit(CommandList const& commandList)
+{
+	eastl::vector<char> liveBytes;
+	for (auto const& command : commandList.mCommands)
+	{
+		switch (command.mType)
+		{
+		case CommandList::CT_BLEND_STATE:
+			SetBlendState(eastl::static_pointer_cast<BlendState>(
+				commandList.mStates[command.mIndex]));
+			break;
+		case CommandList::CT_DEPTH_STENCIL_STATE:
+			SetDepthStencilState(eastl::static_pointer_cast<DepthStencilState>(
+				commandList.mStates[command.mIndex]));
+			break;
+		case CommandList::CT_RASTERIZER_STATE:
+			SetRasterizerState(eastl::static_pointer_cast<RasterizerState>(
+				commandList.mStates[command.mIndex]));
+			break;
+		case CommandList::CT_VIEWPORT:
+			SetViewport(command.mArgs[0], command.mArgs[1], command.mArgs[2], command.mArgs[3]);
+			break;
+		case CommandList::CT_DEPTH_RANGE:
+		{
+			float zmin, zmax;
+			memcpy(&zmin, &command.mArgs[0], sizeof(float));
+			memcpy(&zmax, &command.mArgs[1], sizeof(float));
+			SetDepthRange(zmin, zmax);
+			break;
+		}
+		case CommandList::CT_CLEAR:
+		{
+			unsigned int flags = (unsigned int)command.mArgs[0];
+			if (flags == (CommandList::CF_COLOR | CommandList::CF_DEPTH | CommandList::CF_STENCIL))
+			{
+				ClearBuffers();
+			}
+			else
+			{
+				if (flags & CommandList::CF_COLOR)
+					ClearColorBuffer();
+				if (flags & CommandList::CF_DEPTH)
+					ClearDepthBuffer();
+				if (flags & CommandList::CF_STENCIL)
+					ClearStencilBuffer();
+			}
+			break;
+		}
+		case CommandList::CT_UPDATE_BUFFER:
+		{
+			// The buffer is uploaded with the data it had when the update was
+			// recorded, along with its dirty range, then gets its live data
+			// and dirty range back.
+			CommandList::Upload const& upload = commandList.mUploads[command.mIndex];
+			char* data = upload.mBuffer->GetData();
+			liveBytes.assign(data, data + upload.mNumBytes);
+			memcpy(data, &commandList.mBytes[upload.mOffset], upload.mNumBytes);
+
+			ConstantBuffer* cbuffer = nullptr;
+			unsigned int dirtyOffset = 0, numDirtyBytes = 0;
+			if (upload.mBuffer->GetType() == GE_CONSTANT_BUFFER)
+			{
+				cbuffer = static_cast<ConstantBuffer*>(upload.mBuffer.get());
+				if (cbuffer->HasDirtyRange())
+				{
+					dirtyOffset = cbuffer->GetDirtyOffset();
+					numDirtyBytes = cbuffer->GetNumDirtyBytes();
+				}
+				cbuffer->ClearDirtyRange();
+				if (upload.mNumDirtyBytes > 0)
+					cbuffer->MarkDirty(upload.mDirtyOffset, upload.mNumDirtyBytes);
+			}
+
+			Update(upload.mBuffer);
+
+			memcpy(data, liveBytes.data(), upload.mNumBytes);
+			if (cbuffer)
+			{
+				cbuffer->ClearDirtyRange();
+				if (numDirtyBytes > 0)
+					cbuffer->MarkDirty(dirtyOffset, numDirtyBytes);
+			}
+			break;
+		}
+		case CommandList::CT_UPDATE_TEXTURE:
+		{
+			CommandList::TextureUpload const& upload = commandList.mTextureUploads[command.mIndex];
+			if (upload.mTexture->IsTextureArray())
+			{
+				auto textureArray = eastl::static_pointer_cast<TextureArray>(upload.mTexture);
+				if (upload.mItem == CommandList::AllSubresources)
+					Update(textureArray);
+				else
+					Update(textureArray, upload.mItem, upload.mLevel);
+			}
+			else
+			{
+				auto texture = eastl::static_pointer_cast<TextureSingle>(upload.mTexture);
+				if (upload.mLevel == CommandList::AllSubresources)
+					Update(texture);
+				else
+					Update(texture, upload.mLevel);
+			}
+			break;
+		}
+		case CommandList::CT_UNBIND:
+			Unbind(commandList.mUnbinds[command.mIndex]);
+			break;
+		case CommandList::CT_DRAW:
+		{
+			// The active ranges of the buffers are the recorded ones during
+			// the draw only.
+			CommandList::DrawCall const& draw = commandList.mDraws[command.mIndex];
+			unsigned int const vertexOffset = draw.mVBuffer->GetOffset();
+			unsigned int const numVertices = draw.mVBuffer->GetNumActiveElements();
+			unsigned int const firstPrimitive = draw.mIBuffer->GetFirstPrimitive();
+			unsigned int const numPrimitives = draw.mIBuffer->GetNumActivePrimitives();
+
+			draw.mVBuffer->SetOffset(draw.mVertexOffset);
+			draw.mVBuffer->SetNumActiveElements(draw.mNumVertices);
+			draw.mIBuffer->SetNumActivePrimitives(draw.mNumPrimitives);
+			draw.mIBuffer->SetFirstPrimitive(draw.mFirstPrimitive);
+			if (draw.mNumInstances > 0)
+				DrawInstancedPrimitive(draw.mVBuffer, draw.mIBuffer, draw.mEffect, draw.mNumInstances);
+			else
+				DrawPrimitive(draw.mVBuffer, draw.mIBuffer, draw.mEffect);
+
+			draw.mVBuffer->SetOffset(vertexOffset);
+			draw.mVBuffer->SetNumActiveElements(numVertices);
+			draw.mIBuffer->SetNumActivePrimitives(numPrimitives);
+			draw.mIBuffer->SetFirstPrimitive(firstPrimitive);
+			break;
+		}
+		default:
+			LogError("Unknown command.");
+			break;
+		}
+	}
+}
+
 GraphicObject* Renderer::Bind(eastl::shared_ptr<GraphicObject> const& object)
 {
 	if (!object)
@@ -214,6 +388,16 @@ GraphicObject* Renderer::Bind(eastl::shared_ptr<GraphicObject> const& object)
 	}
 
 	GraphicObject const* gObject = object.get();
+	bool const cached = (Renderer::mRenderer == this);
+	if (cached)
+	{
+		GraphicObject* bridge = gObject->GetBridge();
+		if (bridge)
+		{
+			return bridge;
+		}
+	}
+
 	eastl::shared_ptr<GraphicObject> geObject;
 	if (!mGraphicObjects.Get(gObject, geObject))
 	{
@@ -232,6 +416,12 @@ GraphicObject* Renderer::Bind(eastl::shared_ptr<GraphicObject> const& object)
 		LogAssert(gObject, "Null object.  Out of memory?");
 
 		mGraphicObjects.Insert(gObject, geObject);
+		mObjectGeneration++;
+	}
+
+	if (cached)
+	{
+		gObject->SetBridge(geObject.get());
 	}
 	return geObject.get();
 }
@@ -262,6 +452,7 @@ DrawTarget* Renderer::Bind(eastl::shared_ptr<DrawTarget> const& target)
 
 		geTarget = mCreateDrawTarget(gTarget, rtTextures, dsTexture);
 		mDrawTargets.Insert(gTarget, geTarget);
+		mObjectGeneration++;
 	}
 	return geTarget.get();
 }
@@ -269,6 +460,15 @@ DrawTarget* Renderer::Bind(eastl::shared_ptr<DrawTarget> const& target)
 GraphicObject* Renderer::Get(eastl::shared_ptr<GraphicObject> const& object) const
 {
 	GraphicObject const* gObject = object.get();
+	if (Renderer::mRenderer == this)
+	{
+		GraphicObject* bridge = gObject->GetBridge();
+		if (bridge)
+		{
+			return bridge;
+		}
+	}
+
 	eastl::shared_ptr<GraphicObject> geObject;
 	if (mGraphicObjects.Get(gObject, geObject))
 	{
@@ -303,8 +503,14 @@ bool Renderer::Unbind(GraphicObject const* object)
 			mInputLayouts->Unbind(static_cast<Shader const*>(object));
 		}
 
+		if (Renderer::mRenderer == this)
+		{
+			object->SetBridge(nullptr);
+		}
+
 		if (mGraphicObjects.Remove(object, gxObject))
 		{
+			mObjectGeneration++;
 			return true;
 		}
 	}
@@ -316,12 +522,79 @@ bool Renderer::Unbind(DrawTarget const* target)
 	eastl::shared_ptr<DrawTarget> dxTarget = nullptr;
 	if (mDrawTargets.Remove(target, dxTarget))
 	{
+		mObjectGeneration++;
 		return true;
 	}
 
 	return false;
 }
 
+void Renderer::RemoveAllGraphicObjects()
+{
+	if (Renderer::mRenderer == this)
+	{
+		eastl::vector<GraphicObject const*> objects;
+		mGraphicObjects.GatherKeys(objects);
+		for (auto object : objects)
+		{
+			object->SetBridge(nullptr);
+		}
+	}
+
+	mGraphicObjects.RemoveAll();
+	mObjectGeneration++;
+}
+
+void Renderer::BenchmarkBind(unsigned int numBinds, unsigned int numObjects, unsigned int numFrames)
+{
+	if (numBinds == 0 || numObjects == 0 || numFrames == 0)
+	{
+		return;
+	}
+
+	eastl::vector<eastl::shared_ptr<GraphicObject>> objects(numObjects);
+	for (auto& object : objects)
+	{
+		object = eastl::make_shared<ConstantBuffer>(sizeof(Vector4<float>), false);
+		Bind(object);
+	}
+
+	// Both paths must find the same bridge objects.
+	uintptr_t cachedSum = 0, lockedSum = 0;
+
+	unsigned int startTime = Timer::GetRealTime();
+	for (unsigned int frame = 0; frame < numFrames; ++frame)
+	{
+		for (unsigned int i = 0; i < numBinds; ++i)
+		{
+			cachedSum += reinterpret_cast<uintptr_t>(Bind(objects[i % numObjects]));
+		}
+	}
+	unsigned int const cachedTime = Timer::GetRealTime() - startTime;
+
+	startTime = Timer::GetRealTime();
+	for (unsigned int frame = 0; frame < numFrames; ++frame)
+	{
+		for (unsigned int i = 0; i < numBinds; ++i)
+		{
+			eastl::shared_ptr<GraphicObject> geObject;
+			mGraphicObjects.Get(objects[i % numObjects].get(), geObject);
+			lockedSum += reinterpret_cast<uintptr_t>(geObject.get());
+		}
+	}
+	unsigned int const lockedTime = Timer::GetRealTime() - startTime;
+
+	if (cachedSum != lockedSum)
+	{
+		LogWarning("Bind benchmark found different bridge objects in the cache and the map.");
+	}
+
+	LogInformation("Bind benchmark, " + eastl::to_string(numBinds) + " binds of " +
+		eastl::to_string(numObjects) + " objects per frame over " + eastl::to_string(numFrames) + " frames");
+	LogInformation("  bridge cache: " + eastl::to_string(cachedTime / (float)numFrames) + " ms per frame");
+	LogInformation("  locked map: " + eastl::to_string(lockedTime / (float)numFrames) + " ms per frame");
+}
+
 Renderer::GOListener::~GOListener()
 {
 }
@@ -11,6 +11,8 @@
 
 #include "Core/Threading/ThreadSafeMap.h"
 
+#include <atomic>
+
 #include "Graphic/Graphic.h"
 
 //! An enum for all types of renderes the Engine supports.
@@ -93,12 +95,16 @@ enum GRAPHIC_ITEM RendererType
 	The second section lists the platform-dependent functions and data. These are implemented 
 	by each platform of interest in the LibRenderers folder.
 */
+class CommandList;
+
 class GRAPHIC_ITEM Renderer
 {
 public:
 
-	// Construction and destruction.
-	Renderer();
+	// Construction and destruction. A renderer which isn't set as global
+	// can live next to the global one or stand in for it on a thread, see
+	// RecordingRenderer and CommandRecorder.
+	Renderer(bool setAsGlobal = true);
 	~Renderer();
 
 	// Support for drawing to offscreen memory (i.e. not to the back buffer).
@@ -138,9 +144,19 @@ public:
 	uint64_t Draw(eastl::shared_ptr<Visual> const& visual);
 	uint64_t Draw(eastl::vector<eastl::shared_ptr<Visual>> const& visuals);
 
+	// Draw numInstances copies of the geometry in a single call.  The effect
+	// reads the data of each instance by the instance id, for example from a
+	// structured buffer.
+	uint64_t DrawInstanced(eastl::shared_ptr<Visual> const& visual, unsigned int numInstances);
+
 	// Draw 2D text
 	uint64_t Draw(int x, int y, eastl::array<float, 4> const& color, eastl::wstring const& message);
 
+	// Execute the commands of a list recorded by a CommandRecorder, in the
+	// order they were recorded.  The lists must be submitted by the thread
+	// which draws with the renderer.
+	virtual void Submit(CommandList const& commandList);
+
 	// Set the warning to 'true' if you want the DX11Engine destructor to
 	// report that the bridge maps are nonempty.  If they are, the application
 	// did not destroy GraphicsObject items before the engine was destroyed.
@@ -203,15 +219,26 @@ public:
 	inline bool Unbind(eastl::shared_ptr<GraphicObject> const& object);
 	inline bool Unbind(eastl::shared_ptr<DrawTarget> const& target);
 
+	// Binds and looks up the bridge objects of numObjects constant buffers
+	// numBinds times per frame, through the bridge cache of the objects and
+	// through the locked bridge map, and logs the time of a frame for both.
+	void BenchmarkBind(unsigned int numBinds = 100000,
+		unsigned int numObjects = 1000, unsigned int numFrames = 60);
+
 	// Getter for the main global renderer. This is the renderer that is used by the majority of the 
 	// engine, though you are free to define your own as long as you instantiate it.
-	// It is not valid to have more than one global renderer.
+	// It is not valid to have more than one global renderer. On a thread
+	// which records a command list, the recorder is returned instead.
 	static Renderer* Get(void);
 
 protected:
 
 	static Renderer* mRenderer;
 
+	// The renderer returned by Get on the calling thread, null for the
+	// global one.
+	static void SetThreadRenderer(Renderer* renderer);
+
 	// Support for drawing.  If occlusion queries are enabled, the return
 	// values are the number of samples that passed the depth and stencil
 	// tests, effectively the number of pixels drawn.  If occlusion queries
@@ -221,19 +248,34 @@ protected:
 		eastl::shared_ptr<IndexBuffer> const& ibuffer,
 		eastl::shared_ptr<VisualEffect> const& effect) = 0;
 
+	virtual uint64_t DrawInstancedPrimitive(
+		eastl::shared_ptr<VertexBuffer> const& vbuffer,
+		eastl::shared_ptr<IndexBuffer> const& ibuffer,
+		eastl::shared_ptr<VisualEffect> const& effect,
+		unsigned int numInstances) = 0;
+
 	// Support for GOListener::OnDestroy and DTListener::OnDestroy, because
 	// they are passed raw pointers from resource destructors.  These are
 	// also used by the Unbind calls whose inputs are eastl::shared_ptr<T>.
-	bool Unbind(GraphicObject const* object);
+	virtual bool Unbind(GraphicObject const* object);
 	bool Unbind(DrawTarget const* target);
 
+	// Destroys every bridge object and clears the bridge caches of the
+	// front-end objects still alive.
+	void RemoveAllGraphicObjects();
+
 	// Bridge pattern to create graphics API-specific objects that correspond
 	// to front-end objects. The Bind, Get, and Unbind operations act on
-	// these maps.
+	// these maps. The global renderer also caches the bridge object in the
+	// front-end object, which Bind and Get check before taking the lock.
 	ThreadSafeMap<GraphicObject const*, eastl::shared_ptr<GraphicObject>> mGraphicObjects;
 	ThreadSafeMap<DrawTarget const*, eastl::shared_ptr<DrawTarget>> mDrawTargets;
 	eastl::unique_ptr<InputLayoutManager> mInputLayouts;
 
+	// Incremented whenever a bridge object is created or destroyed, so that
+	// a backend which caches its bindings knows when they may be stale.
+	std::atomic<unsigned int> mObjectGeneration;
+
 	// Creation functions for adding objects to the bridges. The function
 	// pointers are assigned during construction.
 	typedef eastl::shared_ptr<GraphicObject>(*CreateGraphicObject)(void*, GraphicObject const*);
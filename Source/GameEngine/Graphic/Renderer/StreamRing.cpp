@@ -0,0 +1,147 @@
+//========================================================================
+// StreamRing.cpp : Suballocates the bytes of a ring buffer to the dynamic
+// data uploaded each frame.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "StreamRing.h"
+
+#include "Core/Logger/Logger.h"
+
+StreamRing::Slice::Slice()
+	:
+	mOffset(Invalid),
+	mNumBytes(0),
+	mFrame(0)
+{
+}
+
+StreamRing::Statistics::Statistics()
+	:
+	mNumAllocations(0),
+	mNumFailures(0),
+	mNumWraps(0),
+	mNumRetired(0),
+	mNumBytes(0)
+{
+}
+
+StreamRing::StreamRing(unsigned int numBytes)
+	:
+	mNumBytes(numBytes),
+	mHead(0),
+	mTail(0),
+	mNumUsedBytes(0),
+	mFrameBytes(0),
+	mFrame(1)
+{
+}
+
+StreamRing::Slice StreamRing::Allocate(unsigned int numBytes, unsigned int alignment)
+{
+	LogAssert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Invalid alignment.");
+
+	Slice slice;
+	slice.mNumBytes = numBytes;
+	slice.mFrame = mFrame;
+	if (numBytes == 0 || numBytes > mNumBytes)
+	{
+		mFrameStatistics.mNumFailures++;
+		return slice;
+	}
+
+	// An empty ring starts over, which keeps the largest free range.
+	if (mNumUsedBytes == 0)
+	{
+		mHead = 0;
+		mTail = 0;
+	}
+
+	unsigned int offset = (mHead + alignment - 1) & ~(alignment - 1);
+	unsigned int end = 0;
+	bool wrap = false;
+	if (mNumUsedBytes > 0 && mHead == mTail)
+	{
+		// full
+	}
+	else if (mHead >= mTail)
+	{
+		// the free bytes are after the head and before the tail
+		if (offset <= mNumBytes && numBytes <= mNumBytes - offset)
+		{
+			end = offset + numBytes;
+			slice.mOffset = offset;
+		}
+		else if (numBytes <= mTail)
+		{
+			end = numBytes;
+			slice.mOffset = 0;
+			wrap = true;
+		}
+	}
+	else if (offset < mTail && numBytes <= mTail - offset)
+	{
+		end = offset + numBytes;
+		slice.mOffset = offset;
+	}
+
+	if (slice.mOffset == Invalid)
+	{
+		mFrameStatistics.mNumFailures++;
+		return slice;
+	}
+
+	// the bytes skipped for the alignment or the wrap stay with the frame
+	unsigned int numTaken = wrap ? (mNumBytes - mHead) + end : end - mHead;
+	mHead = end == mNumBytes ? 0 : end;
+	mNumUsedBytes += numTaken;
+	mFrameBytes += numTaken;
+
+	mFrameStatistics.mNumAllocations++;
+	mFrameStatistics.mNumBytes += numBytes;
+	if (wrap)
+		mFrameStatistics.mNumWraps++;
+	return slice;
+}
+
+uint64_t StreamRing::EndFrame()
+{
+	Frame frame;
+	frame.mFrame = mFrame;
+	frame.mEnd = mHead;
+	frame.mNumBytes = mFrameBytes;
+	mFramesInFlight.push_back(frame);
+	mFrameBytes = 0;
+
+	mLastFrameStatistics = mFrameStatistics;
+	mFrameStatistics = Statistics();
+	return mFrame++;
+}
+
+void StreamRing::Retire(uint64_t frame)
+{
+	unsigned int numRetired = 0;
+	for (; numRetired < mFramesInFlight.size(); ++numRetired)
+	{
+		Frame const& oldest = mFramesInFlight[numRetired];
+		if (oldest.mFrame > frame)
+			break;
+
+		mTail = oldest.mEnd;
+		mNumUsedBytes -= oldest.mNumBytes;
+	}
+	mFramesInFlight.erase(mFramesInFlight.begin(), mFramesInFlight.begin() + numRetired);
+	mFrameStatistics.mNumRetired += numRetired;
+}
+
+void StreamRing::Reset()
+{
+	mFramesInFlight.clear();
+	mHead = 0;
+	mTail = 0;
+	mNumUsedBytes = 0;
+	mFrameBytes = 0;
+	mFrame++;
+}
@@ -0,0 +1,131 @@
+//========================================================================
+// StreamRing.h : Suballocates the bytes of a ring buffer to the dynamic
+// data uploaded each frame.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef STREAMRING_H
+#define STREAMRING_H
+
+#include "GameEngineStd.h"
+
+// The ring only manages offsets, the backends own the memory. Each frame
+// takes the bytes following the previous frame, wrapping to the start when
+// the end is reached. Once a frame ends, its bytes stay in use until the
+// backend retires it, usually when a fence put after its draws has been
+// passed. An allocation which doesn't fit in the free bytes fails: the
+// backend either waits for the oldest frame and retires it, or resets the
+// ring when the API renames the memory (discard). A slice is only current
+// in the frame it was allocated in, after that its bytes may be reused and
+// the data has to be written again.
+class GRAPHIC_ITEM StreamRing
+{
+public:
+	static unsigned int const Invalid = 0xFFFFFFFFu;
+
+	struct Slice
+	{
+		Slice();
+
+		unsigned int mOffset;
+		unsigned int mNumBytes;
+		uint64_t mFrame;
+	};
+
+	struct Statistics
+	{
+		Statistics();
+
+		unsigned int mNumAllocations;
+		unsigned int mNumFailures;
+		unsigned int mNumWraps;
+		unsigned int mNumRetired;
+		uint64_t mNumBytes;
+	};
+
+	StreamRing(unsigned int numBytes);
+
+	inline unsigned int GetNumBytes() const;
+	inline unsigned int GetNumUsedBytes() const;
+
+	// The alignment must be a power of two. The offset of the slice is
+	// Invalid when the bytes are still used by the frames in flight.
+	Slice Allocate(unsigned int numBytes, unsigned int alignment);
+	inline bool IsCurrent(Slice const& slice) const;
+
+	// The id of the frame in progress, which EndFrame returns before
+	// starting the next one. The backend associates its fence with it.
+	inline uint64_t GetFrame() const;
+	uint64_t EndFrame();
+
+	// The frames ended but not retired, oldest first.
+	inline bool HasFramesInFlight() const;
+	inline uint64_t GetOldestFrame() const;
+	void Retire(uint64_t frame);
+
+	// Forgets every frame, the slices allocated so far are no longer current.
+	void Reset();
+
+	// The counters of the frame in progress move to the last frame ones.
+	inline Statistics const& GetLastFrameStatistics() const;
+
+private:
+	struct Frame
+	{
+		uint64_t mFrame;
+		unsigned int mEnd;
+		unsigned int mNumBytes;
+	};
+
+	unsigned int mNumBytes;
+	unsigned int mHead;
+	unsigned int mTail;
+	unsigned int mNumUsedBytes;
+
+	// bytes taken by the frame in progress, wasted ones included
+	unsigned int mFrameBytes;
+	uint64_t mFrame;
+	eastl::vector<Frame> mFramesInFlight;
+
+	Statistics mFrameStatistics;
+	Statistics mLastFrameStatistics;
+};
+
+inline unsigned int StreamRing::GetNumBytes() const
+{
+	return mNumBytes;
+}
+
+inline unsigned int StreamRing::GetNumUsedBytes() const
+{
+	return mNumUsedBytes;
+}
+
+inline bool StreamRing::IsCurrent(Slice const& slice) const
+{
+	return slice.mOffset != Invalid && slice.mFrame == mFrame;
+}
+
+inline uint64_t StreamRing::GetFrame() const
+{
+	return mFrame;
+}
+
+inline bool StreamRing::HasFramesInFlight() const
+{
+	return !mFramesInFlight.empty();
+}
+
+inline uint64_t StreamRing::GetOldestFrame() const
+{
+	return mFramesInFlight.front().mFrame;
+}
+
+inline StreamRing::Statistics const& StreamRing::GetLastFrameStatistics() const
+{
+	return mLastFrameStatistics;
+}
+
+#endif
@@ -5,22 +5,57 @@
 // http://www.geometrictools.com/License/Boost/LICENSE_1_0.txt
 // File Version: 3.0.1 (2016/08/29)
 
+#include "Core/Logger/Logger.h"
+
 #include "Graphic/Resource/Buffer/ConstantBuffer.h"
 
 ConstantBuffer::ConstantBuffer(size_t numBytes, bool allowDynamicUpdate)
     :
-    Buffer(1, GetRoundedNumBytes(numBytes), true)
+    Buffer(1, GetRoundedNumBytes(numBytes), true),
+    mDirtyBegin(0),
+    mDirtyEnd(0)
 {
     mType = GE_CONSTANT_BUFFER;
     mUsage = (allowDynamicUpdate ? DYNAMIC_UPDATE : IMMUTABLE);
     memset(mData, 0, mNumBytes);
 }
 
+void ConstantBuffer::SetLayout(eastl::vector<MemberLayout> const& layout)
+{
+    mLayout = layout;
+
+    // Index the members by name so that lookups don't compare every name.
+    mMembers.clear();
+    for (unsigned int i = 0; i < mLayout.size(); ++i)
+        mMembers.insert(eastl::make_pair(mLayout[i].name, i));
+}
+
 bool ConstantBuffer::HasMember(eastl::string const& name) const
 {
-    auto iter = eastl::find_if(mLayout.begin(), mLayout.end(),
-        [&name](MemberLayout const& item){ return name == item.name; });
-    return iter != mLayout.end();
+    return FindMember(name) != nullptr;
+}
+
+MemberLayout const* ConstantBuffer::FindMember(eastl::string const& name) const
+{
+    auto iter = mMembers.find(name);
+    return iter != mMembers.end() ? &mLayout[iter->second] : nullptr;
+}
+
+ConstantBuffer::MemberHandle ConstantBuffer::GetMemberHandle(eastl::string const& name) const
+{
+    MemberHandle handle;
+    MemberLayout const* member = FindMember(name);
+    if (member)
+    {
+        handle.offset = member->offset;
+        handle.numElements = member->numElements;
+        handle.valid = true;
+    }
+    else
+    {
+        LogError("Failed to find member name " + name + ".");
+    }
+    return handle;
 }
 
 size_t ConstantBuffer::GetRoundedNumBytes(size_t numBytes)
@@ -11,6 +11,8 @@
 #include "Buffer.h"
 #include "Graphic/Resource/MemberLayout.h"
 
+#include <EASTL/hash_map.h>
+
 /*
 	Constant Buffers. Its purpose is to organize one or more shader constants.
 	A shader constant is input the CPU sends to a hader, which remains constant for
@@ -43,7 +45,7 @@ public:
     // 'value' will cause a memory overwrite within the buffer.  The code
     // does test to ensure that no overwrite occurs outside the buffer.
 
-    inline void SetLayout(eastl::vector<MemberLayout> const& layout);
+    void SetLayout(eastl::vector<MemberLayout> const& layout);
     inline eastl::vector<MemberLayout> const& GetLayout() const;
 
     // Test for existence of a member with the specified name.
@@ -64,6 +66,41 @@ public:
     template <typename T>
     bool GetMember(eastl::string const& name, unsigned int index, T& value) const;
 
+    // A member can be resolved once into a handle that holds its offset, so
+    // that setting it every frame is a copy without any name lookup.  The
+    // handle is valid until the layout changes; resolve it after attaching
+    // the buffer to a shader.
+    struct MemberHandle
+    {
+        MemberHandle() : offset(0), numElements(0), valid(false) {}
+
+        unsigned int offset;
+        unsigned int numElements;
+        bool valid;
+    };
+
+    MemberHandle GetMemberHandle(eastl::string const& name) const;
+
+    template <typename T>
+    inline bool Set(MemberHandle const& handle, T const& value);
+
+    template <typename T>
+    inline bool Set(MemberHandle const& handle, unsigned int index, T const& value);
+
+    // The bytes written through SetMember or the handles since the last
+    // upload form the dirty range, and the renderers upload only that range.
+    // The writable Get<T>() marks the whole buffer dirty because the writes
+    // through its pointer can't be tracked, so take the pointer again before
+    // each raw write. Mark the writes through GetData() with MarkDirty.
+    using Resource::Get;
+    template <typename T> inline T* Get();
+
+    inline void MarkDirty(unsigned int offset, unsigned int numBytes);
+    inline bool HasDirtyRange() const;
+    inline unsigned int GetDirtyOffset() const;
+    inline unsigned int GetNumDirtyBytes() const;
+    inline void ClearDirtyRange();
+
 protected:
     // Direct3D 11 requires the storage to be a multiple of 16 bytes.
     // Direct3D 12 requires the storage to be a multiple of 256 bytes.
@@ -71,7 +108,13 @@ protected:
     // buffer memory.
     static size_t GetRoundedNumBytes(size_t numBytes);
 
+    MemberLayout const* FindMember(eastl::string const& name) const;
+
 	eastl::vector<MemberLayout> mLayout;
+	eastl::hash_map<eastl::string, unsigned int> mMembers;
+
+    unsigned int mDirtyBegin;
+    unsigned int mDirtyEnd;
 
 public:
     // For use by the Shader class for storing reflection information.
@@ -79,11 +122,6 @@ public:
 };
 
 
-inline void ConstantBuffer::SetLayout(eastl::vector<MemberLayout> const& layout)
-{
-    mLayout = layout;
-}
-
 inline eastl::vector<MemberLayout> const& ConstantBuffer::GetLayout() const
 {
     return mLayout;
@@ -92,57 +130,54 @@ inline eastl::vector<MemberLayout> const& ConstantBuffer::GetLayout() const
 template <typename T>
 bool ConstantBuffer::SetMember(eastl::string const& name, T const& value)
 {
-    auto iter = eastl::find_if(mLayout.begin(), mLayout.end(),
-        [&name](MemberLayout const& item){ return name == item.name; });
-
-    if (iter == mLayout.end())
+    MemberLayout const* member = FindMember(name);
+    if (!member)
     {
         LogError("Failed to find member name " + name + ".");
         return false;
     }
 
-    if (iter->numElements > 0)
+    if (member->numElements > 0)
     {
         LogError("Member is an array, use SetMember(name,index,value).");
         return false;
     }
 
-    if (iter->offset + sizeof(T) > mNumBytes)
+    if (member->offset + sizeof(T) > mNumBytes)
     {
         LogError("Writing will access memory outside the buffer.");
         return false;
     }
 
-    T* target = reinterpret_cast<T*>(mData + iter->offset);
+    T* target = reinterpret_cast<T*>(mData + member->offset);
     *target = value;
+    MarkDirty(member->offset, sizeof(T));
     return true;
 }
 
 template <typename T>
 bool ConstantBuffer::GetMember(eastl::string const& name, T& value) const
 {
-    auto iter = eastl::find_if(mLayout.begin(), mLayout.end(),
-        [&name](MemberLayout const& item){ return name == item.name; });
-
-    if (iter == mLayout.end())
+    MemberLayout const* member = FindMember(name);
+    if (!member)
     {
         LogError("Failed to find member name " + name + ".");
         return false;
     }
 
-    if (iter->numElements > 0)
+    if (member->numElements > 0)
     {
         LogError("Member is an array, use GetMember(name,index,value).");
         return false;
     }
 
-    if (iter->offset + sizeof(T) > mNumBytes)
+    if (member->offset + sizeof(T) > mNumBytes)
     {
         LogError("Reading will access memory outside the buffer.");
         return false;
     }
 
-    T* target = reinterpret_cast<T*>(mData + iter->offset);
+    T* target = reinterpret_cast<T*>(mData + member->offset);
     value = *target;
     return true;
 }
@@ -151,72 +186,141 @@ template <typename T>
 bool ConstantBuffer::SetMember(eastl::string const& name, unsigned int index,
     T const& value)
 {
-    auto iter = eastl::find_if(mLayout.begin(), mLayout.end(),
-        [&name](MemberLayout const& item){ return name == item.name; });
-
-    if (iter == mLayout.end())
+    MemberLayout const* member = FindMember(name);
+    if (!member)
     {
         LogError("Failed to find member name " + name + ".");
         return false;
     }
 
-    if (iter->numElements == 0)
+    if (member->numElements == 0)
     {
         LogError("Member is a singleton, use SetMember(name,value).");
         return false;
     }
 
-    if (index >= iter->numElements)
+    if (index >= member->numElements)
     {
         LogError("Index is out of range for the member array.");
         return false;
     }
 
-    if (iter->offset + (index + 1)*sizeof(T) > mNumBytes)
+    if (member->offset + (index + 1)*sizeof(T) > mNumBytes)
     {
         LogError("Writing will access memory outside the buffer.");
         return false;
     }
 
-    T* target = reinterpret_cast<T*>(mData + iter->offset + index*sizeof(T));
+    T* target = reinterpret_cast<T*>(mData + member->offset + index*sizeof(T));
     *target = value;
+    MarkDirty(member->offset + index*sizeof(T), sizeof(T));
     return true;
 }
 
 template <typename T>
 bool ConstantBuffer::GetMember(eastl::string const& name, unsigned int index, T& value) const
 {
-    auto iter = eastl::find_if(mLayout.begin(), mLayout.end(),
-        [&name](MemberLayout const& item){ return name == item.name; });
-
-    if (iter == mLayout.end())
+    MemberLayout const* member = FindMember(name);
+    if (!member)
     {
         LogError("Failed to find member name " + name + ".");
         return false;
     }
 
-    if (iter->numElements == 0)
+    if (member->numElements == 0)
     {
         LogError("Member is a singleton, use GetMember(name,value).");
         return false;
     }
 
-    if (index >= iter->numElements)
+    if (index >= member->numElements)
     {
         LogError("Index is out of range for the member array.");
         return false;
     }
 
-    if (iter->offset + (index + 1)*sizeof(T) > mNumBytes)
+    if (member->offset + (index + 1)*sizeof(T) > mNumBytes)
     {
         LogError("Reading will access memory outside the buffer.");
         return false;
     }
 
-    T* target = reinterpret_cast<T*>(mData + iter->offset + index*sizeof(T));
+    T* target = reinterpret_cast<T*>(mData + member->offset + index*sizeof(T));
     value = *target;
     return true;
 }
 
+template <typename T>
+inline bool ConstantBuffer::Set(MemberHandle const& handle, T const& value)
+{
+    if (!handle.valid || handle.numElements > 0 ||
+        handle.offset + sizeof(T) > mNumBytes)
+    {
+        LogError("Invalid member handle.");
+        return false;
+    }
+
+    memcpy(mData + handle.offset, &value, sizeof(T));
+    MarkDirty(handle.offset, sizeof(T));
+    return true;
+}
+
+template <typename T>
+inline bool ConstantBuffer::Set(MemberHandle const& handle, unsigned int index, T const& value)
+{
+    if (!handle.valid || index >= handle.numElements ||
+        handle.offset + (index + 1)*sizeof(T) > mNumBytes)
+    {
+        LogError("Invalid member handle.");
+        return false;
+    }
+
+    memcpy(mData + handle.offset + index*sizeof(T), &value, sizeof(T));
+    MarkDirty(handle.offset + index*(unsigned int)sizeof(T), sizeof(T));
+    return true;
+}
+
+template <typename T>
+inline T* ConstantBuffer::Get()
+{
+    MarkDirty(0, (unsigned int)mNumBytes);
+    return Resource::Get<T>();
+}
+
+inline void ConstantBuffer::MarkDirty(unsigned int offset, unsigned int numBytes)
+{
+    if (mDirtyEnd > mDirtyBegin)
+    {
+        mDirtyBegin = eastl::min(mDirtyBegin, offset);
+        mDirtyEnd = eastl::max(mDirtyEnd, offset + numBytes);
+    }
+    else
+    {
+        mDirtyBegin = offset;
+        mDirtyEnd = offset + numBytes;
+    }
+}
+
+inline bool ConstantBuffer::HasDirtyRange() const
+{
+    return mDirtyEnd > mDirtyBegin;
+}
+
+inline unsigned int ConstantBuffer::GetDirtyOffset() const
+{
+    return mDirtyBegin;
+}
+
+inline unsigned int ConstantBuffer::GetNumDirtyBytes() const
+{
+    return mDirtyEnd - mDirtyBegin;
+}
+
+inline void ConstantBuffer::ClearDirtyRange()
+{
+    mDirtyBegin = 0;
+    mDirtyEnd = 0;
+}
+
 
 #endif
\ No newline at end of file
@@ -21,10 +21,26 @@ GraphicObject::~GraphicObject()
 
 GraphicObject::GraphicObject()
     :
-    mType(GE_GRAPHICS_OBJECT)
+    mType(GE_GRAPHICS_OBJECT),
+    mBridge(nullptr)
 {
 }
 
+GraphicObject::GraphicObject(GraphicObject const& object)
+    :
+    mType(object.mType),
+    mName(object.mName),
+    mBridge(nullptr)
+{
+}
+
+GraphicObject& GraphicObject::operator=(GraphicObject const& object)
+{
+    mType = object.mType;
+    mName = object.mName;
+    return *this;
+}
+
 void GraphicObject::SubscribeForDestruction(eastl::shared_ptr<ListenerForDestruction> const& listener)
 {
     msLFDMutex.lock();
@@ -10,6 +10,7 @@
 
 #include "Graphic/GraphicStd.h"
 
+#include <atomic>
 #include <mutex>
 
 #include <EASTL/set.h>
@@ -120,6 +121,10 @@ public:
     // represented by the ID3D11DeviceChild interface.
     virtual ~GraphicObject();
 
+    // A copy is a new front-end object, it has no bridge object yet.
+    GraphicObject(GraphicObject const& object);
+    GraphicObject& operator=(GraphicObject const& object);
+
     // Run-time type information.
     inline GraphicObjectType GetType() const;
     inline bool IsBuffer() const;
@@ -149,6 +154,13 @@ public:
     static void SubscribeForDestruction(eastl::shared_ptr<ListenerForDestruction> const& listener);
     static void UnsubscribeForDestruction(eastl::shared_ptr<ListenerForDestruction> const& listener);
 
+    // The global renderer caches the bridge object of a front-end object
+    // here, so that binding an object which is already bound is an atomic
+    // load instead of a lookup in the locked bridge map.  The renderer
+    // clears the cache before it destroys the bridge object.
+    inline GraphicObject* GetBridge() const;
+    inline void SetBridge(GraphicObject* bridge) const;
+
 protected:
     // This is an abstract base class.
     GraphicObject();
@@ -157,6 +169,8 @@ protected:
 	eastl::wstring mName;
 
 private:
+    mutable std::atomic<GraphicObject*> mBridge;
+
     // Support for listeners for destruction (LFD).
     static std::recursive_mutex msLFDMutex;
     static eastl::set<eastl::shared_ptr<ListenerForDestruction>> msLFDSet;
@@ -202,4 +216,14 @@ inline eastl::wstring const& GraphicObject::GetName() const
     return mName;
 }
 
+inline GraphicObject* GraphicObject::GetBridge() const
+{
+    return mBridge.load(std::memory_order_acquire);
+}
+
+inline void GraphicObject::SetBridge(GraphicObject* bridge) const
+{
+    mBridge.store(bridge, std::memory_order_release);
+}
+
 #endif
\ No newline at end of file
@@ -22,7 +22,8 @@ Texture::Texture(unsigned int numItems, DFType format,
     mNumLevels(1),
     mLOffset(numItems),
     mHasMipmaps(hasMipmaps),
-    mAutogenerateMipmaps(false)
+    mAutogenerateMipmaps(false),
+    mPrecomputedMipmaps(false)
 {
     mType = GE_TEXTURE;
 
@@ -130,13 +131,22 @@ Texture::Subresource Texture::GetSubresource(unsigned int index) const
 
 void Texture::AutogenerateMipmaps()
 {
-    if (mHasMipmaps)
+    if (mHasMipmaps && !mPrecomputedMipmaps)
     {
         mAutogenerateMipmaps = true;
         //mUsage = SHADER_OUTPUT;
     }
 }
 
+void Texture::SetPrecomputedMipmaps()
+{
+    if (mHasMipmaps)
+    {
+        mPrecomputedMipmaps = true;
+        mAutogenerateMipmaps = false;
+    }
+}
+
 unsigned int Texture::GetTotalElements(unsigned int numItems,
     unsigned int dim0, unsigned int dim1, unsigned int dim2, bool hasMipmaps)
 {
@@ -61,8 +61,12 @@ public:
     // data is modified.  The AutogenerateMipmaps call should be made before
     // binding the texture to the engine.  If the texture does not have mipmaps,
     // the AutogenerateMipmaps call will not set mAutogenerateMipmaps to true.
+    // Neither does it when the mipmap levels were precomputed, for example by
+    // the texture cooker, in which case all the levels are uploaded as is.
     void AutogenerateMipmaps();
     inline bool IsAutogenerateMipmaps() const;
+    void SetPrecomputedMipmaps();
+    inline bool HasPrecomputedMipmaps() const;
 
 protected:
     // Support for computing the numElements parameter for the Resource
@@ -79,6 +83,7 @@ protected:
 	eastl::vector<eastl::array<unsigned int, MAX_MIPMAP_LEVELS>> mLOffset;
     bool mHasMipmaps;
     bool mAutogenerateMipmaps;
+    bool mPrecomputedMipmaps;
 };
 
 typedef eastl::function<void(eastl::shared_ptr<Texture> const&)> TextureUpdater;
@@ -169,4 +174,9 @@ inline bool Texture::IsAutogenerateMipmaps() const
     return mAutogenerateMipmaps;
 }
 
+inline bool Texture::HasPrecomputedMipmaps() const
+{
+    return mPrecomputedMipmaps;
+}
+
 #endif
@@ -19,7 +19,7 @@ AnimatedMeshNode::AnimatedMeshNode(const ActorId actorId, PVWUpdater* updater,
 :	Node(actorId, NT_ANIMATED_MESH),
 	mMesh(0), mStartFrame(0), mEndFrame(0), mFramesPerSecond(0.025f), mCurrentFrameNr(0.f), 
 	mLastTime(0), mLooping(true), mReadOnlyMaterials(false), mRenderFromIdentity(false), 
-	mLoopCallBack(0), mPassCount(0), mShadow(0)
+	mBakedBounds(true), mLoopCallBack(0), mPassCount(0), mShadow(0), mJointMode(JUOR_NONE)
 {
 	mPVWUpdater = updater;
 
@@ -219,7 +219,7 @@ eastl::shared_ptr<BaseMesh> AnimatedMeshNode::GetMeshForCurrentFrame()
 		if (mJointMode == JUOR_CONTROL)//write to mesh
 			skinnedMesh->TransferJointsToMesh(mJointChildSceneNodes);
 		else
-			skinnedMesh->AnimateMesh(GetFrameNr(), 1.0f);
+			skinnedMesh->AnimateMesh(GetFrameNr(), 1.0f, mAnimationCursor);
 
 		// Update the skinned mesh for the current joint transforms.
 		skinnedMesh->SkinMesh();
@@ -295,6 +295,44 @@ bool AnimatedMeshNode::OnAnimate(Scene* pScene, unsigned int time)
 	return Node::OnAnimate(pScene, time);
 }
 
+//! Takes the bounds of the visuals from the ones baked with the mesh for
+//! the current frame and scans the vertices only when there are none.
+void AnimatedMeshNode::UpdateModelBounds()
+{
+	unsigned int visual = 0;
+	if (dynamic_cast<AnimateMeshMD3*>(mMesh.get()))
+	{
+		AnimateMeshMD3* animMeshMD3 = dynamic_cast<AnimateMeshMD3*>(mMesh.get());
+
+		eastl::vector<eastl::shared_ptr<MD3Mesh>> meshes;
+		animMeshMD3->GetMD3Mesh()->GetMeshes(meshes);
+		for (eastl::shared_ptr<MD3Mesh> mesh : meshes)
+		{
+			for (unsigned int i = 0; i < mesh->GetMeshBufferCount() && visual < mVisuals.size(); ++i, ++visual)
+			{
+				const BoundingSphere& bound = mesh->GetMeshBufferBound(i);
+				if (mBakedBounds && bound.GetRadius() > 0.f)
+					mVisuals[visual]->mModelBound = bound;
+				else
+					mVisuals[visual]->UpdateModelBound();
+			}
+		}
+	}
+	else if (mMesh->GetMeshType() == MT_SKINNED && mJointMode != JUOR_CONTROL)
+	{
+		// the joints controlled by the nodes give poses which weren't baked
+		SkinnedMesh* skinnedMesh = static_cast<SkinnedMesh*>(mMesh.get());
+		for (unsigned int i = 0; i < mMesh->GetMeshBufferCount() && visual < mVisuals.size(); ++i, ++visual)
+		{
+			if (!mBakedBounds || !skinnedMesh->GetFrameBound(GetFrameNr(), i, mVisuals[visual]->mModelBound))
+				mVisuals[visual]->UpdateModelBound();
+		}
+	}
+
+	for (; visual < mVisuals.size(); ++visual)
+		mVisuals[visual]->UpdateModelBound();
+}
+
 bool AnimatedMeshNode::PreRender(Scene* pScene)
 {
 	if (IsVisible())
@@ -302,8 +340,7 @@ bool AnimatedMeshNode::PreRender(Scene* pScene)
 		mCurrentFrameMesh = GetMeshForCurrentFrame();
 
 		// update bbox
-		for (auto visual : mVisuals)
-			visual->UpdateModelBound();
+		UpdateModelBounds();
 
 		// because this node supports rendering of mixed mode meshes consisting of
 		// transparent and solid material at the same time, we need to go through all
@@ -784,6 +821,12 @@ void AnimatedMeshNode::SetRenderFromIdentity(bool enable)
 	mRenderFromIdentity = enable;
 }
 
+//! Sets if the bounds baked with the mesh are used.
+void AnimatedMeshNode::SetBakedBounds(bool baked)
+{
+	mBakedBounds = baked;
+}
+
 //! Creates shadow volume scene node as child of this node
 //! and returns a pointer to it.
 eastl::shared_ptr<ShadowVolumeNode> AnimatedMeshNode::AddShadowVolumeNode(const ActorId actorId,
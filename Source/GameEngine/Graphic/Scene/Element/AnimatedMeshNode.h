@@ -8,6 +8,8 @@
 #include "BoneNode.h"
 #include "ShadowVolumeNode.h"
 
+#include "Graphic/Scene/Element/Mesh/SkinnedMesh.h"
+
 enum GRAPHIC_ITEM JointUpdateOnRender
 {
 	//! do nothing
@@ -198,6 +200,11 @@ public:
 	//! Returns if the scene node should not copy the materials of the mesh but use them in a read only style
 	bool IsReadOnlyMaterials() const;
 
+	//! Sets if the bounds baked with the mesh are used, which is the default.
+	/** Turn it off when the vertices are changed outside of the animation,
+	the bounds are then computed from the vertices every frame. */
+	void SetBakedBounds(bool baked);
+
 private:
 
 	void Render(unsigned int& visual, bool isTransparentPass, Scene *pScene, 
@@ -207,6 +214,7 @@ private:
 	eastl::shared_ptr<BaseMesh> GetMeshForCurrentFrame();
 
 	void BuildFrameNr(unsigned int timeMs);
+	void UpdateModelBounds();
 	void CheckJoints();
 	void BeginTransition();
 
@@ -231,6 +239,7 @@ private:
 	bool mLooping;
 	bool mReadOnlyMaterials;
 	bool mRenderFromIdentity;
+	bool mBakedBounds;
 
 	eastl::shared_ptr<AnimationEndCallBack> mLoopCallBack;
 	int mPassCount;
@@ -243,6 +252,9 @@ private:
 
 	eastl::vector<eastl::shared_ptr<BoneNode>> mJointChildSceneNodes;
 	eastl::vector<Transform> mPretransitingSave;
+
+	//keyframe hints of this node in its skinned mesh
+	SkinnedMesh::AnimationCursor mAnimationCursor;
 };
 
 
@@ -8,6 +8,61 @@
 #include "Core/IO/Filesystem.h"
 #include "Core/Utility/StringUtil.h"
 
+#include <xmmintrin.h>
+
+namespace
+{
+	// Interpolates four vertices of the x, y and z arrays of two frames and
+	// writes the ones below count as float3 into the interleaved vertices.
+	inline void LerpVertices(const float* frameA, const float* frameB, unsigned int stride,
+		__m128 interpolation, char* vertices, unsigned int vertexSize, unsigned int count)
+	{
+		__m128 x = _mm_loadu_ps(frameA);
+		__m128 y = _mm_loadu_ps(frameA + stride);
+		__m128 z = _mm_loadu_ps(frameA + stride * 2);
+		x = _mm_add_ps(x, _mm_mul_ps(interpolation, _mm_sub_ps(_mm_loadu_ps(frameB), x)));
+		y = _mm_add_ps(y, _mm_mul_ps(interpolation, _mm_sub_ps(_mm_loadu_ps(frameB + stride), y)));
+		z = _mm_add_ps(z, _mm_mul_ps(interpolation, _mm_sub_ps(_mm_loadu_ps(frameB + stride * 2), z)));
+
+		__m128 w = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		// only three floats per vertex, the rest belongs to other attributes
+		const __m128 vertex[4] = { x, y, z, w };
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			float* dest = (float*)(vertices + i * vertexSize);
+			_mm_storel_pi((__m64*)dest, vertex[i]);
+			_mm_store_ss(dest + 2, _mm_movehl_ps(vertex[i], vertex[i]));
+		}
+	}
+
+	// Writes the positions and normals interpolated between two frames of
+	// a md3 buffer into the vertex buffer.
+	void LerpFrames(const MD3MeshBuffer& source, unsigned int frameA, unsigned int frameB,
+		float interpolate, VertexBuffer& vbuffer)
+	{
+		const VertexFormat& vformat = vbuffer.GetFormat();
+		const unsigned int vertexSize = vformat.GetVertexSize();
+		char* positions = vbuffer.GetData() + vformat.GetOffset(vformat.GetIndex(VA_POSITION, 0));
+		char* normals = vbuffer.GetData() + vformat.GetOffset(vformat.GetIndex(VA_NORMAL, 0));
+
+		const unsigned int numVertices = source.mMeshHeader.numVertices;
+		const unsigned int stride = source.mFrameStride;
+		const float* sourceA = source.GetFrame(frameA);
+		const float* sourceB = source.GetFrame(frameB);
+		const __m128 interpolation = _mm_set1_ps(interpolate);
+		for (unsigned int i = 0; i < numVertices; i += 4)
+		{
+			const unsigned int count = eastl::min(4u, numVertices - i);
+			LerpVertices(sourceA + i, sourceB + i, stride,
+				interpolation, positions + i * vertexSize, vertexSize, count);
+			LerpVertices(sourceA + stride * 3 + i, sourceB + stride * 3 + i, stride,
+				interpolation, normals + i * vertexSize, vertexSize, count);
+		}
+	}
+}
+
 void MD3Mesh::SetInterpolationShift(unsigned int shift, unsigned int loopMode)
 {
 	mInterPolShift = shift;
@@ -44,6 +99,9 @@ void MD3Mesh::AddMeshBuffer(BaseMeshBuffer* meshBuffer)
 {
 	eastl::shared_ptr<MeshBuffer> buffer((MeshBuffer*)meshBuffer);
 	mBufferInterpol.push_back(buffer);
+
+	// no baked bound, it has to come from the vertices
+	mBoundInterpol.push_back(BoundingSphere());
 }
 
 //! create a MeshBuffer for a MD3 MeshBuffer
@@ -60,11 +118,8 @@ eastl::shared_ptr<MeshBuffer> MD3Mesh::CreateMeshBuffer(const eastl::shared_ptr<
 	// fill in buffer info
 	dest->SetName(ToWideString(source->mMeshHeader.meshName));
 	for (unsigned int i = 0; i < source->mMeshHeader.numVertices; ++i)
-	{
-		dest->Position(i) = source->mPositions[i];
-		dest->Normal(i) = source->mNormals[i];
 		dest->TCoord(0, i) = Vector2<float>{ source->mTexCoords[i].u, source->mTexCoords[i].v };
-	}
+	LerpFrames(*source, 0, 0, 0.f, *dest->GetVertice());
 
 	// Fill in all triangles
 	unsigned int iCurrent = 0;
@@ -80,6 +135,12 @@ eastl::shared_ptr<MeshBuffer> MD3Mesh::CreateMeshBuffer(const eastl::shared_ptr<
 	return dest;
 }
 
+//! returns the bound of a mesh buffer in its current pose
+const BoundingSphere& MD3Mesh::GetMeshBufferBound(unsigned int nr) const
+{
+	return mBoundInterpol[nr];
+}
+
 int MD3Mesh::AttachChild(eastl::shared_ptr<MD3Mesh> const& child)
 {
 	if (!child)
@@ -309,37 +370,56 @@ bool MD3Mesh::UpdateMesh(int frame, int detailLevel, int startFrameLoop, int end
 }
 
 //! build final mesh's vertices from frames frameA and frameB with linear interpolation.
+/** Instances of the same model showing the same pose share its vertices through
+the pose cache, so only the first one interpolates them and the others point
+their vertex buffer to the cached pose. */
 void MD3Mesh::BuildVertexArray(unsigned int meshId,
 	unsigned int frameA, unsigned int frameB, float interpolate)
 {
-	const unsigned int frameOffsetA = frameA * mBufferInterpol[meshId]->GetVertice()->GetNumElements();
-	const unsigned int frameOffsetB = frameB * mBufferInterpol[meshId]->GetVertice()->GetNumElements();
-
-	for (unsigned int i = 0; i != mBuffer[meshId]->mMeshHeader.numTriangles; ++i)
-	{
-		for (unsigned int idx = 0; idx < 3; idx++)
-		{
-			int index = mBuffer[meshId]->mFaces[i].index[idx];
+	const eastl::shared_ptr<MD3MeshBuffer>& source = mBuffer[meshId];
+	const eastl::shared_ptr<VertexBuffer>& vertices = mBufferInterpol[meshId]->GetVertice();
 
-			const Vector3<float> &vA = mBuffer[meshId]->mPositions[frameOffsetA + index];
-			const Vector3<float> &vB = mBuffer[meshId]->mPositions[frameOffsetB + index];
+	if (mPoseInterpol.size() < mBufferInterpol.size())
+		mPoseInterpol.resize(mBufferInterpol.size());
 
-			// position
-			mBufferInterpol[meshId]->Position(index)[0] = vA[0] + interpolate * (vB[0] - vA[0]);
-			mBufferInterpol[meshId]->Position(index)[1] = vA[1] + interpolate * (vB[1] - vA[1]);
-			mBufferInterpol[meshId]->Position(index)[2] = vA[2] + interpolate * (vB[2] - vA[2]);
+	MeshPoseCache* poseCache = MeshPoseCache::Get();
+	MeshPoseCache::Key key(source.get(), frameA, frameB, interpolate);
+	if (poseCache)
+	{
+		// evaluate the pose the cache stands for
+		frameA = key.mFrameA;
+		frameB = key.mFrameB;
+		interpolate = key.mBucket / (float)MeshPoseCache::InterpolationBuckets;
+	}
 
-			// normal
-			const Vector3<float> &nA = mBuffer[meshId]->mNormals[frameOffsetA + index];
-			const Vector3<float> &nB = mBuffer[meshId]->mNormals[frameOffsetB + index];
+	// The vertices are interpolated linearly, so are the bounds of the key
+	// frames. The result contains every interpolated vertex.
+	const BoundingSphere& boundA = source->mFrameBounds[frameA];
+	const BoundingSphere& boundB = source->mFrameBounds[frameB];
+	BoundingSphere& bound = mBoundInterpol[meshId];
+	bound.SetCenter(boundA.GetCenter() + interpolate * (boundB.GetCenter() - boundA.GetCenter()));
+	bound.SetRadius(boundA.GetRadius() + interpolate * (boundB.GetRadius() - boundA.GetRadius()));
 
-			mBufferInterpol[meshId]->Normal(index)[0] = nA[0] + interpolate * (nB[0] - nA[0]);
-			mBufferInterpol[meshId]->Normal(index)[1] = nA[1] + interpolate * (nB[1] - nA[1]);
-			mBufferInterpol[meshId]->Normal(index)[2] = nA[2] + interpolate * (nB[2] - nA[2]);
+	if (poseCache)
+	{
+		eastl::shared_ptr<const MeshPoseCache::Pose> pose = poseCache->Find(key);
+		if (pose && pose->size() == vertices->GetNumBytes())
+		{
+			// the buffer reads the cached pose, which we hold on to until the
+			// next one. The renderer only reads the interpolated vertices.
+			mPoseInterpol[meshId] = pose;
+			vertices->SetData(const_cast<char*>(pose->data()));
+			return;
 		}
 	}
 
-	//dest->recalculateBoundingBox();
+	// back to our own vertices before writing them
+	mPoseInterpol[meshId] = nullptr;
+	vertices->ResetData();
+	LerpFrames(*source, frameA, frameB, interpolate, *vertices);
+
+	if (poseCache)
+		poseCache->Store(key, vertices->GetData(), vertices->GetNumBytes());
 }
 
 //! build final mesh's tag from frames frameA and frameB with linear interpolation.
@@ -543,28 +623,63 @@ bool MD3Mesh::LoadModel(eastl::wstring& path)
 			eastl::swap(face.index[0], face.index[2]);
 		}
 
-		//! prepare memory
-		buf->mNormals = eastl::vector<Vector3<float>>(meshHeader.numVertices * meshHeader.numFrames);
-		buf->mPositions = eastl::vector<Vector3<float>>(meshHeader.numVertices * meshHeader.numFrames);
+		//! prepare memory, the frames are split in arrays of x, y and z
+		buf->mFrameStride = (meshHeader.numVertices + 3) & ~3u;
+		buf->mFrames = eastl::vector<float>(buf->mFrameStride * 6 * meshHeader.numFrames, 0.f);
 
-		// Fill in all triangles
 		const float scale = (1.f / 64.f);
-		for (unsigned int i = 0; i < meshHeader.numVertices * meshHeader.numFrames; ++i)
+		for (unsigned int frame = 0; frame < meshHeader.numFrames; ++frame)
+		{
+			float* positions = buf->mFrames.data() + frame * buf->mFrameStride * 6;
+			float* normals = positions + buf->mFrameStride * 3;
+			for (unsigned int i = 0; i < meshHeader.numVertices; ++i)
+			{
+				const MD3Vertex& vertex = vertices[frame * meshHeader.numVertices + i];
+
+				// Read vertices
+				positions[i] = vertex.position[0] * scale;
+				positions[buf->mFrameStride + i] = vertex.position[1] * scale;
+				positions[buf->mFrameStride * 2 + i] = vertex.position[2] * scale;
+
+				// Convert the normal vector to uncompressed float3 format
+				float normal[3];
+				LatLngNormalToVec3(vertex.normal, normal);
+				normals[i] = normal[0];
+				normals[buf->mFrameStride + i] = normal[1];
+				normals[buf->mFrameStride * 2 + i] = normal[2];
+			}
+		}
+
+		//! bake the bound of every frame, the center is the average of the
+		//! positions and the radius the largest distance from it
+		buf->mFrameBounds.resize(meshHeader.numFrames);
+		for (unsigned int frame = 0; frame < meshHeader.numFrames && meshHeader.numVertices; ++frame)
 		{
-			// Read vertices
-			Vector3<float>& position = buf->mPositions[i];
-			position[0] = vertices[i].position[0] * scale;
-			position[1] = vertices[i].position[1] * scale;
-			position[2] = vertices[i].position[2] * scale;
-
-			// Convert the normal vector to uncompressed float3 format
-			Vector3<float>& normal = buf->mNormals[i];
-			LatLngNormalToVec3(vertices[i].normal, (float*)&normal);
+			const float* positions = buf->GetFrame(frame);
+			Vector3<float> center = Vector3<float>::Zero();
+			for (unsigned int i = 0; i < meshHeader.numVertices; ++i)
+			{
+				center += Vector3<float>{ positions[i],
+					positions[buf->mFrameStride + i], positions[buf->mFrameStride * 2 + i] };
+			}
+			center /= (float)meshHeader.numVertices;
+
+			float radius = 0.f;
+			for (unsigned int i = 0; i < meshHeader.numVertices; ++i)
+			{
+				const Vector3<float> diff = Vector3<float>{ positions[i],
+					positions[buf->mFrameStride + i], positions[buf->mFrameStride * 2 + i] } - center;
+				radius = eastl::max(radius, Dot(diff, diff));
+			}
+
+			buf->mFrameBounds[frame].SetCenter(HLift(center, 1.f));
+			buf->mFrameBounds[frame].SetRadius(sqrt(radius));
 		}
 
 		//! store meshBuffer
 		mBuffer.push_back(buf);
 		mBufferInterpol.push_back(CreateMeshBuffer(buf));
+		mBoundInterpol.push_back(buf->mFrameBounds.size() ? buf->mFrameBounds[0] : BoundingSphere());
 
 		offset += meshHeader.offsetEnd;
 	}
@@ -6,6 +6,8 @@
 #define MESHMD3_H
 
 #include "Graphic/Scene/Element/Mesh/Mesh.h"
+#include "Graphic/Scene/Element/Mesh/MeshPoseCache.h"
+#include "Graphic/Scene/Hierarchy/BoundingSphere.h"
 
 #include "Mathematic/Algebra/Rotation.h"
 
@@ -150,12 +152,29 @@ struct AnimationData
 //! Holding Frame Data for a Mesh
 struct MD3MeshBuffer
 {
+	MD3MeshBuffer() : mFrameStride(0)
+	{
+
+	}
+
 	MD3MeshHeader mMeshHeader;
 
 	eastl::vector<MD3Face> mFaces;
 	eastl::vector<MD3TexCoord> mTexCoords;
-	eastl::vector<Vector3<float>> mNormals;
-	eastl::vector<Vector3<float>> mPositions;
+
+	//! vertex frames as structure of arrays. Each frame holds the x, y, z
+	//! arrays of the positions followed by the ones of the normals, every
+	//! array padded to mFrameStride floats, a multiple of 4 vertices.
+	eastl::vector<float> mFrames;
+	unsigned int mFrameStride;
+
+	const float* GetFrame(unsigned int frame) const
+	{
+		return mFrames.data() + frame * mFrameStride * 6;
+	}
+
+	//! bound of the positions of every frame, baked at load time
+	eastl::vector<BoundingSphere> mFrameBounds;
 };
 
 //! hold a tag info for connecting meshes
@@ -285,6 +304,16 @@ public:
 
 	virtual ~MD3Mesh()
 	{
+		// the cached poses are keyed by our source buffers
+		if (MeshPoseCache::Get())
+			for (unsigned int i = 0; i < mBuffer.size(); ++i)
+				MeshPoseCache::Get()->Remove(mBuffer[i].get());
+
+		// the buffers may outlive the cached poses they point to
+		for (unsigned int i = 0; i < mPoseInterpol.size(); ++i)
+			if (mPoseInterpol[i])
+				mBufferInterpol[i]->GetVertice()->ResetData();
+		mPoseInterpol.clear();
 		mBufferInterpol.clear();
 
 		// delete all children
@@ -327,6 +356,9 @@ public:
 
 	eastl::shared_ptr<MeshBuffer> CreateMeshBuffer(const eastl::shared_ptr<MD3MeshBuffer>& source);
 
+	//! returns the bound of a mesh buffer in its current pose
+	const BoundingSphere& GetMeshBufferBound(unsigned int nr) const;
+
 	void BuildFrameNr(bool loop, unsigned int timeMs);
 	void BuildVertexArray(unsigned int meshId, unsigned int frameA, unsigned int frameB, float interpolate);
 	void BuildTagArray(unsigned int frameA, unsigned int frameB, float interpolate);
@@ -418,6 +450,10 @@ private:
 
 	eastl::vector<eastl::shared_ptr<MD3MeshBuffer>> mBuffer;
 	eastl::vector<eastl::shared_ptr<MeshBuffer>> mBufferInterpol;
+	eastl::vector<BoundingSphere> mBoundInterpol;
+
+	// the cached poses our interpolated buffers point to, if any
+	eastl::vector<eastl::shared_ptr<const MeshPoseCache::Pose>> mPoseInterpol;
 };
 
 class AnimateMeshMD3 : public BaseAnimatedMesh
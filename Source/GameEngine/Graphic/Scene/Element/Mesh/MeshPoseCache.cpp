@@ -0,0 +1,187 @@
+//========================================================================
+// MeshPoseCache.cpp : Keeps the vertices of animated mesh poses so that
+// the instances of a model which show the same pose share its evaluation.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "MeshPoseCache.h"
+
+#include "Core/Logger/Logger.h"
+
+#include <climits>
+
+MeshPoseCache* MeshPoseCache::mPoseCache = nullptr;
+
+MeshPoseCache::Key::Key(const void* mesh, int frameA, int frameB, float interpolation)
+	: mMesh(mesh), mFrameA(frameA), mFrameB(frameB)
+{
+	mBucket = (unsigned int)(interpolation * InterpolationBuckets + 0.5f);
+	if (mBucket >= InterpolationBuckets)
+	{
+		mBucket = 0;
+		mFrameA = frameB;
+	}
+
+	// a pose right on a key frame doesn't depend on the next one
+	if (mBucket == 0)
+		mFrameB = mFrameA;
+}
+
+bool MeshPoseCache::Key::operator<(const Key& other) const
+{
+	if (mMesh != other.mMesh)
+		return mMesh < other.mMesh;
+	if (mFrameA != other.mFrameA)
+		return mFrameA < other.mFrameA;
+	if (mFrameB != other.mFrameB)
+		return mFrameB < other.mFrameB;
+	return mBucket < other.mBucket;
+}
+
+float MeshPoseCache::Statistics::GetHitRate() const
+{
+	unsigned int requests = mHits + mMisses;
+	return requests > 0 ? (float)mHits / (float)requests : 0.f;
+}
+
+MeshPoseCache* MeshPoseCache::Get()
+{
+	return MeshPoseCache::mPoseCache;
+}
+
+MeshPoseCache::MeshPoseCache(size_t memoryCap, bool setAsGlobal)
+	: mMemory(0), mMemoryCap(memoryCap), mHits(0), mMisses(0), mEvictions(0)
+{
+	if (setAsGlobal)
+	{
+		if (MeshPoseCache::mPoseCache)
+		{
+			LogError("Attempting to create two global pose caches! \
+					The old one will be destroyed and overwritten with this one.");
+			delete MeshPoseCache::mPoseCache;
+		}
+
+		MeshPoseCache::mPoseCache = this;
+	}
+}
+
+MeshPoseCache::~MeshPoseCache()
+{
+	Clear();
+
+	if (MeshPoseCache::mPoseCache == this)
+		MeshPoseCache::mPoseCache = nullptr;
+}
+
+eastl::shared_ptr<const MeshPoseCache::Pose> MeshPoseCache::Find(const Key& key)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto itPose = mPoses.find(key);
+	if (itPose == mPoses.end())
+	{
+		mMisses++;
+		return nullptr;
+	}
+
+	mHits++;
+	mUses.splice(mUses.begin(), mUses, itPose->second.mUse);
+	return itPose->second.mPose;
+}
+
+void MeshPoseCache::Store(const Key& key, const char* data, size_t size)
+{
+	if (size > mMemoryCap)
+		return;
+
+	eastl::shared_ptr<Pose> pose = eastl::make_shared<Pose>(data, data + size);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto itPose = mPoses.find(key);
+	if (itPose != mPoses.end())
+	{
+		// another instance evaluated the same pose in the meantime
+		mUses.splice(mUses.begin(), mUses, itPose->second.mUse);
+		return;
+	}
+
+	Evict(mMemoryCap - size);
+
+	Entry entry;
+	entry.mPose = pose;
+	entry.mUse = mUses.insert(mUses.begin(), key);
+	mPoses[key] = entry;
+	mMemory += size;
+}
+
+void MeshPoseCache::Remove(const void* mesh)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto itPose = mPoses.lower_bound(Key(mesh, INT_MIN, INT_MIN, 0.f));
+	while (itPose != mPoses.end() && itPose->first.mMesh == mesh)
+	{
+		mMemory -= itPose->second.mPose->size();
+		mUses.erase(itPose->second.mUse);
+		itPose = mPoses.erase(itPose);
+	}
+}
+
+void MeshPoseCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	mPoses.clear();
+	mUses.clear();
+	mMemory = 0;
+}
+
+void MeshPoseCache::Evict(size_t memory)
+{
+	while (mMemory > memory && !mUses.empty())
+	{
+		auto itPose = mPoses.find(mUses.back());
+		mMemory -= itPose->second.mPose->size();
+		mPoses.erase(itPose);
+		mUses.pop_back();
+		mEvictions++;
+	}
+}
+
+MeshPoseCache::Statistics MeshPoseCache::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	Statistics statistics;
+	statistics.mHits = mHits;
+	statistics.mMisses = mMisses;
+	statistics.mEvictions = mEvictions;
+	statistics.mNumPoses = (unsigned int)mPoses.size();
+	statistics.mMemory = mMemory;
+	statistics.mMemoryCap = mMemoryCap;
+	return statistics;
+}
+
+void MeshPoseCache::ResetStatistics()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	mHits = 0;
+	mMisses = 0;
+	mEvictions = 0;
+}
+
+void MeshPoseCache::LogStatistics() const
+{
+	Statistics statistics = GetStatistics();
+	LogInformation("Pose cache: " + eastl::to_string(statistics.mHits) + " hits, " +
+		eastl::to_string(statistics.mMisses) + " misses (" +
+		eastl::to_string((int)(statistics.GetHitRate() * 100.f)) + "% hit rate), " +
+		eastl::to_string(statistics.mEvictions) + " evictions, " +
+		eastl::to_string(statistics.mNumPoses) + " poses in " +
+		eastl::to_string((unsigned int)(statistics.mMemory / 1024)) + " of " +
+		eastl::to_string((unsigned int)(statistics.mMemoryCap / 1024)) + " KB");
+}
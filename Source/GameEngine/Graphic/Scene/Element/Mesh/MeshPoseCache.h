@@ -0,0 +1,102 @@
+//========================================================================
+// MeshPoseCache.h : Keeps the vertices of animated mesh poses so that
+// the instances of a model which show the same pose share its evaluation.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef MESHPOSECACHE_H
+#define MESHPOSECACHE_H
+
+#include "Core/CoreStd.h"
+
+#include <mutex>
+
+// Poses are keyed by the source mesh data, the pair of key frames and the
+// interpolation bucket between them. The first instance asking for a pose
+// evaluates it and stores the resulting vertices, the following ones read
+// them from the cache instead of their own buffers. The poses are handed out
+// read-only and shared, so an eviction never invalidates a pose somebody is
+// still reading. The least
+// recently used poses are evicted once the memory cap is reached.
+class MeshPoseCache
+{
+public:
+	// Interpolation between two key frames is split in this many buckets.
+	static const unsigned int InterpolationBuckets = 256;
+
+	typedef eastl::vector<char> Pose;
+
+	struct Key
+	{
+		Key(const void* mesh = nullptr, int frameA = 0, int frameB = 0, float interpolation = 0.f);
+
+		bool operator<(const Key& other) const;
+
+		const void* mMesh;
+		int mFrameA;
+		int mFrameB;
+		unsigned int mBucket;
+	};
+
+	struct Statistics
+	{
+		unsigned int mHits;
+		unsigned int mMisses;
+		unsigned int mEvictions;
+		unsigned int mNumPoses;
+		size_t mMemory;
+		size_t mMemoryCap;
+
+		float GetHitRate() const;
+	};
+
+	// Construction and destruction. The cache can be set as global so that
+	// it is reachable through MeshPoseCache::Get.
+	MeshPoseCache(size_t memoryCap, bool setAsGlobal = true);
+	~MeshPoseCache();
+
+	// The global cache or nullptr if poses aren't cached.
+	static MeshPoseCache* Get();
+
+	// Returns the pose for the key or nullptr if it isn't cached.
+	eastl::shared_ptr<const Pose> Find(const Key& key);
+
+	// Stores a copy of the pose for the key.
+	void Store(const Key& key, const char* data, size_t size);
+
+	// Drops every pose of the mesh, for when its data goes away.
+	void Remove(const void* mesh);
+	void Clear();
+
+	Statistics GetStatistics() const;
+	void ResetStatistics();
+	void LogStatistics() const;
+
+private:
+	typedef eastl::list<Key> KeyList;
+
+	struct Entry
+	{
+		eastl::shared_ptr<const Pose> mPose;
+		KeyList::iterator mUse;
+	};
+
+	void Evict(size_t memory);
+
+	eastl::map<Key, Entry> mPoses;
+	KeyList mUses; // most recently used first
+	size_t mMemory;
+	size_t mMemoryCap;
+
+	unsigned int mHits;
+	unsigned int mMisses;
+	unsigned int mEvictions;
+
+	mutable std::mutex mMutex;
+
+	static MeshPoseCache* mPoseCache;
+};
+
+#endif
@@ -7,10 +7,28 @@
 
 #include "Mathematic/Function/Functions.h"
 
+#include "Core/OS/OS.h"
+#include "Core/Threading/JobSystem.h"
+
 #include "Graphic/Scene/Scene.h"
 #include "Graphic/Scene/Element/BoneNode.h"
 #include "Graphic/Scene/Element/AnimatedMeshNode.h"
 
+#include <xmmintrin.h>
+
+namespace
+{
+	// adds the rows of a joint skinning transform scaled by its weight
+	inline void BlendJointRows(__m128& row0, __m128& row1, __m128& row2, __m128& row3,
+		const float* matrix, __m128 strength)
+	{
+		row0 = _mm_add_ps(row0, _mm_mul_ps(strength, _mm_loadu_ps(matrix + 0)));
+		row1 = _mm_add_ps(row1, _mm_mul_ps(strength, _mm_loadu_ps(matrix + 4)));
+		row2 = _mm_add_ps(row2, _mm_mul_ps(strength, _mm_loadu_ps(matrix + 8)));
+		row3 = _mm_add_ps(row3, _mm_mul_ps(strength, _mm_loadu_ps(matrix + 12)));
+	}
+}
+
 //! constructor
 SkinnedMesh::SkinnedMesh()
 : mAnimationFrames(0.f), mFramesPerSecond(25.f), mLastAnimatedFrame(-1), 
@@ -82,6 +100,22 @@ eastl::shared_ptr<BaseMesh> SkinnedMesh::GetMesh(int frame, int detailLevel, int
 //! Animates this mesh's joints based on frame input
 //! blend: {0-old position, 1-New position}
 void SkinnedMesh::AnimateMesh(float frame, float blend)
+{
+	AnimateJoints(frame, blend, nullptr);
+}
+
+
+//! Animates this mesh's joints with the keyframe cursors of an instance
+void SkinnedMesh::AnimateMesh(float frame, float blend, AnimationCursor& cursor)
+{
+	if (cursor.size() != mAllJoints.size() * 3)
+		cursor.assign(mAllJoints.size() * 3, -1);
+
+	AnimateJoints(frame, blend, cursor.data());
+}
+
+
+void SkinnedMesh::AnimateJoints(float frame, float blend, int* cursor)
 {
 	if (!mHasAnimation || mLastAnimatedFrame==frame)
 		return;
@@ -107,10 +141,21 @@ void SkinnedMesh::AnimateMesh(float frame, float blend)
 		Vector3<float> scale = oldScale;
 		Quaternion<float> rotation = oldRotation;
 
-		GetFrameData(frame, joint,
+		//the mesh keeps its own hints in the joints
+		if (cursor)
+		{
+			GetFrameData(frame, mJointTracks[i],
+				position, cursor[i * 3 + 0],
+				scale, cursor[i * 3 + 1],
+				rotation, cursor[i * 3 + 2]);
+		}
+		else
+		{
+			GetFrameData(frame, mJointTracks[i],
 				position, joint->mPositionHint,
 				scale, joint->mScaleHint,
 				rotation, joint->mRotationHint);
+		}
 
 		if (blend==1.0f)
 		{
@@ -238,214 +283,245 @@ void SkinnedMesh::BuildAllGlobalAnimatedMatrices(Joint *joint, Joint *parentJoin
 		BuildAllGlobalAnimatedMatrices(joint->mChildren[j], joint);
 }
 
-void SkinnedMesh::GetFrameData(float frame, Joint *joint,
+void SkinnedMesh::GetFrameData(float frame, const JointTrack& track,
 	Vector3<float> &position, int &positionHint,
 	Vector3<float> &scale, int &scaleHint,
 	Quaternion<float> &rotation, int &rotationHint)
 {
-	int foundPositionIndex = -1;
-	int foundScaleIndex = -1;
-	int foundRotationIndex = -1;
-
-	if (joint->mUseAnimationFrom)
+	if (track.mBakedRate > 0.f && mInterpolationMode == IM_LINEAR)
 	{
-		const eastl::vector<PositionKey> &positionKeys=joint->mUseAnimationFrom->mPositionKeys;
-		const eastl::vector<ScaleKey> &scaleKeys=joint->mUseAnimationFrom->mScaleKeys;
-		const eastl::vector<RotationKey> &rotationKeys=joint->mUseAnimationFrom->mRotationKeys;
-
-		if (positionKeys.size())
+		//the baked samples are looked up straight from the frame. Lerp gives
+		//its second argument at 0 and its first at 1.
+		if (frame > mAnimationFrames)
+			return;
+
+		unsigned int sample;
+		float t;
+		if (!track.mBakedPositions.empty())
+		{
+			GetBakedSample(track, (unsigned int)track.mBakedPositions.size(), frame, sample, t);
+			position = Function<float>::Lerp(
+				track.mBakedPositions[sample + 1], track.mBakedPositions[sample], t);
+		}
+		if (!track.mBakedScales.empty())
+		{
+			GetBakedSample(track, (unsigned int)track.mBakedScales.size(), frame, sample, t);
+			scale = Function<float>::Lerp(
+				track.mBakedScales[sample + 1], track.mBakedScales[sample], t);
+		}
+		if (!track.mBakedRotations.empty())
 		{
-			foundPositionIndex = -1;
+			GetBakedSample(track, (unsigned int)track.mBakedRotations.size(), frame, sample, t);
+			rotation = Slerp(t, track.mBakedRotations[sample], track.mBakedRotations[sample + 1]);
+		}
+		return;
+	}
 
-			//Test the Hints...
-			if (positionHint>=0 && (unsigned int)positionHint < positionKeys.size())
-			{
-				//check this hint
-				if (positionHint > 0 &&
-					positionKeys[positionHint].mFrame >= frame &&
-					positionKeys[positionHint - 1].mFrame < frame)
-				{
-					foundPositionIndex = positionHint;
-				}
-				else if (positionHint+1 < (int)positionKeys.size())
-				{
-					//check the next index
-					if (positionKeys[positionHint+1].mFrame>=frame &&
-						positionKeys[positionHint+0].mFrame<frame)
-					{
-						positionHint++;
-						foundPositionIndex=positionHint;
-					}
-				}
-			}
+	if (track.mPositionFrames.size())
+	{
+		const int foundPositionIndex = FindKey(track.mPositionFrames, frame, positionHint);
 
-			//The hint test failed, do a full scan...
-			if (foundPositionIndex==-1)
+		//Do interpolation...
+		if (foundPositionIndex!=-1)
+		{
+			if (mInterpolationMode==IM_CONSTANT || foundPositionIndex==0)
 			{
-				for (unsigned int i=0; i<positionKeys.size(); ++i)
-				{
-					if (positionKeys[i].mFrame >= frame) //Keys should to be sorted by frame
-					{
-						foundPositionIndex=i;
-						positionHint=i;
-						break;
-					}
-				}
+				position = track.mPositions[foundPositionIndex];
 			}
-
-			//Do interpolation...
-			if (foundPositionIndex!=-1)
+			else if (mInterpolationMode==IM_LINEAR)
 			{
-				if (mInterpolationMode==IM_CONSTANT || foundPositionIndex==0)
-				{
-					position = positionKeys[foundPositionIndex].mPosition;
-				}
-				else if (mInterpolationMode==IM_LINEAR)
-				{
-					const PositionKey& keyA = positionKeys[foundPositionIndex];
-					const PositionKey& keyB = positionKeys[foundPositionIndex-1];
+				const Vector3<float>& keyA = track.mPositions[foundPositionIndex];
+				const Vector3<float>& keyB = track.mPositions[foundPositionIndex-1];
 
-					const float fd1 = frame - keyA.mFrame;
-					const float fd2 = keyB.mFrame - frame;
-					position = ((keyB.mPosition-keyA.mPosition)/(fd1+fd2))*fd1 + keyA.mPosition;
-				}
+				const float fd1 = frame - track.mPositionFrames[foundPositionIndex];
+				const float fd2 = track.mPositionFrames[foundPositionIndex-1] - frame;
+				position = ((keyB-keyA)/(fd1+fd2))*fd1 + keyA;
 			}
 		}
+	}
 
-		//------------------------------------------------------------
+	//------------------------------------------------------------
 
-		if (scaleKeys.size())
-		{
-			foundScaleIndex = -1;
+	if (track.mScaleFrames.size())
+	{
+		const int foundScaleIndex = FindKey(track.mScaleFrames, frame, scaleHint);
 
-			//Test the Hints...
-			if (scaleHint>=0 && (unsigned int)scaleHint < scaleKeys.size())
+		//Do interpolation...
+		if (foundScaleIndex!=-1)
+		{
+			if (mInterpolationMode==IM_CONSTANT || foundScaleIndex==0)
 			{
-				//check this hint
-				if (scaleHint > 0 &&
-					scaleKeys[scaleHint].mFrame >= frame &&
-					scaleKeys[scaleHint - 1].mFrame < frame)
-				{
-					foundScaleIndex = scaleHint;
-				}
-				else if (scaleHint+1 < (int)scaleKeys.size())
-				{
-					//check the next index
-					if (scaleKeys[scaleHint+1].mFrame>=frame &&
-						scaleKeys[scaleHint+0].mFrame<frame)
-					{
-						scaleHint++;
-						foundScaleIndex=scaleHint;
-					}
-				}
+				scale = track.mScales[foundScaleIndex];
+			}
+			else if (mInterpolationMode==IM_LINEAR)
+			{
+				const Vector3<float>& keyA = track.mScales[foundScaleIndex];
+				const Vector3<float>& keyB = track.mScales[foundScaleIndex-1];
+
+				const float fd1 = frame - track.mScaleFrames[foundScaleIndex];
+				const float fd2 = track.mScaleFrames[foundScaleIndex-1] - frame;
+				scale = ((keyB-keyA)/(fd1+fd2))*fd1 + keyA;
 			}
+		}
+	}
 
+	//-------------------------------------------------------------
 
-			//The hint test failed, do a full scan...
-			if (foundScaleIndex==-1)
+	if (track.mRotationFrames.size())
+	{
+		const int foundRotationIndex = FindKey(track.mRotationFrames, frame, rotationHint);
+
+		//Do interpolation...
+		if (foundRotationIndex!=-1)
+		{
+			if (mInterpolationMode==IM_CONSTANT || foundRotationIndex==0)
 			{
-				for (unsigned int i=0; i<scaleKeys.size(); ++i)
-				{
-					if (scaleKeys[i].mFrame >= frame) //Keys should to be sorted by frame
-					{
-						foundScaleIndex=i;
-						scaleHint=i;
-						break;
-					}
-				}
+				rotation = track.mRotations[foundRotationIndex];
 			}
-
-			//Do interpolation...
-			if (foundScaleIndex!=-1)
+			else if (mInterpolationMode==IM_LINEAR)
 			{
-				if (mInterpolationMode==IM_CONSTANT || foundScaleIndex==0)
-				{
-					scale = scaleKeys[foundScaleIndex].mScale;
-				}
-				else if (mInterpolationMode==IM_LINEAR)
-				{
-					const ScaleKey& keyA = scaleKeys[foundScaleIndex];
-					const ScaleKey& keyB = scaleKeys[foundScaleIndex-1];
+				const Quaternion<float>& keyA = track.mRotations[foundRotationIndex];
+				const Quaternion<float>& keyB = track.mRotations[foundRotationIndex-1];
 
-					const float fd1 = frame - keyA.mFrame;
-					const float fd2 = keyB.mFrame - frame;
-					scale = ((keyB.mScale-keyA.mScale)/(fd1+fd2))*fd1 + keyA.mScale;
-				}
+				const float fd1 = frame - track.mRotationFrames[foundRotationIndex];
+				const float fd2 = track.mRotationFrames[foundRotationIndex-1] - frame;
+				const float t = fd1/(fd1+fd2);
+
+				rotation = Slerp(t, keyA, keyB);
 			}
 		}
+	}
+}
 
-		//-------------------------------------------------------------
 
-		if (rotationKeys.size())
-		{
-			foundRotationIndex = -1;
+//! Returns the index of the first key at or after the frame, or -1 if the
+//! frame is past the last key. The hint and the key following it are tested
+//! first since the frames mostly move forward, otherwise the keys are
+//! binary searched.
+int SkinnedMesh::FindKey(const eastl::vector<float>& frames, float frame, int& hint)
+{
+	const int numKeys = (int)frames.size();
 
-			//Test the Hints...
-			if (rotationHint>=0 && (unsigned int)rotationHint < rotationKeys.size())
-			{
-				//check this hint
-				if (rotationHint > 0 &&
-					rotationKeys[rotationHint].mFrame >= frame &&
-					rotationKeys[rotationHint - 1].mFrame < frame)
-				{
-					foundRotationIndex = rotationHint;
-				}
-				else if (rotationHint+1 < (int)rotationKeys.size())
-				{
-					//check the next index
-					if (rotationKeys[rotationHint+1].mFrame>=frame &&
-						rotationKeys[rotationHint+0].mFrame<frame)
-					{
-						rotationHint++;
-						foundRotationIndex=rotationHint;
-					}
-				}
-			}
+	//Test the Hints...
+	if (hint>=0 && hint < numKeys)
+	{
+		//check this hint
+		if (hint > 0 && frames[hint] >= frame && frames[hint - 1] < frame)
+			return hint;
 
+		//check the next index
+		if (hint+1 < numKeys && frames[hint+1] >= frame && frames[hint] < frame)
+			return ++hint;
+	}
 
-			//The hint test failed, do a full scan...
-			if (foundRotationIndex==-1)
-			{
-				for (unsigned int i=0; i<rotationKeys.size(); ++i)
-				{
-					if (rotationKeys[i].mFrame >= frame) //Keys should be sorted by frame
-					{
-						foundRotationIndex=i;
-						rotationHint=i;
-						break;
-					}
-				}
-			}
+	//The hint test failed, search the keys (sorted by frame)
+	const int key = (int)(eastl::lower_bound(frames.begin(), frames.end(), frame) - frames.begin());
+	if (key == numKeys)
+		return -1;
 
-			//Do interpolation...
-			if (foundRotationIndex!=-1)
-			{
-				if (mInterpolationMode==IM_CONSTANT || foundRotationIndex==0)
-				{
-					rotation = rotationKeys[foundRotationIndex].mRotation;
-				}
-				else if (mInterpolationMode==IM_LINEAR)
-				{
-					const RotationKey& keyA = rotationKeys[foundRotationIndex];
-					const RotationKey& keyB = rotationKeys[foundRotationIndex-1];
+	hint = key;
+	return key;
+}
+
+
+//! Gets the baked samples around the frame and how far it is between them
+void SkinnedMesh::GetBakedSample(const JointTrack& track, unsigned int numSamples,
+	float frame, unsigned int& sample, float& t)
+{
+	const float position = eastl::max(frame, 0.f) * track.mBakedRate;
+	sample = eastl::min((unsigned int)position, numSamples - 2);
+	t = eastl::min(position - sample, 1.f);
+}
 
-					const float fd1 = frame - keyA.mFrame;
-					const float fd2 = keyB.mFrame - frame;
-					const float t = fd1/(fd1+fd2);
 
-					/*
-					float t = 0;
-					if (keyA.mFrame!=keyB.mFrame)
-						t = (frame-keyA.mFrame) / (keyB.mFrame - keyA.mFrame);
-					*/
+//! Copies the keys of the joints, or of the joints they take their animation
+//! from, in separate frame and value arrays
+void SkinnedMesh::BuildJointTracks()
+{
+	const float bakedRate = mJointTracks.empty() ? 0.f : mJointTracks[0].mBakedRate;
 
-					rotation = Slerp(t, keyA.mRotation, keyB.mRotation);
-				}
-			}
+	mJointTracks.clear();
+	mJointTracks.resize(mAllJoints.size());
+	for (unsigned int i=0; i<mAllJoints.size(); ++i)
+	{
+		JointTrack& track = mJointTracks[i];
+		track.mBakedRate = 0.f;
+
+		const Joint* joint = mAllJoints[i]->mUseAnimationFrom;
+		if (!joint)
+			continue;
+
+		for (const PositionKey& key : joint->mPositionKeys)
+		{
+			track.mPositionFrames.push_back(key.mFrame);
+			track.mPositions.push_back(key.mPosition);
+		}
+		for (const ScaleKey& key : joint->mScaleKeys)
+		{
+			track.mScaleFrames.push_back(key.mFrame);
+			track.mScales.push_back(key.mScale);
+		}
+		for (const RotationKey& key : joint->mRotationKeys)
+		{
+			track.mRotationFrames.push_back(key.mFrame);
+			track.mRotations.push_back(key.mRotation);
+		}
+	}
+
+	if (bakedRate > 0.f)
+		BakeAnimation(bakedRate);
+}
+
+
+//! Samples every track at a uniform rate between the first and the last frame
+//! of the animation, so that GetFrameData only interpolates the two samples
+//! around a frame. The samples are linearly interpolated, the keys in between
+//! them are approximated.
+void SkinnedMesh::BakeAnimation(float samplesPerFrame)
+{
+	const InterpolationMode interpolationMode = mInterpolationMode;
+	mInterpolationMode = IM_LINEAR;
+
+	const unsigned int numSamples = samplesPerFrame > 0.f ?
+		(unsigned int)Function<float>::Ceil(mAnimationFrames * samplesPerFrame) + 2 : 0;
+	for (JointTrack& track : mJointTracks)
+	{
+		track.mBakedRate = 0.f;
+		track.mBakedPositions.clear();
+		track.mBakedScales.clear();
+		track.mBakedRotations.clear();
+		if (numSamples == 0)
+			continue;
+
+		int positionHint = -1, scaleHint = -1, rotationHint = -1;
+		for (unsigned int sample=0; sample<numSamples; ++sample)
+		{
+			const float frame = eastl::min(sample / samplesPerFrame, mAnimationFrames);
+
+			Vector3<float> position = Vector3<float>::Zero();
+			Vector3<float> scale = Vector3<float>{ 1.f, 1.f, 1.f };
+			Quaternion<float> rotation = Quaternion<float>::Identity();
+			GetFrameData(frame, track, position, positionHint,
+				scale, scaleHint, rotation, rotationHint);
+
+			if (track.mPositionFrames.size())
+				track.mBakedPositions.push_back(position);
+			if (track.mScaleFrames.size())
+				track.mBakedScales.push_back(scale);
+			if (track.mRotationFrames.size())
+				track.mBakedRotations.push_back(rotation);
 		}
+		track.mBakedRate = samplesPerFrame;
 	}
+
+	mInterpolationMode = interpolationMode;
+
+	// make sure the joints are animated again from the new tracks
+	mLastAnimatedFrame=-1;
+	mSkinnedLastFrame=false;
 }
 
+
 //--------------------------------------------------------------------------
 //				Software Skinning
 //--------------------------------------------------------------------------
@@ -478,14 +554,291 @@ void SkinnedMesh::SkinMesh()
 			}
 		}
 
-		//clear skinning helper array
-		for (i=0; i<mVerticesMoved.size(); ++i)
-			for (unsigned int j=0; j<mVerticesMoved[i].size(); ++j)
-				mVerticesMoved[i][j]=false;
+		SkinVertices(true);
+	}
+}
+
+
+//! Skins every frame of the animation once and keeps the bound of each
+//! mesh buffer, so that instances don't compute it from their vertices.
+void SkinnedMesh::BakeBounds()
+{
+	mFrameBounds.clear();
+	if (!mHasAnimation || mHardwareSkinning || mLocalBuffers.empty())
+		return;
+
+	eastl::set<DFType> required;
+	required.insert(DF_R32G32B32_FLOAT);
+	required.insert(DF_R32G32B32A32_FLOAT);
+
+	const unsigned int numBuffers = mLocalBuffers.size();
+	const unsigned int numFrames = (unsigned int)Function<float>::Ceil(mAnimationFrames) + 1;
+	mFrameBounds.resize(numFrames * numBuffers);
+	for (unsigned int frame=0; frame<numFrames; ++frame)
+	{
+		AnimateMesh(eastl::min((float)frame, mAnimationFrames), 1.f);
+		SkinMesh();
+
+		for (unsigned int i=0; i<numBuffers; ++i)
+		{
+			const eastl::shared_ptr<VertexBuffer>& vbuffer = mLocalBuffers[i]->GetVertice();
+			char const* positions = vbuffer->GetChannel(VA_POSITION, 0, required);
+			if (positions && vbuffer->GetNumElements())
+			{
+				mFrameBounds[frame * numBuffers + i].ComputeFromData(
+					vbuffer->GetNumElements(), (int)vbuffer->GetElementSize(), positions);
+			}
+		}
+	}
+
+	// make sure the instances animate the mesh again
+	mLastAnimatedFrame=-1;
+	mSkinnedLastFrame=false;
+}
+
+
+//! Gets the bound of a mesh buffer at a frame from the baked bounds.
+bool SkinnedMesh::GetFrameBound(float frame, unsigned int nr, BoundingSphere& bound) const
+{
+	const unsigned int numBuffers = mLocalBuffers.size();
+	if (mFrameBounds.empty() || nr >= numBuffers)
+		return false;
+
+	const unsigned int numFrames = mFrameBounds.size() / numBuffers;
+	frame = eastl::min(eastl::max(frame, 0.f), (float)(numFrames - 1));
+	const unsigned int frameA = (unsigned int)frame;
+	const unsigned int frameB = eastl::min(frameA + 1, numFrames - 1);
+
+	// The joints don't move the vertices linearly in between two frames, so
+	// the bound grows to contain both baked ones instead of blending them.
+	bound = mFrameBounds[frameA * numBuffers + nr];
+	bound.GrowToContain(mFrameBounds[frameB * numBuffers + nr]);
+	return bound.GetRadius() > 0.f;
+}
+
+
+//! Joint-major skinning, each joint adds its pull to the vertices it weights.
+//! Kept as the reference the vertex-major path is measured against.
+void SkinnedMesh::SkinJoints()
+{
+	//clear skinning helper array
+	for (unsigned int i=0; i<mVerticesMoved.size(); ++i)
+		for (unsigned int j=0; j<mVerticesMoved[i].size(); ++j)
+			mVerticesMoved[i][j]=false;
+
+	//skin starting with the root joints
+	for (unsigned int i=0; i<mRootJoints.size(); ++i)
+		SkinJoint(mRootJoints[i], 0);
+}
+
+
+//! Gathers the weights of every vertex from the joints. Vertices pulled by
+//! more than 4 joints keep the strongest ones, renormalized.
+void SkinnedMesh::BuildSkinningTables()
+{
+	struct VertexWeights
+	{
+		unsigned short mJoints[4];
+		float mWeights[4];
+		unsigned int mCount;
+		Vector3<float> mStaticPos;
+		Vector3<float> mStaticNormal;
+	};
+
+	unsigned int droppedWeights = 0;
+	mSkinningTables.clear();
+	mSkinningTables.resize(mLocalBuffers.size());
+	for (unsigned int b=0; b<mLocalBuffers.size(); ++b)
+	{
+		eastl::vector<VertexWeights> vertexWeights(
+			mLocalBuffers[b]->GetVertice()->GetNumElements());
+		for (VertexWeights& vertex : vertexWeights)
+			vertex.mCount = 0;
+
+		for (unsigned int j=0; j<mAllJoints.size(); ++j)
+		{
+			for (const Weight& weight : mAllJoints[j]->mWeights)
+			{
+				if (weight.mBufferId != b)
+					continue;
+
+				VertexWeights& vertex = vertexWeights[weight.mVertexId];
+				vertex.mStaticPos = weight.mStaticPos;
+				vertex.mStaticNormal = weight.mStaticNormal;
+
+				unsigned int slot = vertex.mCount;
+				if (vertex.mCount < 4)
+				{
+					vertex.mCount++;
+				}
+				else
+				{
+					// replace the weakest one if this one pulls more
+					slot = 0;
+					for (unsigned int w=1; w<4; ++w)
+						if (vertex.mWeights[w] < vertex.mWeights[slot])
+							slot = w;
+
+					droppedWeights++;
+					if (vertex.mWeights[slot] >= weight.mStrength)
+						continue;
+				}
+				vertex.mJoints[slot] = (unsigned short)j;
+				vertex.mWeights[slot] = weight.mStrength;
+			}
+		}
+
+		SkinningTable& table = mSkinningTables[b];
+		for (unsigned int v=0; v<vertexWeights.size(); ++v)
+		{
+			VertexWeights& vertex = vertexWeights[v];
+			if (vertex.mCount == 0)
+				continue;
+
+			float total = 0.f;
+			for (unsigned int w=0; w<vertex.mCount; ++w)
+				total += vertex.mWeights[w];
+
+			Vector4<float> weights = Vector4<float>::Zero();
+			for (unsigned int w=0; w<4; ++w)
+			{
+				if (w < vertex.mCount)
+				{
+					weights[w] = (total != 0 && total != 1) ?
+						vertex.mWeights[w] / total : vertex.mWeights[w];
+					table.mJoints.push_back(vertex.mJoints[w]);
+				}
+				else table.mJoints.push_back(0);
+			}
+
+			table.mVertices.push_back(v);
+			table.mWeights.push_back(weights);
+			table.mPositions.push_back(HLift(vertex.mStaticPos, 0.f));
+			// the joint-major path swaps the normals back before transforming them
+			table.mNormals.push_back(Vector4<float>{
+				vertex.mStaticNormal[0], vertex.mStaticNormal[2], vertex.mStaticNormal[1], 0.f });
+		}
+	}
+
+	if (droppedWeights)
+	{
+		LogWarning("Skinned Mesh: " + eastl::to_string(droppedWeights) +
+			" weights dropped from vertices pulled by more than 4 joints");
+	}
+}
 
-		//skin starting with the root joints
-		for (i=0; i<mRootJoints.size(); ++i)
-			SkinJoint(mRootJoints[i], 0);
+
+//! Computes the skinning transform of every joint, stored as the 3 rows of
+//! its rotation-scale followed by its translation
+void SkinnedMesh::BuildSkinningMatrices()
+{
+	mSkinningMatrices.resize(mAllJoints.size() * 4);
+	for (unsigned int j=0; j<mAllJoints.size(); ++j)
+	{
+		Joint* joint = mAllJoints[j];
+		Transform jointTransform =
+			joint->mGlobalAnimatedTransform *
+			joint->mGlobalInversedTransform;
+
+		const Matrix4x4<float>& jointVertexPull = jointTransform.GetRotation();
+		for (int row=0; row<3; ++row)
+		{
+			mSkinningMatrices[j * 4 + row] = Vector4<float>{
+				jointVertexPull(row, 0), jointVertexPull(row, 1), jointVertexPull(row, 2), 0.f };
+		}
+		mSkinningMatrices[j * 4 + 3] = jointTransform.GetTranslationW0();
+	}
+}
+
+
+//! Vertex-major skinning, every vertex blends the transforms of its joints
+//! and is written once. Large buffers are split across the job system.
+void SkinnedMesh::SkinVertices(bool parallel)
+{
+	BuildSkinningMatrices();
+
+	for (unsigned int b=0; b<mSkinningTables.size(); ++b)
+	{
+		const SkinningTable& table = mSkinningTables[b];
+		SkinMeshBuffer* buffer = mSkinningBuffers[b];
+
+		const unsigned int numVertices = (unsigned int)table.mVertices.size();
+		if (parallel && numVertices > SkinningGrainSize)
+		{
+			JobSystem::Get()->ParallelFor(0, numVertices, SkinningGrainSize,
+				[this, buffer, &table](unsigned int begin, unsigned int end)
+				{
+					SkinVertices(buffer, table, begin, end);
+				});
+		}
+		else
+		{
+			SkinVertices(buffer, table, 0, numVertices);
+		}
+	}
+}
+
+
+void SkinnedMesh::SkinVertices(SkinMeshBuffer* buffer,
+	const SkinningTable& table, unsigned int begin, unsigned int end)
+{
+	const float* matrices = reinterpret_cast<const float*>(mSkinningMatrices.data());
+	const unsigned short* joints = table.mJoints.data();
+	const float* weights = reinterpret_cast<const float*>(table.mWeights.data());
+	const float* positions = reinterpret_cast<const float*>(table.mPositions.data());
+	const float* normals = reinterpret_cast<const float*>(table.mNormals.data());
+
+	alignas(16) float skinned[4];
+	for (unsigned int v=begin; v<end; ++v)
+	{
+		// blend the joint transforms by the vertex weights
+		const unsigned short* vertexJoints = joints + v * 4;
+		const __m128 weight = _mm_loadu_ps(weights + v * 4);
+		__m128 row0 = _mm_setzero_ps();
+		__m128 row1 = _mm_setzero_ps();
+		__m128 row2 = _mm_setzero_ps();
+		__m128 row3 = _mm_setzero_ps();
+		BlendJointRows(row0, row1, row2, row3, matrices + vertexJoints[0] * 16,
+			_mm_shuffle_ps(weight, weight, _MM_SHUFFLE(0, 0, 0, 0)));
+		BlendJointRows(row0, row1, row2, row3, matrices + vertexJoints[1] * 16,
+			_mm_shuffle_ps(weight, weight, _MM_SHUFFLE(1, 1, 1, 1)));
+		BlendJointRows(row0, row1, row2, row3, matrices + vertexJoints[2] * 16,
+			_mm_shuffle_ps(weight, weight, _MM_SHUFFLE(2, 2, 2, 2)));
+		BlendJointRows(row0, row1, row2, row3, matrices + vertexJoints[3] * 16,
+			_mm_shuffle_ps(weight, weight, _MM_SHUFFLE(3, 3, 3, 3)));
+
+		// Pull this vertex...
+		const __m128 position = _mm_loadu_ps(positions + v * 4);
+		__m128 vertexMove = _mm_add_ps(row3, _mm_add_ps(
+			_mm_mul_ps(_mm_shuffle_ps(position, position, _MM_SHUFFLE(0, 0, 0, 0)), row0),
+			_mm_add_ps(
+				_mm_mul_ps(_mm_shuffle_ps(position, position, _MM_SHUFFLE(1, 1, 1, 1)), row1),
+				_mm_mul_ps(_mm_shuffle_ps(position, position, _MM_SHUFFLE(2, 2, 2, 2)), row2))));
+		_mm_store_ps(skinned, vertexMove);
+
+		//swapping Y and Z axis
+		const unsigned int vertexId = table.mVertices[v];
+		float* target = reinterpret_cast<float*>(&buffer->Position(vertexId));
+		target[0] = skinned[0];
+		target[1] = skinned[2];
+		target[2] = skinned[1];
+
+		if (mAnimateNormals)
+		{
+			const __m128 normal = _mm_loadu_ps(normals + v * 4);
+			__m128 normalMove = _mm_add_ps(
+				_mm_mul_ps(_mm_shuffle_ps(normal, normal, _MM_SHUFFLE(0, 0, 0, 0)), row0),
+				_mm_add_ps(
+					_mm_mul_ps(_mm_shuffle_ps(normal, normal, _MM_SHUFFLE(1, 1, 1, 1)), row1),
+					_mm_mul_ps(_mm_shuffle_ps(normal, normal, _MM_SHUFFLE(2, 2, 2, 2)), row2)));
+			_mm_store_ps(skinned, normalMove);
+
+			//swapping Y and Z axis
+			target = reinterpret_cast<float*>(&buffer->Normal(vertexId));
+			target[0] = skinned[0];
+			target[1] = skinned[2];
+			target[2] = skinned[1];
+		}
 	}
 }
 
@@ -593,6 +946,106 @@ void SkinnedMesh::SkinJoint(Joint *joint, Joint *parentJoint)
 }
 
 
+//! Builds a cylinder skinned to a chain of joints, each vertex pulled by the
+//! 4 joints closest to its height, and skins a frame of its animation with
+//! each path
+void SkinnedMesh::BenchmarkSkinning(unsigned int numVertices, unsigned int numJoints, unsigned int numRuns)
+{
+	if (numVertices == 0 || numJoints < 4 || numRuns == 0)
+		return;
+
+	SkinnedMesh mesh;
+
+	VertexFormat vformat;
+	vformat.Bind(VA_POSITION, DF_R32G32B32_FLOAT, 0);
+	vformat.Bind(VA_NORMAL, DF_R32G32B32_FLOAT, 0);
+	SkinMeshBuffer* meshBuffer = new SkinMeshBuffer(
+		vformat, numVertices, eastl::max(numVertices / 3, 1u), sizeof(unsigned int));
+	mesh.AddMeshBuffer(meshBuffer);
+
+	const unsigned int verticesPerRing = 32;
+	const float height = (float)numJoints;
+	for (unsigned int v=0; v<numVertices; ++v)
+	{
+		const float angle = (float)GE_C_TWO_PI * (v % verticesPerRing) / verticesPerRing;
+		const float y = height * v / numVertices;
+		meshBuffer->Position(v) = Vector3<float>{ cos(angle), y, sin(angle) };
+		meshBuffer->Normal(v) = Vector3<float>{ cos(angle), 0.f, sin(angle) };
+	}
+
+	Joint* parent = nullptr;
+	for (unsigned int j=0; j<numJoints; ++j)
+	{
+		Joint* joint = mesh.AddJoint(parent);
+		joint->mParent = parent;
+		joint->mName = "joint" + eastl::to_string(j);
+		joint->mLocalTransform.SetTranslation(0.f, parent ? 1.f : 0.f, 0.f);
+
+		const float bend = 0.05f * (j % 2 ? 1.f : -1.f);
+		for (unsigned int k=0; k<2; ++k)
+		{
+			RotationKey* key = mesh.AddRotationKey(joint);
+			key->mFrame = 10.f * k;
+			key->mRotation = Quaternion<float>(0.f, 0.f, sin(bend * k), cos(bend * k));
+		}
+		parent = joint;
+	}
+
+	for (unsigned int v=0; v<numVertices; ++v)
+	{
+		const float y = height * v / numVertices;
+		const unsigned int first = eastl::min((unsigned int)y, numJoints - 4);
+		for (unsigned int j=first; j<first + 4; ++j)
+		{
+			Weight* weight = mesh.AddWeight(mesh.mAllJoints[j]);
+			weight->mBufferId = 0;
+			weight->mVertexId = v;
+			weight->mStrength = 1.f / (1.f + fabs(y - j - 0.5f));
+		}
+	}
+
+	mesh.Finalize();
+	mesh.AnimateMesh(5.f, 1.f);
+	mesh.BuildAllGlobalAnimatedMatrices();
+
+	unsigned int startTime = Timer::GetRealTime();
+	for (unsigned int run=0; run<numRuns; ++run)
+		mesh.SkinJoints();
+	const unsigned int jointMajorTime = Timer::GetRealTime() - startTime;
+
+	eastl::vector<Vector3<float>> reference(numVertices);
+	for (unsigned int v=0; v<numVertices; ++v)
+		reference[v] = meshBuffer->Position(v);
+
+	startTime = Timer::GetRealTime();
+	for (unsigned int run=0; run<numRuns; ++run)
+		mesh.SkinVertices(false);
+	const unsigned int vertexMajorTime = Timer::GetRealTime() - startTime;
+
+	startTime = Timer::GetRealTime();
+	for (unsigned int run=0; run<numRuns; ++run)
+		mesh.SkinVertices(true);
+	const unsigned int parallelTime = Timer::GetRealTime() - startTime;
+
+	float maxError = 0.f;
+	for (unsigned int v=0; v<numVertices; ++v)
+		maxError = eastl::max(maxError, Length(meshBuffer->Position(v) - reference[v]));
+
+	auto throughput = [numVertices, numRuns](unsigned int time)
+	{
+		return eastl::to_string((unsigned int)((float)numVertices * numRuns / eastl::max(time, 1u))) +
+			" vertices/ms (" + eastl::to_string(time) + " ms)";
+	};
+	LogInformation("Skinning " + eastl::to_string(numVertices) + " vertices, " +
+		eastl::to_string(numJoints) + " joints, " + eastl::to_string(numRuns) + " runs");
+	LogInformation("  joint-major: " + throughput(jointMajorTime));
+	LogInformation("  vertex-major: " + throughput(vertexMajorTime));
+	LogInformation("  vertex-major on " + eastl::to_string(JobSystem::Get()->GetNumThreads()) +
+		" threads: " + throughput(parallelTime));
+	LogInformation("  max position difference: " + eastl::to_string(maxError));
+}
+
+
 MeshType SkinnedMesh::GetMeshType() const
 {
 	return MT_SKINNED;
@@ -683,6 +1136,8 @@ bool SkinnedMesh::UseAnimationFrom(const BaseSkinnedMesh *mesh)
 	}
 
 	CheckForAnimation();
+	BuildJointTracks();
+	BakeBounds();
 
 	return !unmatched;
 }
@@ -897,6 +1352,8 @@ void SkinnedMesh::CheckForAnimation()
 
 		// normalize weights
 		NormalizeWeights();
+
+		BuildSkinningTables();
 	}
 	mSkinnedLastFrame=false;
 }
@@ -1086,6 +1543,8 @@ void SkinnedMesh::Finalize()
 		}
 	}
 
+	BuildJointTracks();
+
 	//Needed for animation and skinning...
 	CalculateGlobalMatrices(0,0);
 
@@ -1102,6 +1561,8 @@ void SkinnedMesh::Finalize()
 			buffer->GetTransform() = mAllJoints[i]->mGlobalAnimatedTransform;
 		}
 	}
+
+	BakeBounds();
 }
 
 
@@ -7,6 +7,7 @@
 
 #include "Graphic/Scene/Element/Mesh/Mesh.h"
 #include "Graphic/Resource/Buffer/SkinMeshBuffer.h"
+#include "Graphic/Scene/Hierarchy/BoundingSphere.h"
 
 enum InterpolationMode
 {
@@ -244,9 +245,28 @@ public:
 	//! blend: {0-old position, 1-New position}
 	virtual void AnimateMesh(float frame, float blend);
 
+	//! Keyframe hints of one instance of the mesh, 3 per joint. Nodes which
+	//! share the mesh keep their own so that they don't reset each other's.
+	typedef eastl::vector<int> AnimationCursor;
+
+	//! Animates this mesh's joints with the keyframe hints of an instance
+	void AnimateMesh(float frame, float blend, AnimationCursor& cursor);
+
+	//! Resamples the joint keys at a uniform rate so that a frame is found
+	//! without searching its keys. 0 goes back to the keys.
+	void BakeAnimation(float samplesPerFrame);
+
 	//! Preforms a software skin on this mesh based of joint positions
 	virtual void SkinMesh();
 
+	//! Skins every frame of the animation once and keeps the bound of each
+	//! mesh buffer, so that instances don't compute it from their vertices.
+	void BakeBounds();
+
+	//! Gets the bound of a mesh buffer at a frame from the baked bounds.
+	/** \return False if there are no baked bounds for the buffer. */
+	bool GetFrameBound(float frame, unsigned int nr, BoundingSphere& bound) const;
+
 	//! returns amount of mesh buffers.
 	virtual unsigned int GetMeshBufferCount() const;
 
@@ -334,7 +354,49 @@ public:
 	//! Creates an array of joints from this mesh as children of node
 	void AddJoints(eastl::vector<eastl::shared_ptr<BoneNode>> &jointChildSceneNodes, AnimatedMeshNode* node, Scene* scene);
 
+	//! Skins a generated rig with the joint-major and the vertex-major paths
+	//! and logs the throughput of each in vertices per millisecond
+	static void BenchmarkSkinning(unsigned int numVertices = 50000,
+		unsigned int numJoints = 64, unsigned int numRuns = 100);
+
 private:
+
+	//! Keys of a joint in separate frame and value arrays
+	struct JointTrack
+	{
+		eastl::vector<float> mPositionFrames;
+		eastl::vector<Vector3<float>> mPositions;
+		eastl::vector<float> mScaleFrames;
+		eastl::vector<Vector3<float>> mScales;
+		eastl::vector<float> mRotationFrames;
+		eastl::vector<Quaternion<float>> mRotations;
+
+		//! samples per frame of the baked values, 0 if not baked
+		float mBakedRate;
+		eastl::vector<Vector3<float>> mBakedPositions;
+		eastl::vector<Vector3<float>> mBakedScales;
+		eastl::vector<Quaternion<float>> mBakedRotations;
+	};
+
+	//! Vertex-major skinning data of a mesh buffer. Every skinned vertex keeps
+	//! up to 4 joints with their weights and its bind pose, each packed in 4
+	//! floats so that the skinning kernel loads them at once.
+	struct SkinningTable
+	{
+		//! vertex of the buffer written by each entry
+		eastl::vector<unsigned int> mVertices;
+
+		//! joint indices, 4 per vertex. The unused ones have a null weight
+		eastl::vector<unsigned short> mJoints;
+		eastl::vector<Vector4<float>> mWeights;
+
+		//! bind pose in the joint space layout (Y and Z swapped for positions)
+		eastl::vector<Vector4<float>> mPositions;
+		eastl::vector<Vector4<float>> mNormals;
+	};
+
+	//! vertices skinned by each job when a buffer is split across the workers
+	static const unsigned int SkinningGrainSize = 2048;
 	void CheckForAnimation();
 
 	void NormalizeWeights();
@@ -344,12 +406,27 @@ private:
 
 	void CalculateGlobalMatrices(Joint *joint, Joint *parentJoint);
 
-	void GetFrameData(float frame, Joint *Node,
+	void AnimateJoints(float frame, float blend, int* cursor);
+
+	void BuildJointTracks();
+
+	void GetFrameData(float frame, const JointTrack& track,
 		Vector3<float> &position, int &positionHint,
 		Vector3<float> &scale, int &scaleHint,
 		Quaternion<float> &rotation, int &rotationHint);
 
+	static int FindKey(const eastl::vector<float>& frames, float frame, int& hint);
+	static void GetBakedSample(const JointTrack& track, unsigned int numSamples,
+		float frame, unsigned int& sample, float& t);
+
 	void SkinJoint(Joint *joint, Joint *parentJoint);
+	void SkinJoints();
+
+	void BuildSkinningTables();
+	void BuildSkinningMatrices();
+	void SkinVertices(bool parallel);
+	void SkinVertices(SkinMeshBuffer* buffer, const SkinningTable& table,
+		unsigned int begin, unsigned int end);
 
 	void CalculateTangents(Vector3<float>& normal,
 		Vector3<float>& tangent, Vector3<float>& binormal,
@@ -363,8 +440,20 @@ private:
 	eastl::vector<Joint*> mAllJoints;
 	eastl::vector<Joint*> mRootJoints;
 
+	//! keys sampled by each joint of mAllJoints
+	eastl::vector<JointTrack> mJointTracks;
+
 	eastl::vector<eastl::vector<bool>> mVerticesMoved;
 
+	//! one table per buffer, built once the weights are normalized
+	eastl::vector<SkinningTable> mSkinningTables;
+
+	//! rows of the joint skinning transforms, 4 per joint of mAllJoints
+	eastl::vector<Vector4<float>> mSkinningMatrices;
+
+	//! baked bounds, the ones of every mesh buffer for each frame in turn
+	eastl::vector<BoundingSphere> mFrameBounds;
+
 	float mAnimationFrames;
 	float mFramesPerSecond;
 
@@ -0,0 +1,328 @@
+//========================================================================
+// StaticMeshBatch.cpp : Merges the buffers of a static mesh into a few large
+// vertex and index buffers split in spatial chunks.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "StaticMeshBatch.h"
+
+#include "Graphic/Scene/Hierarchy/BoundingSphere.h"
+
+#include "Core/Logger/Logger.h"
+
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+	const unsigned int CacheMagic = 0x48534D53; // "SMSH"
+	const unsigned int CacheVersion = 1;
+
+	struct CacheHeader
+	{
+		unsigned int mMagic;
+		unsigned int mVersion;
+		unsigned int mHash;
+		unsigned int mNumGroups;
+		unsigned int mNumChunks;
+		unsigned int mNumVertices;
+		unsigned int mNumIndices;
+		unsigned int mNumLayers;
+	};
+
+	// groups of the buffers without texture, drawn after the textured ones
+	const uint64_t UntexturedGroup = ~0ull;
+
+	// FNV-1a hash
+	unsigned int HashBytes(unsigned int hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	uint64_t GetGroupKey(BaseMeshBuffer* meshBuffer)
+	{
+		eastl::shared_ptr<Texture2> textureDiffuse = meshBuffer->GetMaterial()->GetTexture(TT_DIFFUSE);
+		if (!textureDiffuse)
+			return UntexturedGroup;
+
+		uint64_t transparent = meshBuffer->GetMaterial()->IsTransparent() ? 1 : 0;
+		return (transparent << 62) | ((uint64_t)textureDiffuse->GetWidth() << 31) |
+			(uint64_t)textureDiffuse->GetHeight();
+	}
+
+	// cell of the grid the center of the buffer falls in, packed in a key
+	uint64_t GetCellKey(BaseMeshBuffer* meshBuffer, float cellSize)
+	{
+		unsigned int numVertices = meshBuffer->GetVertice()->GetNumElements();
+		if (cellSize <= 0.f || numVertices == 0)
+			return 0;
+
+		Vector3<float> minimum = meshBuffer->Position(0);
+		Vector3<float> maximum = minimum;
+		for (unsigned int i = 1; i < numVertices; ++i)
+		{
+			const Vector3<float>& position = meshBuffer->Position(i);
+			for (int j = 0; j < 3; ++j)
+			{
+				minimum[j] = eastl::min(minimum[j], position[j]);
+				maximum[j] = eastl::max(maximum[j], position[j]);
+			}
+		}
+
+		uint64_t key = 0;
+		for (int j = 0; j < 3; ++j)
+		{
+			float cell = floor((minimum[j] + maximum[j]) * 0.5f / cellSize);
+			cell = eastl::max(eastl::min(cell, 32767.f), -32768.f);
+			key = (key << 16) | (uint64_t)((int)cell + 32768);
+		}
+		return key;
+	}
+
+	template <typename T>
+	bool ReadArray(std::ifstream& file, eastl::vector<T>& data, unsigned int count)
+	{
+		data.resize(count);
+		if (count > 0)
+			file.read(reinterpret_cast<char*>(data.data()), count * sizeof(T));
+		return file.good();
+	}
+
+	template <typename T>
+	void WriteArray(std::ofstream& file, const eastl::vector<T>& data)
+	{
+		if (!data.empty())
+			file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+	}
+}
+
+StaticMeshBatch::StaticMeshBatch(float cellSize)
+	: mCellSize(cellSize), mHash(0)
+{
+}
+
+void StaticMeshBatch::Clear()
+{
+	mGroups.clear();
+	mChunks.clear();
+	mVertices.clear();
+	mIndices.clear();
+	mLayers.clear();
+}
+
+unsigned int StaticMeshBatch::Hash(const BaseMesh& mesh, float cellSize)
+{
+	unsigned int hash = 2166136261u;
+	hash = HashBytes(hash, &CacheVersion, sizeof(CacheVersion));
+	hash = HashBytes(hash, &cellSize, sizeof(cellSize));
+
+	unsigned int numMeshBuffers = mesh.GetMeshBufferCount();
+	hash = HashBytes(hash, &numMeshBuffers, sizeof(numMeshBuffers));
+	for (unsigned int i = 0; i < numMeshBuffers; ++i)
+	{
+		const eastl::shared_ptr<BaseMeshBuffer>& meshBuffer = mesh.GetMeshBuffer(i);
+		uint64_t groupKey = meshBuffer ? GetGroupKey(meshBuffer.get()) : 0;
+		hash = HashBytes(hash, &groupKey, sizeof(groupKey));
+		if (!meshBuffer)
+			continue;
+
+		const eastl::shared_ptr<VertexBuffer>& vertices = meshBuffer->GetVertice();
+		const eastl::shared_ptr<IndexBuffer>& indices = meshBuffer->GetIndice();
+		unsigned int numVertices = vertices->GetNumElements();
+		unsigned int numPrimitives = indices->GetNumPrimitives();
+		hash = HashBytes(hash, &numVertices, sizeof(numVertices));
+		hash = HashBytes(hash, &numPrimitives, sizeof(numPrimitives));
+		hash = HashBytes(hash, vertices->GetData(), vertices->GetNumBytes());
+		hash = HashBytes(hash, indices->GetData(), indices->GetNumBytes());
+	}
+	return hash;
+}
+
+void StaticMeshBatch::Build(const BaseMesh& mesh)
+{
+	Clear();
+	mHash = Hash(mesh, mCellSize);
+
+	eastl::map<uint64_t, eastl::vector<unsigned int>> groups;
+	for (unsigned int i = 0; i < mesh.GetMeshBufferCount(); ++i)
+	{
+		const eastl::shared_ptr<BaseMeshBuffer>& meshBuffer = mesh.GetMeshBuffer(i);
+		if (meshBuffer)
+			groups[GetGroupKey(meshBuffer.get())].push_back(i);
+	}
+
+	for (auto& group : groups)
+		AddGroup(mesh, group.second, group.first != UntexturedGroup);
+}
+
+void StaticMeshBatch::AddGroup(const BaseMesh& mesh, eastl::vector<unsigned int>& buffers, bool textured)
+{
+	// the buffers of a cell follow each other, in mesh order inside the cell
+	eastl::vector<eastl::pair<uint64_t, unsigned int>> cells;
+	for (unsigned int buffer : buffers)
+		cells.push_back({ GetCellKey(mesh.GetMeshBuffer(buffer).get(), mCellSize), buffer });
+	eastl::sort(cells.begin(), cells.end());
+
+	Group group;
+	group.mTextured = textured ? 1 : 0;
+	group.mTextureWidth = 0;
+	group.mTextureHeight = 0;
+	group.mMaterialBuffer = buffers.back();
+	group.mFirstVertex = (unsigned int)mVertices.size();
+	group.mFirstIndex = (unsigned int)mIndices.size();
+	group.mFirstChunk = (unsigned int)mChunks.size();
+	group.mFirstLayer = (unsigned int)mLayers.size();
+	if (textured)
+	{
+		eastl::shared_ptr<Texture2> textureDiffuse =
+			mesh.GetMeshBuffer(buffers.back())->GetMaterial()->GetTexture(TT_DIFFUSE);
+		group.mTextureWidth = textureDiffuse->GetWidth();
+		group.mTextureHeight = textureDiffuse->GetHeight();
+	}
+
+	unsigned int chunkVertex = 0;
+	for (unsigned int c = 0; c < cells.size(); ++c)
+	{
+		if (c == 0 || cells[c].first != cells[c - 1].first)
+		{
+			Chunk chunk;
+			chunk.mFirstPrimitive = (unsigned int)(mIndices.size() - group.mFirstIndex) / 3;
+			chunk.mNumPrimitives = 0;
+			mChunks.push_back(chunk);
+			chunkVertex = (unsigned int)mVertices.size();
+		}
+
+		const eastl::shared_ptr<BaseMeshBuffer>& meshBuffer = mesh.GetMeshBuffer(cells[c].second);
+		unsigned int vertexOffset = (unsigned int)mVertices.size() - group.mFirstVertex;
+		float layer = (float)(mLayers.size() - group.mFirstLayer);
+		if (textured)
+			mLayers.push_back(cells[c].second);
+
+		// fill vertices
+		for (unsigned int i = 0; i < meshBuffer->GetVertice()->GetNumElements(); i++)
+		{
+			Vertex vertex;
+			vertex.mPosition = meshBuffer->Position(i);
+			vertex.mNormal = meshBuffer->Normal(i);
+			vertex.mTCoord = textured ? HLift(meshBuffer->TCoord(0, i), layer) : Vector3<float>::Zero();
+			mVertices.push_back(vertex);
+		}
+
+		//fill indices
+		unsigned int* index = meshBuffer->GetIndice()->Get<unsigned int>();
+		unsigned int numIndices = meshBuffer->GetIndice()->GetNumPrimitives() * 3;
+		for (unsigned int i = 0; i < numIndices; i++)
+			mIndices.push_back(vertexOffset + index[i]);
+		mChunks.back().mNumPrimitives += numIndices / 3;
+
+		// the chunk is complete once the next buffer is in another cell
+		if (c + 1 == cells.size() || cells[c + 1].first != cells[c].first)
+		{
+			BoundingSphere bound;
+			unsigned int numVertices = (unsigned int)mVertices.size() - chunkVertex;
+			if (numVertices > 0)
+			{
+				bound.ComputeFromData(numVertices, sizeof(Vertex),
+					reinterpret_cast<const char*>(&mVertices[chunkVertex]));
+			}
+
+			Chunk& chunk = mChunks.back();
+			for (int j = 0; j < 3; ++j)
+				chunk.mCenter[j] = bound.GetCenter()[j];
+			chunk.mRadius = bound.GetRadius();
+		}
+	}
+
+	group.mNumVertices = (unsigned int)mVertices.size() - group.mFirstVertex;
+	group.mNumIndices = (unsigned int)mIndices.size() - group.mFirstIndex;
+	group.mNumChunks = (unsigned int)mChunks.size() - group.mFirstChunk;
+	group.mNumLayers = (unsigned int)mLayers.size() - group.mFirstLayer;
+	mGroups.push_back(group);
+}
+
+bool StaticMeshBatch::Load(const eastl::string& fileName, unsigned int hash)
+{
+	std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	uint64_t const fileSize = (uint64_t)file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	CacheHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file.good() || header.mMagic != CacheMagic ||
+		header.mVersion != CacheVersion || header.mHash != hash)
+	{
+		LogInformation("Outdated static mesh cache " + fileName);
+		return false;
+	}
+
+	// a corrupted header mustn't allocate arrays bigger than the file
+	uint64_t const numArrayBytes =
+		(uint64_t)header.mNumGroups * sizeof(Group) +
+		(uint64_t)header.mNumChunks * sizeof(Chunk) +
+		(uint64_t)header.mNumVertices * sizeof(Vertex) +
+		(uint64_t)header.mNumIndices * sizeof(unsigned int) +
+		(uint64_t)header.mNumLayers * sizeof(unsigned int);
+	if (numArrayBytes > fileSize - sizeof(header))
+	{
+		LogWarning("Corrupted static mesh cache " + fileName);
+		return false;
+	}
+
+	Clear();
+	bool loaded =
+		ReadArray(file, mGroups, header.mNumGroups) &&
+		ReadArray(file, mChunks, header.mNumChunks) &&
+		ReadArray(file, mVertices, header.mNumVertices) &&
+		ReadArray(file, mIndices, header.mNumIndices) &&
+		ReadArray(file, mLayers, header.mNumLayers);
+
+	if (!loaded)
+	{
+		LogWarning("Corrupted static mesh cache " + fileName);
+		Clear();
+		return false;
+	}
+
+	mHash = hash;
+	return true;
+}
+
+bool StaticMeshBatch::Save(const eastl::string& fileName) const
+{
+	std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		LogWarning("Couldn't write static mesh cache " + fileName);
+		return false;
+	}
+
+	CacheHeader header;
+	header.mMagic = CacheMagic;
+	header.mVersion = CacheVersion;
+	header.mHash = mHash;
+	header.mNumGroups = (unsigned int)mGroups.size();
+	header.mNumChunks = (unsigned int)mChunks.size();
+	header.mNumVertices = (unsigned int)mVertices.size();
+	header.mNumIndices = (unsigned int)mIndices.size();
+	header.mNumLayers = (unsigned int)mLayers.size();
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	WriteArray(file, mGroups);
+	WriteArray(file, mChunks);
+	WriteArray(file, mVertices);
+	WriteArray(file, mIndices);
+	WriteArray(file, mLayers);
+
+	return file.good();
+}
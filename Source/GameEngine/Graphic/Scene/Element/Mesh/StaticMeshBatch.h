@@ -0,0 +1,94 @@
+//========================================================================
+// StaticMeshBatch.h : Merges the buffers of a static mesh into a few large
+// vertex and index buffers split in spatial chunks.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef STATICMESHBATCH_H
+#define STATICMESHBATCH_H
+
+#include "Graphic/Scene/Element/Mesh/Mesh.h"
+
+// The mesh buffers of a level are grouped as the static mesh node draws
+// them: the solid and the transparent textured buffers by texture size,
+// each texture becoming a layer of a texture array, and the buffers without
+// texture together. Inside a group the buffers are ordered by the cell of a
+// grid their center falls in, so the triangles of a cell are a contiguous
+// range of the index buffer. Each range is a chunk with its bounding
+// sphere, and the node only draws the chunks in view, merging the adjacent
+// ones into one draw. The merged data only depends on the mesh geometry,
+// the textures sizes and the cell size, which are hashed to validate a
+// cache file before loading it. The textures aren't saved, each layer keeps
+// the index of the mesh buffer whose texture it holds.
+class StaticMeshBatch
+{
+public:
+	struct Vertex
+	{
+		Vector3<float> mPosition;
+		Vector3<float> mTCoord;		// texture coordinates and array layer
+		Vector3<float> mNormal;
+	};
+
+	struct Chunk
+	{
+		unsigned int mFirstPrimitive;
+		unsigned int mNumPrimitives;
+		float mCenter[3];
+		float mRadius;
+	};
+
+	struct Group
+	{
+		unsigned int mTextured;
+		unsigned int mTextureWidth;
+		unsigned int mTextureHeight;
+		unsigned int mMaterialBuffer;	// mesh buffer whose material the group uses
+		unsigned int mFirstVertex;
+		unsigned int mNumVertices;
+		unsigned int mFirstIndex;
+		unsigned int mNumIndices;
+		unsigned int mFirstChunk;
+		unsigned int mNumChunks;
+		unsigned int mFirstLayer;
+		unsigned int mNumLayers;
+	};
+
+	// A cell size of 0 keeps every group in a single chunk.
+	StaticMeshBatch(float cellSize);
+
+	// hash of the mesh data the batch is built from
+	static unsigned int Hash(const BaseMesh& mesh, float cellSize);
+
+	// merges the mesh, replacing any data the batch already has
+	void Build(const BaseMesh& mesh);
+
+	// the files are only valid for the mesh and cell size of the given hash
+	bool Load(const eastl::string& fileName, unsigned int hash);
+	bool Save(const eastl::string& fileName) const;
+
+	unsigned int GetHash() const { return mHash; }
+
+	const eastl::vector<Group>& GetGroups() const { return mGroups; }
+	const eastl::vector<Chunk>& GetChunks() const { return mChunks; }
+	const eastl::vector<Vertex>& GetVertices() const { return mVertices; }
+	const eastl::vector<unsigned int>& GetIndices() const { return mIndices; }
+	const eastl::vector<unsigned int>& GetLayers() const { return mLayers; }
+
+private:
+	void Clear();
+	void AddGroup(const BaseMesh& mesh, eastl::vector<unsigned int>& buffers, bool textured);
+
+	float mCellSize;
+	unsigned int mHash;
+
+	eastl::vector<Group> mGroups;
+	eastl::vector<Chunk> mChunks;
+	eastl::vector<Vertex> mVertices;
+	eastl::vector<unsigned int> mIndices;	// relative to the first vertex of the group
+	eastl::vector<unsigned int> mLayers;
+};
+
+#endif
@@ -36,6 +36,9 @@ public:
 	eastl::shared_ptr<ShadowVolumeNode> AddShadowVolumeNode(const ActorId actorId,
 		Scene* pScene, const eastl::shared_ptr<BaseMesh>& shadowMesh = 0, bool zfailmethod = true, float infinity = 10000.0f);
 
+	//! Returns the shadow volume scene node, if there is one
+	const eastl::shared_ptr<ShadowVolumeNode>& GetShadowVolumeNode() const { return mShadow; }
+
 	//! Returns the visual based on the zero based index i. To get the amount 
 	//! of visuals used by this scene node, use GetVisualCount(). 
 	//! This function is needed for inserting the node into the scene hierarchy 
@@ -31,9 +31,8 @@ public:
 
 	//! Affects an array of particles.
 	/** \param now Current time. (Same as ITimer::getTime() would return)
-	\param particlearray Array of particles.
-	\param count Amount of particles in array. */
-	virtual void Affect(unsigned int now, Particle* particlearray, unsigned int count) = 0;
+	\param particles Array of particles. */
+	virtual void Affect(unsigned int now, ParticleArray& particles) = 0;
 
 	//! Sets whether or not the affector is currently enabled.
 	virtual void SetEnabled(bool enabled) { mEnabled = enabled; }
@@ -15,7 +15,7 @@ ParticleAttractionAffector::ParticleAttractionAffector( const Vector3<float>& po
 
 
 //! Affects an array of particles.
-void ParticleAttractionAffector::Affect(unsigned int now, Particle* particlearray, unsigned int count)
+void ParticleAttractionAffector::Affect(unsigned int now, ParticleArray& particles)
 {
 	if( mLastTime == 0 )
 	{
@@ -29,9 +29,10 @@ void ParticleAttractionAffector::Affect(unsigned int now, Particle* particlearra
 	if( !mEnabled )
 		return;
 
-	for(unsigned int i=0; i<count; ++i)
+	for(unsigned int i=0; i<particles.GetSize(); ++i)
 	{
-		Vector3<float> direction(mPoint - particlearray[i].mPos);
+		Vector3<float> position{ particles.mPos[0][i], particles.mPos[1][i], particles.mPos[2][i] };
+		Vector3<float> direction(mPoint - position);
 		Normalize(direction);
 		direction *= mSpeed * timeDelta;
 
@@ -39,12 +40,12 @@ void ParticleAttractionAffector::Affect(unsigned int now, Particle* particlearra
 			direction *= -1.0f;
 
 		if( mAffectX )
-			particlearray[i].mPos[0] += direction[0];
+			particles.mPos[0][i] += direction[0];
 
 		if( mAffectY )
-			particlearray[i].mPos[1] += direction[1];
+			particles.mPos[1][i] += direction[1];
 
 		if( mAffectZ )
-			particlearray[i].mPos[2] += direction[2];
+			particles.mPos[2][i] += direction[2];
 	}
 }
\ No newline at end of file
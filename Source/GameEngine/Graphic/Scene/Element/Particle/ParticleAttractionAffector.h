@@ -18,7 +18,7 @@ public:
 		bool affectY = true, bool affectZ = true );
 
 	//! Affects a particle.
-	virtual void Affect(unsigned int now, Particle* particlearray, unsigned int count);
+	virtual void Affect(unsigned int now, ParticleArray& particles);
 
 	//! Set the point that particles will attract to
 	virtual void SetPoint( const Vector3<float>& point ) { mPoint = point; }
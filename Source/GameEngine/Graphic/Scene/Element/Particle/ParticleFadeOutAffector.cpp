@@ -16,19 +16,22 @@ ParticleFadeOutAffector::ParticleFadeOutAffector(
 
 
 //! Affects an array of particles.
-void ParticleFadeOutAffector::Affect(unsigned int now, Particle* particlearray, unsigned int count)
+void ParticleFadeOutAffector::Affect(unsigned int now, ParticleArray& particles)
 {
 	if (!mEnabled)
 		return;
 
 	float d;
 
-	for (unsigned int i=0; i<count; ++i)
+	for (unsigned int i=0; i<particles.GetSize(); ++i)
 	{
-		if (particlearray[i].mEndTime - now < mFadeOutTime)
+		if (particles.mEndTime[i] - now < mFadeOutTime)
 		{
-			d = (particlearray[i].mEndTime - now) / mFadeOutTime;	// FadeOutTime probably float to save casts here (just guessing)
-			particlearray[i].mColor = Function<float>::Lerp(particlearray[i].mStartColor, mTargetColor, d);
+			d = (particles.mEndTime[i] - now) / mFadeOutTime;	// FadeOutTime probably float to save casts here (just guessing)
+			d = eastl::clamp(d, 0.f, 1.f);
+
+			for (int k = 0; k < 4; ++k)
+				particles.mColor[k][i] = mTargetColor[k] * (1.0f - d) + particles.mStartColor[k][i] * d;
 		}
 	}
 }
\ No newline at end of file
@@ -15,7 +15,7 @@ public:
 	ParticleFadeOutAffector(const eastl::array<float, 4>& targetColor, unsigned int fadeOutTime);
 
 	//! Affects a particle.
-	virtual void Affect(unsigned int now, Particle* particlearray, unsigned int count);
+	virtual void Affect(unsigned int now, ParticleArray& particles);
 
 	//! Sets the targetColor, i.e. the color the particles will interpolate
 	//! to over time.
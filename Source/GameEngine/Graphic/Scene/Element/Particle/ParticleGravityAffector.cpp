@@ -16,22 +16,23 @@ ParticleGravityAffector::ParticleGravityAffector(
 
 
 //! Affects an array of particles.
-void ParticleGravityAffector::Affect(unsigned int now, Particle* particlearray, unsigned int count)
+void ParticleGravityAffector::Affect(unsigned int now, ParticleArray& particles)
 {
 	if (!mEnabled)
 		return;
 
 	float d;
 
-	for (unsigned int i=0; i<count; ++i)
+	for (unsigned int i=0; i<particles.GetSize(); ++i)
 	{
-		d = (now - particlearray[i].mStartTime) / mTimeForceLost;
+		d = (now - particles.mStartTime[i]) / mTimeForceLost;
 		if (d > 1.0f)
 			d = 1.0f;
 		if (d < 0.0f)
 			d = 0.0f;
 		d = 1.0f - d;
 
-		particlearray[i].mVector = Function<float>::Lerp(particlearray[i].mStartVector, mGravity, d);
+		for (int k = 0; k < 3; ++k)
+			particles.mVector[k][i] = mGravity[k] * (1.0f - d) + particles.mStartVector[k][i] * d;
 	}
 }
\ No newline at end of file
@@ -20,7 +20,7 @@ ParticleRotationAffector::ParticleRotationAffector( const Vector3<float>& speed,
 
 
 //! Affects an array of particles.
-void ParticleRotationAffector::Affect(unsigned int now, Particle* particlearray, unsigned int count)
+void ParticleRotationAffector::Affect(unsigned int now, ParticleArray& particles)
 {
 	if( mLastTime == 0 )
 	{
@@ -34,30 +34,34 @@ void ParticleRotationAffector::Affect(unsigned int now, Particle* particlearray,
 	if( !mEnabled )
 		return;
 
-	for(unsigned int i=0; i<count; ++i)
+	for(unsigned int i=0; i<particles.GetSize(); ++i)
 	{
+		Vector3<float> position{ particles.mPos[0][i], particles.mPos[1][i], particles.mPos[2][i] };
 		if (mSpeed[0] != 0.0f)
 		{
 			Quaternion<float> tgt = Rotation<3, float>(
-				AxisAngle<3, float>(particlearray[i].mPos, timeDelta * mSpeed[0] * (float)GE_C_DEG_TO_RAD));
-			particlearray[i].mPos = HProject(Rotate(tgt, Vector4<float>::Unit(0)));
-			//particlearray[i].mPos.RotateYZBy(timeDelta * mSpeed.X, mPivotPoint);
+				AxisAngle<3, float>(position, timeDelta * mSpeed[0] * (float)GE_C_DEG_TO_RAD));
+			position = HProject(Rotate(tgt, Vector4<float>::Unit(0)));
+			//position.RotateYZBy(timeDelta * mSpeed.X, mPivotPoint);
 		}
 
 		if (mSpeed[1] != 0.0f)
 		{
 			Quaternion<float> tgt = Rotation<3, float>(
-				AxisAngle<3, float>(particlearray[i].mPos, timeDelta * mSpeed[2] * (float)GE_C_DEG_TO_RAD));
-			particlearray[i].mPos = HProject(Rotate(tgt, Vector4<float>::Unit(2)));
-			//particlearray[i].mPos.RotateXZBy(timeDelta * mSpeed.Y, mPivotPoint);
+				AxisAngle<3, float>(position, timeDelta * mSpeed[2] * (float)GE_C_DEG_TO_RAD));
+			position = HProject(Rotate(tgt, Vector4<float>::Unit(2)));
+			//position.RotateXZBy(timeDelta * mSpeed.Y, mPivotPoint);
 		}
 
 		if (mSpeed[2] != 0.0f)
 		{
 			Quaternion<float> tgt = Rotation<3, float>(
-				AxisAngle<3, float>(particlearray[i].mPos, timeDelta * mSpeed[1] * (float)GE_C_DEG_TO_RAD));
-			particlearray[i].mPos = HProject(Rotate(tgt, Vector4<float>::Unit(1)));
-			//particlearray[i].mPos.RotateXYBy(timeDelta * mSpeed.Z, mPivotPoint);
+				AxisAngle<3, float>(position, timeDelta * mSpeed[1] * (float)GE_C_DEG_TO_RAD));
+			position = HProject(Rotate(tgt, Vector4<float>::Unit(1)));
+			//position.RotateXYBy(timeDelta * mSpeed.Z, mPivotPoint);
 		}
+
+		for (int k = 0; k < 3; ++k)
+			particles.mPos[k][i] = position[k];
 	}
 }
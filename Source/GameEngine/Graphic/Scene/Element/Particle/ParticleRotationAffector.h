@@ -18,7 +18,7 @@ public:
 	);
 
 	//! Affects a particle.
-	virtual void Affect(unsigned int now, Particle* particlearray, unsigned int count);
+	virtual void Affect(unsigned int now, ParticleArray& particles);
 
 	//! Set the point that particles will attract to
 	virtual void SetPivotPoint( const Vector3<float>& point ) { mPivotPoint = point; }
@@ -10,14 +10,18 @@ ParticleScaleAffector::ParticleScaleAffector(const Vector2<float>& scaleTo)
 
 }
 
-void ParticleScaleAffector::Affect (unsigned int now, Particle *particlearray, unsigned int count)
+void ParticleScaleAffector::Affect(unsigned int now, ParticleArray& particles)
 {
-	for(unsigned int i=0;i<count;i++)
+	if (!mEnabled)
+		return;
+
+	for(unsigned int i=0;i<particles.GetSize();i++)
 	{
-		const unsigned int maxdiff = particlearray[i].mEndTime - particlearray[i].mStartTime;
-		const unsigned int curdiff = now - particlearray[i].mStartTime;
+		const unsigned int maxdiff = particles.mEndTime[i] - particles.mStartTime[i];
+		const unsigned int curdiff = now - particles.mStartTime[i];
 		const float newscale = (float)curdiff / maxdiff;
-		particlearray[i].mSize = particlearray[i].mStartSize + mScaleTo*newscale;
+		particles.mSize[0][i] = particles.mStartSize[0][i] + mScaleTo[0]*newscale;
+		particles.mSize[1][i] = particles.mStartSize[1][i] + mScaleTo[1]*newscale;
 	}
 }
 
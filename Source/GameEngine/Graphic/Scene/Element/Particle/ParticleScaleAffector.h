@@ -14,11 +14,14 @@ public:
 
 	ParticleScaleAffector(const Vector2<float>& scaleTo = Vector2<float>{ 1.f, 1.f });
 
-	virtual void Affect(unsigned int now, Particle *particlearray, unsigned int count);
+	virtual void Affect(unsigned int now, ParticleArray& particles);
 
 	//! Get affector type
 	virtual ParticleAffectorType GetType() const { return PAT_SCALE; }
 
+	//! Get the size added to the particles over their life time
+	virtual const Vector2<float>& GetScaleTo() const { return mScaleTo; }
+
 protected:
 	Vector2<float> mScaleTo;
 };
@@ -13,13 +13,15 @@
 
 #include "ParticleAnimatedMeshNodeEmitter.h"
 
+#include <emmintrin.h>
+
 //#include "Utilities/ViewFrustum.h"
 
 //! constructor
 ParticleSystemNode::ParticleSystemNode(const ActorId actorId, PVWUpdater* updater, bool createDefaultEmitter)
 :	Node(actorId, NT_PARTICLE_SYSTEM),
 	mEmitter(0), mParticleSize(Vector2<float>{5.f, 5.f}), mLastEmitTime(0),
-	mMaxParticles(0xffff), mParticlesAreGlobal(true)
+	mMaxParticles(16250), mParticlesAreGlobal(true), mSortByDepth(false)
 {
 	mPVWUpdater = updater;
 	mMeshBuffer = eastl::make_shared<MeshBuffer>();
@@ -87,7 +89,7 @@ bool ParticleSystemNode::PreRender(Scene *pScene)
 
 		DoParticleBuffers(pScene);
 
-		if (mParticles.size() != 0)
+		if (mParticles.GetSize() != 0)
 		{
 			int transparentCount = 0;
 			int solidCount = 0;
@@ -172,65 +174,185 @@ void ParticleSystemNode::DoParticleSystem(unsigned int time)
 
 		if (newParticles && array)
 		{
-			int j = mParticles.size();
-			if (newParticles > 16250 - j)
-				newParticles = 16250 - j;
+			unsigned int j = mParticles.GetSize();
+			if (j >= mMaxParticles)
+				newParticles = 0;
+			else if ((unsigned int)newParticles > mMaxParticles - j)
+				newParticles = mMaxParticles - j;
+
+			// grow geometrically so that the arrays and the buffers settle quickly
+			if (j + newParticles > mParticles.GetCapacity())
+			{
+				unsigned int capacity = eastl::max(mParticles.GetCapacity() * 2, 64u);
+				mParticles.Reserve(eastl::max(j + newParticles, eastl::min(capacity, mMaxParticles)));
+			}
 
-			mParticles.resize(j + newParticles);
-			for (int i = j; i<j + newParticles; ++i)
+			for (int i = 0; i<newParticles; ++i)
 			{
-				mParticles[i] = array[i - j];
+				Particle particle = array[i];
 
 				Vector4<float> startVector;
 				GetAbsoluteTransform().GetRotation().Transformation(
-					HLift(mParticles[i].mStartVector, 0.f), startVector);
-				mParticles[i].mStartVector = HProject(startVector);
+					HLift(particle.mStartVector, 0.f), startVector);
+				particle.mStartVector = HProject(startVector);
 				if (mParticlesAreGlobal)
 				{
 					Vector4<float> positionVector;
 					GetAbsoluteTransform().GetRotation().Transformation(
-						HLift(mParticles[i].mPos, 0.f), positionVector);
-					mParticles[i].mPos = HProject(positionVector);
+						HLift(particle.mPos, 0.f), positionVector);
+					particle.mPos = HProject(positionVector);
 				}
+				mParticles.Add(particle);
 			}
 		}
 	}
 
-	// run affectors
+	// Run affectors. The gravity, fade out and scale affectors are fused in
+	// the simulation pass: the last enabled one of each type takes part in it
+	// and the others run on their own. They don't touch the positions, so
+	// moving them after the remaining affectors gives the same result.
+	const ParticleGravityAffector* gravity = nullptr;
+	const ParticleFadeOutAffector* fadeOut = nullptr;
+	const ParticleScaleAffector* scale = nullptr;
+	eastl::list<eastl::shared_ptr<BaseParticleAffector>>::reverse_iterator rait = mAffectorList.rbegin();
+	for (; rait != mAffectorList.rend(); ++rait)
+	{
+		if (!(*rait)->GetEnabled())
+			continue;
+
+		if ((*rait)->GetType() == PAT_GRAVITY && !gravity)
+			gravity = static_cast<ParticleGravityAffector*>((*rait).get());
+		else if ((*rait)->GetType() == PAT_FADE_OUT && !fadeOut)
+			fadeOut = static_cast<ParticleFadeOutAffector*>((*rait).get());
+		else if ((*rait)->GetType() == PAT_SCALE && !scale)
+			scale = static_cast<ParticleScaleAffector*>((*rait).get());
+	}
+
 	eastl::list<eastl::shared_ptr<BaseParticleAffector>>::iterator ait = mAffectorList.begin();
 	for (; ait != mAffectorList.end(); ++ait)
-		(*ait)->Affect(now, mParticles.data(), mParticles.size());
+	{
+		const BaseParticleAffector* affector = (*ait).get();
+		if (affector != gravity && affector != fadeOut && affector != scale)
+			(*ait)->Affect(now, mParticles);
+	}
 
 	// animate all particles
-	float scale = (float)timediff;
+	SimulateParticles(now, (float)timediff, gravity, fadeOut, scale);
 
-	for (unsigned int i=0; i<mParticles.size();)
+	for (unsigned int i=0; i<mParticles.GetSize();)
 	{
-		// erase is pretty expensive!
-		if (now > mParticles[i].mEndTime)
+		if (now > mParticles.mEndTime[i])
+			mParticles.Remove(i);
+		else
+			++i;
+	}
+}
+
+//! Runs the fused affectors and moves the particles, four at once.
+void ParticleSystemNode::SimulateParticles(unsigned int now, float timeDiff,
+	const ParticleGravityAffector* gravity, const ParticleFadeOutAffector* fadeOut,
+	const ParticleScaleAffector* scale)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128i nowTime = _mm_set1_epi32((int)now);
+	const __m128 time = _mm_set1_ps(timeDiff);
+
+	__m128 gravityForce[3], timeForceLost = one;
+	if (gravity)
+	{
+		for (int k = 0; k < 3; ++k)
+			gravityForce[k] = _mm_set1_ps(gravity->GetGravity()[k]);
+		timeForceLost = _mm_set1_ps(gravity->GetTimeForceLost());
+	}
+
+	__m128 targetColor[4], fadeOutTime = one;
+	if (fadeOut)
+	{
+		for (int k = 0; k < 4; ++k)
+			targetColor[k] = _mm_set1_ps(fadeOut->GetTargetColor()[k]);
+		fadeOutTime = _mm_set1_ps((float)fadeOut->GetFadeOutTime());
+	}
+
+	__m128 scaleTo[2];
+	if (scale)
+	{
+		for (int k = 0; k < 2; ++k)
+			scaleTo[k] = _mm_set1_ps(scale->GetScaleTo()[k]);
+	}
+
+	for (unsigned int i = 0; i < mParticles.GetSize(); i += 4)
+	{
+		const __m128i startTime = _mm_loadu_si128((const __m128i*)(mParticles.mStartTime.data() + i));
+		const __m128i endTime = _mm_loadu_si128((const __m128i*)(mParticles.mEndTime.data() + i));
+		const __m128 age = _mm_cvtepi32_ps(_mm_sub_epi32(nowTime, startTime));
+
+		if (gravity)
 		{
-			// Particle order does not seem to matter.
-			// So we can delete by switching with last particle and deleting that one.
-			// This is a lot faster and speed is very important here as the erase otherwise
-			// can cause noticable freezes.
-			mParticles[i] = mParticles[mParticles.size()-1];
-			mParticles.pop_back();
+			// goes from the start vector to the gravity as the force is lost
+			__m128 d = _mm_div_ps(age, timeForceLost);
+			d = _mm_sub_ps(one, _mm_min_ps(_mm_max_ps(d, zero), one));
+			for (int k = 0; k < 3; ++k)
+			{
+				__m128 startVector = _mm_loadu_ps(mParticles.mStartVector[k].data() + i);
+				_mm_storeu_ps(mParticles.mVector[k].data() + i, _mm_add_ps(
+					gravityForce[k], _mm_mul_ps(d, _mm_sub_ps(startVector, gravityForce[k]))));
+			}
 		}
-		else
+
+		if (fadeOut)
 		{
-			mParticles[i].mPos += (mParticles[i].mVector * scale);
-			++i;
+			// only the particles which are about to die fade out
+			const __m128 remaining = _mm_cvtepi32_ps(_mm_sub_epi32(endTime, nowTime));
+			const __m128 fading = _mm_and_ps(
+				_mm_cmpge_ps(remaining, zero), _mm_cmplt_ps(remaining, fadeOutTime));
+			if (_mm_movemask_ps(fading))
+			{
+				const __m128 d = _mm_min_ps(_mm_div_ps(remaining, fadeOutTime), one);
+				for (int k = 0; k < 4; ++k)
+				{
+					__m128 startColor = _mm_loadu_ps(mParticles.mStartColor[k].data() + i);
+					__m128 color = _mm_add_ps(targetColor[k],
+						_mm_mul_ps(d, _mm_sub_ps(startColor, targetColor[k])));
+					color = _mm_or_ps(_mm_and_ps(fading, color),
+						_mm_andnot_ps(fading, _mm_loadu_ps(mParticles.mColor[k].data() + i)));
+					_mm_storeu_ps(mParticles.mColor[k].data() + i, color);
+				}
+			}
+		}
+
+		if (scale)
+		{
+			// grows by scaleTo over the life time
+			const __m128 lifeTime = _mm_cvtepi32_ps(_mm_sub_epi32(endTime, startTime));
+			const __m128 d = _mm_div_ps(age, lifeTime);
+			for (int k = 0; k < 2; ++k)
+			{
+				__m128 startSize = _mm_loadu_ps(mParticles.mStartSize[k].data() + i);
+				_mm_storeu_ps(mParticles.mSize[k].data() + i,
+					_mm_add_ps(startSize, _mm_mul_ps(scaleTo[k], d)));
+			}
+		}
+
+		for (int k = 0; k < 3; ++k)
+		{
+			__m128 position = _mm_loadu_ps(mParticles.mPos[k].data() + i);
+			__m128 vector = _mm_loadu_ps(mParticles.mVector[k].data() + i);
+			_mm_storeu_ps(mParticles.mPos[k].data() + i,
+				_mm_add_ps(position, _mm_mul_ps(vector, time)));
 		}
 	}
 }
 
 void ParticleSystemNode::ReallocateBuffers()
 {
-	if (mParticles.size() * 4 != mMeshBuffer->GetVertice()->GetNumElements() ||
-		mParticles.size() * 2 != mMeshBuffer->GetIndice()->GetNumPrimitives())
+	// the buffers follow the capacity of the particles and only grow, the
+	// draw is limited to the live particles
+	if (mParticles.GetCapacity() * 4 > mMeshBuffer->GetVertice()->GetNumElements())
 	{
+		const unsigned int capacity = mParticles.GetCapacity();
 		MeshBuffer* meshBuffer = new MeshBuffer(mMeshBuffer->GetVertice()->GetFormat(),
-			mParticles.size() * 4, mParticles.size() * 2, sizeof(unsigned int));
+			capacity * 4, capacity * 2, sizeof(unsigned int));
 		for (unsigned int i = 0; i < GetMaterialCount(); ++i)
 			meshBuffer->GetMaterial() = GetMaterial(i);
 		mMeshBuffer.reset(meshBuffer);
@@ -260,6 +382,68 @@ void ParticleSystemNode::ReallocateBuffers()
 				mMeshBuffer->GetVertice(), mMeshBuffer->GetIndice(), mEffect));
 		}
 	}
+
+	mMeshBuffer->GetVertice()->SetNumActiveElements(mParticles.GetSize() * 4);
+	mMeshBuffer->GetIndice()->SetNumActivePrimitives(mParticles.GetSize() * 2);
+}
+
+//! Orders the particles back to front along the view direction. The depths
+//! are quantized to 16 bits and sorted by two radix passes of 8 bits.
+void ParticleSystemNode::SortParticles(const Vector4<float>& direction)
+{
+	const unsigned int numParticles = mParticles.GetSize();
+	mDepthKeys.resize(numParticles);
+	mSortBuffer.resize(numParticles);
+	mSortedParticles.resize((numParticles + 3) & ~3u);
+
+	float minDepth = eastl::numeric_limits<float>::max();
+	float maxDepth = -eastl::numeric_limits<float>::max();
+	for (unsigned int i = 0; i < numParticles; ++i)
+	{
+		const float depth = mParticles.mPos[0][i] * direction[0] +
+			mParticles.mPos[1][i] * direction[1] + mParticles.mPos[2][i] * direction[2];
+		minDepth = eastl::min(minDepth, depth);
+		maxDepth = eastl::max(maxDepth, depth);
+	}
+
+	// the farthest particle gets the lowest key
+	const float scale = maxDepth > minDepth ? 65535.f / (maxDepth - minDepth) : 0.f;
+	for (unsigned int i = 0; i < numParticles; ++i)
+	{
+		const float depth = mParticles.mPos[0][i] * direction[0] +
+			mParticles.mPos[1][i] * direction[1] + mParticles.mPos[2][i] * direction[2];
+		mDepthKeys[i] = eastl::min((unsigned int)((maxDepth - depth) * scale), 65535u);
+		mSortBuffer[i] = i;
+	}
+
+	unsigned int* source = mSortBuffer.data();
+	unsigned int* target = mSortedParticles.data();
+	for (unsigned int shift = 0; shift < 16; shift += 8)
+	{
+		unsigned int offsets[256] = { 0 };
+		for (unsigned int i = 0; i < numParticles; ++i)
+			offsets[(mDepthKeys[source[i]] >> shift) & 0xff]++;
+
+		unsigned int offset = 0;
+		for (unsigned int bucket = 0; bucket < 256; ++bucket)
+		{
+			const unsigned int count = offsets[bucket];
+			offsets[bucket] = offset;
+			offset += count;
+		}
+
+		for (unsigned int i = 0; i < numParticles; ++i)
+			target[offsets[(mDepthKeys[source[i]] >> shift) & 0xff]++] = source[i];
+
+		eastl::swap(source, target);
+	}
+
+	// two passes leave the order back in the sort buffer
+	memcpy(mSortedParticles.data(), mSortBuffer.data(), numParticles * sizeof(unsigned int));
+
+	// the expansion reads four particles at once
+	for (unsigned int i = numParticles; i < mSortedParticles.size(); ++i)
+		mSortedParticles[i] = mSortedParticles[0];
 }
 
 void ParticleSystemNode::DoParticleBuffers(Scene *pScene)
@@ -268,34 +452,158 @@ void ParticleSystemNode::DoParticleBuffers(Scene *pScene)
 
 	if (!cameraNode) return;
 
-	//fill vertices
-	if (mParticles.size() != 0)
+	const unsigned int numParticles = mParticles.GetSize();
+	if (numParticles == 0)
+		return;
+
+	// blended particles are drawn back to front
+	const unsigned int* order = nullptr;
+	if (mSortByDepth)
+	{
+		SortParticles(cameraNode->Get()->GetDVector() * GetAbsoluteTransform().GetHMatrix());
+		order = mSortedParticles.data();
+	}
+
+	// The quads are expanded four particles at once and written straight
+	// into the interleaved vertices. The texture coordinates never change,
+	// they were written when the buffers were allocated.
+	const eastl::shared_ptr<VertexBuffer>& vbuffer = mMeshBuffer->GetVertice();
+	const VertexFormat& vformat = vbuffer->GetFormat();
+	const unsigned int vertexSize = vformat.GetVertexSize();
+	char* positions = vbuffer->GetData() + vformat.GetOffset(vformat.GetIndex(VA_POSITION, 0));
+	char* colors = vbuffer->GetData() + vformat.GetOffset(vformat.GetIndex(VA_COLOR, 0));
+
+	const Vector4<float> right = cameraNode->Get()->GetRVector();
+	const Vector4<float> up = cameraNode->Get()->GetUVector();
+	const __m128 half = _mm_set1_ps(0.5f);
+	__m128 rightAxis[3], upAxis[3];
+	for (int k = 0; k < 3; ++k)
+	{
+		rightAxis[k] = _mm_set1_ps(right[k]);
+		upAxis[k] = _mm_set1_ps(up[k]);
+	}
+
+	// the bound is grown over the particle centers and the largest distance
+	// from a center to the corners of its quad
+	__m128 minPosition[3], maxPosition[3];
+	__m128 maxExtent = _mm_setzero_ps();
+	for (int k = 0; k < 3; ++k)
 	{
-		int idx = 0;
-		for (unsigned int i = 0; i < mParticles.size(); ++i)
+		minPosition[k] = _mm_set1_ps(eastl::numeric_limits<float>::max());
+		maxPosition[k] = _mm_set1_ps(-eastl::numeric_limits<float>::max());
+	}
+
+	const __m128i lanes = _mm_set_epi32(3, 2, 1, 0);
+	for (unsigned int i = 0; i < numParticles; i += 4)
+	{
+		__m128 position[3], size[2], color[4];
+		if (order)
+		{
+			const unsigned int* particle = order + i;
+			for (int k = 0; k < 3; ++k)
+			{
+				const float* values = mParticles.mPos[k].data();
+				position[k] = _mm_set_ps(values[particle[3]],
+					values[particle[2]], values[particle[1]], values[particle[0]]);
+			}
+			for (int k = 0; k < 2; ++k)
+			{
+				const float* values = mParticles.mSize[k].data();
+				size[k] = _mm_set_ps(values[particle[3]],
+					values[particle[2]], values[particle[1]], values[particle[0]]);
+			}
+			for (int k = 0; k < 4; ++k)
+			{
+				const float* values = mParticles.mColor[k].data();
+				color[k] = _mm_set_ps(values[particle[3]],
+					values[particle[2]], values[particle[1]], values[particle[0]]);
+			}
+		}
+		else
+		{
+			for (int k = 0; k < 3; ++k)
+				position[k] = _mm_loadu_ps(mParticles.mPos[k].data() + i);
+			for (int k = 0; k < 2; ++k)
+				size[k] = _mm_loadu_ps(mParticles.mSize[k].data() + i);
+			for (int k = 0; k < 4; ++k)
+				color[k] = _mm_loadu_ps(mParticles.mColor[k].data() + i);
+		}
+
+		// lanes past the last particle repeat the first one of the group
+		const unsigned int count = eastl::min(numParticles - i, 4u);
+		if (count < 4)
 		{
-			const Particle& particle = mParticles[i];
+			const __m128 valid = _mm_castsi128_ps(
+				_mm_cmplt_epi32(lanes, _mm_set1_epi32((int)count)));
+			for (int k = 0; k < 3; ++k)
+			{
+				position[k] = _mm_or_ps(_mm_and_ps(valid, position[k]),
+					_mm_andnot_ps(valid, _mm_shuffle_ps(position[k], position[k], 0)));
+			}
+			for (int k = 0; k < 2; ++k)
+			{
+				size[k] = _mm_or_ps(_mm_and_ps(valid, size[k]),
+					_mm_andnot_ps(valid, _mm_shuffle_ps(size[k], size[k], 0)));
+			}
+		}
 
-			float f = 0.5f * particle.mSize[0];
-			const Vector4<float> horizontal = cameraNode->Get()->GetRVector() * f;
+		const __m128 width = _mm_mul_ps(half, size[0]);
+		const __m128 height = _mm_mul_ps(half, size[1]);
+		maxExtent = _mm_max_ps(maxExtent, _mm_sqrt_ps(
+			_mm_add_ps(_mm_mul_ps(width, width), _mm_mul_ps(height, height))));
 
-			f = 0.5f * particle.mSize[1];
-			const Vector4<float> vertical = cameraNode->Get()->GetUVector() * f;
+		__m128 corners[4][4];
+		for (int k = 0; k < 3; ++k)
+		{
+			minPosition[k] = _mm_min_ps(minPosition[k], position[k]);
+			maxPosition[k] = _mm_max_ps(maxPosition[k], position[k]);
+
+			const __m128 horizontal = _mm_mul_ps(rightAxis[k], width);
+			const __m128 vertical = _mm_mul_ps(upAxis[k], height);
+			corners[0][k] = _mm_add_ps(position[k], _mm_add_ps(horizontal, vertical));
+			corners[1][k] = _mm_add_ps(position[k], _mm_sub_ps(horizontal, vertical));
+			corners[2][k] = _mm_sub_ps(position[k], _mm_add_ps(horizontal, vertical));
+			corners[3][k] = _mm_sub_ps(position[k], _mm_sub_ps(horizontal, vertical));
+		}
 
-			mMeshBuffer->Position(0 + idx) = particle.mPos + HProject(horizontal + vertical);
-			mMeshBuffer->Color(0, 0 + idx) = particle.mColor;
-			mMeshBuffer->Position(1 + idx) = particle.mPos + HProject(horizontal - vertical);
-			mMeshBuffer->Color(0, 1 + idx) = particle.mColor;
-			mMeshBuffer->Position(2 + idx) = particle.mPos + HProject(-horizontal - vertical);
-			mMeshBuffer->Color(0, 2 + idx) = particle.mColor;
-			mMeshBuffer->Position(3 + idx) = particle.mPos + HProject(-horizontal + vertical);
-			mMeshBuffer->Color(0, 3 + idx) = particle.mColor;
+		// from one register per component to one register per particle
+		for (int corner = 0; corner < 4; ++corner)
+		{
+			corners[corner][3] = _mm_setzero_ps();
+			_MM_TRANSPOSE4_PS(corners[corner][0], corners[corner][1], corners[corner][2], corners[corner][3]);
+		}
+		_MM_TRANSPOSE4_PS(color[0], color[1], color[2], color[3]);
 
-			idx += 4;
+		for (unsigned int lane = 0; lane < count; ++lane)
+		{
+			const unsigned int vertex = (i + lane) * 4;
+			for (int corner = 0; corner < 4; ++corner)
+			{
+				float* target = (float*)(positions + (vertex + corner) * vertexSize);
+				_mm_storel_pi((__m64*)target, corners[corner][lane]);
+				_mm_store_ss(target + 2, _mm_movehl_ps(corners[corner][lane], corners[corner][lane]));
+				_mm_storeu_ps((float*)(colors + (vertex + corner) * vertexSize), color[lane]);
+			}
 		}
 	}
 
-	mVisual->UpdateModelBound();
+	float minBound[3], maxBound[3];
+	for (int k = 0; k < 3; ++k)
+	{
+		__m128 value = _mm_min_ps(minPosition[k], _mm_movehl_ps(minPosition[k], minPosition[k]));
+		_mm_store_ss(&minBound[k], _mm_min_ss(value, _mm_shuffle_ps(value, value, 1)));
+		value = _mm_max_ps(maxPosition[k], _mm_movehl_ps(maxPosition[k], maxPosition[k]));
+		_mm_store_ss(&maxBound[k], _mm_max_ss(value, _mm_shuffle_ps(value, value, 1)));
+	}
+	maxExtent = _mm_max_ps(maxExtent, _mm_movehl_ps(maxExtent, maxExtent));
+	float extent;
+	_mm_store_ss(&extent, _mm_max_ss(maxExtent, _mm_shuffle_ps(maxExtent, maxExtent, 1)));
+
+	const Vector3<float> halfDiagonal{ 0.5f * (maxBound[0] - minBound[0]),
+		0.5f * (maxBound[1] - minBound[1]), 0.5f * (maxBound[2] - minBound[2]) };
+	mVisual->mModelBound.SetCenter(Vector4<float>{ minBound[0] + halfDiagonal[0],
+		minBound[1] + halfDiagonal[1], minBound[2] + halfDiagonal[2], 1.f });
+	mVisual->mModelBound.SetRadius(Length(halfDiagonal) + extent);
 }
 
 //! Sets if the particles should be global. If it is, the particles are affected by
@@ -309,7 +617,31 @@ void ParticleSystemNode::SetParticlesAreGlobal(bool global)
 //! Remove all currently visible particles
 void ParticleSystemNode::ClearParticles()
 {
-	mParticles.clear();
+	mParticles.Clear();
+}
+
+//! Sets the most particles alive at once.
+void ParticleSystemNode::SetMaxParticles(unsigned int maxParticles)
+{
+	mMaxParticles = maxParticles;
+}
+
+//! Gets the most particles alive at once.
+unsigned int ParticleSystemNode::GetMaxParticles() const
+{
+	return mMaxParticles;
+}
+
+//! Sets if the particles are drawn back to front.
+void ParticleSystemNode::SetSortByDepth(bool sort)
+{
+	mSortByDepth = sort;
+}
+
+//! Gets if the particles are drawn back to front.
+bool ParticleSystemNode::GetSortByDepth() const
+{
+	return mSortByDepth;
 }
 
 //! Gets the particle emitter, which creates the particles.
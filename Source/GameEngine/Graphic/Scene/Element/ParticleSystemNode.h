@@ -73,6 +73,19 @@ public:
 	//! Remove all currently visible particles
 	void ClearParticles();
 
+	//! Sets the most particles alive at once. Default is 16250.
+	void SetMaxParticles(unsigned int maxParticles);
+
+	//! Gets the most particles alive at once.
+	unsigned int GetMaxParticles() const;
+
+	//! Sets if the particles are drawn back to front, for blended effects
+	//! which don't look right in any order. Default is false.
+	void SetSortByDepth(bool sort);
+
+	//! Gets if the particles are drawn back to front.
+	bool GetSortByDepth() const;
+
 	//! Do manually update the particles.
 	//! This should only be called when you want to render the node outside the scenegraph,
 	//! as the node will care about this otherwise automatically.
@@ -220,6 +233,10 @@ private:
 
 	void ReallocateBuffers();
 	void DoParticleBuffers(Scene *pScene);
+	void SortParticles(const Vector4<float>& direction);
+	void SimulateParticles(unsigned int now, float timeDiff,
+		const ParticleGravityAffector* gravity, const ParticleFadeOutAffector* fadeOut,
+		const ParticleScaleAffector* scale);
 
 	eastl::shared_ptr<BlendState> mBlendState;
 	eastl::shared_ptr<DepthStencilState> mDepthStencilState;
@@ -230,10 +247,10 @@ private:
 	eastl::shared_ptr<VisualEffect> mEffect;
 	eastl::list<eastl::shared_ptr<BaseParticleAffector>> mAffectorList;
 	eastl::shared_ptr<BaseParticleEmitter> mEmitter;
-	eastl::vector<Particle> mParticles;
+	ParticleArray mParticles;
 	Vector2<float> mParticleSize;
 	unsigned int mLastEmitTime;
-	int mMaxParticles;
+	unsigned int mMaxParticles;
 
 	enum GRAPHIC_ITEM ParticlePrimitive
 	{
@@ -244,6 +261,12 @@ private:
 	ParticlePrimitive mParticlePrimitive;
 
 	bool mParticlesAreGlobal;
+
+	//back to front order of the particles
+	bool mSortByDepth;
+	eastl::vector<unsigned int> mDepthKeys;
+	eastl::vector<unsigned int> mSortedParticles;
+	eastl::vector<unsigned int> mSortBuffer;
 };
 
 #endif
@@ -55,6 +55,16 @@ bool RootNode::RenderChildren(Scene *pScene)
 	{
 		pScene->SetCurrentRenderPass((RenderPass)pass);
 
+		// Nodes sharing a mesh are drawn as instances, unless the light manager
+		// needs to see each node.
+		if (pass == RP_SOLID && !pScene->GetLightManager())
+			pScene->GetInstanceBatcher().Render(pScene, pScene->GetRenderList(pass));
+
+		// Long lists are recorded by the job system when no light manager
+		// needs to see each node.
+		if (pScene->RenderInParallel(pScene->GetRenderList(pass)))
+			continue;
+
 		SceneNodeRenderList::iterator itNode = pScene->GetRenderList(pass).begin();
 		SceneNodeRenderList::iterator end = pScene->GetRenderList(pass).end();
 
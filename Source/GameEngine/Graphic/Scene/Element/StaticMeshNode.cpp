@@ -9,6 +9,10 @@
 
 #include "Graphic/Scene/Scene.h"
 
+#include "Core/OS/OS.h"
+
+#include "Application/GameApplication.h"
+
 
 //! constructor
 StaticMeshNode::StaticMeshNode(const ActorId actorId, PVWUpdater* updater, const eastl::shared_ptr<BaseMesh>& mesh)
@@ -38,315 +42,136 @@ void StaticMeshNode::SetMesh(const eastl::shared_ptr<BaseMesh>& mesh)
 	mMesh = mesh;
 
 	mVisuals.clear();
-
-	eastl::vector<eastl::shared_ptr<BaseMeshBuffer>> meshBuffers;
-	unsigned int meshBufferVerticeCount = 0, meshBufferPrimitiveCount = 0;
-
-	eastl::map<eastl::string, eastl::vector<eastl::shared_ptr<BaseMeshBuffer>>> 
-		meshBufferDiffuse, meshBufferTransparentDiffuse;
-	eastl::map<eastl::string, unsigned int> meshBufferVertices, meshBufferTransparentVertices;
-	eastl::map<eastl::string, unsigned int> meshBufferPrimitives, meshBufferTransparentPrimitives;
-	for (unsigned int i = 0; i < mMesh->GetMeshBufferCount(); ++i)
+	mChunks.clear();
+	mMaterials.clear();
+	mBlendStates.clear();
+	mDepthStencilStates.clear();
+
+	// the mesh buffers are merged in a visual per group, which is split in
+	// chunks culled one by one. Merging a level takes a while, so the result
+	// is saved and loaded back as long as the mesh and the cell size match
+	GameApplication* gameApp = (GameApplication*)Application::App;
+	const GameOption& option = gameApp->mOption;
+	unsigned int startTime = Timer::GetRealTime();
+
+	StaticMeshBatch batch(option.mStaticBatchCellSize);
+	unsigned int hash = StaticMeshBatch::Hash(*mMesh, option.mStaticBatchCellSize);
+	eastl::string cacheFile = option.mStaticBatchCachePath + "static_" + eastl::to_string(hash) + ".batch";
+
+	bool cached = option.mStaticBatchCache && batch.Load(cacheFile, hash);
+	if (!cached)
 	{
-		const eastl::shared_ptr<BaseMeshBuffer>& meshBuffer = mMesh->GetMeshBuffer(i);
-		if (meshBuffer)
-		{
-			eastl::shared_ptr<Texture2> textureDiffuse = 
-				meshBuffer->GetMaterial()->GetTexture(TT_DIFFUSE);
-			if (textureDiffuse)
-			{
-				eastl::string tex =
-					eastl::to_string(textureDiffuse->GetWidth()) + " " +
-					eastl::to_string(textureDiffuse->GetHeight());
-				if (meshBuffer->GetMaterial()->IsTransparent())
-				{
-					meshBufferTransparentDiffuse[tex].push_back(meshBuffer);
-
-					if (meshBufferTransparentVertices.find(tex) == meshBufferTransparentVertices.end())
-					{
-						meshBufferTransparentVertices[tex] = 0;
-						meshBufferTransparentPrimitives[tex] = 0;
-					}
-					meshBufferTransparentVertices[tex] += meshBuffer->GetVertice()->GetNumElements();
-					meshBufferTransparentPrimitives[tex] += meshBuffer->GetIndice()->GetNumPrimitives();
-				}
-				else
-				{
-					meshBufferDiffuse[tex].push_back(meshBuffer);
-
-					if (meshBufferVertices.find(tex) == meshBufferVertices.end())
-					{
-						meshBufferVertices[tex] = 0;
-						meshBufferPrimitives[tex] = 0;
-					}
-					meshBufferVertices[tex] += meshBuffer->GetVertice()->GetNumElements();
-					meshBufferPrimitives[tex] += meshBuffer->GetIndice()->GetNumPrimitives();
-				}
-			}
-			else
-			{
-				meshBufferVerticeCount += meshBuffer->GetVertice()->GetNumElements();
-				meshBufferPrimitiveCount += meshBuffer->GetIndice()->GetNumPrimitives();
-				meshBuffers.push_back(meshBuffer);
-			}
-		}
+		batch.Build(*mMesh);
+		if (option.mStaticBatchCache)
+			batch.Save(cacheFile);
 	}
 
-	eastl::map<eastl::string, eastl::vector<eastl::shared_ptr<BaseMeshBuffer>>>::const_iterator it;
-	for (it = meshBufferDiffuse.begin(); it != meshBufferDiffuse.end(); it++)
+	const eastl::vector<StaticMeshBatch::Vertex>& vertices = batch.GetVertices();
+	const eastl::vector<unsigned int>& indices = batch.GetIndices();
+	const eastl::vector<StaticMeshBatch::Chunk>& chunks = batch.GetChunks();
+	const eastl::vector<unsigned int>& layers = batch.GetLayers();
+	for (const StaticMeshBatch::Group& group : batch.GetGroups())
 	{
-		struct Vertex
-		{
-			Vector3<float> position;
-			Vector3<float> texCoord;
-			Vector3<float> normal;
-		};
-		VertexFormat vertexFormat;
-		vertexFormat.Bind(VA_POSITION, DF_R32G32B32_FLOAT, 0);
-		vertexFormat.Bind(VA_TEXCOORD, DF_R32G32B32_FLOAT, 0);
-		vertexFormat.Bind(VA_NORMAL, DF_R32G32B32_FLOAT, 0);
-
-		eastl::shared_ptr<VertexBuffer> vBuffer = eastl::make_shared<VertexBuffer>(
-			vertexFormat, meshBufferVertices[it->first] * sizeof(Vertex));
-		Vertex* vertex = vBuffer->Get<Vertex>();
+		eastl::shared_ptr<Material> material = mMesh->GetMeshBuffer(group.mMaterialBuffer)->GetMaterial();
 
 		eastl::shared_ptr<IndexBuffer> iBuffer = eastl::make_shared<IndexBuffer>(
-			IP_TRIMESH, meshBufferPrimitives[it->first], sizeof(unsigned int));
-
-		size_t split = it->first.find(" ");
-		eastl::shared_ptr<Texture2Array> textureArray = 
-			eastl::make_shared<Texture2Array>(it->second.size(), DF_R8G8B8A8_UNORM, 
-			atoi(it->first.substr(0, split).c_str()), atoi(it->first.substr(split + 1).c_str()), false);
-		//textureArray->AutogenerateMipmaps();
-		unsigned char* textureData = textureArray->Get<unsigned char>();
-
-		eastl::shared_ptr<Material> material;
-		SamplerState::Filter samplerfilter;
-		SamplerState::Mode samplerModeU, samplerModeV;
-		unsigned int bufferCount = 0, vertexCount = 0, idx = 0;
-		for (unsigned int mb = 0; mb < it->second.size(); mb++)
+			IP_TRIMESH, group.mNumIndices / 3, sizeof(unsigned int));
+		std::memcpy(iBuffer->GetData(), &indices[group.mFirstIndex], group.mNumIndices * sizeof(unsigned int));
+
+		eastl::shared_ptr<VertexBuffer> vBuffer;
+		eastl::shared_ptr<VisualEffect> effect;
+		if (group.mTextured)
 		{
-			const eastl::shared_ptr<BaseMeshBuffer>& meshBuffer = it->second[mb];
-			if (meshBuffer)
+			VertexFormat vertexFormat;
+			vertexFormat.Bind(VA_POSITION, DF_R32G32B32_FLOAT, 0);
+			vertexFormat.Bind(VA_TEXCOORD, DF_R32G32B32_FLOAT, 0);
+			vertexFormat.Bind(VA_NORMAL, DF_R32G32B32_FLOAT, 0);
+
+			// the batch vertices have the same layout
+			vBuffer = eastl::make_shared<VertexBuffer>(vertexFormat, group.mNumVertices);
+			std::memcpy(vBuffer->GetData(), &vertices[group.mFirstVertex],
+				group.mNumVertices * sizeof(StaticMeshBatch::Vertex));
+
+			eastl::shared_ptr<Texture2Array> textureArray = eastl::make_shared<Texture2Array>(
+				group.mNumLayers, DF_R8G8B8A8_UNORM, group.mTextureWidth, group.mTextureHeight, false);
+			//textureArray->AutogenerateMipmaps();
+			unsigned char* textureData = textureArray->Get<unsigned char>();
+
+			//fill textures
+			for (unsigned int l = 0; l < group.mNumLayers; l++)
 			{
 				eastl::shared_ptr<Texture2> textureDiffuse =
-					meshBuffer->GetMaterial()->GetTexture(TT_DIFFUSE);
-				samplerfilter = meshBuffer->GetMaterial()->mTextureLayer[TT_DIFFUSE].mFilter;
-				samplerModeU = meshBuffer->GetMaterial()->mTextureLayer[TT_DIFFUSE].mModeU;
-				samplerModeV = meshBuffer->GetMaterial()->mTextureLayer[TT_DIFFUSE].mModeV;
-				material = meshBuffer->GetMaterial();
-
-				// fill vertices
-				for (unsigned int i = 0; i < meshBuffer->GetVertice()->GetNumElements(); i++)
-				{
-					vertex[vertexCount + i].position = meshBuffer->Position(i);
-					vertex[vertexCount + i].normal = meshBuffer->Normal(i);
-					vertex[vertexCount + i].texCoord = HLift(meshBuffer->TCoord(0, i), (float)bufferCount);
-				}
-
-				//fill textures
+					mMesh->GetMeshBuffer(layers[group.mFirstLayer + l])->GetMaterial()->GetTexture(TT_DIFFUSE);
 				std::memcpy(textureData, textureDiffuse->GetData(), textureDiffuse->GetNumBytes());
 				textureData += textureDiffuse->GetNumBytes();
-
-				//fill indices
-				unsigned int* index = meshBuffer->GetIndice()->Get<unsigned int>();
-				for (unsigned int i = 0; i < meshBuffer->GetIndice()->GetNumPrimitives(); i++)
-				{
-					iBuffer->SetTriangle(idx++,
-						vertexCount + index[i * 3],
-						vertexCount + index[i * 3 + 1],
-						vertexCount + index[i * 3 + 2]);
-				}
-
-				vertexCount += meshBuffer->GetVertice()->GetNumElements();
-				bufferCount++;
 			}
-		}
 
-		mMaterials.push_back(material);
-		mBlendStates.push_back(eastl::make_shared<BlendState>());
-		mDepthStencilStates.push_back(eastl::make_shared<DepthStencilState>());
-
-		eastl::vector<eastl::string> path;
+			eastl::vector<eastl::string> path;
 #if defined(_OPENGL_)
-		path.push_back("Effects/Texture2ArrayEffectVS.glsl");
-		path.push_back("Effects/Texture2ArrayEffectPS.glsl");
+			path.push_back("Effects/Texture2ArrayEffectVS.glsl");
+			path.push_back("Effects/Texture2ArrayEffectPS.glsl");
 #else
-		path.push_back("Effects/Texture2ArrayEffectVS.hlsl");
-		path.push_back("Effects/Texture2ArrayEffectPS.hlsl");
+			path.push_back("Effects/Texture2ArrayEffectVS.hlsl");
+			path.push_back("Effects/Texture2ArrayEffectPS.hlsl");
 #endif
 
-		eastl::shared_ptr<Texture2ArrayEffect> effect = eastl::make_shared<Texture2ArrayEffect>(
-			ProgramFactory::Get(), path, textureArray, samplerfilter, samplerModeU, samplerModeV);
-
-		eastl::shared_ptr<Visual> visual = eastl::make_shared<Visual>(vBuffer, iBuffer, effect);
-		visual->UpdateModelBound();
-		mVisuals.push_back(visual);
-		mPVWUpdater->Subscribe(mWorldTransform, effect->GetPVWMatrixConstant());
-	}
-
-	for (it = meshBufferTransparentDiffuse.begin(); it != meshBufferTransparentDiffuse.end(); it++)
-	{
-		struct Vertex
-		{
-			Vector3<float> position;
-			Vector3<float> texCoord;
-			Vector3<float> normal;
-		};
-		VertexFormat vertexFormat;
-		vertexFormat.Bind(VA_POSITION, DF_R32G32B32_FLOAT, 0);
-		vertexFormat.Bind(VA_TEXCOORD, DF_R32G32B32_FLOAT, 0);
-		vertexFormat.Bind(VA_NORMAL, DF_R32G32B32_FLOAT, 0);
-
-		eastl::shared_ptr<VertexBuffer> vBuffer = eastl::make_shared<VertexBuffer>(
-			vertexFormat, meshBufferTransparentVertices[it->first] * sizeof(Vertex));
-		Vertex* vertex = vBuffer->Get<Vertex>();
-
-		eastl::shared_ptr<IndexBuffer> iBuffer = eastl::make_shared<IndexBuffer>(
-			IP_TRIMESH, meshBufferTransparentPrimitives[it->first], sizeof(unsigned int));
-
-		size_t split = it->first.find(" ");
-		eastl::shared_ptr<Texture2Array> textureArray =
-			eastl::make_shared<Texture2Array>(it->second.size(), DF_R8G8B8A8_UNORM,
-				atoi(it->first.substr(0, split).c_str()), atoi(it->first.substr(split + 1).c_str()), false);
-		//textureArray->AutogenerateMipmaps();
-		unsigned char* textureData = textureArray->Get<unsigned char>();
-
-		eastl::shared_ptr<Material> material;
-		SamplerState::Filter samplerfilter;
-		SamplerState::Mode samplerModeU, samplerModeV;
-		unsigned int bufferCount = 0, vertexCount = 0, idx = 0;
-		for (unsigned int mb = 0; mb < it->second.size(); mb++)
+			effect = eastl::make_shared<Texture2ArrayEffect>(ProgramFactory::Get(), path, textureArray,
+				material->mTextureLayer[TT_DIFFUSE].mFilter,
+				material->mTextureLayer[TT_DIFFUSE].mModeU,
+				material->mTextureLayer[TT_DIFFUSE].mModeV);
+		}
+		else
 		{
-			const eastl::shared_ptr<BaseMeshBuffer>& meshBuffer = it->second[mb];
-			if (meshBuffer)
+			struct Vertex
 			{
-				eastl::shared_ptr<Texture2> textureDiffuse =
-					meshBuffer->GetMaterial()->GetTexture(TT_DIFFUSE);
-				samplerfilter = meshBuffer->GetMaterial()->mTextureLayer[TT_DIFFUSE].mFilter;
-				samplerModeU = meshBuffer->GetMaterial()->mTextureLayer[TT_DIFFUSE].mModeU;
-				samplerModeV = meshBuffer->GetMaterial()->mTextureLayer[TT_DIFFUSE].mModeV;
-				material = meshBuffer->GetMaterial();
-
-				// fill vertices
-				for (unsigned int i = 0; i < meshBuffer->GetVertice()->GetNumElements(); i++)
-				{
-					vertex[vertexCount + i].position = meshBuffer->Position(i);
-					vertex[vertexCount + i].normal = meshBuffer->Normal(i);
-					vertex[vertexCount + i].texCoord = HLift(meshBuffer->TCoord(0, i), (float)bufferCount);
-				}
-
-				//fill textures
-				std::memcpy(textureData, textureDiffuse->GetData(), textureDiffuse->GetNumBytes());
-				textureData += textureDiffuse->GetNumBytes();
-
-				//fill indices
-				unsigned int* index = meshBuffer->GetIndice()->Get<unsigned int>();
-				for (unsigned int i = 0; i < meshBuffer->GetIndice()->GetNumPrimitives(); i++)
-				{
-					iBuffer->SetTriangle(idx++,
-						vertexCount + index[i * 3],
-						vertexCount + index[i * 3 + 1],
-						vertexCount + index[i * 3 + 2]);
-				}
-
-				vertexCount += meshBuffer->GetVertice()->GetNumElements();
-				bufferCount++;
+				Vector3<float> position;
+				Vector4<float> color;
+				Vector3<float> normal;
+			};
+			VertexFormat vertexFormat;
+			vertexFormat.Bind(VA_POSITION, DF_R32G32B32_FLOAT, 0);
+			vertexFormat.Bind(VA_COLOR, DF_R32G32B32A32_FLOAT, 0);
+			vertexFormat.Bind(VA_NORMAL, DF_R32G32B32_FLOAT, 0);
+
+			vBuffer = eastl::make_shared<VertexBuffer>(vertexFormat, group.mNumVertices);
+			Vertex* vertex = vBuffer->Get<Vertex>();
+
+			// fill vertices
+			for (unsigned int i = 0; i < group.mNumVertices; i++)
+			{
+				vertex[i].position = vertices[group.mFirstVertex + i].mPosition;
+				vertex[i].color = Vector4<float>::Zero();
+				vertex[i].normal = vertices[group.mFirstVertex + i].mNormal;
 			}
-		}
-
-		mMaterials.push_back(material);
-		mBlendStates.push_back(eastl::make_shared<BlendState>());
-		mDepthStencilStates.push_back(eastl::make_shared<DepthStencilState>());
 
-		eastl::vector<eastl::string> path;
+			eastl::vector<eastl::string> path;
 #if defined(_OPENGL_)
-		path.push_back("Effects/Texture2ArrayEffectVS.glsl");
-		path.push_back("Effects/Texture2ArrayEffectPS.glsl");
+			path.push_back("Effects/ConstantColorEffectVS.glsl");
+			path.push_back("Effects/ConstantColorEffectPS.glsl");
 #else
-		path.push_back("Effects/Texture2ArrayEffectVS.hlsl");
-		path.push_back("Effects/Texture2ArrayEffectPS.hlsl");
+			path.push_back("Effects/ConstantColorEffectVS.hlsl");
+			path.push_back("Effects/ConstantColorEffectPS.hlsl");
 #endif
-
-		eastl::shared_ptr<Texture2ArrayEffect> effect = eastl::make_shared<Texture2ArrayEffect>(
-			ProgramFactory::Get(), path, textureArray, samplerfilter, samplerModeU, samplerModeV);
-
-		eastl::shared_ptr<Visual> visual = eastl::make_shared<Visual>(vBuffer, iBuffer, effect);
-		visual->UpdateModelBound();
-		mVisuals.push_back(visual);
-		mPVWUpdater->Subscribe(mWorldTransform, effect->GetPVWMatrixConstant());
-	}
-
-	if (meshBuffers.size() > 0)
-	{
-		struct Vertex
-		{
-			Vector3<float> position;
-			Vector4<float> color;
-			Vector3<float> normal;
-		};
-		VertexFormat vertexFormat;
-		vertexFormat.Bind(VA_POSITION, DF_R32G32B32_FLOAT, 0);
-		vertexFormat.Bind(VA_COLOR, DF_R32G32B32A32_FLOAT, 0);
-		vertexFormat.Bind(VA_NORMAL, DF_R32G32B32_FLOAT, 0);
-
-		eastl::shared_ptr<VertexBuffer> vBuffer = eastl::make_shared<VertexBuffer>(
-			vertexFormat, meshBufferVerticeCount * sizeof(Vertex));
-		Vertex* vertex = vBuffer->Get<Vertex>();
-
-		eastl::shared_ptr<IndexBuffer> iBuffer = eastl::make_shared<IndexBuffer>(
-			IP_TRIMESH, meshBufferPrimitiveCount, sizeof(unsigned int));
-
-		eastl::shared_ptr<Material> material;
-		unsigned int vertexCount = 0, idx = 0;
-		for (unsigned int mb = 0; mb < meshBuffers.size(); mb++)
-		{
-			const eastl::shared_ptr<BaseMeshBuffer>& meshBuffer = meshBuffers[mb];
-			if (meshBuffer)
-			{
-				material = meshBuffer->GetMaterial();
-
-				// fill vertices
-				for (unsigned int i = 0; i < meshBuffer->GetVertice()->GetNumElements(); i++)
-				{
-					vertex[vertexCount + i].position = meshBuffer->Position(i);
-					vertex[vertexCount + i].normal = meshBuffer->Normal(i);
-				}
-
-				//fill indices
-				unsigned int* index = meshBuffer->GetIndice()->Get<unsigned int>();
-				for (unsigned int i = 0; i < meshBuffer->GetIndice()->GetNumPrimitives(); i++)
-				{
-					iBuffer->SetTriangle(idx++,
-						vertexCount + index[i * 3],
-						vertexCount + index[i * 3 + 1],
-						vertexCount + index[i * 3 + 2]);
-				}
-
-				vertexCount += meshBuffer->GetVertice()->GetNumElements();
-			}
+			effect = eastl::make_shared<ConstantColorEffect>(ProgramFactory::Get(), path, Vector4<float>::Zero());
 		}
 
 		mMaterials.push_back(material);
 		mBlendStates.push_back(eastl::make_shared<BlendState>());
 		mDepthStencilStates.push_back(eastl::make_shared<DepthStencilState>());
-
-		eastl::vector<eastl::string> path;
-#if defined(_OPENGL_)
-		path.push_back("Effects/ConstantColorEffectVS.glsl");
-		path.push_back("Effects/ConstantColorEffectPS.glsl");
-#else
-		path.push_back("Effects/ConstantColorEffectVS.hlsl");
-		path.push_back("Effects/ConstantColorEffectPS.hlsl");
-#endif
-		eastl::shared_ptr<ConstantColorEffect> effect =
-			eastl::make_shared<ConstantColorEffect>(ProgramFactory::Get(), path, Vector4<float>::Zero());
+		mChunks.push_back(eastl::vector<StaticMeshBatch::Chunk>(
+			chunks.begin() + group.mFirstChunk, chunks.begin() + group.mFirstChunk + group.mNumChunks));
 
 		eastl::shared_ptr<Visual> visual = eastl::make_shared<Visual>(vBuffer, iBuffer, effect);
 		visual->UpdateModelBound();
 		mVisuals.push_back(visual);
 		mPVWUpdater->Subscribe(mWorldTransform, effect->GetPVWMatrixConstant());
 	}
+
+	LogInformation(eastl::string(cached ? "Loaded" : "Merged") + " static mesh in " +
+		eastl::to_string(Timer::GetRealTime() - startTime) + " ms (" +
+		eastl::to_string(mMesh->GetMeshBufferCount()) + " buffers, " +
+		eastl::to_string(batch.GetGroups().size()) + " groups, " +
+		eastl::to_string(chunks.size()) + " chunks)");
 }
 
 
@@ -422,7 +247,10 @@ bool StaticMeshNode::Render(Scene *pScene)
 			Renderer::Get()->SetDepthStencilState(mDepthStencilStates[i]);
 			Renderer::Get()->SetRasterizerState(mRasterizerState);
 
-			Renderer::Get()->Draw(mVisuals[i]);
+			if (mChunks[i].size() > 1)
+				DrawChunks(pScene, i);
+			else
+				Renderer::Get()->Draw(mVisuals[i]);
 
 			Renderer::Get()->SetDefaultBlendState();
 			Renderer::Get()->SetDefaultDepthStencilState();
@@ -434,6 +262,54 @@ bool StaticMeshNode::Render(Scene *pScene)
 }
 
 
+//! draws the chunks of a visual which are in the view frustum, the chunks
+//! following each other in the index buffer with a single draw
+void StaticMeshNode::DrawChunks(Scene *pScene, unsigned int i)
+{
+	const eastl::shared_ptr<IndexBuffer>& iBuffer = mVisuals[i]->GetIndexBuffer();
+	unsigned int numPrimitives = iBuffer->GetNumPrimitives();
+
+	unsigned int firstPrimitive = 0, numActivePrimitives = 0;
+	for (unsigned int c = 0; c <= mChunks[i].size(); ++c)
+	{
+		if (c < mChunks[i].size())
+		{
+			const StaticMeshBatch::Chunk& chunk = mChunks[i][c];
+
+			BoundingSphere modelBound, worldBound;
+			modelBound.SetCenter(Vector4<float>{ chunk.mCenter[0], chunk.mCenter[1], chunk.mCenter[2], 1.f });
+			modelBound.SetRadius(chunk.mRadius);
+			modelBound.TransformBy(mWorldTransform, worldBound);
+			if (pScene->IsCulled(worldBound))
+				continue;
+
+			if (numActivePrimitives > 0 && firstPrimitive + numActivePrimitives == chunk.mFirstPrimitive)
+			{
+				numActivePrimitives += chunk.mNumPrimitives;
+				continue;
+			}
+		}
+
+		if (numActivePrimitives > 0)
+		{
+			// the first primitive is checked against the active ones
+			iBuffer->SetNumActivePrimitives(numActivePrimitives);
+			iBuffer->SetFirstPrimitive(firstPrimitive);
+			Renderer::Get()->Draw(mVisuals[i]);
+		}
+
+		if (c < mChunks[i].size())
+		{
+			firstPrimitive = mChunks[i][c].mFirstPrimitive;
+			numActivePrimitives = mChunks[i][c].mNumPrimitives;
+		}
+	}
+
+	iBuffer->SetFirstPrimitive(0);
+	iBuffer->SetNumActivePrimitives(numPrimitives);
+}
+
+
 //! Removes a child from this scene node.
 //! Implemented here, to be able to remove the shadow properly, if there is one,
 //! or to remove attached childs.
@@ -9,6 +9,8 @@
 
 #include "ShadowVolumeNode.h"
 
+#include "Graphic/Scene/Element/Mesh/StaticMeshBatch.h"
+
 class StaticMeshNode : public Node
 {
 public:
@@ -78,12 +80,16 @@ public:
 
 protected:
 
+	//! draws the chunks of the visual in the view frustum
+	void DrawChunks(Scene *pScene, unsigned int i);
+
 	eastl::vector<eastl::shared_ptr<Material>> mMaterials;
 	eastl::vector<eastl::shared_ptr<BlendState>> mBlendStates;
 	eastl::vector<eastl::shared_ptr<DepthStencilState>> mDepthStencilStates;
 	eastl::shared_ptr<RasterizerState> mRasterizerState;
 
 	eastl::vector<eastl::shared_ptr<Visual>> mVisuals;
+	eastl::vector<eastl::vector<StaticMeshBatch::Chunk>> mChunks;
 	eastl::shared_ptr<BaseMesh> mMesh;
 	eastl::shared_ptr<ShadowVolumeNode> mShadow;
 
@@ -441,78 +441,23 @@ bool Node::PreRender(Scene *pScene)
 //! Sort the nodes which are going to be rendered
 void Node::SortRenderList(Scene* pScene)
 {
-	//LIGHT NODES
-	if (!pScene->GetLightManager())
-	{
-		SceneNodeRenderList& renderList = pScene->GetRenderList(RP_LIGHT);
-
-		// Sort the lights by distance from the camera
-		Vector4<float> camWorldPos;
-		if (pScene->GetActiveCamera())
-			camWorldPos = pScene->GetActiveCamera()->Get()->GetPosition();
-
-		eastl::vector<DistanceNodeEntry> SortedLights;
-		for (int light = renderList.size() - 1; light >= 0; --light)
-			SortedLights.push_back(DistanceNodeEntry(renderList[light], camWorldPos));
-
-		eastl::sort(SortedLights.begin(), SortedLights.end());
-
-		for (int light = (int)renderList.size() - 1; light >= 0; --light)
-			renderList[light] = SortedLights[light].mNode;
-	}
-
-	//SOLID NODES
-	{
-		SceneNodeRenderList& renderList = pScene->GetRenderList(RP_SOLID);
-
-		// Sort the solids by texture id
-		eastl::vector<DefaultNodeEntry> SortedSolids;
-		for (int solid = renderList.size() - 1; solid >= 0; --solid)
-			SortedSolids.push_back(DefaultNodeEntry(renderList[solid]));
-
-		eastl::sort(SortedSolids.begin(), SortedSolids.end());
-
-		for (int solid = (int)renderList.size() - 1; solid >= 0; --solid)
-			renderList[solid] = SortedSolids[solid].mNode;
-	}
-
-	//TRANSPARENT NODES
-	{
-		SceneNodeRenderList& renderList = pScene->GetRenderList(RP_TRANSPARENT);
-
-		// Sort the transparent nodes by distance from the camera
-		Vector4<float> camWorldPos;
-		if (pScene->GetActiveCamera())
-			camWorldPos = pScene->GetActiveCamera()->Get()->GetPosition();
-
-		eastl::vector<TransparentNodeEntry> SortedTransparent;
-		for (int transparent = renderList.size() - 1; transparent >= 0; --transparent)
-			SortedTransparent.push_back(TransparentNodeEntry(renderList[transparent], camWorldPos));
-
-		eastl::sort(SortedTransparent.begin(), SortedTransparent.end());
+	Vector4<float> camWorldPos = Vector4<float>::Unit(3);
+	if (pScene->GetActiveCamera())
+		camWorldPos = pScene->GetActiveCamera()->Get()->GetPosition();
 
-		for (int transparent = (int)renderList.size() - 1; transparent >= 0; --transparent)
-			renderList[transparent] = SortedTransparent[transparent].mNode;
-	}
-
-	//TRANSPARENT EFFECT NODES
-	{
-		SceneNodeRenderList& renderList = pScene->GetRenderList(RP_TRANSPARENT_EFFECT);
+	RenderQueue& renderQueue = pScene->GetRenderQueue();
 
-		// Sort the transparent nodes by distance from the camera
-		Vector4<float> camWorldPos;
-		if (pScene->GetActiveCamera())
-			camWorldPos = pScene->GetActiveCamera()->Get()->GetPosition();
-
-		eastl::vector<TransparentNodeEntry> SortedTransparent;
-		for (int transparent = renderList.size() - 1; transparent >= 0; --transparent)
-			SortedTransparent.push_back(TransparentNodeEntry(renderList[transparent], camWorldPos));
+	// Sort the lights by distance from the camera, the light manager orders
+	// them itself when there is one
+	if (!pScene->GetLightManager())
+		renderQueue.Sort(RP_LIGHT, pScene->GetRenderList(RP_LIGHT), camWorldPos);
 
-		eastl::sort(SortedTransparent.begin(), SortedTransparent.end());
+	// Sort the solids by program and texture, then front to back
+	renderQueue.Sort(RP_SOLID, pScene->GetRenderList(RP_SOLID), camWorldPos);
 
-		for (int transparent = (int)renderList.size() - 1; transparent >= 0; --transparent)
-			renderList[transparent] = SortedTransparent[transparent].mNode;
-	}
+	// Sort the transparent nodes back to front
+	renderQueue.Sort(RP_TRANSPARENT, pScene->GetRenderList(RP_TRANSPARENT), camWorldPos);
+	renderQueue.Sort(RP_TRANSPARENT_EFFECT, pScene->GetRenderList(RP_TRANSPARENT_EFFECT), camWorldPos);
 }
 
 //
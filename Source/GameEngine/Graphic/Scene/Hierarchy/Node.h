@@ -346,79 +346,6 @@ protected:
 
 	void SortRenderList(Scene* pScene);
 
-	struct DefaultNodeEntry
-	{
-		DefaultNodeEntry(Node* n) :
-			mNode(n), mTextureValue(0)
-		{
-			/*
-			if (n->GetMaterialCount())
-				mTextureValue = (n->GetMaterial(0).GetTexture(0));
-			*/
-		}
-
-		bool operator < (const DefaultNodeEntry& other) const
-		{
-			return (mTextureValue < other.mTextureValue);
-		}
-
-		Node* mNode;
-
-	private:
-		void* mTextureValue;
-	};
-
-	//! sort on distance (center) to camera
-	struct TransparentNodeEntry
-	{
-		TransparentNodeEntry(Node* n, const Vector4<float>& cameraPos)
-			: mNode(n)
-		{
-			//mDistance = mNode->Get()->ToWorld().GetTranslation().GetDistanceFromSQ(cameraPos);
-		}
-
-		bool operator < (const TransparentNodeEntry& other) const
-		{
-			return mDistance > other.mDistance;
-		}
-
-		Node* mNode;
-
-	private:
-
-		float mDistance;
-	};
-
-	//! sort on distance (sphere) to camera
-	struct DistanceNodeEntry
-	{
-		DistanceNodeEntry(Node* n, const Vector4<float>& cameraPos)
-			: mNode(n)
-		{
-			SetNodeAndDistanceFromPosition(n, cameraPos);
-		}
-
-		bool operator < (const DistanceNodeEntry& other) const
-		{
-			return mDistance < other.mDistance;
-		}
-
-		void SetNodeAndDistanceFromPosition(Node* n, const Vector4<float>& fromPosition)
-		{
-			mNode = n;
-			/*
-			mDistance = mNode->Get()->ToWorld().GetTranslation().GetDistanceFromSQ(fromPosition);
-			mDistance -= mNode->GetBoundingBox().GetExtent().GetLengthSQ() * 0.5;
-			*/
-		}
-
-		Node* mNode;
-
-	private:
-
-		float mDistance;
-	};
-
 protected:
 
     // Support for geometric updates.
@@ -7,16 +7,45 @@
 
 #include "PVWUpdater.h"
 
+#include "Core/Threading/JobSystem.h"
+
+#include <xmmintrin.h>
+
+namespace
+{
+    // out = a * b for row-major 4x4 matrices: each row of the product is
+    // the rows of b scaled by the entries of the same row of a.
+    inline void MultiplyMatrices(float const* a, float const* b, float* out)
+    {
+        __m128 const row0 = _mm_loadu_ps(b + 0);
+        __m128 const row1 = _mm_loadu_ps(b + 4);
+        __m128 const row2 = _mm_loadu_ps(b + 8);
+        __m128 const row3 = _mm_loadu_ps(b + 12);
+        for (int r = 0; r < 4; ++r)
+        {
+            __m128 row = _mm_mul_ps(_mm_set1_ps(a[4 * r + 0]), row0);
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[4 * r + 1]), row1));
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[4 * r + 2]), row2));
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[4 * r + 3]), row3));
+            _mm_storeu_ps(out + 4 * r, row);
+        }
+    }
+}
+
 PVWUpdater::~PVWUpdater()
 {
 }
 
 PVWUpdater::PVWUpdater()
+    :
+    mInvalid(true)
 {
     Set(nullptr, [](eastl::shared_ptr<Buffer> const&) {});
 }
 
 PVWUpdater::PVWUpdater(eastl::shared_ptr<Camera> const& camera, BufferUpdater const& updater)
+    :
+    mInvalid(true)
 {
     Set(camera, updater);
 }
@@ -25,6 +54,7 @@ void PVWUpdater::Set(eastl::shared_ptr<Camera> const& camera, BufferUpdater cons
 {
     mCamera = camera;
     mBufferUpdater = updater;
+    mInvalid = true;
 }
 
 bool PVWUpdater::Subscribe(Matrix4x4<float> const& worldMatrix,
@@ -33,12 +63,16 @@ bool PVWUpdater::Subscribe(Matrix4x4<float> const& worldMatrix,
 {
     if (cbuffer && cbuffer->HasMember(pvwMatrixName))
     {
-		for (PVWIterator it = mSubscribers.begin(); it != mSubscribers.end(); it++)
-			if ((*it).second.first == cbuffer)
+		for (auto const& subscriber : mSubscribers)
+			if (subscriber.cbuffer == cbuffer)
 				return false;
 
-		mSubscribers.insert(eastl::make_pair(&worldMatrix,
-			eastl::make_pair(cbuffer, pvwMatrixName)));
+		Subscriber subscriber;
+		subscriber.worldMatrix = &worldMatrix;
+		subscriber.cbuffer = cbuffer;
+		subscriber.pvwMatrix = cbuffer->GetMemberHandle(pvwMatrixName);
+		subscriber.dirty = true;
+		mSubscribers.push_back(subscriber);
 		return true;
     }
     return false;
@@ -46,11 +80,14 @@ bool PVWUpdater::Subscribe(Matrix4x4<float> const& worldMatrix,
 
 bool PVWUpdater::Unsubscribe(eastl::shared_ptr<ConstantBuffer> const& cbuffer)
 {
-	for (PVWIterator it = mSubscribers.begin(); it != mSubscribers.end(); it++)
+	for (unsigned int i = 0; i < mSubscribers.size(); ++i)
 	{
-		if ((*it).second.first == cbuffer)
+		if (mSubscribers[i].cbuffer == cbuffer)
 		{
-			mSubscribers.erase(it);
+			// the order of the subscribers doesn't matter
+			if (i + 1 < mSubscribers.size())
+				mSubscribers[i] = eastl::move(mSubscribers.back());
+			mSubscribers.pop_back();
 			return true;
 		}
 	}
@@ -62,25 +99,74 @@ void PVWUpdater::UnsubscribeAll()
     mSubscribers.clear();
 }
 
+void PVWUpdater::Invalidate()
+{
+    mInvalid = true;
+}
+
 void PVWUpdater::Update()
 {
     // The function is called knowing that mCamera is not null.
     Matrix4x4<float> pvMatrix = mCamera->GetProjectionViewMatrix();
-    for (auto& element : mSubscribers)
+    bool pvChanged = mInvalid ||
+        memcmp(&pvMatrix, &mLastPVMatrix, sizeof(Matrix4x4<float>)) != 0;
+    mLastPVMatrix = pvMatrix;
+    mInvalid = false;
+
+    // Compute the new projection-view-world matrices.  Every subscriber
+    // owns its constant buffer, so the jobs write disjoint memory.
+    unsigned int const numSubscribers = (unsigned int)mSubscribers.size();
+    mUpdated.resize(numSubscribers);
+    if (JobSystem::Exists() && numSubscribers > UpdateGrainSize)
+    {
+        JobSystem::Get()->ParallelFor(0, numSubscribers, UpdateGrainSize,
+            [this, &pvMatrix, pvChanged](unsigned int begin, unsigned int end)
+            {
+                UpdateSubscribers(pvMatrix, pvChanged, begin, end);
+            });
+    }
+    else
+    {
+        UpdateSubscribers(pvMatrix, pvChanged, 0, numSubscribers);
+    }
+
+    // Allow the caller to update GPU memory as desired.  The uploads are
+    // issued together from the calling thread once all products are ready.
+    for (unsigned int i = 0; i < numSubscribers; ++i)
+    {
+        if (mUpdated[i])
+            mBufferUpdater(mSubscribers[i].cbuffer);
+    }
+}
+
+void PVWUpdater::UpdateSubscribers(Matrix4x4<float> const& pvMatrix,
+    bool pvChanged, unsigned int begin, unsigned int end)
+{
+    for (unsigned int i = begin; i < end; ++i)
     {
-        // Compute the new projection-view-world matrix.  The matrix
-        // *element.first is the model-to-world matrix for the associated
-        // object.
+        Subscriber& subscriber = mSubscribers[i];
+
+        // The matrix *subscriber.worldMatrix is the model-to-world matrix
+        // for the associated object.
+        Matrix4x4<float> const& worldMatrix = *subscriber.worldMatrix;
+        if (!pvChanged && !subscriber.dirty && memcmp(&worldMatrix,
+            &subscriber.lastWorldMatrix, sizeof(Matrix4x4<float>)) == 0)
+        {
+            mUpdated[i] = false;
+            continue;
+        }
+
+        Matrix4x4<float> pvwMatrix;
 #if defined(GE_USE_MAT_VEC)
-        Matrix4x4<float> pvwMatrix = pvMatrix * (*element.first);
+        MultiplyMatrices(&pvMatrix[0], &worldMatrix[0], &pvwMatrix[0]);
 #else
-        Matrix4x4<float> pvwMatrix = (*element.first) * pvMatrix;
+        MultiplyMatrices(&worldMatrix[0], &pvMatrix[0], &pvwMatrix[0]);
 #endif
         // Copy the source matrix into the system memory of the constant
         // buffer.
-        element.second.first->SetMember(element.second.second, pvwMatrix);
-
-        // Allow the caller to update GPU memory as desired.
-        mBufferUpdater(element.second.first);
+        subscriber.cbuffer->Set(subscriber.pvwMatrix, pvwMatrix);
+        subscriber.lastWorldMatrix = worldMatrix;
+        subscriber.dirty = false;
+        mUpdated[i] = true;
     }
 }
@@ -31,7 +31,7 @@ public:
     // Update the constant buffer's projection-view-world matrix (pvw-matrix)
     // when the camera's view or projection matrices change.  The input
     // 'pvwMatrixName' is the name specified in the shader program and is
-    // used in calls to ConstantBuffer::SetMember<Matrix4x4<float>>(...).
+    // resolved once into a ConstantBuffer::MemberHandle when subscribing.
     // If you modify the view or projection matrices directly through the
     // Camera interface, you are responsible for calling UpdatePVWMatrices().
     //
@@ -49,17 +49,42 @@ public:
 
     // After any camera modifictions that change the projection or view
     // matrices, call this function to update the constant buffers that
-    // are subscribed.
+    // are subscribed.  Only the subscribers whose world matrix changed are
+    // updated unless the projection-view matrix changed too.  The products
+    // are computed in parallel and the updated buffers are passed to the
+    // buffer updater afterwards, one after the other, on the calling thread.
     void Update();
 
+    // Force the update of every subscriber on the next call to Update, for
+    // instance when the constant buffers were written by other means.
+    void Invalidate();
+
 protected:
+    // Number of subscribers computed by each job of the parallel loop.
+    static unsigned int const UpdateGrainSize = 64;
+
+    struct Subscriber
+    {
+        Matrix4x4<float> const* worldMatrix;
+        eastl::shared_ptr<ConstantBuffer> cbuffer;
+        ConstantBuffer::MemberHandle pvwMatrix;
+
+        // The world matrix of the last update, used to skip the subscriber
+        // when neither it nor the projection-view matrix changed.
+        Matrix4x4<float> lastWorldMatrix;
+        bool dirty;
+    };
+
+    void UpdateSubscribers(Matrix4x4<float> const& pvMatrix,
+        bool pvChanged, unsigned int begin, unsigned int end);
+
 	eastl::shared_ptr<Camera> mCamera;
     BufferUpdater mBufferUpdater;
 
-    typedef Matrix4x4<float> const* PVWKey;
-    typedef eastl::pair<eastl::shared_ptr<ConstantBuffer>, eastl::string> PVWValue;
-	typedef eastl::multimap<PVWKey, PVWValue>::iterator PVWIterator;
-	eastl::multimap<PVWKey, PVWValue> mSubscribers;
+	eastl::vector<Subscriber> mSubscribers;
+    eastl::vector<unsigned char> mUpdated;
+    Matrix4x4<float> mLastPVMatrix;
+    bool mInvalid;
 };
 
 
@@ -0,0 +1,256 @@
+//========================================================================
+// InstanceBatcher.cpp : Draws the mesh nodes of the solid pass which share a
+// mesh with instanced draws.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "InstanceBatcher.h"
+
+#include "Graphic/Scene/Scene.h"
+#include "Graphic/Scene/Element/MeshNode.h"
+
+#include "Graphic/Renderer/Renderer.h"
+#include "Graphic/Effect/Material.h"
+#include "Graphic/Effect/Texture2Effect.h"
+
+namespace
+{
+	// Nodes of a mesh needed for a batch.
+	const unsigned int MinInstances = 2;
+
+	// Instances drawn by a call, the size of the world matrix buffer.
+	const unsigned int MaxInstances = 256;
+
+	// Frames a batch is kept without being drawn.
+	const unsigned int MaxUnusedFrames = 600;
+}
+
+InstanceBatcher::InstanceBatcher()
+	: mFrame(0)
+{
+}
+
+void InstanceBatcher::Clear()
+{
+	mBatches.clear();
+	mGroups.clear();
+}
+
+void InstanceBatcher::Render(Scene* pScene, SceneNodeRenderList& renderList)
+{
+	++mFrame;
+
+	const eastl::shared_ptr<Camera>& camera = pScene->GetPVWUpdater().GetCamera();
+	if (!camera || !Renderer::Get() || renderList.size() < MinInstances)
+		return;
+
+	// group the nodes by mesh, the first node of a group sets the textures
+	for (auto& group : mGroups)
+		group.second.clear();
+
+	bool grouped = false;
+	for (Node* node : renderList)
+	{
+		if (node->GetType() != NT_MESH)
+			continue;
+
+		MeshNode* meshNode = static_cast<MeshNode*>(node);
+		if (!IsBatchable(meshNode))
+			continue;
+
+		eastl::vector<MeshNode*>& group = mGroups[meshNode->GetMesh().get()];
+		if (group.empty() || HasSameTextures(meshNode, group.front()))
+		{
+			group.push_back(meshNode);
+			grouped = grouped || group.size() >= MinInstances;
+		}
+	}
+
+	if (grouped)
+	{
+		Matrix4x4<float> pvMatrix = camera->GetProjectionViewMatrix();
+		for (auto& group : mGroups)
+		{
+			eastl::vector<MeshNode*>& nodes = group.second;
+			if (nodes.size() < MinInstances)
+				continue;
+
+			Batch* batch = GetBatch(nodes.front());
+			if (!batch)
+				continue;
+
+			mWorldMatrices.resize(nodes.size());
+			for (unsigned int i = 0; i < nodes.size(); ++i)
+				mWorldMatrices[i] = nodes[i]->GetAbsoluteTransform().GetHMatrix();
+
+			Draw(*batch, nodes.front(), pvMatrix);
+		}
+
+		// the nodes drawn are dropped from the render list
+		mRemaining.clear();
+		for (Node* node : renderList)
+		{
+			if (node->GetType() == NT_MESH)
+			{
+				MeshNode* meshNode = static_cast<MeshNode*>(node);
+				auto itGroup = mGroups.find(meshNode->GetMesh().get());
+				if (itGroup != mGroups.end() && itGroup->second.size() >= MinInstances &&
+					mBatches.find(itGroup->first) != mBatches.end() &&
+					eastl::find(itGroup->second.begin(), itGroup->second.end(), meshNode) !=
+					itGroup->second.end())
+				{
+					continue;
+				}
+			}
+			mRemaining.push_back(node);
+		}
+		renderList.swap(mRemaining);
+	}
+
+	// release the batches and the groups of the meshes not drawn lately
+	for (auto itBatch = mBatches.begin(); itBatch != mBatches.end();)
+	{
+		if (mFrame - itBatch->second.mLastFrame > MaxUnusedFrames)
+		{
+			mGroups.erase(itBatch->first);
+			itBatch = mBatches.erase(itBatch);
+		}
+		else ++itBatch;
+	}
+}
+
+bool InstanceBatcher::IsBatchable(MeshNode* node) const
+{
+	if (!node->GetMesh() || node->GetShadowVolumeNode())
+		return false;
+
+	unsigned int numVisuals = node->GetVisualCount();
+	if (numVisuals == 0 || numVisuals != node->GetMaterialCount())
+		return false;
+
+	for (unsigned int i = 0; i < numVisuals; ++i)
+	{
+		if (node->GetMaterial(i)->IsTransparent())
+			return false;
+
+		const eastl::shared_ptr<Visual>& visual = node->GetVisual(i);
+		if (!visual || !eastl::dynamic_pointer_cast<Texture2Effect>(visual->GetEffect()))
+			return false;
+	}
+	return true;
+}
+
+bool InstanceBatcher::HasSameTextures(MeshNode* node, MeshNode* first) const
+{
+	for (unsigned int i = 0; i < node->GetVisualCount(); ++i)
+	{
+		auto effect = eastl::static_pointer_cast<Texture2Effect>(node->GetVisual(i)->GetEffect());
+		auto firstEffect = eastl::static_pointer_cast<Texture2Effect>(first->GetVisual(i)->GetEffect());
+		if (effect->GetTexture() != firstEffect->GetTexture())
+			return false;
+	}
+	return true;
+}
+
+InstanceBatcher::Batch* InstanceBatcher::GetBatch(MeshNode* node)
+{
+	const eastl::shared_ptr<BaseMesh>& mesh = node->GetMesh();
+	auto itBatch = mBatches.find(mesh.get());
+	if (itBatch != mBatches.end())
+	{
+		// a batch whose mesh was released may have left its address to another one
+		if (itBatch->second.mMesh.lock() == mesh &&
+			itBatch->second.mVisuals.size() == node->GetVisualCount())
+		{
+			bool sameTextures = true;
+			for (unsigned int i = 0; i < node->GetVisualCount() && sameTextures; ++i)
+			{
+				auto effect = eastl::static_pointer_cast<Texture2Effect>(node->GetVisual(i)->GetEffect());
+				auto instancedEffect = eastl::static_pointer_cast<Texture2InstancedEffect>(
+					itBatch->second.mVisuals[i]->GetEffect());
+				sameTextures = effect->GetTexture() == instancedEffect->GetTexture();
+			}
+			if (sameTextures)
+			{
+				itBatch->second.mLastFrame = mFrame;
+				return &itBatch->second;
+			}
+		}
+		mBatches.erase(itBatch);
+	}
+
+	Batch batch;
+	batch.mMesh = mesh;
+	batch.mRasterizerState = eastl::make_shared<RasterizerState>();
+	batch.mLastFrame = mFrame;
+	for (unsigned int i = 0; i < node->GetVisualCount(); ++i)
+	{
+		const eastl::shared_ptr<Visual>& visual = node->GetVisual(i);
+		auto effect = eastl::static_pointer_cast<Texture2Effect>(visual->GetEffect());
+
+		eastl::vector<eastl::string> path;
+#if defined(_OPENGL_)
+		path.push_back("Effects/Texture2InstancedEffectVS.glsl");
+		path.push_back("Effects/Texture2EffectPS.glsl");
+#else
+		path.push_back("Effects/Texture2InstancedEffectVS.hlsl");
+		path.push_back("Effects/Texture2EffectPS.hlsl");
+#endif
+		const eastl::shared_ptr<SamplerState>& sampler = effect->GetSampler();
+		eastl::shared_ptr<Texture2InstancedEffect> instancedEffect =
+			eastl::make_shared<Texture2InstancedEffect>(ProgramFactory::Get(), path,
+			effect->GetTexture(), sampler->mFilter, sampler->mMode[0], sampler->mMode[1],
+			MaxInstances);
+		if (!instancedEffect->GetProgram())
+		{
+			LogWarning("Couldn't create the instanced effect, the mesh is drawn per node");
+			return nullptr;
+		}
+
+		batch.mVisuals.push_back(eastl::make_shared<Visual>(
+			visual->GetVertexBuffer(), visual->GetIndexBuffer(), instancedEffect));
+		batch.mBlendStates.push_back(eastl::make_shared<BlendState>());
+		batch.mDepthStencilStates.push_back(eastl::make_shared<DepthStencilState>());
+	}
+
+	return &(mBatches[mesh.get()] = batch);
+}
+
+void InstanceBatcher::Draw(Batch& batch, MeshNode* node, Matrix4x4<float> const& pvMatrix)
+{
+	Renderer* renderer = Renderer::Get();
+	const unsigned int numInstances = (unsigned int)mWorldMatrices.size();
+	for (unsigned int i = 0; i < batch.mVisuals.size(); ++i)
+	{
+		const eastl::shared_ptr<Visual>& visual = batch.mVisuals[i];
+		auto effect = eastl::static_pointer_cast<Texture2InstancedEffect>(visual->GetEffect());
+		effect->SetPVMatrix(pvMatrix);
+		renderer->Update(effect->GetPVWMatrixConstant());
+
+		// the nodes of a mesh share its materials
+		const eastl::shared_ptr<Material>& material = node->GetMaterial(i);
+		if (material->Update(batch.mBlendStates[i]))
+			renderer->Unbind(batch.mBlendStates[i]);
+		if (material->Update(batch.mDepthStencilStates[i]))
+			renderer->Unbind(batch.mDepthStencilStates[i]);
+		if (material->Update(batch.mRasterizerState))
+			renderer->Unbind(batch.mRasterizerState);
+
+		renderer->SetBlendState(batch.mBlendStates[i]);
+		renderer->SetDepthStencilState(batch.mDepthStencilStates[i]);
+		renderer->SetRasterizerState(batch.mRasterizerState);
+
+		for (unsigned int first = 0; first < numInstances; first += effect->GetMaxInstances())
+		{
+			unsigned int count = eastl::min(numInstances - first, effect->GetMaxInstances());
+			renderer->Update(effect->SetWorldMatrices(&mWorldMatrices[first], count));
+			renderer->DrawInstanced(visual, count);
+		}
+
+		renderer->SetDefaultBlendState();
+		renderer->SetDefaultDepthStencilState();
+		renderer->SetDefaultRasterizerState();
+	}
+}
@@ -0,0 +1,68 @@
+//========================================================================
+// InstanceBatcher.h : Draws the mesh nodes of the solid pass which share a
+// mesh with instanced draws.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef INSTANCEBATCHER_H
+#define INSTANCEBATCHER_H
+
+#include "GameEngineStd.h"
+
+#include "Graphic/Scene/Hierarchy/Node.h"
+#include "Graphic/Effect/Texture2InstancedEffect.h"
+
+class Scene;
+class MeshNode;
+class BaseMesh;
+
+// The mesh nodes which share a mesh also share its vertex buffers, index
+// buffers and materials, and differ only by their world matrix. When at
+// least two such nodes are in the render list of the solid pass and every
+// buffer of the mesh is drawn by a Texture2Effect, the batcher draws them
+// together: each buffer of the mesh is drawn once per chunk of instances by
+// a Texture2InstancedEffect, which reads the world matrices from a
+// structured buffer. The batched nodes are removed from the render list and
+// the others keep their order. Nodes with a shadow volume or a transparent
+// material are drawn on their own. The effects and the visuals of a mesh
+// are kept between frames and released once the mesh isn't drawn anymore.
+class InstanceBatcher
+{
+public:
+	InstanceBatcher();
+
+	// Draws the batches found in the render list and removes their nodes
+	// from the list.
+	void Render(Scene* pScene, SceneNodeRenderList& renderList);
+
+	// Releases the batches kept between frames.
+	void Clear();
+
+private:
+	struct Batch
+	{
+		eastl::weak_ptr<BaseMesh> mMesh;
+		eastl::vector<eastl::shared_ptr<Visual>> mVisuals;
+		eastl::vector<eastl::shared_ptr<BlendState>> mBlendStates;
+		eastl::vector<eastl::shared_ptr<DepthStencilState>> mDepthStencilStates;
+		eastl::shared_ptr<RasterizerState> mRasterizerState;
+		unsigned int mLastFrame;
+	};
+
+	bool IsBatchable(MeshNode* node) const;
+	bool HasSameTextures(MeshNode* node, MeshNode* first) const;
+	Batch* GetBatch(MeshNode* node);
+	void Draw(Batch& batch, MeshNode* node, Matrix4x4<float> const& pvMatrix);
+
+	eastl::hash_map<BaseMesh const*, Batch> mBatches;
+	unsigned int mFrame;
+
+	// Buffers reused between frames.
+	eastl::hash_map<BaseMesh const*, eastl::vector<MeshNode*>> mGroups;
+	eastl::vector<Matrix4x4<float>> mWorldMatrices;
+	SceneNodeRenderList mRemaining;
+};
+
+#endif
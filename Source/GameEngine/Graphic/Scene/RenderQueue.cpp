@@ -0,0 +1,148 @@
+//========================================================================
+// RenderQueue.cpp : Orders the render list of a pass by packed sort keys so
+// that the nodes sharing a program and a texture are drawn together.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "RenderQueue.h"
+
+#include "Graphic/Scene/Hierarchy/Visual.h"
+#include "Graphic/Effect/Material.h"
+
+namespace
+{
+	const unsigned int PassShift = 60;
+	const unsigned int IdBits = 16;
+	const unsigned int DepthBits = 28;
+	const uint64_t IdMask = (1ull << IdBits) - 1;
+	const uint64_t DepthMask = (1ull << DepthBits) - 1;
+
+	// Bits of a positive float keep its order, the sign bit is always clear
+	// and the lowest bits are dropped to fit the depth field.
+	inline uint64_t QuantizeDepth(float distance)
+	{
+		uint32_t bits;
+		memcpy(&bits, &distance, sizeof(bits));
+		return (uint64_t)(bits >> (31 - DepthBits)) & DepthMask;
+	}
+}
+
+RenderQueue::RenderQueue()
+{
+}
+
+void RenderQueue::Sort(RenderPass pass, SceneNodeRenderList& renderList,
+	const Vector4<float>& cameraPosition)
+{
+	const unsigned int numNodes = (unsigned int)renderList.size();
+	if (numNodes < 2)
+		return;
+
+	mKeys.resize(numNodes);
+	mIndices.resize(numNodes);
+	for (unsigned int i = 0; i < numNodes; ++i)
+	{
+		mKeys[i] = GetKey(pass, renderList[i], cameraPosition);
+		mIndices[i] = i;
+	}
+
+	RadixSort();
+
+	mNodes.assign(renderList.begin(), renderList.end());
+	for (unsigned int i = 0; i < numNodes; ++i)
+		renderList[i] = mNodes[mIndices[i]];
+}
+
+uint64_t RenderQueue::GetKey(RenderPass pass, Node* node, const Vector4<float>& cameraPosition)
+{
+	const BoundingSphere& bound = node->GetAbsoulteBound();
+	float distance = Length(bound.GetCenter() - cameraPosition);
+
+	uint64_t key = (uint64_t)pass << PassShift;
+	if (pass == RP_LIGHT)
+	{
+		// the lights reaching nearer the camera come first
+		distance = eastl::max(distance - bound.GetRadius(), 0.f);
+		return key | (QuantizeDepth(distance) << (PassShift - DepthBits));
+	}
+
+	uint64_t programId = 0;
+	if (node->GetVisualCount() > 0 && node->GetVisual(0) && node->GetVisual(0)->GetEffect())
+		programId = GetResourceId(node->GetVisual(0)->GetEffect()->GetProgram().get());
+
+	uint64_t textureId = 0;
+	if (node->GetMaterialCount() > 0 && node->GetMaterial(0))
+		textureId = GetResourceId(node->GetMaterial(0)->GetTexture(0).get());
+
+	if (pass == RP_TRANSPARENT || pass == RP_TRANSPARENT_EFFECT)
+	{
+		// blending needs the farthest nodes first
+		uint64_t depth = DepthMask - QuantizeDepth(distance);
+		return key | (depth << (PassShift - DepthBits)) | (programId << IdBits) | textureId;
+	}
+
+	return key | (programId << (DepthBits + IdBits)) | (textureId << DepthBits) | QuantizeDepth(distance);
+}
+
+unsigned int RenderQueue::GetResourceId(const void* resource)
+{
+	if (!resource)
+		return 0;
+
+	auto itResource = mResourceIds.find(resource);
+	if (itResource != mResourceIds.end())
+		return itResource->second;
+
+	// ids are never reused while the table lives, start over once they run out
+	if (mResourceIds.size() >= IdMask)
+		mResourceIds.clear();
+
+	unsigned int id = (unsigned int)mResourceIds.size() + 1;
+	mResourceIds[resource] = id;
+	return id;
+}
+
+//! Sorts the keys and the node indices by bytes, from the least significant
+//! one. A byte which is the same for every key doesn't need a pass, which
+//! skips the pass byte and the unused fields.
+void RenderQueue::RadixSort()
+{
+	const unsigned int numKeys = (unsigned int)mKeys.size();
+	mSortedKeys.resize(numKeys);
+	mSortedIndices.resize(numKeys);
+
+	unsigned int counts[8][256];
+	memset(counts, 0, sizeof(counts));
+	for (unsigned int i = 0; i < numKeys; ++i)
+	{
+		uint64_t key = mKeys[i];
+		for (unsigned int digit = 0; digit < 8; ++digit)
+			counts[digit][(key >> (digit * 8)) & 0xFF]++;
+	}
+
+	for (unsigned int digit = 0; digit < 8; ++digit)
+	{
+		unsigned int* count = counts[digit];
+		if (count[(mKeys[0] >> (digit * 8)) & 0xFF] == numKeys)
+			continue;
+
+		unsigned int offset = 0;
+		for (unsigned int bucket = 0; bucket < 256; ++bucket)
+		{
+			unsigned int bucketCount = count[bucket];
+			count[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		for (unsigned int i = 0; i < numKeys; ++i)
+		{
+			unsigned int position = count[(mKeys[i] >> (digit * 8)) & 0xFF]++;
+			mSortedKeys[position] = mKeys[i];
+			mSortedIndices[position] = mIndices[i];
+		}
+		mKeys.swap(mSortedKeys);
+		mIndices.swap(mSortedIndices);
+	}
+}
@@ -0,0 +1,54 @@
+//========================================================================
+// RenderQueue.h : Orders the render list of a pass by packed sort keys so
+// that the nodes sharing a program and a texture are drawn together.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include "GameEngineStd.h"
+
+#include "Graphic/Scene/Hierarchy/Node.h"
+
+// Each node of a pass gets a 64-bit key and the keys are sorted together
+// with the node indices by a stable LSD radix sort. The key packs, from the
+// most significant bits:
+//   - the render pass (4 bits),
+//   - for the opaque passes, the program id (16 bits), the texture id
+//     (16 bits) and the depth front to back (28 bits),
+//   - for the transparent passes, the depth back to front first and then
+//     the program and texture ids,
+//   - for the lights, only the depth front to back.
+// The depth is the distance from the camera, taken from the bits of the
+// positive float so that no range has to be known. Program and texture ids
+// are handed out the first time a resource is seen and kept between frames,
+// and nodes with equal keys keep their list order, so the draw order is
+// coherent from frame to frame. The buffers are reused between sorts.
+class RenderQueue
+{
+public:
+	RenderQueue();
+
+	// Sorts the render list of the pass in place.
+	void Sort(RenderPass pass, SceneNodeRenderList& renderList,
+		const Vector4<float>& cameraPosition);
+
+private:
+	uint64_t GetKey(RenderPass pass, Node* node, const Vector4<float>& cameraPosition);
+	unsigned int GetResourceId(const void* resource);
+
+	void RadixSort();
+
+	eastl::hash_map<const void*, unsigned int> mResourceIds;
+
+	eastl::vector<uint64_t> mKeys;
+	eastl::vector<uint64_t> mSortedKeys;
+	eastl::vector<unsigned int> mIndices;
+	eastl::vector<unsigned int> mSortedIndices;
+	eastl::vector<Node*> mNodes;
+};
+
+#endif
@@ -43,11 +43,14 @@
 
 #include "Core/Event/EventManager.h"
 #include "Core/Event/Event.h"
+#include "Core/Threading/JobSystem.h"
 
 #include "Application/GameApplication.h"
 
 #include "LightManager.h"
 
+#include "Graphic/Renderer/CommandRecorder.h"
+
 
 ////////////////////////////////////////////////////
 // Scene Implementation
@@ -83,6 +86,7 @@ Scene::~Scene()
 {
 	ClearRenderList();
 	ClearDeletionList();
+	mCommandRecorders.clear();
 
 	//! force to remove hardwareTextures from the driver
 	//! because Scenes may hold internally data bounded to sceneNodes
@@ -111,9 +115,63 @@ bool Scene::OnUpdate(unsigned int timeMs, unsigned long elapsedTime)
 	if (!mRoot)
 		return true;
 
+	InterpolateActorTransforms();
+
 	return mRoot->OnUpdate(this, timeMs, elapsedTime);
 }
 
+//
+// Scene::ActorTransformState::Interpolate
+//
+void Scene::ActorTransformState::Interpolate(float interpolation,
+	Vector3<float>& translation, Quaternion<float>& rotation) const
+{
+	translation = mPreviousTranslation + (mTranslation - mPreviousTranslation) * interpolation;
+	rotation = Slerp(interpolation, mPreviousRotation, mRotation);
+}
+
+//
+// Scene::InterpolateActorTransforms
+//
+void Scene::InterpolateActorTransforms()
+{
+	if (mActorTransformStates.empty())
+		return;
+
+	GameApplication* gameApp = (GameApplication*)Application::App;
+	const unsigned int logicTick = gameApp->GetLogicTick();
+	const float interpolation = gameApp->GetInterpolation();
+
+	auto it = mActorTransformStates.begin();
+	while (it != mActorTransformStates.end())
+	{
+		eastl::shared_ptr<Node> pNode = GetSceneNode(it->first);
+		if (!pNode)
+		{
+			it = mActorTransformStates.erase(it);
+			continue;
+		}
+
+		const ActorTransformState& state = it->second;
+		if (state.mTick == logicTick)
+		{
+			Vector3<float> translation;
+			Quaternion<float> rotation;
+			state.Interpolate(interpolation, translation, rotation);
+			pNode->GetRelativeTransform().SetTranslation(translation);
+			pNode->GetRelativeTransform().SetRotation(rotation);
+			++it;
+		}
+		else
+		{
+			// the actor hasn't moved since, leave it where the logic put it
+			pNode->GetRelativeTransform().SetTranslation(state.mTranslation);
+			pNode->GetRelativeTransform().SetRotation(state.mRotation);
+			it = mActorTransformStates.erase(it);
+		}
+	}
+}
+
 
 //
 // Scene::OnRender					- Chapter 16, page 539
@@ -184,6 +242,42 @@ void Scene::ClearRenderList()
 		mRenderList[pass].clear();
 }
 
+//! Renders the nodes of a render list with the job system.
+bool Scene::RenderInParallel(SceneNodeRenderList& renderList)
+{
+	GameApplication* gameApp = (GameApplication*)Application::App;
+	const unsigned int grainSize = gameApp->mOption.mRenderGrainSize;
+	if (grainSize == 0 || !JobSystem::Exists() || JobSystem::Get()->GetNumWorkers() == 0 ||
+		mLightManager || renderList.size() <= grainSize)
+		return false;
+
+	// the parts only depend on the list and the grain size, so each job
+	// knows its recorder from the first node of its part
+	const unsigned int numNodes = (unsigned int)renderList.size();
+	const unsigned int numParts = (numNodes + grainSize - 1) / grainSize;
+	while (mCommandRecorders.size() < numParts)
+		mCommandRecorders.push_back(eastl::make_unique<CommandRecorder>());
+
+	Renderer* renderer = Renderer::Get();
+	for (unsigned int part = 0; part < numParts; ++part)
+		mCommandRecorders[part]->Reset(renderer);
+
+	JobSystem::Get()->ParallelFor(0, numNodes, grainSize,
+		[this, &renderList, grainSize](unsigned int begin, unsigned int end)
+		{
+			CommandRecorder* recorder = mCommandRecorders[begin / grainSize].get();
+			recorder->Begin();
+			for (unsigned int i = begin; i < end; ++i)
+				renderList[i]->Render(this);
+			recorder->End();
+		});
+
+	for (unsigned int part = 0; part < numParts; ++part)
+		renderer->Submit(mCommandRecorders[part]->GetCommandList());
+
+	return true;
+}
+
 //! Adds a scene node to the deletion queue.
 void Scene::AddToDeletionQueue(Node* node)
 {
@@ -213,6 +307,7 @@ void Scene::RemoveAll()
 {
 	mSceneNodeActors.clear();
 	mPVWUpdater.UnsubscribeAll();
+	mInstanceBatcher.Clear();
 	// Make sure the driver is reset, might need a more complex method at some point
 	/*
 	if (mRenderer)
@@ -524,6 +619,7 @@ bool Scene::RemoveSceneNode(ActorId id)
 	}
 
 	mSceneNodeActors.erase(id);
+	mActorTransformStates.erase(id);
 	return mRoot->DetachChild(node);
 }
 
@@ -551,6 +647,14 @@ bool Scene::IsCulled(Node* node)
 	return !mCuller.IsVisible(node);
 }
 
+bool Scene::IsCulled(BoundingSphere const& sphere)
+{
+	// every sphere is tested against all the planes, the nodes may be
+	// rendered by several threads
+	Culler const& culler = mCuller;
+	return !culler.IsVisible(sphere);
+}
+
 void Scene::NewRenderComponentDelegate(BaseEventDataPtr pEventData)
 {
     eastl::shared_ptr<EventDataNewRenderComponent> pCastEventData = 
@@ -606,6 +710,11 @@ void Scene::SyncActorDelegate(BaseEventDataPtr pEventData)
 	eastl::shared_ptr<Node> pNode = GetSceneNode(actorId);
 	if (pNode)
 	{
+		// where the node was drawn from before this sync
+		const Vector3<float> previousTranslation = pNode->GetRelativeTransform().GetTranslation();
+		const Quaternion<float> previousRotation(
+			Rotation<4, float>(pNode->GetRelativeTransform().GetRotation()));
+
 		eastl::shared_ptr<Actor> pGameActor(GameLogic::Get()->GetActor(actorId).lock());
 		eastl::shared_ptr<TransformComponent> pTransformComponent(
 			pGameActor->GetComponent<TransformComponent>(TransformComponent::Name).lock());
@@ -628,5 +737,30 @@ void Scene::SyncActorDelegate(BaseEventDataPtr pEventData)
 #endif
 			pNode->GetRelativeTransform().SetTranslation(actorTranslation);
 		}
+
+		GameApplication* gameApp = (GameApplication*)Application::App;
+		if (gameApp->GetLogicTimeStep() > 0.f)
+		{
+			const unsigned int logicTick = gameApp->GetLogicTick();
+
+			auto itState = mActorTransformStates.find(actorId);
+			if (itState == mActorTransformStates.end())
+			{
+				ActorTransformState& state = mActorTransformStates[actorId];
+				state.mPreviousTranslation = previousTranslation;
+				state.mPreviousRotation = previousRotation;
+			}
+			else if (itState->second.mTick != logicTick)
+			{
+				// the node may still be drawn in between older ticks
+				itState->second.mPreviousTranslation = itState->second.mTranslation;
+				itState->second.mPreviousRotation = itState->second.mRotation;
+			}
+
+			ActorTransformState& state = mActorTransformStates[actorId];
+			state.mTranslation = pNode->GetRelativeTransform().GetTranslation();
+			state.mRotation = Rotation<4, float>(pNode->GetRelativeTransform().GetRotation());
+			state.mTick = logicTick;
+		}
 	}
 }
@@ -48,6 +48,8 @@
 
 #include "Graphic/Scene/Hierarchy/Node.h"
 #include "Graphic/Scene/Hierarchy/Light.h"
+#include "Graphic/Scene/RenderQueue.h"
+#include "Graphic/Scene/InstanceBatcher.h"
 
 //  An STL map that allows fast lookup of a scene node given an ActorId.
 typedef eastl::map<ActorId, eastl::shared_ptr<Node> > SceneNodeActorMap;
@@ -59,6 +61,7 @@ class BaseAnimatedMesh;
 class RootNode;
 class CameraNode;
 class LightManager;
+class CommandRecorder;
 
 
 // Scene Description. A heirarchical container of scene nodes, which
@@ -400,6 +403,10 @@ public:
 	invisible even if this method returns false.*/
 	bool IsCulled(Node* node);
 
+	//! Check if a bounding sphere in world space is outside the current view frustum.
+	/** Used by the nodes to cull parts of their geometry while they are rendered. */
+	bool IsCulled(BoundingSphere const& sphere);
+
 	//! Get the current active camera.
 	/** \return The active camera is returned. Note that this can
 	be NULL, if there was no camera created yet.
@@ -440,6 +447,8 @@ public:
 
 	SceneNodeRenderList& GetDeletionList() { return mDeletionList; }
 	SceneNodeRenderList& GetRenderList(unsigned int pass) { return mRenderList[pass]; }
+	RenderQueue& GetRenderQueue() { return mRenderQueue; }
+	InstanceBatcher& GetInstanceBatcher() { return mInstanceBatcher; }
 
 	//! Adds a scene node to the render queue.
 	void AddToRenderQueue(RenderPass renderPass, const eastl::shared_ptr<Node>& node);
@@ -447,6 +456,13 @@ public:
 	//! clears the render list
 	void ClearRenderList();
 
+	//! Renders the nodes of a render list with the job system.
+	/** The list is split in parts of RenderGrainSize nodes, which the workers
+	record in command lists at once. The lists are then submitted in order.
+	\return False, having rendered nothing, if the list is too short to be
+	split, or if a light manager has to see each node. */
+	bool RenderInParallel(SceneNodeRenderList& renderList);
+
 	//! Adds a scene node to the deletion queue.
 	void AddToDeletionQueue(Node* node);
 
@@ -465,12 +481,40 @@ protected:
 	SceneNodeActorMap mSceneNodeActors;
 	RenderPass mCurrentRenderPass;
 
+public:
+	// Actor transforms synced by the logic. When the logic runs at a fixed
+	// step the nodes are drawn in between the last two logic ticks, so each
+	// actor moved by the last tick keeps where it came from.
+	struct ActorTransformState
+	{
+		Vector3<float> mPreviousTranslation;
+		Quaternion<float> mPreviousRotation;
+		Vector3<float> mTranslation;
+		Quaternion<float> mRotation;
+		unsigned int mTick;
+
+		// The transform at 'interpolation' in between the two ticks, the
+		// previous one at 0 and the last one at 1.
+		void Interpolate(float interpolation,
+			Vector3<float>& translation, Quaternion<float>& rotation) const;
+	};
+
+protected:
+	eastl::map<ActorId, ActorTransformState> mActorTransformStates;
+
+	void InterpolateActorTransforms();
+
 	eastl::array<float, 4> mShadowColor;
 	eastl::array<float, 4> mAmbientLight;
 
 	//! scene node lists
 	SceneNodeRenderList mDeletionList;
 	SceneNodeRenderList mRenderList[RP_LAST];
+	RenderQueue mRenderQueue;
+	InstanceBatcher mInstanceBatcher;
+
+	//! a recorder per part of the render list rendered in parallel
+	eastl::vector<eastl::unique_ptr<CommandRecorder>> mCommandRecorders;
 
 	void RemoveAll();
 	void Clear();
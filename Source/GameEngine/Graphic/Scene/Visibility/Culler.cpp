@@ -99,6 +99,24 @@ bool Culler::IsVisible(BoundingSphere const& sphere)
     return true;
 }
 
+bool Culler::IsVisible(BoundingSphere const& sphere) const
+{
+    if (sphere.GetRadius() == 0.0f)
+    {
+        return false;
+    }
+
+    for (int index = mPlaneQuantity - 1; index >= 0; --index)
+    {
+        if (sphere.WhichSide(mPlane[index]) < 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool Culler::IsVisible(Spatial* spatial)
 {
 	return eastl::find(mVisibleSet.begin(), mVisibleSet.end(), spatial) != mVisibleSet.end();
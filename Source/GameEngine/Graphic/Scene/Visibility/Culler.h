@@ -84,6 +84,10 @@ protected:
     // Only Spatial calls this function.
     bool IsVisible(BoundingSphere const& sphere);
 
+    // Compare the sphere against all the culling planes without changing
+    // the plane state, so that several threads may test at once.
+    bool IsVisible(BoundingSphere const& sphere) const;
+
     // The base class behavior is to append the visible object to the end of
     // the visible set (stored as an array).  Derived classes may override
     // this behavior; for example, the array might be maintained as a sorted
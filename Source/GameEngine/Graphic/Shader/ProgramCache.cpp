@@ -0,0 +1,311 @@
+//========================================================================
+// ProgramCache.cpp : Keeps the compiled shader programs in a file so that
+// later runs load them instead of compiling their sources again.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "ProgramCache.h"
+
+#include "Core/Logger/Logger.h"
+#include "Core/Threading/JobSystem.h"
+
+#include <fstream>
+
+namespace
+{
+	const unsigned int CacheMagic = 0x43475250; // "PRGC"
+	const unsigned int CacheVersion = 1;
+
+	struct CacheHeader
+	{
+		unsigned int mMagic;
+		unsigned int mVersion;
+		uint64_t mBackendHash;
+	};
+
+	struct RecordHeader
+	{
+		uint64_t mKey;
+		uint64_t mNumBytes;
+	};
+
+	// programs bigger than this are taken for a corrupted record
+	const uint64_t MaxProgramBytes = 64 * 1024 * 1024;
+
+	void WriteRecord(std::ofstream& file, uint64_t key, const ProgramCache::Program& program)
+	{
+		RecordHeader record;
+		record.mKey = key;
+		record.mNumBytes = program.size();
+		file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+		if (!program.empty())
+			file.write(program.data(), program.size());
+	}
+}
+
+ProgramCache* ProgramCache::mProgramCache = nullptr;
+
+uint64_t ProgramCache::HashKey(uint64_t key, const void* data, size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; ++i)
+	{
+		key ^= bytes[i];
+		key *= 1099511628211ULL;
+	}
+	return key;
+}
+
+uint64_t ProgramCache::HashKey(uint64_t key, const eastl::string& value)
+{
+	// the size keeps consecutive strings apart
+	uint64_t size = value.size();
+	key = HashKey(key, &size, sizeof(size));
+	return HashKey(key, value.data(), value.size());
+}
+
+uint64_t ProgramCache::HashKey(uint64_t key, unsigned int value)
+{
+	return HashKey(key, &value, sizeof(value));
+}
+
+uint64_t ProgramCache::HashKey(uint64_t key, const ProgramDefines& defines)
+{
+	auto const& definitions = defines.Get();
+	key = HashKey(key, (unsigned int)definitions.size());
+	for (auto const& definition : definitions)
+	{
+		key = HashKey(key, definition.first);
+		key = HashKey(key, definition.second);
+	}
+	return key;
+}
+
+ProgramCache* ProgramCache::Get()
+{
+	return ProgramCache::mProgramCache;
+}
+
+ProgramCache::ProgramCache(const eastl::string& fileName,
+	const eastl::string& backendVersion, bool setAsGlobal)
+	: mFileName(fileName), mLoadState(LS_UNLOADED), mRewrite(false),
+	mHits(0), mMisses(0), mInvalidations(0)
+{
+	mBackendHash = HashKey(KeyBasis, backendVersion);
+
+	if (setAsGlobal)
+	{
+		if (ProgramCache::mProgramCache)
+		{
+			LogError("Attempting to create two global program caches! \
+					The old one will be destroyed and overwritten with this one.");
+			delete ProgramCache::mProgramCache;
+		}
+
+		ProgramCache::mProgramCache = this;
+	}
+}
+
+ProgramCache::~ProgramCache()
+{
+	// a preload job may still be reading the file
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (mLoadState == LS_LOADING)
+			WaitLoaded(lock);
+	}
+
+	if (ProgramCache::mProgramCache == this)
+		ProgramCache::mProgramCache = nullptr;
+}
+
+void ProgramCache::Preload()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mLoadState != LS_UNLOADED)
+			return;
+		mLoadState = LS_LOADING;
+	}
+
+	if (JobSystem::Exists())
+		JobSystem::Get()->Submit([this]() { Load(); });
+	else
+		Load();
+}
+
+void ProgramCache::Load()
+{
+	// The file is read without holding the lock, nobody touches the
+	// programs until the state is loaded.
+	eastl::map<uint64_t, Program> programs;
+	bool rewrite = false;
+
+	std::ifstream file(mFileName.c_str(), std::ios::in | std::ios::binary);
+	if (file.is_open())
+	{
+		CacheHeader header;
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file.good() || header.mMagic != CacheMagic ||
+			header.mVersion != CacheVersion || header.mBackendHash != mBackendHash)
+		{
+			LogInformation("Outdated program cache " + mFileName);
+			rewrite = true;
+		}
+		else
+		{
+			RecordHeader record;
+			while (file.read(reinterpret_cast<char*>(&record), sizeof(record)))
+			{
+				Program program;
+				if (record.mNumBytes <= MaxProgramBytes)
+				{
+					program.resize((size_t)record.mNumBytes);
+					if (!program.empty())
+						file.read(program.data(), program.size());
+				}
+
+				if (record.mNumBytes > MaxProgramBytes || !file.good())
+				{
+					LogWarning("Corrupted program cache " + mFileName);
+					rewrite = true;
+					break;
+				}
+				programs[record.mKey] = eastl::move(program);
+			}
+
+			// a record cut in the middle of its header
+			if (!rewrite && file.gcount() != 0)
+			{
+				LogWarning("Corrupted program cache " + mFileName);
+				rewrite = true;
+			}
+		}
+	}
+	else
+	{
+		rewrite = true;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mPrograms = eastl::move(programs);
+	mRewrite = rewrite;
+	mLoadState = LS_LOADED;
+	mLoaded.notify_all();
+}
+
+void ProgramCache::WaitLoaded(std::unique_lock<std::mutex>& lock)
+{
+	if (mLoadState == LS_UNLOADED)
+	{
+		mLoadState = LS_LOADING;
+		lock.unlock();
+		Load();
+		lock.lock();
+	}
+
+	while (mLoadState != LS_LOADED)
+		mLoaded.wait(lock);
+}
+
+bool ProgramCache::Find(uint64_t key, Program& program)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	WaitLoaded(lock);
+
+	auto itProgram = mPrograms.find(key);
+	if (itProgram == mPrograms.end())
+	{
+		mMisses++;
+		return false;
+	}
+
+	mHits++;
+	program = itProgram->second;
+	return true;
+}
+
+void ProgramCache::Store(uint64_t key, const char* data, size_t size)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	WaitLoaded(lock);
+
+	if (mPrograms.find(key) != mPrograms.end())
+		return;
+
+	Program& program = mPrograms[key];
+	program.assign(data, data + size);
+
+	if (mRewrite)
+	{
+		Rewrite();
+		return;
+	}
+
+	std::ofstream file(mFileName.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+	if (file.is_open())
+		WriteRecord(file, key, program);
+	if (!file.good())
+		LogWarning("Couldn't write program cache " + mFileName);
+}
+
+void ProgramCache::Remove(uint64_t key)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	WaitLoaded(lock);
+
+	if (mPrograms.erase(key) == 0)
+		return;
+
+	mInvalidations++;
+	mRewrite = true;
+	Rewrite();
+}
+
+bool ProgramCache::Rewrite()
+{
+	std::ofstream file(mFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		LogWarning("Couldn't write program cache " + mFileName);
+		return false;
+	}
+
+	CacheHeader header;
+	header.mMagic = CacheMagic;
+	header.mVersion = CacheVersion;
+	header.mBackendHash = mBackendHash;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	for (auto const& program : mPrograms)
+		WriteRecord(file, program.first, program.second);
+
+	mRewrite = !file.good();
+	if (mRewrite)
+		LogWarning("Couldn't write program cache " + mFileName);
+	return !mRewrite;
+}
+
+ProgramCache::Statistics ProgramCache::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	Statistics statistics;
+	statistics.mHits = mHits;
+	statistics.mMisses = mMisses;
+	statistics.mInvalidations = mInvalidations;
+	statistics.mNumPrograms = (unsigned int)mPrograms.size();
+	return statistics;
+}
+
+void ProgramCache::LogStatistics() const
+{
+	Statistics statistics = GetStatistics();
+	LogInformation("Program cache: " +
+		eastl::to_string(statistics.mHits) + " hits, " +
+		eastl::to_string(statistics.mMisses) + " misses, " +
+		eastl::to_string(statistics.mInvalidations) + " invalidations, " +
+		eastl::to_string(statistics.mNumPrograms) + " programs");
+}
@@ -0,0 +1,105 @@
+//========================================================================
+// ProgramCache.h : Keeps the compiled shader programs in a file so that
+// later runs load them instead of compiling their sources again.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include "Graphic/Shader/ProgramDefines.h"
+
+#include <condition_variable>
+#include <mutex>
+
+// Programs are keyed by a hash of their sources and of everything else the
+// compiled result depends on (version, entry points, flags and defines),
+// which the program factories build with HashKey. The cached data is opaque
+// to the cache: each factory stores what it needs to rebuild a program
+// without compiling it, typically the binary and the reflection data. The
+// file is only valid for the backend it was written with (driver, compiler
+// version), so it starts over when the backend changes. New programs are
+// appended to the file as they are compiled. The file can be read on the
+// job system while the game loads, a lookup waits for it to be read.
+class GRAPHIC_ITEM ProgramCache
+{
+public:
+	typedef eastl::vector<char> Program;
+
+	struct Statistics
+	{
+		unsigned int mHits;
+		unsigned int mMisses;
+		unsigned int mInvalidations;
+		unsigned int mNumPrograms;
+	};
+
+	// Basis of the keys, hashed with the program inputs.
+	static uint64_t const KeyBasis = 14695981039346656037ULL;
+
+	// FNV-1a hash of the inputs a program depends on.
+	static uint64_t HashKey(uint64_t key, const void* data, size_t size);
+	static uint64_t HashKey(uint64_t key, const eastl::string& value);
+	static uint64_t HashKey(uint64_t key, unsigned int value);
+	static uint64_t HashKey(uint64_t key, const ProgramDefines& defines);
+
+	// Construction and destruction. The backend version describes what the
+	// compiled programs depend on beside their inputs. The cache can be set
+	// as global so that it is reachable through ProgramCache::Get.
+	ProgramCache(const eastl::string& fileName,
+		const eastl::string& backendVersion, bool setAsGlobal = true);
+	~ProgramCache();
+
+	// The global cache or nullptr if programs aren't cached. Unlike the
+	// other global getters it doesn't assert, the callers test it to know
+	// whether caching is on.
+	static ProgramCache* Get();
+
+	// Starts reading the file on the job system. Without preloading, the
+	// file is read by the first lookup.
+	void Preload();
+
+	// Copies the program of the key, returns false if it isn't cached.
+	bool Find(uint64_t key, Program& program);
+
+	// Stores the program of the key and appends it to the file.
+	void Store(uint64_t key, const char* data, size_t size);
+
+	// Drops a program the backend refused to load.
+	void Remove(uint64_t key);
+
+	Statistics GetStatistics() const;
+	void LogStatistics() const;
+
+private:
+	enum LoadState
+	{
+		LS_UNLOADED,
+		LS_LOADING,
+		LS_LOADED
+	};
+
+	void Load();
+	void WaitLoaded(std::unique_lock<std::mutex>& lock);
+	bool Rewrite();
+
+	eastl::string mFileName;
+	uint64_t mBackendHash;
+
+	eastl::map<uint64_t, Program> mPrograms;
+	LoadState mLoadState;
+	bool mRewrite; // the file is missing, outdated or corrupted
+
+	unsigned int mHits;
+	unsigned int mMisses;
+	unsigned int mInvalidations;
+
+	mutable std::mutex mMutex;
+	std::condition_variable mLoaded;
+
+	static ProgramCache* mProgramCache;
+};
+
+#endif
@@ -42,6 +42,10 @@ public:
 
     virtual int GetAPI() const = 0;
 
+    // Description of the driver or the compiler the programs are compiled
+    // with.  The programs saved by ProgramCache are only valid for it.
+    virtual eastl::string GetBackendVersion() const = 0;
+
 	// Create a program for GPU display. The filenames are passed as parameters 
 	// in case the shader compiler needs this for #include path searches.
 	eastl::shared_ptr<VisualProgram> CreateFromFiles(
@@ -0,0 +1,354 @@
+//========================================================================
+// BspCollisionCache.cpp : Keeps the collision data converted from a bsp level
+// so that it can be saved to a file and loaded back on later runs.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "BspCollisionCache.h"
+
+#include "Core/Logger/Logger.h"
+
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+#include "LinearMath/btAlignedAllocator.h"
+
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+	const unsigned int CacheMagic = 0x43505342; // "BSPC"
+	const unsigned int CacheVersion = 1;
+
+	struct CacheHeader
+	{
+		unsigned int mMagic;
+		unsigned int mVersion;
+		unsigned int mHash;
+		unsigned int mNumHullVertices;
+		unsigned int mNumConvexHulls;
+		unsigned int mNumConvexInstances;
+		unsigned int mNumMeshVertices;
+		unsigned int mNumTriangleMeshes;
+	};
+
+	// brush vertices closer than this are considered the same when
+	// looking for duplicated brushes
+	const float HullVertexTolerance = 1.f / 64.f;
+
+	// FNV-1a hash
+	unsigned int HashBytes(unsigned int hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	template <typename T>
+	unsigned int HashLump(unsigned int hash, const eastl::vector<T>& lump, int count)
+	{
+		hash = HashBytes(hash, &count, sizeof(count));
+		if (count > 0)
+			hash = HashBytes(hash, lump.data(), count * sizeof(T));
+		return hash;
+	}
+
+	template <typename T>
+	bool ReadArray(std::ifstream& file, eastl::vector<T>& data, unsigned int count)
+	{
+		data.resize(count);
+		if (count > 0)
+			file.read(reinterpret_cast<char*>(data.data()), count * sizeof(T));
+		return file.good();
+	}
+
+	template <typename T>
+	void WriteArray(std::ofstream& file, const eastl::vector<T>& data)
+	{
+		if (!data.empty())
+			file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+	}
+}
+
+BspCollisionCache::BspCollisionCache(int tessellation)
+	: BspConverter(tessellation), mHash(0)
+{
+}
+
+BspCollisionCache::~BspCollisionCache()
+{
+	Clear();
+}
+
+void BspCollisionCache::Clear()
+{
+	for (void* bvh : mMeshBvhs)
+		btAlignedFree(bvh);
+
+	mHullVertices.clear();
+	mConvexHulls.clear();
+	mConvexInstances.clear();
+	mMeshVertices.clear();
+	mTriangleMeshes.clear();
+	mMeshBvhs.clear();
+	mHullLookup.clear();
+}
+
+unsigned int BspCollisionCache::Hash(const BspLoader& bspLoader, int tessellation)
+{
+	// only the lumps which take part in the conversion
+	unsigned int hash = 2166136261u;
+	hash = HashBytes(hash, &CacheVersion, sizeof(CacheVersion));
+	hash = HashBytes(hash, &tessellation, sizeof(tessellation));
+	hash = HashLump(hash, bspLoader.mDShaders, bspLoader.mNumShaders);
+	hash = HashLump(hash, bspLoader.mDPlanes, bspLoader.mNumPlanes);
+	hash = HashLump(hash, bspLoader.mDLeafs, bspLoader.mNumLeafs);
+	hash = HashLump(hash, bspLoader.mDLeafBrushes, bspLoader.mNumLeafBrushes);
+	hash = HashLump(hash, bspLoader.mDBrushes, bspLoader.mNumBrushes);
+	hash = HashLump(hash, bspLoader.mDBrushsides, bspLoader.mNumBrushsides);
+	hash = HashLump(hash, bspLoader.mDrawSurfaces, bspLoader.mNumDrawSurfaces);
+	hash = HashLump(hash, bspLoader.mDrawVertices, bspLoader.mNumDrawVertices);
+	return hash;
+}
+
+void BspCollisionCache::Convert(BspLoader& bspLoader, float scaling)
+{
+	Clear();
+
+	mHash = Hash(bspLoader, mTessellation);
+	ConvertBsp(bspLoader, scaling);
+
+	// the lookup is only needed while converting
+	mHullLookup.clear();
+}
+
+void BspCollisionCache::AddConvexVerticesCollider(btAlignedObjectArray<btVector3>& vertices)
+{
+	if (vertices.size() == 0)
+		return;
+
+	// the hull is stored around its center so that the same brush placed
+	// somewhere else in the level gives the same vertices
+	btVector3 aabbMin = vertices[0], aabbMax = vertices[0];
+	for (int i = 1; i < vertices.size(); ++i)
+	{
+		aabbMin.setMin(vertices[i]);
+		aabbMax.setMax(vertices[i]);
+	}
+	btVector3 center = (aabbMin + aabbMax) * btScalar(0.5);
+
+	unsigned int hash = 2166136261u;
+	for (int i = 0; i < vertices.size(); ++i)
+	{
+		btVector3 vertex = vertices[i] - center;
+		int quantized[3] = {
+			(int)std::floor(vertex.getX() / HullVertexTolerance + 0.5f),
+			(int)std::floor(vertex.getY() / HullVertexTolerance + 0.5f),
+			(int)std::floor(vertex.getZ() / HullVertexTolerance + 0.5f) };
+		hash = HashBytes(hash, quantized, sizeof(quantized));
+	}
+
+	ConvexInstance instance;
+	instance.mOffset[0] = center.getX();
+	instance.mOffset[1] = center.getY();
+	instance.mOffset[2] = center.getZ();
+	instance.mHull = (unsigned int)mConvexHulls.size();
+
+	auto range = mHullLookup.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		const ConvexHull& hull = mConvexHulls[it->second];
+		if (hull.mNumVertices != (unsigned int)vertices.size())
+			continue;
+
+		const float* hullVertices = GetHullVertices(hull);
+		bool sameHull = true;
+		for (int i = 0; i < vertices.size() && sameHull; ++i)
+		{
+			btVector3 vertex = vertices[i] - center;
+			sameHull =
+				std::fabs(hullVertices[i * 3 + 0] - vertex.getX()) < HullVertexTolerance &&
+				std::fabs(hullVertices[i * 3 + 1] - vertex.getY()) < HullVertexTolerance &&
+				std::fabs(hullVertices[i * 3 + 2] - vertex.getZ()) < HullVertexTolerance;
+		}
+
+		if (sameHull)
+		{
+			instance.mHull = it->second;
+			break;
+		}
+	}
+
+	if (instance.mHull == mConvexHulls.size())
+	{
+		ConvexHull hull;
+		hull.mFirstVertex = (unsigned int)mHullVertices.size() / 3;
+		hull.mNumVertices = (unsigned int)vertices.size();
+		for (int i = 0; i < vertices.size(); ++i)
+		{
+			btVector3 vertex = vertices[i] - center;
+			mHullVertices.push_back(vertex.getX());
+			mHullVertices.push_back(vertex.getY());
+			mHullVertices.push_back(vertex.getZ());
+		}
+		mConvexHulls.push_back(hull);
+		mHullLookup.insert(eastl::make_pair(hash, instance.mHull));
+	}
+	mConvexInstances.push_back(instance);
+}
+
+void BspCollisionCache::AddTriangleMeshCollider(btTriangleMesh* triangleMesh)
+{
+	if (triangleMesh->getNumTriangles() > 0)
+	{
+		TriangleMesh mesh;
+		mesh.mFirstVertex = (unsigned int)mMeshVertices.size() / 3;
+		mesh.mNumTriangles = 0;
+
+		// keep the triangles in the mesh order, which the bvh refers to
+		const unsigned char* vertexBase;
+		const unsigned char* indexBase;
+		int numVertices, vertexStride, indexStride, numFaces;
+		PHY_ScalarType vertexType, indexType;
+		triangleMesh->getLockedReadOnlyVertexIndexBase(&vertexBase, numVertices, vertexType,
+			vertexStride, &indexBase, indexStride, numFaces, indexType);
+		LogAssert(vertexType == PHY_FLOAT, "unexpected vertex type");
+
+		for (int face = 0; face < numFaces; ++face)
+		{
+			for (int corner = 0; corner < 3; ++corner)
+			{
+				const unsigned char* index = indexBase + face * indexStride;
+				unsigned int vertexIndex = (indexType == PHY_SHORT) ?
+					((const unsigned short*)index)[corner] : ((const unsigned int*)index)[corner];
+
+				const float* vertex = (const float*)(vertexBase + vertexIndex * vertexStride);
+				mMeshVertices.push_back(vertex[0]);
+				mMeshVertices.push_back(vertex[1]);
+				mMeshVertices.push_back(vertex[2]);
+			}
+			mesh.mNumTriangles++;
+		}
+		triangleMesh->unLockReadOnlyVertexBase(0);
+
+		// build the bvh now so that loading the cache doesn't have to
+		btVector3 aabbMin, aabbMax;
+		triangleMesh->calculateAabbBruteForce(aabbMin, aabbMax);
+		btOptimizedBvh* bvh = new btOptimizedBvh();
+		bvh->build(triangleMesh, true, aabbMin, aabbMax);
+
+		mesh.mBvhSize = bvh->calculateSerializeBufferSize();
+		void* bvhBuffer = btAlignedAlloc(mesh.mBvhSize, 16);
+		bvh->serializeInPlace(bvhBuffer, mesh.mBvhSize, false);
+		delete bvh;
+
+		mTriangleMeshes.push_back(mesh);
+		mMeshBvhs.push_back(bvhBuffer);
+	}
+
+	delete triangleMesh;
+}
+
+bool BspCollisionCache::Load(const eastl::string& fileName, unsigned int hash)
+{
+	std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	uint64_t const fileSize = (uint64_t)file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	CacheHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file.good() || header.mMagic != CacheMagic ||
+		header.mVersion != CacheVersion || header.mHash != hash)
+	{
+		LogInformation("Outdated bsp collision cache " + fileName);
+		return false;
+	}
+
+	// a corrupted header mustn't allocate arrays bigger than the file
+	uint64_t const numArrayBytes =
+		(uint64_t)header.mNumHullVertices * 3 * sizeof(float) +
+		(uint64_t)header.mNumConvexHulls * sizeof(ConvexHull) +
+		(uint64_t)header.mNumConvexInstances * sizeof(ConvexInstance) +
+		(uint64_t)header.mNumMeshVertices * 3 * sizeof(float) +
+		(uint64_t)header.mNumTriangleMeshes * sizeof(TriangleMesh);
+	uint64_t numBytesLeft = fileSize - sizeof(header);
+	if (numArrayBytes > numBytesLeft)
+	{
+		LogWarning("Corrupted bsp collision cache " + fileName);
+		return false;
+	}
+	numBytesLeft -= numArrayBytes;
+
+	Clear();
+	bool loaded =
+		ReadArray(file, mHullVertices, header.mNumHullVertices * 3) &&
+		ReadArray(file, mConvexHulls, header.mNumConvexHulls) &&
+		ReadArray(file, mConvexInstances, header.mNumConvexInstances) &&
+		ReadArray(file, mMeshVertices, header.mNumMeshVertices * 3) &&
+		ReadArray(file, mTriangleMeshes, header.mNumTriangleMeshes);
+
+	for (unsigned int i = 0; loaded && i < mTriangleMeshes.size(); ++i)
+	{
+		if (mTriangleMeshes[i].mBvhSize > numBytesLeft)
+		{
+			loaded = false;
+			break;
+		}
+		numBytesLeft -= mTriangleMeshes[i].mBvhSize;
+
+		void* bvhBuffer = btAlignedAlloc(mTriangleMeshes[i].mBvhSize, 16);
+		mMeshBvhs.push_back(bvhBuffer);
+
+		file.read(reinterpret_cast<char*>(bvhBuffer), mTriangleMeshes[i].mBvhSize);
+		loaded = file.good();
+	}
+
+	if (!loaded)
+	{
+		LogWarning("Corrupted bsp collision cache " + fileName);
+		Clear();
+		return false;
+	}
+
+	mHash = hash;
+	return true;
+}
+
+bool BspCollisionCache::Save(const eastl::string& fileName) const
+{
+	std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		LogWarning("Couldn't write bsp collision cache " + fileName);
+		return false;
+	}
+
+	CacheHeader header;
+	header.mMagic = CacheMagic;
+	header.mVersion = CacheVersion;
+	header.mHash = mHash;
+	header.mNumHullVertices = (unsigned int)mHullVertices.size() / 3;
+	header.mNumConvexHulls = (unsigned int)mConvexHulls.size();
+	header.mNumConvexInstances = (unsigned int)mConvexInstances.size();
+	header.mNumMeshVertices = (unsigned int)mMeshVertices.size() / 3;
+	header.mNumTriangleMeshes = (unsigned int)mTriangleMeshes.size();
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	WriteArray(file, mHullVertices);
+	WriteArray(file, mConvexHulls);
+	WriteArray(file, mConvexInstances);
+	WriteArray(file, mMeshVertices);
+	WriteArray(file, mTriangleMeshes);
+	for (unsigned int i = 0; i < mTriangleMeshes.size(); ++i)
+		file.write(reinterpret_cast<const char*>(mMeshBvhs[i]), mTriangleMeshes[i].mBvhSize);
+
+	return file.good();
+}
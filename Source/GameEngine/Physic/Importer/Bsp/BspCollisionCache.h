@@ -0,0 +1,102 @@
+//========================================================================
+// BspCollisionCache.h : Keeps the collision data converted from a bsp level
+// so that it can be saved to a file and loaded back on later runs.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef BSPCOLLISIONCACHE_H
+#define BSPCOLLISIONCACHE_H
+
+#include "BspConverter.h"
+
+#include "EASTL/map.h"
+#include "EASTL/string.h"
+#include "EASTL/vector.h"
+
+///BspCollisionCache gathers the convex brushes and the tessellated patches of
+///a bsp level instead of turning them straight into bodies. Brushes with the
+///same shape are stored once with their vertices relative to their center and
+///instanced at different offsets, and every patch mesh keeps its serialized
+///bvh. The data only depends on the level and the tessellation, which are
+///hashed to validate a cache file before loading it.
+class BspCollisionCache : public BspConverter
+{
+public:
+
+	struct ConvexHull
+	{
+		unsigned int mFirstVertex;
+		unsigned int mNumVertices;
+	};
+
+	struct ConvexInstance
+	{
+		unsigned int mHull;
+		float mOffset[3];
+	};
+
+	struct TriangleMesh
+	{
+		unsigned int mFirstVertex;
+		unsigned int mNumTriangles;
+		unsigned int mBvhSize;
+	};
+
+	BspCollisionCache(int tessellation = 8);
+	virtual ~BspCollisionCache();
+
+	///hash of the level data the collision is built from
+	static unsigned int Hash(const BspLoader& bspLoader, int tessellation);
+
+	///converts the level, replacing any data the cache already has
+	void Convert(BspLoader& bspLoader, float scaling);
+
+	///the files are only valid for the level and tessellation of the given hash
+	bool Load(const eastl::string& fileName, unsigned int hash);
+	bool Save(const eastl::string& fileName) const;
+
+	unsigned int GetHash() const { return mHash; }
+
+	const eastl::vector<ConvexHull>& GetConvexHulls() const { return mConvexHulls; }
+	const eastl::vector<ConvexInstance>& GetConvexInstances() const { return mConvexInstances; }
+	const eastl::vector<TriangleMesh>& GetTriangleMeshes() const { return mTriangleMeshes; }
+
+	const float* GetHullVertices(const ConvexHull& hull) const
+	{
+		return &mHullVertices[hull.mFirstVertex * 3];
+	}
+
+	const float* GetMeshVertices(const TriangleMesh& mesh) const
+	{
+		return &mMeshVertices[mesh.mFirstVertex * 3];
+	}
+
+	///16 bytes aligned buffer which holds the serialized bvh of the mesh. The
+	///bvh is deserialized in place, so the buffer can only back one shape and
+	///must live as long as it.
+	void* GetMeshBvh(unsigned int mesh) const { return mMeshBvhs[mesh]; }
+
+	virtual void AddConvexVerticesCollider(btAlignedObjectArray<btVector3>& vertices);
+	virtual void AddTriangleMeshCollider(btTriangleMesh* triangleMesh);
+
+private:
+
+	void Clear();
+
+	unsigned int mHash;
+
+	eastl::vector<float> mHullVertices;
+	eastl::vector<ConvexHull> mConvexHulls;
+	eastl::vector<ConvexInstance> mConvexInstances;
+
+	eastl::vector<float> mMeshVertices;
+	eastl::vector<TriangleMesh> mTriangleMeshes;
+	eastl::vector<void*> mMeshBvhs;
+
+	// hulls sorted by the hash of their vertices to find the duplicated brushes
+	eastl::multimap<unsigned int, unsigned int> mHullLookup;
+};
+
+#endif
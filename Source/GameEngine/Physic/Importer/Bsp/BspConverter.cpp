@@ -48,7 +48,6 @@ void BspConverter::CreateCurvedSurfaceBezier(BspLoader& bspLoader, BSPSurface* s
 	SBezier bezier;
 
 	//Loop through the biquadratic patches
-	int tessellation = 8;
 	for (j = 0; j < biquadHeight; ++j)
 	{
 		for (k = 0; k < biquadWidth; ++k)
@@ -67,7 +66,7 @@ void BspConverter::CreateCurvedSurfaceBezier(BspLoader& bspLoader, BSPSurface* s
 			bezier.control[7] = controlPoint[inx + controlWidth * 2 + 1];
 			bezier.control[8] = controlPoint[inx + controlWidth * 2 + 2];
 
-			bezier.tesselate(tessellation);
+			bezier.tesselate(mTessellation);
 		}
 	}
 
@@ -95,29 +94,21 @@ void BspConverter::ConvertBsp(BspLoader& bspLoader, float scaling)
 
 	for (int i = 0; i < bspLoader.mNumDrawSurfaces; i++)
 	{
-		char info[128];
-		sprintf(info, "Reading bspSurface %i from total %i (%f percent)\n",
-			i, bspLoader.mNumDrawSurfaces, (100.f*(float)i / float(bspLoader.mNumDrawSurfaces)));
-		printf(info);
-
 		BSPSurface& surface = bspLoader.mDrawSurfaces[i];
 		if (surface.surfaceType == MST_PATCH)
 		{
 			if (bspLoader.mDShaders[surface.shaderNum].contentFlags & BSPCONTENTS_SOLID)
 			{
-				int tesselation = 8;
 				CreateCurvedSurfaceBezier(bspLoader, &surface);
 			}
 		}
 	}
 
+	// brushes are shared by several leafs, keep track of the converted ones
+	// without touching the loader so that the level can be converted again
+	eastl::vector<bool> convertedBrushes(bspLoader.mNumBrushes, false);
 	for (int i=0;i<bspLoader.mNumLeafs;i++)
 	{
-		char info[128];
-		sprintf(info, "Reading bspLeaf %i from total %i (%f percent)\n",
-			i, bspLoader.mNumLeafs, (100.f*(float)i / float(bspLoader.mNumLeafs)));
-		printf(info);
-			
 		bool isValidBrush = false;
 			
 		BSPLeaf& leaf = bspLoader.mDLeafs[i];
@@ -128,11 +119,11 @@ void BspConverter::ConvertBsp(BspLoader& bspLoader, float scaling)
 			int brushid = bspLoader.mDLeafBrushes[leaf.firstLeafBrush+b];
 
 			BSPBrush& brush = bspLoader.mDBrushes[brushid];
-			if (brush.shaderNum!=-1)
+			if (brush.shaderNum!=-1 && !convertedBrushes[brushid])
 			{
 				if (bspLoader.mDShaders[ brush.shaderNum ].contentFlags & BSPCONTENTS_SOLID)
 				{
-					brush.shaderNum = -1;
+					convertedBrushes[brushid] = true;
 
 					for (int p=0;p<brush.numSides;p++)
 					{
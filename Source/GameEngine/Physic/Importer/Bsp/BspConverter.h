@@ -27,16 +27,27 @@ class BspConverter
 {
 	public:
 
+		BspConverter(int tessellation = 8) : mTessellation(tessellation)
+		{
+		}
+
 		void CreateCurvedSurfaceBezier(BspLoader& bspLoader, BSPSurface* surface);
 		void ConvertBsp(BspLoader& bspLoader,float scaling);
 		virtual ~BspConverter()
 		{
 		}
 
+		///number of subdivisions of each biquadratic patch of the curved surfaces
+		int GetTessellation() const { return mTessellation; }
+		void SetTessellation(int tessellation) { mTessellation = tessellation > 0 ? tessellation : 1; }
+
 		///this callback is called for each brush that succesfully converted into vertices
 		virtual void AddConvexVerticesCollider(btAlignedObjectArray<btVector3>& vertices) = 0;
 		virtual void AddTriangleMeshCollider(btTriangleMesh* triangleMesh) = 0;
 
+	protected:
+
+		int mTessellation;
 };
 
 #endif //BSP_CONVERTER_H
@@ -44,6 +44,7 @@
 
 #include "Importer/Bsp/BspLoader.h"
 #include "Importer/Bsp/BspConverter.h"
+#include "Importer/Bsp/BspCollisionCache.h"
 
 #include "Game/Actor/Actor.h"
 #include "Game/Actor/TransformComponent.h"
@@ -52,6 +53,8 @@
 #include "Core/Event/EventManager.h"
 #include "Core/Event/Event.h"
 
+#include "Core/OS/OS.h"
+
 #include "Application/GameApplication.h"
 
 #include "LinearMath/btGeometryUtil.h"
@@ -60,9 +63,15 @@
 #include "btBulletCollisionCommon.h"
 #include "BulletCollision/Gimpact/btBoxCollision.h"
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletDynamics/Character/btKinematicCharacterController.h"
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
 /////////////////////////////////////////////////////////////////////////////
 //   Materials Description						- Chapter 17, page 579
 //
@@ -263,9 +272,6 @@ struct ActorMotionState : public btMotionState
 	}
 };
 
-// forward declaration
-class BspToBulletConverter;
-
 /////////////////////////////////////////////////////////////////////////////
 // BaseGamePhysic								- Chapter 17, page 590
 //
@@ -275,8 +281,6 @@ class BspToBulletConverter;
 
 class BulletPhysics : public BaseGamePhysic
 {
-	friend class BspToBulletConverter;
-
 	// use auto pointers to automatically call delete on these objects
 	//   during ~BulletPhysics
 	
@@ -289,6 +293,56 @@ class BulletPhysics : public BaseGamePhysic
 	btDefaultCollisionConfiguration*	mCollisionConfiguration;
 	BulletDebugDrawer*					mDebugDrawer;
 
+	// multithreading options, read from the "Physics" element of the game options.
+	//   mThreadedSimulation steps the world on its own fixed timestep thread.
+	bool mThreadedSimulation;
+	float mFixedTimeStep;
+
+	void ReadOptions(tinyxml2::XMLElement *pRoot);
+
+	// options of the bsp conversion, also read from the "Physics" element. The
+	//   collision converted from a level is saved to a cache file named after
+	//   the hash of the level, which later runs load instead of converting it.
+	int mBspTessellation;
+	bool mBspCache;
+	eastl::string mBspCachePath;
+	unsigned int mBspBenchmarkRuns;
+
+	// collision data of the loaded levels. The shapes built from them may be
+	//   shared by several bodies, so they are deleted with the world instead of
+	//   with the bodies.
+	eastl::vector<eastl::shared_ptr<BspCollisionCache>> mBspCollisions;
+	eastl::set<btCollisionShape*> mSharedShapes;
+	eastl::vector<btTriangleMesh*> mSharedMeshes;
+
+	eastl::string GetBspCacheFile(unsigned int hash) const;
+	void AddBspCollision(eastl::shared_ptr<Actor> pGameActor, 
+		const eastl::shared_ptr<BspCollisionCache>& collision, const eastl::string& physicMaterial);
+	void AddStaticBody(const btTransform& transform, 
+		btCollisionShape* shape, const MaterialData& material);
+	void BenchmarkBsp(BspLoader& bspLoader);
+
+	// the physic thread owns the world while stepping. Every access from the
+	//   game thread goes through mWorldMutex, which is cheap when uncontended.
+	std::thread mPhysicThread;
+	std::atomic<bool> mPhysicThreadQuit;
+	std::recursive_mutex mWorldMutex;
+
+	void PhysicThread();
+	void SendEvent(const BaseEventDataPtr& pEvent);
+
+	// double buffered actor transforms. The physic thread fills the back buffer
+	//   after each step and swaps it with the front one, which SyncVisibleScene
+	//   takes on the game thread.
+	typedef eastl::vector<eastl::pair<ActorId, Transform>> ActorTransforms;
+	ActorTransforms mTransformBuffers[2];
+	ActorTransforms mSyncTransforms;
+	unsigned int mFrontTransformBuffer;
+	bool mTransformsUpdated;
+	std::mutex mTransformMutex;
+
+	void SyncActorTransform(ActorId id, const Transform& transform);
+
     // tables read from the XML
     typedef eastl::map<eastl::string, float> DensityTable;
     typedef eastl::map<eastl::string, MaterialData> MaterialTable;
@@ -320,15 +374,38 @@ class BulletPhysics : public BaseGamePhysic
 	//   Collision events sent.  When a new pair of touching bodies are detected,
 	//   they are added to m_previousTickCollisionPairs and an event is sent.
 	//   When the pair is no longer detected, they are removed and another event
-	//   is sent.
-	typedef eastl::pair<btRigidBody const *, btRigidBody const *> CollisionPair;
-	typedef eastl::set<CollisionPair> CollisionPairs;
+	//   is sent. The pairs are kept sorted in flat arrays which are swapped 
+	//   between ticks, so that tracking them doesn't allocate once the arrays
+	//   have grown to the number of contacts in the scene.
+	struct CollisionPair
+	{
+		btRigidBody const * mBodyA;
+		btRigidBody const * mBodyB;
+		btPersistentManifold const * mManifold;
+
+		bool operator<(const CollisionPair& other) const
+		{
+			return mBodyA < other.mBodyA || 
+				(mBodyA == other.mBodyA && mBodyB < other.mBodyB);
+		}
+
+		bool operator==(const CollisionPair& other) const
+		{
+			return mBodyA == other.mBodyA && mBodyB == other.mBodyB;
+		}
+	};
+	typedef eastl::vector<CollisionPair> CollisionPairs;
 	CollisionPairs mPreviousTickCollisionPairs;
+	CollisionPairs mCurrentTickCollisionPairs;
 	
+	// the notifications of a tick are batched and sent as a single event
+	eastl::shared_ptr<EventDataPhysContacts> mContacts;
+
 	// helpers for sending events relating to collision pairs
-	void SendCollisionPairAddEvent( btPersistentManifold const * manifold, 
+	void AddCollisionPairContact( btPersistentManifold const * manifold, 
 		btRigidBody const * body0, btRigidBody const * body1 );
-	void SendCollisionPairRemoveEvent( btRigidBody const * body0, btRigidBody const * body1 );
+	void RemoveCollisionPairContact( btRigidBody const * body0, btRigidBody const * body1 );
+	void SendCollisionPairContacts();
 	
 	// common functionality used by AddSphere, AddBox, etc
 	void AddShape(eastl::shared_ptr<Actor> pGameActor, btCollisionShape* shape, 
@@ -410,122 +487,23 @@ public:
 	virtual Transform GetTransform(const ActorId id);
 };
 
-///BspToBulletConverter  extends the BspConverter to convert to Bullet datastructures
-class BspToBulletConverter : public BspConverter
-{
-public:
-
-	BspToBulletConverter(BulletPhysics*	physics, eastl::shared_ptr<Actor> pGameActor,
-		btScalar mass, const eastl::string& physicMaterial)
-		: mPhysics(physics), mGameActor(pGameActor), mMass(mass), mPhysicMaterial(physicMaterial)
-	{
-		LogAssert(mGameActor, "no actor");
-	}
-
-	virtual void AddConvexVerticesCollider(btAlignedObjectArray<btVector3>& vertices)
-	{
-		///perhaps we can do something special with entities (isEntity)
-		///like adding a collision Triggering (as example)
-		if (vertices.size() > 0)
-		{
-			btCollisionShape* shape = new btConvexHullShape(&(vertices[0].getX()), vertices.size());
-
-			// lookup the material
-			MaterialData material(mPhysics->LookupMaterialData(mPhysicMaterial));
-
-			// localInertia defines how the object's mass is distributed
-			btVector3 localInertia(0.f, 0.f, 0.f);
-			if (mMass > 0.f)
-				shape->calculateLocalInertia(mMass, localInertia);
-
-			Transform transform;
-			eastl::shared_ptr<TransformComponent> pTransformComponent =
-				mGameActor->GetComponent<TransformComponent>(TransformComponent::Name).lock();
-			LogAssert(pTransformComponent, "no transform");
-			if (pTransformComponent)
-			{
-				transform = pTransformComponent->GetTransform();
-			}
-			else
-			{
-				// Physics can't work on an actor that doesn't have a TransformComponent!
-				return;
-			}
-
-			// set the initial transform of the body from the actor
-			ActorMotionState * const motionState = new ActorMotionState(transform);
-
-			btRigidBody::btRigidBodyConstructionInfo rbInfo(mMass, motionState, shape, localInertia);
-
-			// set up the materal properties
-			rbInfo.m_restitution = material.mRestitution;
-			rbInfo.m_friction = material.mFriction;
-
-			btRigidBody* const body = new btRigidBody(rbInfo);
-			mPhysics->mDynamicsWorld->addRigidBody(body);
-		}
-	}
-
-	virtual void AddTriangleMeshCollider(btTriangleMesh* triangleMesh)
-	{
-		///perhaps we can do something special with entities (isEntity)
-		///like adding a collision Triggering (as example)
-		if (triangleMesh->getNumTriangles() > 0)
-		{
-			// Create the shape
-			btCollisionShape *shape = new btBvhTriangleMeshShape(triangleMesh, true);
-
-			// lookup the material
-			MaterialData material(mPhysics->LookupMaterialData(mPhysicMaterial));
-
-			// localInertia defines how the object's mass is distributed
-			btVector3 localInertia(0.f, 0.f, 0.f);
-			if (mMass > 0.f)
-				shape->calculateLocalInertia(mMass, localInertia);
-
-			Transform transform;
-			eastl::shared_ptr<TransformComponent> pTransformComponent =
-				mGameActor->GetComponent<TransformComponent>(TransformComponent::Name).lock();
-			LogAssert(pTransformComponent, "no transform");
-			if (pTransformComponent)
-			{
-				transform = pTransformComponent->GetTransform();
-			}
-			else
-			{
-				// Physics can't work on an actor that doesn't have a TransformComponent!
-				return;
-			}
-
-			// set the initial transform of the body from the actor
-			ActorMotionState * const motionState = new ActorMotionState(transform);
-
-			btRigidBody::btRigidBodyConstructionInfo rbInfo(mMass, motionState, shape, localInertia);
-
-			// set up the materal properties
-			rbInfo.m_restitution = material.mRestitution;
-			rbInfo.m_friction = material.mFriction;
-
-			btRigidBody* const body = new btRigidBody(rbInfo);
-			mPhysics->mDynamicsWorld->addRigidBody(body);
-		}
-	}
-
-protected:
-	BulletPhysics* mPhysics;
-	eastl::shared_ptr<Actor> mGameActor;
-	eastl::string mPhysicMaterial;
-	btScalar mMass;
-};
 
 
 BulletPhysics::BulletPhysics()
+	: mThreadedSimulation(false), mFixedTimeStep(1.f / 60.f),
+	mBspTessellation(8), mBspCache(true), mBspBenchmarkRuns(0),
+	mPhysicThreadQuit(false), mFrontTransformBuffer(0), mTransformsUpdated(false)
 {
 	// [mrmike] This was changed post-press to add event registration!
 	REGISTER_EVENT(EventDataPhysTriggerEnter);
 	REGISTER_EVENT(EventDataPhysTriggerLeave);
 	REGISTER_EVENT(EventDataPhysCollision);
 	REGISTER_EVENT(EventDataPhysSeparation);
+	REGISTER_EVENT(EventDataPhysContacts);
+
+	mContacts.reset(new EventDataPhysContacts());
+	mPreviousTickCollisionPairs.reserve(256);
+	mCurrentTickCollisionPairs.reserve(256);
 }
 
 
@@ -534,6 +512,13 @@ BulletPhysics::BulletPhysics()
 //
 BulletPhysics::~BulletPhysics()
 {
+	// the physic thread must be done with the world before we tear it down
+	if (mPhysicThread.joinable())
+	{
+		mPhysicThreadQuit = true;
+		mPhysicThread.join();
+	}
+
 	// delete any physics objects which are still in the world
 	
 	// iterate backwards because removing the last object doesn't affect the
@@ -547,6 +532,12 @@ BulletPhysics::~BulletPhysics()
 	
 	mCollisionObjectToActorId.clear();
 
+	for (btCollisionShape* shape : mSharedShapes)
+		delete shape;
+	for (btTriangleMesh* triangleMesh : mSharedMeshes)
+		delete triangleMesh;
+	mBspCollisions.clear();
+
 	delete mDebugDrawer;
 	delete mDynamicsWorld;
 	delete mSolver;
@@ -588,6 +579,48 @@ void BulletPhysics::LoadXml()
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// BulletPhysics::ReadOptions					- not described in the book
+//
+//    Reads the multithreading options from the game options
+//
+void BulletPhysics::ReadOptions(tinyxml2::XMLElement *pRoot)
+{
+	tinyxml2::XMLElement *pNode = pRoot ? pRoot->FirstChildElement("Physics") : NULL;
+	if (pNode)
+	{
+		if (pNode->Attribute("ThreadedSimulation"))
+		{
+			eastl::string attribute(pNode->Attribute("ThreadedSimulation"));
+			mThreadedSimulation = (attribute == "true");
+		}
+
+		if (pNode->Attribute("TickRate"))
+		{
+			int tickRate = pNode->IntAttribute("TickRate", 60);
+			if (tickRate > 0) mFixedTimeStep = 1.f / tickRate;
+		}
+
+		if (pNode->Attribute("BspTessellation"))
+		{
+			int tessellation = pNode->IntAttribute("BspTessellation", mBspTessellation);
+			if (tessellation > 0) mBspTessellation = tessellation;
+		}
+
+		if (pNode->Attribute("BspCache"))
+		{
+			eastl::string attribute(pNode->Attribute("BspCache"));
+			mBspCache = (attribute == "true");
+		}
+
+		if (pNode->Attribute("BspCachePath"))
+			mBspCachePath = pNode->Attribute("BspCachePath");
+
+		if (pNode->Attribute("BspBenchmark"))
+			mBspBenchmarkRuns = pNode->UnsignedAttribute("BspBenchmark");
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // BulletPhysics::Initialize					- Chapter 17, page 594
 //
@@ -595,6 +628,9 @@ bool BulletPhysics::Initialize()
 {
 	LoadXml();
 
+	GameApplication* gameApp = (GameApplication*)Application::App;
+	ReadOptions(gameApp->mOption.mRoot);
+
 	// this controls how Bullet does internal memory management during the collision pass
 	mCollisionConfiguration = new btDefaultCollisionConfiguration();
 
@@ -616,7 +652,6 @@ bool BulletPhysics::Initialize()
 	mDynamicsWorld->setGravity(btVector3(0, 0, -300.f));
 
 	mDebugDrawer = new BulletDebugDrawer();
-	GameApplication* gameApp = (GameApplication*)Application::App;
 	mDebugDrawer->ReadOptions(gameApp->mOption.mRoot);
 
 	if(!mCollisionConfiguration || !mDispatcher || !mBroadphase ||
@@ -640,10 +675,88 @@ bool BulletPhysics::Initialize()
 //
 void BulletPhysics::OnUpdate( float const deltaSeconds )
 {
+	if (mThreadedSimulation)
+	{
+		// the simulation runs on its own thread at a fixed rate. It is started 
+		// on the first update so the level is fully loaded by then.
+		if (!mPhysicThread.joinable())
+			mPhysicThread = std::thread(&BulletPhysics::PhysicThread, this);
+		return;
+	}
+
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	// Bullet uses an internal fixed timestep (default 1/60th of a second)
 	// Bullet will run the simulation in increments of the fixed timestep 
 	// until "deltaSeconds" amount of time has passed (maximum of 10 steps).
-	mDynamicsWorld->stepSimulation(deltaSeconds, 10 );
+	mDynamicsWorld->stepSimulation(deltaSeconds, 10, mFixedTimeStep);
+}
+
+// set on the thread which steps the simulation when it runs on its own
+static thread_local bool PhysicThreadRunning = false;
+
+/////////////////////////////////////////////////////////////////////////////
+// BulletPhysics::PhysicThread					- not described in the book
+//
+//    Steps the simulation at a fixed rate, independently of the frame rate.
+//    After each step the actor transforms are copied into the back buffer,
+//    which is then swapped with the front buffer read by SyncVisibleScene.
+//
+void BulletPhysics::PhysicThread()
+{
+	PhysicThreadRunning = true;
+
+	typedef std::chrono::steady_clock Clock;
+	Clock::duration const timeStep = std::chrono::duration_cast<Clock::duration>(
+		std::chrono::duration<float>(mFixedTimeStep));
+	Clock::time_point nextTick = Clock::now() + timeStep;
+
+	while (!mPhysicThreadQuit)
+	{
+		ActorTransforms& backBuffer = mTransformBuffers[1 - mFrontTransformBuffer];
+		{
+			std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
+			// exactly one fixed step per tick keeps the simulation deterministic
+			mDynamicsWorld->stepSimulation(mFixedTimeStep, 0);
+
+			backBuffer.clear();
+			for (auto const& actorCollisionObject : mActorIdToCollisionObject)
+			{
+				backBuffer.push_back(eastl::make_pair(actorCollisionObject.first,
+					btTransformToTransform(actorCollisionObject.second->getWorldTransform())));
+			}
+		}
+
+		mTransformMutex.lock();
+		{
+			mFrontTransformBuffer = 1 - mFrontTransformBuffer;
+			mTransformsUpdated = true;
+		}
+		mTransformMutex.unlock();
+
+		// if we fell behind more than a few ticks don't try to catch up, 
+		// otherwise a long stall would be followed by a burst of steps
+		Clock::time_point now = Clock::now();
+		if (now > nextTick + 4 * timeStep)
+			nextTick = now;
+		std::this_thread::sleep_until(nextTick);
+		nextTick += timeStep;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// BulletPhysics::SendEvent						- not described in the book
+//
+//    Events raised while the physic thread is stepping the world are queued 
+//    so that the listeners run on the game thread.
+//
+void BulletPhysics::SendEvent(const BaseEventDataPtr& pEvent)
+{
+	if (PhysicThreadRunning)
+		BaseEventManager::Get()->ThreadSafeQueueEvent(pEvent);
+	else
+		BaseEventManager::Get()->TriggerEvent(pEvent);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -653,6 +766,28 @@ void BulletPhysics::SyncVisibleScene()
 {
 	// Keep physics & graphics in sync
 
+	if (mThreadedSimulation)
+	{
+		// take the transforms from the last step finished by the physic thread
+		mTransformMutex.lock();
+		{
+			if (mTransformsUpdated)
+			{
+				mSyncTransforms.swap(mTransformBuffers[mFrontTransformBuffer]);
+				mTransformsUpdated = false;
+			}
+			else
+			{
+				mSyncTransforms.clear();
+			}
+		}
+		mTransformMutex.unlock();
+
+		for (auto const& actorTransform : mSyncTransforms)
+			SyncActorTransform(actorTransform.first, actorTransform.second);
+		return;
+	}
+
 	// check all the existing actor's collision object for changes. 
 	//  If there is a change, send the appropriate event for the game system.
 	for (	ActorIDToBulletCollisionObjectMap::const_iterator it = mActorIdToCollisionObject.begin();
@@ -660,32 +795,39 @@ void BulletPhysics::SyncVisibleScene()
 	{ 
 		ActorId const id = it->first;
 		btCollisionObject* actorCollisionObject = it->second;
-		
-		eastl::shared_ptr<Actor> pGameActor(GameLogic::Get()->GetActor(id).lock());
-		if (pGameActor)
+
+		SyncActorTransform(id, btTransformToTransform(actorCollisionObject->getWorldTransform()));
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// BulletPhysics::SyncActorTransform			- not described in the book
+//
+//    Sends a sync event if the actor transform differs from the physics one
+//
+void BulletPhysics::SyncActorTransform(ActorId id, const Transform& actorTransform)
+{
+	eastl::shared_ptr<Actor> pGameActor(GameLogic::Get()->GetActor(id).lock());
+	if (pGameActor)
+	{
+		eastl::shared_ptr<TransformComponent> pTransformComponent(
+			pGameActor->GetComponent<TransformComponent>(TransformComponent::Name).lock());
+		if (pTransformComponent)
 		{
-            eastl::shared_ptr<TransformComponent> pTransformComponent(
-				pGameActor->GetComponent<TransformComponent>(TransformComponent::Name).lock());
-            if (pTransformComponent)
-            {
-				Transform actorTransform = 
-					btTransformToTransform(actorCollisionObject->getWorldTransform());
-
-			    if (pTransformComponent->GetTransform().GetMatrix() != actorTransform.GetMatrix() ||
-					pTransformComponent->GetTransform().GetTranslation() != actorTransform.GetTranslation())
-                {
-                    // Bullet has moved the actor's physics object. Sync and inform
-					// about game actor transform 
-					//pTransformComponent->SetTransform(actorTransform);
+			if (pTransformComponent->GetTransform().GetMatrix() != actorTransform.GetMatrix() ||
+				pTransformComponent->GetTransform().GetTranslation() != actorTransform.GetTranslation())
+			{
+				// Bullet has moved the actor's physics object. Sync and inform
+				// about game actor transform 
+				//pTransformComponent->SetTransform(actorTransform);
 /*
-					LogInformation("x = " + eastl::to_string(actorTransform.GetTranslation()[0]) +
-									" y = " + eastl::to_string(actorTransform.GetTranslation()[1]) +
-									" z = " + eastl::to_string(actorTransform.GetTranslation()[2]));
+				LogInformation("x = " + eastl::to_string(actorTransform.GetTranslation()[0]) +
+								" y = " + eastl::to_string(actorTransform.GetTranslation()[1]) +
+								" z = " + eastl::to_string(actorTransform.GetTranslation()[2]));
 */
-                    eastl::shared_ptr<EventDataSyncActor> pEvent(new EventDataSyncActor(id, actorTransform));
-                    BaseEventManager::Get()->TriggerEvent(pEvent);
-			    }
-            }
+				eastl::shared_ptr<EventDataSyncActor> pEvent(new EventDataSyncActor(id, actorTransform));
+				BaseEventManager::Get()->TriggerEvent(pEvent);
+			}
 		}
 	}
 }
@@ -753,27 +895,25 @@ void BulletPhysics::RemoveCollisionObject( btCollisionObject * const removeMe )
 	mDynamicsWorld->removeCollisionObject( removeMe );
 	
 	// then remove the pointer from the ongoing contacts list
+	CollisionPairs::iterator last = mPreviousTickCollisionPairs.begin();
 	for ( CollisionPairs::iterator it = mPreviousTickCollisionPairs.begin();
-	      it != mPreviousTickCollisionPairs.end(); )
+	      it != mPreviousTickCollisionPairs.end(); ++it )
     {
-		CollisionPairs::iterator next = it;
-		++next;
-		
-		if ( it->first == removeMe || it->second == removeMe )
-		{
-			SendCollisionPairRemoveEvent( it->first, it->second );
-			mPreviousTickCollisionPairs.erase( it );
-		}
-		
-		it = next;
+		if ( it->mBodyA == removeMe || it->mBodyB == removeMe )
+			RemoveCollisionPairContact( it->mBodyA, it->mBodyB );
+		else
+			*last++ = *it;
     }
+	mPreviousTickCollisionPairs.erase( last, mPreviousTickCollisionPairs.end() );
+	SendCollisionPairContacts();
 	
 	// if the object is a RigidBody (all of ours are RigidBodies, but it's good to be safe)
 	if ( btRigidBody * const body = btRigidBody::upcast(removeMe) )
 	{
 		// delete the components of the object
 		delete body->getMotionState();
-		delete body->getCollisionShape();
+		if (mSharedShapes.find(body->getCollisionShape()) == mSharedShapes.end())
+			delete body->getCollisionShape();
 		delete body->getUserPointer();
 		delete body->getUserPointer();
 		
@@ -834,6 +974,8 @@ ActorId BulletPhysics::FindActorID( btCollisionObject const * const collisionObj
 void BulletPhysics::AddTrigger(const Vector3<float> &dimension, 
 	eastl::weak_ptr<Actor> pGameActor, const eastl::string& physicMaterial)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	eastl::shared_ptr<Actor> pStrongActor(pGameActor.lock());
 	if (!pStrongActor)
 		return;  // FUTURE WORK: Add a call to the error log here
@@ -887,16 +1029,187 @@ void BulletPhysics::AddTrigger(const Vector3<float> &dimension,
 void BulletPhysics::AddBSP(BspLoader& bspLoader, eastl::weak_ptr<Actor> pGameActor,
 	const eastl::string& densityStr, const eastl::string& physicMaterial)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	eastl::shared_ptr<Actor> pStrongActor(pGameActor.lock());
 	if (!pStrongActor)
 		return;  // FUTURE WORK - Add a call to the error log here
 
-	// triggers are immoveable.  0 mass signals this to Bullet.
+	if (mBspBenchmarkRuns > 0)
+		BenchmarkBsp(bspLoader);
+
+	unsigned int const startTime = Timer::GetRealTime();
+
+	eastl::shared_ptr<BspCollisionCache> collision(new BspCollisionCache(mBspTessellation));
+	unsigned int const hash = BspCollisionCache::Hash(bspLoader, mBspTessellation);
+	eastl::string const cacheFile = GetBspCacheFile(hash);
+
+	bool const cached = mBspCache && collision->Load(cacheFile, hash);
+	if (cached)
+	{
+		// the conversion parses the entities, so it still has to be done here
+		bspLoader.ParseEntities();
+	}
+	else
+	{
+		float bspScaling = 1.0f;
+		collision->Convert(bspLoader, bspScaling);
+
+		// the shapes deserialize the bvh buffers in place, save them before
+		if (mBspCache)
+			collision->Save(cacheFile);
+	}
+	AddBspCollision(pStrongActor, collision, physicMaterial);
+
+	LogInformation(eastl::string(cached ? "Loaded" : "Converted") + " bsp collision in " + 
+		eastl::to_string(Timer::GetRealTime() - startTime) + " ms (" + 
+		eastl::to_string(collision->GetConvexInstances().size()) + " brushes, " + 
+		eastl::to_string(collision->GetConvexHulls().size()) + " unique, " + 
+		eastl::to_string(collision->GetTriangleMeshes().size()) + " patches)");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// BulletPhysics::GetBspCacheFile				- not described in the book
+//
+eastl::string BulletPhysics::GetBspCacheFile(unsigned int hash) const
+{
+	return mBspCachePath + "bsp_" + eastl::to_string(hash) + ".collision";
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// BulletPhysics::AddBspCollision				- not described in the book
+//
+//    Creates the static bodies of a level from its converted collision. The
+//    brushes which have the same shape share a single convex hull shape and
+//    the patches get their bvh from the collision data instead of building it.
+//
+void BulletPhysics::AddBspCollision(eastl::shared_ptr<Actor> pGameActor,
+	const eastl::shared_ptr<BspCollisionCache>& collision, const eastl::string& physicMaterial)
+{
+	Transform transform;
+	eastl::shared_ptr<TransformComponent> pTransformComponent =
+		pGameActor->GetComponent<TransformComponent>(TransformComponent::Name).lock();
+	LogAssert(pTransformComponent, "no transform");
+	if (pTransformComponent)
+	{
+		transform = pTransformComponent->GetTransform();
+	}
+	else
+	{
+		// Physics can't work on an actor that doesn't have a TransformComponent!
+		return;
+	}
+	btTransform const bodyTransform = TransformTobtTransform(transform);
+
+	// lookup the material
+	MaterialData material(LookupMaterialData(physicMaterial));
+
+	const eastl::vector<BspCollisionCache::ConvexHull>& hulls = collision->GetConvexHulls();
+	eastl::vector<btCollisionShape*> hullShapes(hulls.size());
+	for (unsigned int i = 0; i < hulls.size(); ++i)
+	{
+		hullShapes[i] = new btConvexHullShape(
+			collision->GetHullVertices(hulls[i]), hulls[i].mNumVertices, 3 * sizeof(float));
+		mSharedShapes.insert(hullShapes[i]);
+	}
+
+	for (const BspCollisionCache::ConvexInstance& instance : collision->GetConvexInstances())
+	{
+		btTransform offset(btMatrix3x3::getIdentity(), 
+			btVector3(instance.mOffset[0], instance.mOffset[1], instance.mOffset[2]));
+		AddStaticBody(bodyTransform * offset, hullShapes[instance.mHull], material);
+	}
+
+	const eastl::vector<BspCollisionCache::TriangleMesh>& meshes = collision->GetTriangleMeshes();
+	for (unsigned int i = 0; i < meshes.size(); ++i)
+	{
+		// add the triangles in the same order than when the bvh was built
+		btTriangleMesh* triangleMesh = new btTriangleMesh();
+		triangleMesh->preallocateVertices(meshes[i].mNumTriangles * 3);
+		const float* vertices = collision->GetMeshVertices(meshes[i]);
+		for (unsigned int triangle = 0; triangle < meshes[i].mNumTriangles; ++triangle, vertices += 9)
+		{
+			triangleMesh->addTriangle(
+				btVector3(vertices[0], vertices[1], vertices[2]),
+				btVector3(vertices[3], vertices[4], vertices[5]),
+				btVector3(vertices[6], vertices[7], vertices[8]));
+		}
+		mSharedMeshes.push_back(triangleMesh);
+
+		btBvhTriangleMeshShape* shape = new btBvhTriangleMeshShape(triangleMesh, true, false);
+		shape->setOptimizedBvh(btOptimizedBvh::deSerializeInPlace(
+			collision->GetMeshBvh(i), meshes[i].mBvhSize, false));
+		mSharedShapes.insert(shape);
+
+		AddStaticBody(bodyTransform, shape, material);
+	}
+
+	// the bvhs live in the collision buffers
+	mBspCollisions.push_back(collision);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// BulletPhysics::AddStaticBody				- not described in the book
+//
+void BulletPhysics::AddStaticBody(const btTransform& transform, 
+	btCollisionShape* shape, const MaterialData& material)
+{
+	// static bodies are immoveable.  0 mass signals this to Bullet.
 	btScalar const mass = 0;
+	btVector3 localInertia(0.f, 0.f, 0.f);
 
-	BspToBulletConverter bspToBullet(this, pStrongActor, mass, physicMaterial);
-	float bspScaling = 1.0f;
-	bspToBullet.ConvertBsp(bspLoader, bspScaling);
+	// set the initial transform of the body
+	ActorMotionState * const motionState = new ActorMotionState(btTransformToTransform(transform));
+
+	btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState, shape, localInertia);
+
+	// set up the materal properties
+	rbInfo.m_restitution = material.mRestitution;
+	rbInfo.m_friction = material.mFriction;
+
+	btRigidBody* const body = new btRigidBody(rbInfo);
+	mDynamicsWorld->addRigidBody(body);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// BulletPhysics::BenchmarkBsp					- not described in the book
+//
+//    Measures the cold (converting the level) and warm (loading the cache
+//    file) times of the bsp collision. It runs when the "BspBenchmark" 
+//    option sets a number of runs.
+//
+void BulletPhysics::BenchmarkBsp(BspLoader& bspLoader)
+{
+	unsigned int const hash = BspCollisionCache::Hash(bspLoader, mBspTessellation);
+	eastl::string const cacheFile = GetBspCacheFile(hash) + ".benchmark";
+
+	unsigned int coldTime = 0, warmTime = 0;
+	for (unsigned int run = 0; run < mBspBenchmarkRuns; ++run)
+	{
+		unsigned int startTime = Timer::GetRealTime();
+		{
+			BspCollisionCache collision(mBspTessellation);
+			collision.Convert(bspLoader, 1.f);
+			collision.Save(cacheFile);
+		}
+		coldTime += Timer::GetRealTime() - startTime;
+
+		startTime = Timer::GetRealTime();
+		{
+			BspCollisionCache collision(mBspTessellation);
+			if (!collision.Load(cacheFile, hash))
+			{
+				LogWarning("Bsp collision benchmark couldn't load " + cacheFile);
+				return;
+			}
+		}
+		warmTime += Timer::GetRealTime() - startTime;
+	}
+	remove(cacheFile.c_str());
+
+	LogInformation("Bsp collision benchmark over " + eastl::to_string(mBspBenchmarkRuns) + 
+		" runs: cold " + eastl::to_string(coldTime / (float)mBspBenchmarkRuns) + 
+		" ms, warm " + eastl::to_string(warmTime / (float)mBspBenchmarkRuns) + " ms");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -906,6 +1219,8 @@ void BulletPhysics::AddCharacterController(
 	const Vector3<float>& dimensions, eastl::weak_ptr<Actor> pGameActor,
 	const eastl::string& densityStr, const eastl::string& physicMaterial)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	eastl::shared_ptr<Actor> pStrongActor(pGameActor.lock());
 	if (!pStrongActor)
 		return;  // FUTURE WORK - Add a call to the error log here
@@ -970,6 +1285,8 @@ void BulletPhysics::AddCharacterController(
 void BulletPhysics::AddSphere(float const radius, eastl::weak_ptr<Actor> pGameActor, 
 	const eastl::string& densityStr, const eastl::string& physicMaterial)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	eastl::shared_ptr<Actor> pStrongActor(pGameActor.lock());
     if (!pStrongActor)
         return;  // FUTURE WORK - Add a call to the error log here
@@ -991,6 +1308,8 @@ void BulletPhysics::AddSphere(float const radius, eastl::weak_ptr<Actor> pGameAc
 void BulletPhysics::AddBox(const Vector3<float>& dimensions, eastl::weak_ptr<Actor> pGameActor,
 	const eastl::string& densityStr, const eastl::string& physicMaterial)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	eastl::shared_ptr<Actor> pStrongActor(pGameActor.lock());
     if (!pStrongActor)
         return;  // FUTURE WORK: Add a call to the error log here
@@ -1012,6 +1331,8 @@ void BulletPhysics::AddBox(const Vector3<float>& dimensions, eastl::weak_ptr<Act
 void BulletPhysics::AddPointCloud(Vector3<float> *verts, int numPoints, eastl::weak_ptr<Actor> pGameActor,
 	const eastl::string& densityStr, const eastl::string& physicMaterial)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	eastl::shared_ptr<Actor> pStrongActor(pGameActor.lock());
     if (!pStrongActor)
         return;  // FUTURE WORK: Add a call to the error log here
@@ -1041,6 +1362,8 @@ void BulletPhysics::AddPointCloud(Vector3<float> *verts, int numPoints, eastl::w
 void BulletPhysics::AddPointCloud(Plane3<float> *planes, int numPlanes, eastl::weak_ptr<Actor> pGameActor,
 	const eastl::string& densityStr, const eastl::string& physicMaterial)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	eastl::shared_ptr<Actor> pStrongActor(pGameActor.lock());
 	if (!pStrongActor)
 		return;  // FUTURE WORK: Add a call to the error log here
@@ -1084,6 +1407,8 @@ void BulletPhysics::AddPointCloud(Plane3<float> *planes, int numPlanes, eastl::w
 //
 void BulletPhysics::RemoveActor(ActorId id)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if ( btCollisionObject * const collisionObject = FindBulletCollisionObject( id ) )
 	{
 		// destroy the body and all its components
@@ -1098,6 +1423,8 @@ void BulletPhysics::RemoveActor(ActorId id)
 //
 void BulletPhysics::RenderDiagnostics()
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	mDynamicsWorld->debugDrawWorld();
 
 	mDebugDrawer->Render();
@@ -1109,6 +1436,8 @@ void BulletPhysics::RenderDiagnostics()
 //
 void BulletPhysics::ApplyForce(ActorId aid, const Vector3<float> &velocity)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(aid))
 	{
 		if (collisionObject->getCollisionFlags() & btCollisionObject::CF_CHARACTER_OBJECT)
@@ -1132,6 +1461,8 @@ void BulletPhysics::ApplyForce(ActorId aid, const Vector3<float> &velocity)
 //
 void BulletPhysics::ApplyTorque(ActorId aid, const Vector3<float> &velocity)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btRigidBody* const rigidBody = dynamic_cast<btRigidBody*>(FindBulletCollisionObject(aid)))
 		rigidBody->applyTorqueImpulse( Vector3TobtVector3(velocity) );
 }
@@ -1143,6 +1474,8 @@ void BulletPhysics::ApplyTorque(ActorId aid, const Vector3<float> &velocity)
 //
 Transform BulletPhysics::GetTransform(const ActorId id)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	btCollisionObject * pCollisionObject = FindBulletCollisionObject(id);
     LogAssert(pCollisionObject, "no collision object");
 
@@ -1157,6 +1490,8 @@ Transform BulletPhysics::GetTransform(const ActorId id)
 //
 void BulletPhysics::SetTransform(ActorId actorId, const Transform& mat)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		// warp the body to the new position
@@ -1177,6 +1512,8 @@ void BulletPhysics::StopActor(ActorId actorId)
 //
 void BulletPhysics::SetIgnoreCollision(ActorId actorId, ActorId ignoreActorId, bool ignoreCollision) 
 { 
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		if (btCollisionObject * const ignoreCollisionObject = FindBulletCollisionObject(ignoreActorId))
@@ -1190,6 +1527,8 @@ void BulletPhysics::SetIgnoreCollision(ActorId actorId, ActorId ignoreActorId, b
 // BulletPhysics::FindIntersection		
 bool BulletPhysics::FindIntersection(ActorId actorId, const Vector3<float>& point)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		if (collisionObject->getCollisionFlags() & btCollisionObject::CF_CHARACTER_OBJECT)
@@ -1235,6 +1574,8 @@ ActorId BulletPhysics::CastRay(
 	const Vector3<float>& origin, const Vector3<float>& end, 
 	Vector3<float>& collisionPoint, Vector3<float>& collisionNormal)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	btVector3 from = Vector3TobtVector3(origin);
 	btVector3 to = Vector3TobtVector3(end);
 	btCollisionWorld::ClosestRayResultCallback closestResults(from, to);
@@ -1264,6 +1605,8 @@ void BulletPhysics::CastRay(
 	eastl::vector<Vector3<float>>& collisionPoints, 
 	eastl::vector<Vector3<float>>& collisionNormals)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	btVector3 from = Vector3TobtVector3(origin);
 	btVector3 to = Vector3TobtVector3(end);
 	btCollisionWorld::AllHitsRayResultCallback allHitsResults(from, to);
@@ -1289,6 +1632,8 @@ ActorId BulletPhysics::ConvexSweep(
 	ActorId aId, const Transform& origin, const Transform& end,
 	Vector3<float>& collisionPoint, Vector3<float>& collisionNormal)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(aId))
 	{
 		if (collisionObject->getCollisionFlags() & btCollisionObject::CF_CHARACTER_OBJECT)
@@ -1340,6 +1685,8 @@ ActorId BulletPhysics::ConvexSweep(
 //
 Vector3<float> BulletPhysics::GetCenter(ActorId actorId)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		if (collisionObject->getCollisionFlags() & btCollisionObject::CF_CHARACTER_OBJECT)
@@ -1373,6 +1720,8 @@ Vector3<float> BulletPhysics::GetCenter(ActorId actorId)
 //
 Vector3<float> BulletPhysics::GetScale(ActorId actorId)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		if (collisionObject->getCollisionFlags() & btCollisionObject::CF_CHARACTER_OBJECT)
@@ -1406,6 +1755,8 @@ Vector3<float> BulletPhysics::GetScale(ActorId actorId)
 //
 Vector3<float> BulletPhysics::GetVelocity(ActorId actorId)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		if (collisionObject->getCollisionFlags() & btCollisionObject::CF_CHARACTER_OBJECT)
@@ -1430,6 +1781,8 @@ Vector3<float> BulletPhysics::GetVelocity(ActorId actorId)
 /////////////////////////////////////////////////////////////////////////////
 float BulletPhysics::GetJumpSpeed(ActorId actorId)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	float jumpSpeed = 0;
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
@@ -1448,6 +1801,8 @@ float BulletPhysics::GetJumpSpeed(ActorId actorId)
 /////////////////////////////////////////////////////////////////////////////
 void BulletPhysics::SetGravity(ActorId actorId, const Vector3<float>& g)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		if (collisionObject->getCollisionFlags() & btCollisionObject::CF_CHARACTER_OBJECT)
@@ -1471,6 +1826,8 @@ void BulletPhysics::SetGravity(ActorId actorId, const Vector3<float>& g)
 /////////////////////////////////////////////////////////////////////////////
 void BulletPhysics::SetVelocity(ActorId actorId, const Vector3<float>& vel)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		if (collisionObject->getCollisionFlags() & btCollisionObject::CF_CHARACTER_OBJECT)
@@ -1494,6 +1851,8 @@ void BulletPhysics::SetVelocity(ActorId actorId, const Vector3<float>& vel)
 /////////////////////////////////////////////////////////////////////////////
 Vector3<float> BulletPhysics::GetAngularVelocity(ActorId actorId)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		if (collisionObject->getCollisionFlags() & btCollisionObject::CF_CHARACTER_OBJECT)
@@ -1518,6 +1877,8 @@ Vector3<float> BulletPhysics::GetAngularVelocity(ActorId actorId)
 /////////////////////////////////////////////////////////////////////////////
 void BulletPhysics::SetAngularVelocity(ActorId actorId, const Vector3<float>& vel)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		if (collisionObject->getCollisionFlags() & btCollisionObject::CF_CHARACTER_OBJECT)
@@ -1541,6 +1902,8 @@ void BulletPhysics::SetAngularVelocity(ActorId actorId, const Vector3<float>& ve
 /////////////////////////////////////////////////////////////////////////////
 void BulletPhysics::Translate(ActorId actorId, const Vector3<float>& vec)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btRigidBody* const rigidBody = dynamic_cast<btRigidBody*>(FindBulletCollisionObject(actorId)))
 	{
 		btVector3 btVec = Vector3TobtVector3(vec);
@@ -1552,6 +1915,8 @@ void BulletPhysics::Translate(ActorId actorId, const Vector3<float>& vec)
 // BulletPhysics::OnGround
 bool BulletPhysics::OnGround(ActorId aid)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btKinematicCharacterController* const controller =
 		dynamic_cast<btKinematicCharacterController*>(FindBulletAction(aid)))
 	{
@@ -1564,6 +1929,8 @@ bool BulletPhysics::OnGround(ActorId aid)
 // BulletPhysics::Jump
 void BulletPhysics::Jump(ActorId aid, const Vector3<float> &dir)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btKinematicCharacterController* const controller =
 		dynamic_cast<btKinematicCharacterController*>(FindBulletAction(aid)))
 	{
@@ -1577,6 +1944,8 @@ void BulletPhysics::Jump(ActorId aid, const Vector3<float> &dir)
 // BulletPhysics::FallDirection
 void BulletPhysics::FallDirection(ActorId aid, const Vector3<float> &dir)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btKinematicCharacterController* const controller =
 		dynamic_cast<btKinematicCharacterController*>(FindBulletAction(aid)))
 	{
@@ -1589,6 +1958,8 @@ void BulletPhysics::FallDirection(ActorId aid, const Vector3<float> &dir)
 // BulletPhysics::WalkDirection
 void BulletPhysics::WalkDirection(ActorId aid, const Vector3<float> &dir)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btKinematicCharacterController* const controller =
 		dynamic_cast<btKinematicCharacterController*>(FindBulletAction(aid)))
 	{
@@ -1600,6 +1971,8 @@ void BulletPhysics::WalkDirection(ActorId aid, const Vector3<float> &dir)
 // BulletPhysics::SetPosition
 void BulletPhysics::SetPosition(ActorId actorId, const Vector3<float>& pos)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		btTransform transform = collisionObject->getWorldTransform();
@@ -1612,6 +1985,8 @@ void BulletPhysics::SetPosition(ActorId actorId, const Vector3<float>& pos)
 // BulletPhysics::SetRotation
 void BulletPhysics::SetRotation(ActorId actorId, const Transform& mat)
 {
+	std::lock_guard<std::recursive_mutex> lock(mWorldMutex);
+
 	if (btCollisionObject * const collisionObject = FindBulletCollisionObject(actorId))
 	{
 		btTransform transform = TransformTobtTransform(mat);
@@ -1633,7 +2008,9 @@ void BulletPhysics::BulletInternalTickCallback(btDynamicsWorld * const world, bt
 	LogAssert( world->getWorldUserInfo(), "no world user info" );
 	BulletPhysics * const bulletPhysics = static_cast<BulletPhysics*>( world->getWorldUserInfo() );
 	
-	CollisionPairs currentTickCollisionPairs;
+	CollisionPairs& currentTickCollisionPairs = bulletPhysics->mCurrentTickCollisionPairs;
+	CollisionPairs& previousTickCollisionPairs = bulletPhysics->mPreviousTickCollisionPairs;
+	currentTickCollisionPairs.clear();
 	
 	// look at all existing contacts
 	btDispatcher * const dispatcher = world->getDispatcher();
@@ -1657,43 +2034,82 @@ void BulletPhysics::BulletInternalTickCallback(btDynamicsWorld * const world, bt
 		// always create the pair in a predictable order
 		bool const swapped = body0 > body1;
 		
-		btRigidBody const * const sortedBodyA = swapped ? body1 : body0;
-		btRigidBody const * const sortedBodyB = swapped ? body0 : body1;
-		
-		CollisionPair const thisPair = eastl::make_pair( sortedBodyA, sortedBodyB );
-		currentTickCollisionPairs.insert( thisPair );
-		
-		if ( bulletPhysics->mPreviousTickCollisionPairs.find( thisPair ) == bulletPhysics->mPreviousTickCollisionPairs.end() )
-		{
-			// this is a new contact, which wasn't in our list before.  send an event to the game.
-			bulletPhysics->SendCollisionPairAddEvent( manifold, body0, body1 );
-		}
+		CollisionPair thisPair;
+		thisPair.mBodyA = swapped ? body1 : body0;
+		thisPair.mBodyB = swapped ? body0 : body1;
+		thisPair.mManifold = manifold;
+		currentTickCollisionPairs.push_back( thisPair );
 	}
 	
-	CollisionPairs removedCollisionPairs;
-	
-	// use the STL set difference function to find collision pairs that existed during the previous tick but not any more
-	eastl::set_difference( 
-		bulletPhysics->mPreviousTickCollisionPairs.begin(), 
-		bulletPhysics->mPreviousTickCollisionPairs.end(),
-		currentTickCollisionPairs.begin(), currentTickCollisionPairs.end(),
-		eastl::inserter( removedCollisionPairs, removedCollisionPairs.begin() ) );
+	// several manifolds may link the same bodies, keep only the first one of them
+	eastl::sort( currentTickCollisionPairs.begin(), currentTickCollisionPairs.end() );
+	currentTickCollisionPairs.erase( 
+		eastl::unique( currentTickCollisionPairs.begin(), currentTickCollisionPairs.end() ),
+		currentTickCollisionPairs.end() );
 	
-	for ( CollisionPairs::const_iterator it = removedCollisionPairs.begin(), 
-         end = removedCollisionPairs.end(); it != end; ++it )
+	// walk both sorted lists at once to find the collision pairs which are new in
+	//   this tick and the ones that existed during the previous tick but not any more
+	CollisionPairs::const_iterator previousIt = previousTickCollisionPairs.begin();
+	CollisionPairs::const_iterator currentIt = currentTickCollisionPairs.begin();
+	while ( previousIt != previousTickCollisionPairs.end() || 
+			currentIt != currentTickCollisionPairs.end() )
 	{
-		btRigidBody const * const body0 = it->first;
-		btRigidBody const * const body1 = it->second;
-		
-		bulletPhysics->SendCollisionPairRemoveEvent( body0, body1 );
+		if ( previousIt == previousTickCollisionPairs.end() || 
+			(currentIt != currentTickCollisionPairs.end() && *currentIt < *previousIt) )
+		{
+			// this is a new contact, which wasn't in our list before.
+			btPersistentManifold const * const manifold = currentIt->mManifold;
+			bulletPhysics->AddCollisionPairContact( manifold, 
+				static_cast<btRigidBody const *>(manifold->getBody0()), 
+				static_cast<btRigidBody const *>(manifold->getBody1()) );
+			++currentIt;
+		}
+		else if ( currentIt == currentTickCollisionPairs.end() || *previousIt < *currentIt )
+		{
+			// the manifold of a removed pair may be gone, only the bodies are used
+			bulletPhysics->RemoveCollisionPairContact( previousIt->mBodyA, previousIt->mBodyB );
+			++previousIt;
+		}
+		else
+		{
+			++previousIt;
+			++currentIt;
+		}
 	}
 	
 	// the current tick becomes the previous tick.  this is the way of all things.
-	bulletPhysics->mPreviousTickCollisionPairs = currentTickCollisionPairs;
+	previousTickCollisionPairs.swap( currentTickCollisionPairs );
+
+	// send all the contacts of this tick to the game at once
+	bulletPhysics->SendCollisionPairContacts();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+void BulletPhysics::SendCollisionPairContacts()
+{
+	if (mContacts->IsEmpty())
+		return;
+
+	if (PhysicThreadRunning)
+	{
+		// the listeners will run later on the game thread so they get their own copy
+		SendEvent(mContacts->Copy());
+		mContacts->Clear();
+	}
+	else
+	{
+		SendEvent(mContacts);
+
+		// reuse the arrays of the event unless a listener kept a reference to it
+		if (mContacts.use_count() > 1)
+			mContacts.reset(new EventDataPhysContacts());
+		else
+			mContacts->Clear();
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
-void BulletPhysics::SendCollisionPairAddEvent( btPersistentManifold const * manifold, 
+void BulletPhysics::AddCollisionPairContact( btPersistentManifold const * manifold, 
 	btRigidBody const * const body0, btRigidBody const * const body1 )
 {
 	if ( body0->getUserPointer() || body1->getUserPointer() )
@@ -1714,11 +2130,9 @@ void BulletPhysics::SendCollisionPairAddEvent( btPersistentManifold const * mani
 			triggerBody = body1;
 		}
 		
-		// send the trigger event.
+		// add the trigger contact.
 		int const triggerId = *static_cast<int*>(triggerBody->getUserPointer());
-        eastl::shared_ptr<EventDataPhysTriggerEnter> pEvent(
-			new EventDataPhysTriggerEnter(triggerId, FindActorID(otherBody)));
-		BaseEventManager::Get()->TriggerEvent(pEvent);
+		mContacts->AddTriggerEnter(triggerId, FindActorID(otherBody));
 	}
 	else
 	{
@@ -1732,30 +2146,22 @@ void BulletPhysics::SendCollisionPairAddEvent( btPersistentManifold const * mani
 			return;
 		}
 		
-		// this pair of colliding objects is new.  send a collision-begun event
-		eastl::list<Vector3<float>> collisionPoints;
-		Vector3<float> sumNormalForce = Vector3<float>::Zero();
-		Vector3<float> sumFrictionForce = Vector3<float>::Zero();
-		
+		// this pair of colliding objects is new.  add a collision-begun contact
+		mContacts->AddCollision(id0, id1);
 		for ( int pointIdx = 0; pointIdx < manifold->getNumContacts(); ++pointIdx )
 		{
 			btManifoldPoint const & point = manifold->getContactPoint( pointIdx );
 		
-			collisionPoints.push_back( btVector3ToVector3( point.getPositionWorldOnB() ) );
-			
-			sumNormalForce += btVector3ToVector3( point.m_combinedRestitution * point.m_normalWorldOnB );
-			sumFrictionForce += btVector3ToVector3( point.m_combinedFriction * point.m_lateralFrictionDir1 );
+			mContacts->AddCollisionPoint( 
+				btVector3ToVector3( point.getPositionWorldOnB() ),
+				btVector3ToVector3( point.m_combinedRestitution * point.m_normalWorldOnB ),
+				btVector3ToVector3( point.m_combinedFriction * point.m_lateralFrictionDir1 ) );
 		}
-		
-		// send the event for the game
-        eastl::shared_ptr<EventDataPhysCollision> pEvent(
-			new EventDataPhysCollision(id0, id1, sumNormalForce, sumFrictionForce, collisionPoints));
-		BaseEventManager::Get()->TriggerEvent(pEvent);
 	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
-void BulletPhysics::SendCollisionPairRemoveEvent(
+void BulletPhysics::RemoveCollisionPairContact(
 	btRigidBody const * const body0, btRigidBody const * const body1 )
 {
 	if ( body0->getUserPointer() || body1->getUserPointer() )
@@ -1774,11 +2180,9 @@ void BulletPhysics::SendCollisionPairRemoveEvent(
 			triggerBody = body1;
 		}
 		
-		// send the trigger event.
+		// add the trigger contact.
 		int const triggerId = *static_cast<int*>(triggerBody->getUserPointer());
-        eastl::shared_ptr<EventDataPhysTriggerLeave> pEvent(
-			new EventDataPhysTriggerLeave(triggerId, FindActorID( otherBody)));
-		BaseEventManager::Get()->TriggerEvent(pEvent);
+		mContacts->AddTriggerLeave(triggerId, FindActorID( otherBody));
 	}
 	else
 	{
@@ -1792,8 +2196,7 @@ void BulletPhysics::SendCollisionPairRemoveEvent(
 			return;
 		}
 
-        eastl::shared_ptr<EventDataPhysSeparation> pEvent(new EventDataPhysSeparation(id0, id1));
-		BaseEventManager::Get()->TriggerEvent(pEvent);
+		mContacts->AddSeparation(id0, id1);
 	}
 }
 
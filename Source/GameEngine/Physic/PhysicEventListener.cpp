@@ -48,4 +48,5 @@
 const BaseEventType EventDataPhysTriggerEnter::skEventType(0x99358c15);
 const BaseEventType EventDataPhysTriggerLeave::skEventType(0x3f49c41f);
 const BaseEventType EventDataPhysCollision::skEventType(0x54c58d0d);
-const BaseEventType EventDataPhysSeparation::skEventType(0x3dcea6e1);
\ No newline at end of file
+const BaseEventType EventDataPhysSeparation::skEventType(0x3dcea6e1);
+const BaseEventType EventDataPhysContacts::skEventType(0x6b1e27d3);
\ No newline at end of file
@@ -256,4 +256,153 @@ public:
 };
 
 
+// Every contact which starts or ends during a physic tick is gathered in a
+// single event, so listeners are notified once per tick instead of once per
+// touching pair. The records are kept in flat arrays which the physic system
+// clears and reuses from one tick to the next.
+class EventDataPhysContacts : public EventData
+{
+public:
+	struct TriggerContact
+	{
+		int mTriggerID;
+		ActorId mOther;
+	};
+
+	struct CollisionContact
+	{
+		ActorId mActorA;
+		ActorId mActorB;
+		Vector3<float> mSumNormalForce;
+		Vector3<float> mSumFrictionForce;
+
+		// range of the contact points in the event collision points
+		unsigned int mFirstPoint;
+		unsigned int mNumPoints;
+	};
+
+	struct SeparationContact
+	{
+		ActorId mActorA;
+		ActorId mActorB;
+	};
+
+	static const BaseEventType skEventType;
+
+	virtual const BaseEventType & GetEventType( void ) const
+	{
+		return skEventType;
+	}
+
+	EventDataPhysContacts()
+	{
+	}
+
+	virtual BaseEventDataPtr Copy() const
+	{
+		eastl::shared_ptr<EventDataPhysContacts> pEvent(new EventDataPhysContacts());
+		pEvent->mTriggerEnters = mTriggerEnters;
+		pEvent->mTriggerLeaves = mTriggerLeaves;
+		pEvent->mCollisions = mCollisions;
+		pEvent->mSeparations = mSeparations;
+		pEvent->mCollisionPoints = mCollisionPoints;
+		return pEvent;
+	}
+
+	virtual const char* GetName(void) const
+	{
+		return "EventDataPhysContacts";
+	}
+
+	void Clear()
+	{
+		mTriggerEnters.clear();
+		mTriggerLeaves.clear();
+		mCollisions.clear();
+		mSeparations.clear();
+		mCollisionPoints.clear();
+	}
+
+	bool IsEmpty() const
+	{
+		return mTriggerEnters.empty() && mTriggerLeaves.empty() &&
+			mCollisions.empty() && mSeparations.empty();
+	}
+
+	void AddTriggerEnter(int triggerID, ActorId other)
+	{
+		TriggerContact contact = { triggerID, other };
+		mTriggerEnters.push_back(contact);
+	}
+
+	void AddTriggerLeave(int triggerID, ActorId other)
+	{
+		TriggerContact contact = { triggerID, other };
+		mTriggerLeaves.push_back(contact);
+	}
+
+	// the collision points of the new collision are pushed with AddCollisionPoint
+	// right after this call
+	void AddCollision(ActorId actorA, ActorId actorB)
+	{
+		CollisionContact contact;
+		contact.mActorA = actorA;
+		contact.mActorB = actorB;
+		contact.mSumNormalForce = Vector3<float>::Zero();
+		contact.mSumFrictionForce = Vector3<float>::Zero();
+		contact.mFirstPoint = (unsigned int)mCollisionPoints.size();
+		contact.mNumPoints = 0;
+		mCollisions.push_back(contact);
+	}
+
+	void AddCollisionPoint(const Vector3<float>& point,
+		const Vector3<float>& normalForce, const Vector3<float>& frictionForce)
+	{
+		CollisionContact& contact = mCollisions.back();
+		contact.mSumNormalForce += normalForce;
+		contact.mSumFrictionForce += frictionForce;
+		contact.mNumPoints++;
+		mCollisionPoints.push_back(point);
+	}
+
+	void AddSeparation(ActorId actorA, ActorId actorB)
+	{
+		SeparationContact contact = { actorA, actorB };
+		mSeparations.push_back(contact);
+	}
+
+	const eastl::vector<TriggerContact>& GetTriggerEnters(void) const
+	{
+		return mTriggerEnters;
+	}
+
+	const eastl::vector<TriggerContact>& GetTriggerLeaves(void) const
+	{
+		return mTriggerLeaves;
+	}
+
+	const eastl::vector<CollisionContact>& GetCollisions(void) const
+	{
+		return mCollisions;
+	}
+
+	const eastl::vector<SeparationContact>& GetSeparations(void) const
+	{
+		return mSeparations;
+	}
+
+	const Vector3<float>* GetCollisionPoints(const CollisionContact& collision) const
+	{
+		return collision.mNumPoints ? &mCollisionPoints[collision.mFirstPoint] : nullptr;
+	}
+
+private:
+	eastl::vector<TriggerContact> mTriggerEnters;
+	eastl::vector<TriggerContact> mTriggerLeaves;
+	eastl::vector<CollisionContact> mCollisions;
+	eastl::vector<SeparationContact> mSeparations;
+	eastl::vector<Vector3<float>> mCollisionPoints;
+};
+
+
 #endif
\ No newline at end of file
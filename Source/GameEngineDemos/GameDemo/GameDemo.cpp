@@ -481,16 +481,7 @@ void GameDemoLogic::CreateNetworkEventForwarder(const int socketId)
 	// then add those events that need to be sent along to amy attached clients
 	pGlobalEventManager->AddListener(
 		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-		EventDataPhysTriggerEnter::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-		EventDataPhysTriggerLeave::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent), 
-		EventDataPhysCollision::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-		EventDataPhysSeparation::skEventType);
+		EventDataPhysContacts::skEventType);
 	pGlobalEventManager->AddListener(
 		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent), 
 		EventDataDestroyActor::skEventType);
@@ -531,16 +522,7 @@ void GameDemoLogic::DestroyAllNetworkEventForwarders(void)
 		BaseEventManager* eventManager = BaseEventManager::Get();
 		eventManager->RemoveListener(
 			MakeDelegate(networkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-			EventDataPhysTriggerEnter::skEventType);
-		eventManager->RemoveListener(
-			MakeDelegate(networkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-			EventDataPhysTriggerLeave::skEventType);
-		eventManager->RemoveListener(
-			MakeDelegate(networkEventForwarder, &NetworkEventForwarder::ForwardEvent), 
-			EventDataPhysCollision::skEventType);
-		eventManager->RemoveListener(
-			MakeDelegate(networkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-			EventDataPhysSeparation::skEventType);
+			EventDataPhysContacts::skEventType);
 		eventManager->RemoveListener(
 			MakeDelegate(networkEventForwarder, &NetworkEventForwarder::ForwardEvent), 
 			EventDataDestroyActor::skEventType);
@@ -52,6 +52,9 @@ public:
 //    static ComponentId COMPONENT_ID;  // unique ID for this component type
 //    virtual ComponentId GetComponentId(void) const override { return COMPONENT_ID; }
 
+    // fires count down their explosion time, the explosion actor is deferred
+	virtual bool IsParallelUpdateSafe(void) const override { return true; }
+
     // Trigger interface
     virtual void Apply(eastl::weak_ptr<Actor> pActor) = 0;
 };
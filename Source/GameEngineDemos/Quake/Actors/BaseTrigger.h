@@ -54,6 +54,9 @@ public:
 //    static ComponentId COMPONENT_ID;  // unique ID for this component type
 //    virtual ComponentId GetComponentId(void) const override { return COMPONENT_ID; }
 
+    // triggers don't update anything
+	virtual bool IsParallelUpdateSafe(void) const override { return true; }
+
     // Trigger interface
     virtual void Apply(eastl::weak_ptr<Actor> pActor) = 0;
 };
@@ -110,9 +110,9 @@ void GrenadeFire::Update(float deltaMs)
 
 				Transform initTransform;
 				initTransform.SetTranslation(location);
-				GameLogic::Get()->CreateActor("actors/quake/effects/grenadeexplosion.xml", nullptr, &initTransform);
+				GameLogic::Get()->DeferCreateActor("actors/quake/effects/grenadeexplosion.xml", &initTransform);
 
-				EventManager::Get()->QueueEvent(
+				EventManager::Get()->ThreadSafeQueueEvent(
 					eastl::make_shared<QuakeEventDataSplashDamage>(mOwner->GetId(), location));
 			}
 		}
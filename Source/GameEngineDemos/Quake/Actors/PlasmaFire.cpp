@@ -110,9 +110,9 @@ void PlasmaFire::Update(float deltaMs)
 
 				Transform initTransform;
 				initTransform.SetTranslation(location);
-				GameLogic::Get()->CreateActor("actors/quake/effects/plasmaexplosion.xml", nullptr, &initTransform);
+				GameLogic::Get()->DeferCreateActor("actors/quake/effects/plasmaexplosion.xml", &initTransform);
 
-				EventManager::Get()->QueueEvent(
+				EventManager::Get()->ThreadSafeQueueEvent(
 					eastl::make_shared<QuakeEventDataSplashDamage>(mOwner->GetId(), location));
 			}
 		}
@@ -110,9 +110,9 @@ void RocketFire::Update(float deltaMs)
 
 				Transform initTransform;
 				initTransform.SetTranslation(location);
-				GameLogic::Get()->CreateActor("actors/quake/effects/rocketexplosion.xml", nullptr, &initTransform);
+				GameLogic::Get()->DeferCreateActor("actors/quake/effects/rocketexplosion.xml", &initTransform);
 
-				EventManager::Get()->QueueEvent(
+				EventManager::Get()->ThreadSafeQueueEvent(
 					eastl::make_shared<QuakeEventDataSplashDamage>(mOwner->GetId(), location));
 			}
 		}
@@ -684,17 +684,8 @@ void QuakeLogic::RegisterAllDelegates(void)
 		MakeDelegate(this, &QuakeLogic::EnvironmentLoadedDelegate), 
 		EventDataRemoteEnvironmentLoaded::skEventType);
 	pGlobalEventManager->AddListener(
-		MakeDelegate(this, &QuakeLogic::PhysicsTriggerEnterDelegate),
-		EventDataPhysTriggerEnter::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(this, &QuakeLogic::PhysicsTriggerLeaveDelegate),
-		EventDataPhysTriggerLeave::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(this, &QuakeLogic::PhysicsCollisionDelegate),
-		EventDataPhysCollision::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(this, &QuakeLogic::PhysicsSeparationDelegate),
-		EventDataPhysSeparation::skEventType);
+		MakeDelegate(this, &QuakeLogic::PhysicsContactsDelegate),
+		EventDataPhysContacts::skEventType);
 
 	pGlobalEventManager->AddListener(
 		MakeDelegate(this, &QuakeLogic::FireWeaponDelegate),
@@ -760,17 +751,8 @@ void QuakeLogic::RemoveAllDelegates(void)
 		MakeDelegate(this, &QuakeLogic::EnvironmentLoadedDelegate), 
 		EventDataRemoteEnvironmentLoaded::skEventType);
 	pGlobalEventManager->RemoveListener(
-		MakeDelegate(this, &QuakeLogic::PhysicsTriggerEnterDelegate),
-		EventDataPhysTriggerEnter::skEventType);
-	pGlobalEventManager->RemoveListener(
-		MakeDelegate(this, &QuakeLogic::PhysicsTriggerLeaveDelegate),
-		EventDataPhysTriggerLeave::skEventType);
-	pGlobalEventManager->RemoveListener(
-		MakeDelegate(this, &QuakeLogic::PhysicsCollisionDelegate),
-		EventDataPhysCollision::skEventType);
-	pGlobalEventManager->RemoveListener(
-		MakeDelegate(this, &QuakeLogic::PhysicsSeparationDelegate),
-		EventDataPhysSeparation::skEventType);
+		MakeDelegate(this, &QuakeLogic::PhysicsContactsDelegate),
+		EventDataPhysContacts::skEventType);
 	if (mIsProxy)
 	{
 		pGlobalEventManager->RemoveListener(
@@ -828,16 +810,7 @@ void QuakeLogic::CreateNetworkEventForwarder(const int socketId)
 	// then add those events that need to be sent along to amy attached clients
 	pGlobalEventManager->AddListener(
 		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-		EventDataPhysTriggerEnter::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-		EventDataPhysTriggerLeave::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-		EventDataPhysCollision::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-		EventDataPhysSeparation::skEventType);
+		EventDataPhysContacts::skEventType);
 	pGlobalEventManager->AddListener(
 		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent), 
 		EventDataDestroyActor::skEventType);
@@ -903,16 +876,7 @@ void QuakeLogic::DestroyAllNetworkEventForwarders(void)
 		BaseEventManager* eventManager = BaseEventManager::Get();
 		eventManager->RemoveListener(
 			MakeDelegate(networkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-			EventDataPhysTriggerEnter::skEventType);
-		eventManager->RemoveListener(
-			MakeDelegate(networkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-			EventDataPhysTriggerLeave::skEventType);
-		eventManager->RemoveListener(
-			MakeDelegate(networkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-			EventDataPhysCollision::skEventType);
-		eventManager->RemoveListener(
-			MakeDelegate(networkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-			EventDataPhysSeparation::skEventType);
+			EventDataPhysContacts::skEventType);
 		eventManager->RemoveListener(
 			MakeDelegate(networkEventForwarder, &NetworkEventForwarder::ForwardEvent), 
 			EventDataDestroyActor::skEventType);
@@ -2978,17 +2942,29 @@ bool QuakeLogic::CanItemBeGrabbed(const eastl::shared_ptr<Actor>& item, const ea
 	return false;
 }
 
-void QuakeLogic::PhysicsTriggerEnterDelegate(BaseEventDataPtr pEventData)
+void QuakeLogic::PhysicsContactsDelegate(BaseEventDataPtr pEventData)
 {
-	eastl::shared_ptr<EventDataPhysTriggerEnter> pCastEventData =
-		eastl::static_pointer_cast<EventDataPhysTriggerEnter>(pEventData);
+	eastl::shared_ptr<EventDataPhysContacts> pCastEventData =
+		eastl::static_pointer_cast<EventDataPhysContacts>(pEventData);
 
+	for (const auto& triggerEnter : pCastEventData->GetTriggerEnters())
+		PhysicsTriggerEnter(triggerEnter.mTriggerID, triggerEnter.mOther);
+	for (const auto& triggerLeave : pCastEventData->GetTriggerLeaves())
+		PhysicsTriggerLeave(triggerLeave.mTriggerID, triggerLeave.mOther);
+	for (const auto& collision : pCastEventData->GetCollisions())
+		PhysicsCollision(collision.mActorA, collision.mActorB);
+	for (const auto& separation : pCastEventData->GetSeparations())
+		PhysicsSeparation(separation.mActorA, separation.mActorB);
+}
+
+void QuakeLogic::PhysicsTriggerEnter(int triggerId, ActorId otherActor)
+{
 	eastl::shared_ptr<Actor> pItemActor(
-		GameLogic::Get()->GetActor(pCastEventData->GetTriggerId()).lock());
+		GameLogic::Get()->GetActor(triggerId).lock());
 
 	eastl::shared_ptr<PlayerActor> pPlayerActor(
 		eastl::dynamic_shared_pointer_cast<PlayerActor>(
-		GameLogic::Get()->GetActor(pCastEventData->GetOtherActor()).lock()));
+		GameLogic::Get()->GetActor(otherActor).lock()));
 
 	if (pPlayerActor)
 	{
@@ -3039,28 +3015,22 @@ void QuakeLogic::PhysicsTriggerEnterDelegate(BaseEventDataPtr pEventData)
 }
 
 
-void QuakeLogic::PhysicsTriggerLeaveDelegate(BaseEventDataPtr pEventData)
+void QuakeLogic::PhysicsTriggerLeave(int triggerId, ActorId otherActor)
 {
-	eastl::shared_ptr<EventDataPhysTriggerLeave> pCastEventData =
-		eastl::static_pointer_cast<EventDataPhysTriggerLeave>(pEventData);
-
 	eastl::shared_ptr<Actor> pTrigger(
-		GameLogic::Get()->GetActor(pCastEventData->GetTriggerId()).lock());
+		GameLogic::Get()->GetActor(triggerId).lock());
 	eastl::shared_ptr<PlayerActor> pPlayerActor(
 		eastl::dynamic_shared_pointer_cast<PlayerActor>(
-		GameLogic::Get()->GetActor(pCastEventData->GetOtherActor()).lock()));
+		GameLogic::Get()->GetActor(otherActor).lock()));
 }
 
 
-void QuakeLogic::PhysicsCollisionDelegate(BaseEventDataPtr pEventData)
+void QuakeLogic::PhysicsCollision(ActorId actorA, ActorId actorB)
 {
-	eastl::shared_ptr<EventDataPhysCollision> pCastEventData =
-		eastl::static_pointer_cast<EventDataPhysCollision>(pEventData);
-
 	eastl::shared_ptr<Actor> pGameActorA(
-		GameLogic::Get()->GetActor(pCastEventData->GetActorA()).lock());
+		GameLogic::Get()->GetActor(actorA).lock());
 	eastl::shared_ptr<Actor> pGameActorB(
-		GameLogic::Get()->GetActor(pCastEventData->GetActorB()).lock());
+		GameLogic::Get()->GetActor(actorB).lock());
 	if (pGameActorA && pGameActorB)
 	{
 		eastl::shared_ptr<Actor> pItemActor;
@@ -3136,15 +3106,12 @@ void QuakeLogic::PhysicsCollisionDelegate(BaseEventDataPtr pEventData)
 	}
 }
 
-void QuakeLogic::PhysicsSeparationDelegate(BaseEventDataPtr pEventData)
+void QuakeLogic::PhysicsSeparation(ActorId actorA, ActorId actorB)
 {
-	eastl::shared_ptr<EventDataPhysSeparation> pCastEventData =
-		eastl::static_pointer_cast<EventDataPhysSeparation>(pEventData);
-
 	eastl::shared_ptr<Actor> pGameActorA(
-		GameLogic::Get()->GetActor(pCastEventData->GetActorA()).lock());
+		GameLogic::Get()->GetActor(actorA).lock());
 	eastl::shared_ptr<Actor> pGameActorB(
-		GameLogic::Get()->GetActor(pCastEventData->GetActorB()).lock());
+		GameLogic::Get()->GetActor(actorB).lock());
 	if (pGameActorA && pGameActorB)
 	{
 		eastl::shared_ptr<Actor> pItemActor;
@@ -237,6 +237,12 @@ public:
 	void GetTriggerActors(eastl::vector<eastl::shared_ptr<Actor>>& trigger);
 	void GetTargetActors(eastl::vector<eastl::shared_ptr<Actor>>& target);
 
+	//Physics contacts
+	void PhysicsTriggerEnter(int triggerId, ActorId otherActor);
+	void PhysicsTriggerLeave(int triggerId, ActorId otherActor);
+	void PhysicsCollision(ActorId actorA, ActorId actorB);
+	void PhysicsSeparation(ActorId actorA, ActorId actorB);
+
 	//Items
 	bool CanItemBeGrabbed(const eastl::shared_ptr<Actor>& item, const eastl::shared_ptr<PlayerActor>& player);
 
@@ -251,10 +257,7 @@ public:
 	void RequestStartGameDelegate(BaseEventDataPtr pEventData);
 	void RemoteClientDelegate(BaseEventDataPtr pEventData);
 	void NetworkPlayerActorAssignmentDelegate(BaseEventDataPtr pEventData);
-	void PhysicsTriggerEnterDelegate(BaseEventDataPtr pEventData);
-	void PhysicsTriggerLeaveDelegate(BaseEventDataPtr pEventData);
-	void PhysicsCollisionDelegate(BaseEventDataPtr pEventData);
-	void PhysicsSeparationDelegate(BaseEventDataPtr pEventData);
+	void PhysicsContactsDelegate(BaseEventDataPtr pEventData);
 	void EnvironmentLoadedDelegate(BaseEventDataPtr pEventData);
 
 	void SplashDamageDelegate(BaseEventDataPtr pEventData);
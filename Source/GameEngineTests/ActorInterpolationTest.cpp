@@ -0,0 +1,48 @@
+//========================================================================
+// ActorInterpolationTest.cpp : Checks the actor transforms drawn in
+// between two logic ticks.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "Graphic/Scene/Scene.h"
+
+#include "UnitTest.h"
+
+#include <cmath>
+
+namespace
+{
+	bool IsClose(float value, float expected)
+	{
+		return std::fabs(value - expected) < 1e-5f;
+	}
+}
+
+UNIT_TEST(ActorInterpolationGoesFromPreviousToLast)
+{
+	// The actor moves and turns a quarter about z on the last tick.
+	float const halfAngle = (float)GE_C_QUARTER_PI / 2.f;
+	Scene::ActorTransformState state;
+	state.mPreviousTranslation = Vector3<float>{ 0.f, 0.f, 0.f };
+	state.mPreviousRotation = Quaternion<float>::Identity();
+	state.mTranslation = Vector3<float>{ 2.f, 4.f, -6.f };
+	state.mRotation = Quaternion<float>(0.f, 0.f, std::sin((float)GE_C_QUARTER_PI), std::cos((float)GE_C_QUARTER_PI));
+	state.mTick = 1;
+
+	Vector3<float> translation;
+	Quaternion<float> rotation;
+
+	state.Interpolate(0.f, translation, rotation);
+	CHECK(IsClose(translation[0], 0.f) && IsClose(translation[1], 0.f) && IsClose(translation[2], 0.f));
+	CHECK(IsClose(rotation[2], 0.f) && IsClose(rotation[3], 1.f));
+
+	state.Interpolate(0.5f, translation, rotation);
+	CHECK(IsClose(translation[0], 1.f) && IsClose(translation[1], 2.f) && IsClose(translation[2], -3.f));
+	CHECK(IsClose(rotation[2], std::sin(halfAngle)) && IsClose(rotation[3], std::cos(halfAngle)));
+
+	state.Interpolate(1.f, translation, rotation);
+	CHECK(IsClose(translation[0], 2.f) && IsClose(translation[1], 4.f) && IsClose(translation[2], -6.f));
+	CHECK(IsClose(rotation[2], state.mRotation[2]) && IsClose(rotation[3], state.mRotation[3]));
+}
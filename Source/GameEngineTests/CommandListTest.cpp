@@ -0,0 +1,153 @@
+//========================================================================
+// CommandListTest.cpp : Checks the command lists recorded by several
+// threads and their submission to the renderer.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "Core/Threading/JobSystem.h"
+
+#include "Graphic/Renderer/CommandRecorder.h"
+#include "Graphic/Renderer/Recording/RecordingRenderer.h"
+#include "Graphic/Scene/Hierarchy/Visual.h"
+#include "Graphic/Shader/ProgramFactory.h"
+
+#include "UnitTest.h"
+
+namespace
+{
+	// A triangle mesh of numPrimitives primitives, which tells the draws
+	// apart in the capture.
+	eastl::shared_ptr<Visual> CreateMesh(unsigned int numPrimitives)
+	{
+		VertexFormat vformat;
+		vformat.Bind(VA_POSITION, DF_R32G32B32_FLOAT, 0);
+		eastl::shared_ptr<VertexBuffer> vbuffer = eastl::make_shared<VertexBuffer>(vformat, 3);
+		eastl::shared_ptr<IndexBuffer> ibuffer = eastl::make_shared<IndexBuffer>(
+			IP_TRIMESH, numPrimitives, sizeof(unsigned int));
+		eastl::shared_ptr<VisualEffect> effect = eastl::make_shared<VisualEffect>(
+			ProgramFactory::Get()->CreateFromSources("", "", ""));
+		return eastl::make_shared<Visual>(vbuffer, ibuffer, effect);
+	}
+
+	// Keeps the first byte of each constant buffer as it is uploaded.
+	class UploadRecordingRenderer : public RecordingRenderer
+	{
+	public:
+		UploadRecordingRenderer() : RecordingRenderer(640, 480) {}
+
+		virtual bool Update(eastl::shared_ptr<Buffer> const& buffer) override
+		{
+			if (buffer->GetType() == GE_CONSTANT_BUFFER)
+				mUploadedBytes.push_back(buffer->GetData()[0]);
+			return RecordingRenderer::Update(buffer);
+		}
+
+		eastl::vector<char> mUploadedBytes;
+	};
+}
+
+UNIT_TEST(CommandListSubmitsInRecordingOrder)
+{
+	RecordingRenderer renderer(640, 480);
+	renderer.DisplayColorBuffer(0);
+
+	const unsigned int numParts = 4, numDrawsPerPart = 8;
+	eastl::vector<eastl::shared_ptr<Visual>> meshes;
+	for (unsigned int i = 0; i < numParts * numDrawsPerPart; ++i)
+		meshes.push_back(CreateMesh(i + 1));
+
+	eastl::vector<eastl::unique_ptr<CommandRecorder>> recorders;
+	for (unsigned int part = 0; part < numParts; ++part)
+	{
+		recorders.push_back(eastl::make_unique<CommandRecorder>());
+		recorders.back()->Reset(&renderer);
+	}
+
+	// Each part is recorded by a worker as Scene::RenderInParallel does, the
+	// draws going to the recorder of the thread.
+	JobSystem jobSystem(3, false);
+	jobSystem.ParallelFor(0, numParts * numDrawsPerPart, numDrawsPerPart,
+		[&meshes, &recorders, numDrawsPerPart](unsigned int begin, unsigned int end)
+		{
+			CommandRecorder* recorder = recorders[begin / numDrawsPerPart].get();
+			recorder->Begin();
+			for (unsigned int i = begin; i < end; ++i)
+				Renderer::Get()->Draw(meshes[i]);
+			recorder->End();
+		});
+
+	for (auto const& recorder : recorders)
+	{
+		CHECK(recorder->GetCommandList().GetNumDraws() == numDrawsPerPart);
+		renderer.Submit(recorder->GetCommandList());
+	}
+	renderer.DisplayColorBuffer(0);
+
+	// The draws reach the renderer in the order of the meshes, whichever
+	// thread recorded them.
+	unsigned int numDraws = 0;
+	for (auto const& command : renderer.GetCapture())
+	{
+		if (command.mType == RecordingRenderer::CT_DRAW)
+		{
+			CHECK(command.mArgs[1] == numDraws + 1);
+			numDraws++;
+		}
+	}
+	CHECK(numDraws == numParts * numDrawsPerPart);
+	CHECK(renderer.GetLastFrameStatistics().mNumCommands[RecordingRenderer::CT_CREATE] ==
+		2 * numParts * numDrawsPerPart);
+}
+
+UNIT_TEST(CommandListKeepsRecordedData)
+{
+	UploadRecordingRenderer renderer;
+	renderer.DisplayColorBuffer(0);
+
+	eastl::shared_ptr<Visual> mesh = CreateMesh(4);
+	eastl::shared_ptr<IndexBuffer> const& ibuffer = mesh->GetIndexBuffer();
+	eastl::shared_ptr<ConstantBuffer> cbuffer = eastl::make_shared<ConstantBuffer>(64, true);
+
+	CommandRecorder recorder;
+	recorder.Reset(&renderer);
+	recorder.Begin();
+	cbuffer->GetData()[0] = 1;
+	Renderer::Get()->Update(cbuffer);
+	ibuffer->SetNumActivePrimitives(2);
+	Renderer::Get()->Draw(mesh);
+	recorder.End();
+
+	// The buffers change again before the list is submitted.
+	cbuffer->GetData()[0] = 2;
+	ibuffer->SetNumActivePrimitives(3);
+
+	CommandList const& commandList = recorder.GetCommandList();
+	CHECK(commandList.GetNumDraws() == 1);
+	CHECK(commandList.GetNumBytes() == cbuffer->GetNumBytes());
+
+	renderer.Submit(commandList);
+	renderer.DisplayColorBuffer(0);
+
+	// The upload and the draw get the data they were recorded with, then
+	// the buffers get their live data and draw range back.
+	CHECK(renderer.mUploadedBytes.size() == 1 && renderer.mUploadedBytes[0] == 1);
+	CHECK(cbuffer->GetData()[0] == 2);
+	CHECK(ibuffer->GetNumActivePrimitives() == 3);
+
+	unsigned int numDraws = 0;
+	for (auto const& command : renderer.GetCapture())
+	{
+		if (command.mType == RecordingRenderer::CT_DRAW)
+		{
+			CHECK(command.mArgs[1] == 2);
+			numDraws++;
+		}
+		else if (command.mType == RecordingRenderer::CT_UPDATE)
+		{
+			CHECK(command.mArgs[0] == cbuffer->GetNumBytes());
+		}
+	}
+	CHECK(numDraws == 1);
+}
@@ -0,0 +1,30 @@
+//========================================================================
+// GameEngineTests.cpp : Runs the unit tests of the engine. They need no
+// window and no graphics device, the renderer being the recording one.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "Core/Logger/LogReporter.h"
+
+#include "Graphic/Renderer/Recording/RecordingProgramFactory.h"
+
+#include "UnitTest.h"
+
+// Usage: GameEngineTests [name prefix of the tests to run]
+// The exit code is the number of failed tests.
+int main(int numArguments, char* arguments[])
+{
+	LogReporter reporter(
+		"",
+		Logger::Listener::LISTEN_FOR_NOTHING,
+		Logger::Listener::LISTEN_FOR_ALL);
+
+	// The effects of the tests get programs without shaders. The factory
+	// is owned by the global program factory, as the backend ones are.
+	new RecordingProgramFactory();
+
+	eastl::string filter = numArguments > 1 ? arguments[1] : "";
+	return (int)UnitTest::RunAll(filter);
+}
@@ -0,0 +1,138 @@
+//========================================================================
+// RecordingRendererTest.cpp : Checks the commands recorded by the
+// recording renderer.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "Graphic/Renderer/Recording/RecordingRenderer.h"
+#include "Graphic/Scene/Hierarchy/Visual.h"
+#include "Graphic/Shader/ProgramFactory.h"
+
+#include "UnitTest.h"
+
+#include <cstdio>
+
+namespace
+{
+	typedef RecordingRenderer::Command Command;
+
+	eastl::shared_ptr<Visual> CreateTriangle()
+	{
+		VertexFormat vformat;
+		vformat.Bind(VA_POSITION, DF_R32G32B32_FLOAT, 0);
+		eastl::shared_ptr<VertexBuffer> vbuffer = eastl::make_shared<VertexBuffer>(vformat, 3);
+		eastl::shared_ptr<IndexBuffer> ibuffer = eastl::make_shared<IndexBuffer>(IP_TRIMESH, 1, sizeof(unsigned int));
+		eastl::shared_ptr<VisualEffect> effect = eastl::make_shared<VisualEffect>(
+			ProgramFactory::Get()->CreateFromSources("", "", ""));
+		return eastl::make_shared<Visual>(vbuffer, ibuffer, effect);
+	}
+}
+
+UNIT_TEST(RecordingRendererRecordsFrame)
+{
+	RecordingRenderer renderer(640, 480);
+
+	// The viewport and the default states set on construction make up the
+	// first frame.
+	renderer.DisplayColorBuffer(0);
+	CHECK(renderer.GetCapture().back().mType == RecordingRenderer::CT_PRESENT);
+
+	eastl::shared_ptr<Visual> triangle = CreateTriangle();
+	renderer.ClearBuffers();
+	renderer.Draw(triangle);
+	renderer.Draw(triangle);
+	renderer.DisplayColorBuffer(1);
+
+	// Clear, the creation of the buffers on the first draw, then the
+	// program and the draw of each triangle.
+	eastl::vector<Command> const& capture = renderer.GetCapture();
+	uint32_t const types[] =
+	{
+		RecordingRenderer::CT_CLEAR,
+		RecordingRenderer::CT_CREATE,
+		RecordingRenderer::CT_CREATE,
+		RecordingRenderer::CT_PROGRAM,
+		RecordingRenderer::CT_DRAW,
+		RecordingRenderer::CT_PROGRAM,
+		RecordingRenderer::CT_DRAW,
+		RecordingRenderer::CT_PRESENT
+	};
+	CHECK(capture.size() == sizeof(types) / sizeof(types[0]));
+	if (capture.size() != sizeof(types) / sizeof(types[0]))
+		return;
+
+	for (unsigned int i = 0; i < capture.size(); ++i)
+		CHECK(capture[i].mType == types[i]);
+
+	Command const& vbufferCreate = capture[1];
+	Command const& ibufferCreate = capture[2];
+	CHECK(vbufferCreate.mArgs[0] == GE_VERTEX_BUFFER);
+	CHECK(vbufferCreate.mArgs[1] == 3 * sizeof(Vector3<float>));
+	CHECK(ibufferCreate.mArgs[0] == GE_INDEX_BUFFER);
+	CHECK(ibufferCreate.mArgs[1] == 3 * sizeof(unsigned int));
+	CHECK(vbufferCreate.mObject != 0 && vbufferCreate.mObject != ibufferCreate.mObject);
+
+	Command const& draw = capture[4];
+	CHECK(draw.mObject == vbufferCreate.mObject);
+	CHECK(draw.mArgs[0] == ibufferCreate.mObject);
+	CHECK(draw.mArgs[1] == 1);
+	CHECK(draw.mArgs[2] == IP_TRIMESH);
+	CHECK(draw.mArgs[3] == 1);
+	CHECK(capture[3].mObject != 0 && capture[3].mObject == capture[5].mObject);
+	CHECK(capture[7].mArgs[0] == 1);
+
+	RecordingRenderer::Statistics const& statistics = renderer.GetLastFrameStatistics();
+	CHECK(statistics.mNumCommands[RecordingRenderer::CT_DRAW] == 2);
+	CHECK(statistics.mNumPrimitives == 2);
+	CHECK(statistics.mNumStateChanges == 1);
+	CHECK(statistics.mNumBytesUploaded == 3 * sizeof(Vector3<float>) + 3 * sizeof(unsigned int));
+
+	// The capture reads back as it was saved.
+	char const* captureFile = "RecordingRendererTest.capture";
+	eastl::vector<Command> loaded;
+	CHECK(renderer.SaveCapture(captureFile));
+	CHECK(RecordingRenderer::LoadCapture(captureFile, loaded));
+	CHECK(loaded.size() == capture.size() &&
+		memcmp(loaded.data(), capture.data(), capture.size() * sizeof(Command)) == 0);
+	std::remove(captureFile);
+}
+
+UNIT_TEST(RecordingRendererRecordsDestruction)
+{
+	RecordingRenderer renderer(640, 480);
+
+	eastl::shared_ptr<Visual> triangle = CreateTriangle();
+	renderer.Draw(triangle);
+	renderer.DisplayColorBuffer(0);
+
+	uint32_t const vbufferId = renderer.GetCapture()[renderer.GetCapture().size() - 2].mObject;
+	uint32_t programId = 0;
+	for (auto const& command : renderer.GetCapture())
+	{
+		if (command.mType == RecordingRenderer::CT_PROGRAM)
+			programId = command.mObject;
+	}
+
+	// The bridges of the buffers go away with them although the renderer
+	// isn't the global one.
+	triangle = nullptr;
+	renderer.DisplayColorBuffer(0);
+
+	eastl::vector<Command> const& capture = renderer.GetCapture();
+	CHECK(capture.size() == 3);
+	CHECK(capture[0].mType == RecordingRenderer::CT_DESTROY || capture[1].mType == RecordingRenderer::CT_DESTROY);
+	CHECK(capture[0].mObject == vbufferId || capture[1].mObject == vbufferId);
+	CHECK(capture[2].mType == RecordingRenderer::CT_PRESENT);
+
+	// The program is known by address, its id doesn't outlive the frame.
+	triangle = CreateTriangle();
+	renderer.Draw(triangle);
+	renderer.DisplayColorBuffer(0);
+	for (auto const& command : renderer.GetCapture())
+	{
+		if (command.mType == RecordingRenderer::CT_PROGRAM)
+			CHECK(command.mObject != programId);
+	}
+}
@@ -0,0 +1,138 @@
+//========================================================================
+// ResourcePreloadTest.cpp : Checks the resources preloaded in the cache
+// while their decoding runs on the job system.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "Core/IO/MemoryFile.h"
+#include "Core/IO/ResourceCache.h"
+#include "Core/Threading/JobSystem.h"
+
+#include "Graphic/Image/ImageResource.h"
+
+#include "UnitTest.h"
+
+namespace
+{
+	// An uncompressed 32 bit tga image, stored from the top row.
+	eastl::vector<char> CreateImage(unsigned int width, unsigned int height, unsigned char seed)
+	{
+		eastl::vector<char> image(18 + 4 * width * height, 0);
+		image[2] = 2;
+		image[12] = (char)(width & 0xFF);
+		image[13] = (char)(width >> 8);
+		image[14] = (char)(height & 0xFF);
+		image[15] = (char)(height >> 8);
+		image[16] = 32;
+		image[17] = 0x28;
+		for (unsigned int i = 18; i < image.size(); ++i)
+			image[i] = (char)((i * 13 + seed) & 0xFF);
+		return image;
+	}
+
+	// Resources held in memory, which counts the files it hands.
+	class MemoryResourceFile : public BaseResourceFile
+	{
+	public:
+		MemoryResourceFile() : mNumReads(0) {}
+
+		void AddResource(eastl::wstring const& name, eastl::vector<char> const& data)
+		{
+			mNames.push_back(name);
+			mData.push_back(data);
+		}
+
+		virtual bool Open() { return true; }
+
+		virtual int GetRawResource(const BaseResource& r, void** buffer)
+		{
+			for (unsigned int i = 0; i < mNames.size(); ++i)
+			{
+				if (mNames[i] == r.mName)
+				{
+					mNumReads++;
+					*buffer = new MemoryReadFile(mData[i].data(), (long)mData[i].size(), mNames[i], false);
+					return (int)mData[i].size();
+				}
+			}
+			*buffer = nullptr;
+			return -1;
+		}
+
+		virtual int GetNumResources() const { return (int)mNames.size(); }
+		virtual eastl::wstring GetResourceName(unsigned int num) const { return mNames[num]; }
+		virtual bool IsUsingDevelopmentDirectories(void) const { return false; }
+
+		virtual bool ExistFile(const eastl::wstring& filename) const
+		{
+			return eastl::find(mNames.begin(), mNames.end(), filename) != mNames.end();
+		}
+
+		virtual bool ExistDirectory(const eastl::wstring& dirname) const { return false; }
+		virtual bool IsALoadableFileFormat(const eastl::wstring& filename) const { return true; }
+		virtual bool IsALoadableFileFormat(FileArchiveType fileType) const { return false; }
+		virtual bool IsALoadableFileFormat(BaseReadFile* file) const { return false; }
+
+		unsigned int mNumReads;
+
+	private:
+		eastl::vector<eastl::wstring> mNames;
+		eastl::vector<eastl::vector<char>> mData;
+	};
+
+	// Tells the handles in the cache apart from the ones loaded on demand.
+	class PreloadResCache : public ResCache
+	{
+	public:
+		PreloadResCache(MemoryResourceFile* file) : ResCache(16, file) {}
+
+		using ResCache::Find;
+	};
+}
+
+UNIT_TEST(ResCachePreloadsInParallel)
+{
+	MemoryResourceFile* file = new MemoryResourceFile();
+	unsigned int const numImages = 5;
+	for (unsigned int i = 0; i < numImages; ++i)
+		file->AddResource(L"image" + eastl::to_wstring(i) + L".tga", CreateImage(4 + i, 3 + 2 * i, (unsigned char)i));
+	file->AddResource(L"readme.txt", eastl::vector<char>(8, 'a'));
+
+	// The images are decoded by the single worker while the next ones are
+	// read, the cache owning the file.
+	JobSystem jobSystem(1, true);
+	extern eastl::shared_ptr<BaseResourceLoader> CreateImageResourceLoader();
+	PreloadResCache resCache(file);
+	CHECK(resCache.Init());
+	resCache.RegisterLoader(CreateImageResourceLoader());
+
+	CHECK(resCache.Preload(L"*.tga", nullptr) == (int)numImages);
+	CHECK(file->mNumReads == numImages);
+
+	for (unsigned int i = 0; i < numImages; ++i)
+	{
+		BaseResource resource(L"image" + eastl::to_wstring(i) + L".tga");
+		eastl::shared_ptr<ResHandle> handle = resCache.Find(&resource);
+		CHECK(handle != nullptr);
+		if (!handle)
+			continue;
+
+		eastl::shared_ptr<ImageResourceExtraData> extra =
+			eastl::static_pointer_cast<ImageResourceExtraData>(handle->GetExtra());
+		CHECK(extra && extra->GetImage());
+		if (extra && extra->GetImage())
+		{
+			CHECK(extra->GetImage()->GetWidth() == 4 + i);
+			CHECK(extra->GetImage()->GetHeight() == 3 + 2 * i);
+		}
+	}
+
+	// The resources which don't match stay out of the cache, the ones
+	// already there aren't read again.
+	BaseResource readme(L"readme.txt");
+	CHECK(resCache.Find(&readme) == nullptr);
+	CHECK(resCache.Preload(L"*.tga", nullptr) == (int)numImages);
+	CHECK(file->mNumReads == numImages);
+}
@@ -0,0 +1,91 @@
+//========================================================================
+// SkinnedMeshTest.cpp : Checks the joint animation sampled from the keys
+// and from the baked tracks.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "Graphic/Scene/Element/Mesh/SkinnedMesh.h"
+
+#include "UnitTest.h"
+
+#include <cmath>
+
+namespace
+{
+	bool IsClose(float value, float expected)
+	{
+		return std::fabs(value - expected) < 1e-4f;
+	}
+
+	Quaternion<float> RotationZ(float angle)
+	{
+		return Quaternion<float>(0.f, 0.f, std::sin(angle / 2.f), std::cos(angle / 2.f));
+	}
+
+	// A joint moving, scaling and turning about z with keys at frames 0, 4
+	// and 10, which fall on the baked samples.
+	void AddAnimatedJoint(SkinnedMesh& mesh)
+	{
+		SkinnedMesh::Joint* joint = mesh.AddJoint();
+		float const frames[] = { 0.f, 4.f, 10.f };
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			SkinnedMesh::PositionKey* positionKey = mesh.AddPositionKey(joint);
+			positionKey->mFrame = frames[i];
+			positionKey->mPosition = Vector3<float>{ 2.f * i, -1.f * i * i, 5.f };
+
+			SkinnedMesh::ScaleKey* scaleKey = mesh.AddScaleKey(joint);
+			scaleKey->mFrame = frames[i];
+			scaleKey->mScale = Vector3<float>{ 1.f + i, 1.f, 1.f + 0.5f * i };
+
+			SkinnedMesh::RotationKey* rotationKey = mesh.AddRotationKey(joint);
+			rotationKey->mFrame = frames[i];
+			rotationKey->mRotation = RotationZ((float)GE_C_PI / 3.f * i);
+		}
+	}
+}
+
+UNIT_TEST(SkinnedMeshBakedTracksMatchKeys)
+{
+	SkinnedMesh mesh;
+	AddAnimatedJoint(mesh);
+	mesh.Finalize();
+
+	SkinnedMesh::Joint const* joint = mesh.GetAllJoints()[0];
+	float const frames[] = { 0.f, 1.3f, 4.f, 6.75f, 9.9f, 10.f };
+	unsigned int const numFrames = sizeof(frames) / sizeof(frames[0]);
+
+	eastl::vector<Vector3<float>> positions, scales;
+	eastl::vector<Quaternion<float>> rotations;
+	for (unsigned int i = 0; i < numFrames; ++i)
+	{
+		mesh.AnimateMesh(frames[i], 1.f);
+		positions.push_back(joint->mAnimatedPosition);
+		scales.push_back(joint->mAnimatedScale);
+		rotations.push_back(joint->mAnimatedRotation);
+	}
+
+	// The keys are linear in between, the baked samples give them back.
+	CHECK(IsClose(positions[2][0], 2.f) && IsClose(positions[2][1], -1.f));
+	CHECK(IsClose(positions[1][0], 2.f * 1.3f / 4.f));
+
+	mesh.BakeAnimation(4.f);
+	for (unsigned int i = 0; i < numFrames; ++i)
+	{
+		mesh.AnimateMesh(frames[i], 1.f);
+		for (unsigned int j = 0; j < 3; ++j)
+		{
+			CHECK(IsClose(joint->mAnimatedPosition[j], positions[i][j]));
+			CHECK(IsClose(joint->mAnimatedScale[j], scales[i][j]));
+		}
+		for (unsigned int j = 0; j < 4; ++j)
+			CHECK(IsClose(joint->mAnimatedRotation[j], rotations[i][j]));
+	}
+
+	// Going back to the keys gives the same joints again.
+	mesh.BakeAnimation(0.f);
+	mesh.AnimateMesh(frames[3], 1.f);
+	CHECK(IsClose(joint->mAnimatedPosition[1], positions[3][1]));
+}
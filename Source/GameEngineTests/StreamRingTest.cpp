@@ -0,0 +1,146 @@
+//========================================================================
+// StreamRingTest.cpp : Checks the suballocations of the stream ring and
+// the reuse of its bytes once the frames are retired.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "Graphic/Renderer/Recording/RecordingRenderer.h"
+#include "Graphic/Renderer/StreamRing.h"
+
+#include "UnitTest.h"
+
+UNIT_TEST(StreamRingRejectsOversizeAllocation)
+{
+	StreamRing ring(1024);
+
+	CHECK(ring.Allocate(0, 1).mOffset == StreamRing::Invalid);
+	CHECK(ring.Allocate(1025, 1).mOffset == StreamRing::Invalid);
+	CHECK(ring.GetNumUsedBytes() == 0);
+
+	// The whole ring fits once, then nothing does until it is retired.
+	StreamRing::Slice slice = ring.Allocate(1024, 256);
+	CHECK(slice.mOffset == 0 && ring.IsCurrent(slice));
+	CHECK(ring.Allocate(1, 1).mOffset == StreamRing::Invalid);
+
+	uint64_t frame = ring.EndFrame();
+	CHECK(ring.GetLastFrameStatistics().mNumAllocations == 1);
+	CHECK(ring.GetLastFrameStatistics().mNumFailures == 3);
+	CHECK(!ring.IsCurrent(slice));
+
+	CHECK(ring.Allocate(1, 1).mOffset == StreamRing::Invalid);
+	ring.Retire(frame);
+	CHECK(ring.GetNumUsedBytes() == 0);
+	CHECK(ring.Allocate(1024, 1).mOffset == 0);
+}
+
+UNIT_TEST(StreamRingAlignsAndWrapsAround)
+{
+	StreamRing ring(1024);
+
+	// The bytes skipped for the alignment stay with the frame.
+	CHECK(ring.Allocate(10, 1).mOffset == 0);
+	CHECK(ring.Allocate(500, 256).mOffset == 256);
+	uint64_t frame1 = ring.EndFrame();
+	CHECK(ring.GetNumUsedBytes() == 756);
+
+	CHECK(ring.Allocate(200, 4).mOffset == 756);
+	uint64_t frame2 = ring.EndFrame();
+	CHECK(ring.GetNumUsedBytes() == 956);
+
+	// The 68 bytes left at the end are too few, the slice wraps to the
+	// start once the first frame is retired and the bytes skipped at the
+	// end are counted as used.
+	CHECK(ring.Allocate(100, 4).mOffset == StreamRing::Invalid);
+	ring.Retire(frame1);
+	CHECK(ring.GetNumUsedBytes() == 200);
+
+	StreamRing::Slice slice = ring.Allocate(100, 4);
+	CHECK(slice.mOffset == 0);
+	CHECK(ring.GetNumUsedBytes() == 368);
+
+	// The slice can't reach the bytes of the second frame.
+	CHECK(ring.Allocate(700, 4).mOffset == StreamRing::Invalid);
+	CHECK(ring.Allocate(656, 4).mOffset == 100);
+
+	ring.EndFrame();
+	StreamRing::Statistics const& statistics = ring.GetLastFrameStatistics();
+	CHECK(statistics.mNumAllocations == 2);
+	CHECK(statistics.mNumWraps == 1);
+	CHECK(statistics.mNumFailures == 2);
+	CHECK(statistics.mNumRetired == 1);
+	CHECK(statistics.mNumBytes == 756);
+	CHECK(ring.GetOldestFrame() == frame2);
+}
+
+UNIT_TEST(StreamRingReusesRetiredFrames)
+{
+	StreamRing ring(1024);
+
+	// The bytes of a frame are reused once its fence is passed, the ring
+	// going around many times with two frames in flight. Each frame takes
+	// a quarter of the ring with the alignment.
+	const unsigned int latency = 2;
+	for (unsigned int i = 0; i < 32; ++i)
+	{
+		StreamRing::Slice slice = ring.Allocate(200, 256);
+		CHECK(slice.mOffset != StreamRing::Invalid);
+		CHECK(slice.mOffset + slice.mNumBytes <= ring.GetNumBytes());
+
+		uint64_t frame = ring.EndFrame();
+		while (ring.HasFramesInFlight() && ring.GetOldestFrame() + latency <= frame)
+			ring.Retire(ring.GetOldestFrame());
+		CHECK(ring.GetNumUsedBytes() <= ring.GetNumBytes());
+	}
+
+	// Retiring a frame retires the older ones with it.
+	ring.Allocate(100, 1);
+	uint64_t frame = ring.EndFrame();
+	ring.Retire(frame);
+	CHECK(!ring.HasFramesInFlight());
+	CHECK(ring.GetNumUsedBytes() == 0);
+
+	// Without retiring, the ring runs out of bytes. The 212 bytes left
+	// after the second frame are lost to the alignment.
+	unsigned int numAllocated = 0;
+	while (ring.Allocate(300, 256).mOffset != StreamRing::Invalid)
+	{
+		numAllocated++;
+		ring.EndFrame();
+	}
+	CHECK(numAllocated == 2);
+
+	// A reset forgets the frames in flight and the slices already handed.
+	StreamRing::Slice slice = ring.Allocate(1, 1);
+	ring.Reset();
+	CHECK(!ring.HasFramesInFlight());
+	CHECK(!ring.IsCurrent(slice));
+	CHECK(ring.Allocate(1024, 1).mOffset == 0);
+}
+
+UNIT_TEST(StreamRingStreamsRecordedUpdates)
+{
+	RecordingRenderer renderer(640, 480);
+
+	// The dynamic buffers go through the ring of the renderer, which keeps
+	// two frames in flight.
+	eastl::shared_ptr<ConstantBuffer> cbuffer = eastl::make_shared<ConstantBuffer>(3 * 1024 * 1024, true);
+	for (unsigned int frame = 1; frame <= 4; ++frame)
+	{
+		CHECK(renderer.Update(cbuffer));
+		renderer.DisplayColorBuffer(0);
+
+		// The whole buffer is uploaded, after its creation in the first frame.
+		eastl::vector<RecordingRenderer::Command> const& capture = renderer.GetCapture();
+		CHECK(capture.size() >= 2);
+		CHECK(capture[capture.size() - 2].mType == RecordingRenderer::CT_UPDATE);
+		CHECK(capture[capture.size() - 2].mArgs[0] == cbuffer->GetNumBytes());
+
+		// The ring can't hold three of them, from the third frame on each
+		// one waits for the oldest frame in flight.
+		RecordingRenderer::Statistics const& statistics = renderer.GetLastFrameStatistics();
+		CHECK(statistics.mNumBytesStreamed == cbuffer->GetNumBytes());
+		CHECK(statistics.mNumStreamWaits == (frame >= 3 ? 1u : 0u));
+	}
+}
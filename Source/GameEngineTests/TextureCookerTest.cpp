@@ -0,0 +1,181 @@
+//========================================================================
+// TextureCookerTest.cpp : Checks the mipmaps computed on the CPU and the
+// cooked textures made of them.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "Graphic/Image/TextureCooker.h"
+
+#include "UnitTest.h"
+
+#include <cmath>
+
+namespace
+{
+	// RGBA8 texels which differ in every channel.
+	eastl::vector<unsigned char> CreateTexels(unsigned int width, unsigned int height)
+	{
+		eastl::vector<unsigned char> texels(4 * width * height);
+		for (unsigned int i = 0; i < texels.size(); ++i)
+			texels[i] = (unsigned char)((i * 37 + i / 4 * 11) & 0xFF);
+		return texels;
+	}
+
+	// The box filter one texel at a time.
+	void DownsampleBoxScalar(const unsigned char* source,
+		unsigned int sourceWidth, unsigned int sourceHeight,
+		unsigned char* target, unsigned int targetWidth, unsigned int targetHeight)
+	{
+		for (unsigned int y = 0; y < targetHeight; ++y)
+		{
+			const unsigned int y0 = 2 * y;
+			const unsigned int y1 = sourceHeight > 1 ? y0 + 1 : y0;
+			for (unsigned int x = 0; x < targetWidth; ++x)
+			{
+				const unsigned int x0 = 2 * x;
+				const unsigned int x1 = sourceWidth > 1 ? x0 + 1 : x0;
+				for (unsigned int c = 0; c < 4; ++c)
+				{
+					target[4 * (targetWidth * y + x) + c] = (unsigned char)((
+						source[4 * (sourceWidth * y0 + x0) + c] + source[4 * (sourceWidth * y0 + x1) + c] +
+						source[4 * (sourceWidth * y1 + x0) + c] + source[4 * (sourceWidth * y1 + x1) + c] + 2) >> 2);
+				}
+			}
+		}
+	}
+
+	// An uncompressed 32 bit tga image, stored from the top row.
+	eastl::vector<char> CreateImage(unsigned int width, unsigned int height, unsigned char seed)
+	{
+		eastl::vector<char> image(18 + 4 * width * height, 0);
+		image[2] = 2;
+		image[12] = (char)(width & 0xFF);
+		image[13] = (char)(width >> 8);
+		image[14] = (char)(height & 0xFF);
+		image[15] = (char)(height >> 8);
+		image[16] = 32;
+		image[17] = 0x28;
+		for (unsigned int i = 18; i < image.size(); ++i)
+			image[i] = (char)((i * 13 + seed) & 0xFF);
+		return image;
+	}
+}
+
+UNIT_TEST(MipGeneratorBoxMatchesScalar)
+{
+	// The even widths go through the SSE path alone, the odd ones end with
+	// the scalar tail, the single texel rows and columns average themselves.
+	unsigned int const sizes[][2] = { { 8, 8 }, { 16, 6 }, { 7, 5 }, { 13, 9 }, { 6, 1 }, { 1, 6 }, { 2, 2 } };
+	for (auto const& size : sizes)
+	{
+		unsigned int const sourceWidth = size[0], sourceHeight = size[1];
+		unsigned int const targetWidth = eastl::max(sourceWidth / 2, 1u);
+		unsigned int const targetHeight = eastl::max(sourceHeight / 2, 1u);
+
+		eastl::vector<unsigned char> source = CreateTexels(sourceWidth, sourceHeight);
+		eastl::vector<unsigned char> target(4 * targetWidth * targetHeight, 0);
+		eastl::vector<unsigned char> expected(4 * targetWidth * targetHeight, 0);
+		MipGenerator::DownsampleBox(source.data(), sourceWidth, sourceHeight,
+			target.data(), targetWidth, targetHeight);
+		DownsampleBoxScalar(source.data(), sourceWidth, sourceHeight,
+			expected.data(), targetWidth, targetHeight);
+		CHECK(target == expected);
+	}
+}
+
+UNIT_TEST(MipGeneratorKaiserWeightsSumToOne)
+{
+	float weights[MipGenerator::KaiserTaps];
+	MipGenerator::GetKaiserWeights(weights);
+
+	float total = 0.f;
+	for (int k = 0; k < MipGenerator::KaiserTaps; ++k)
+	{
+		total += weights[k];
+		CHECK(std::fabs(weights[k] - weights[MipGenerator::KaiserTaps - 1 - k]) < 1e-6f);
+	}
+	CHECK(std::fabs(total - 1.f) < 1e-5f);
+
+	// So a texture of one color keeps it.
+	eastl::vector<unsigned char> source(4 * 8 * 8), target(4 * 4 * 4);
+	for (unsigned int i = 0; i < source.size(); ++i)
+		source[i] = (unsigned char)(40 + 50 * (i % 4));
+	MipGenerator::DownsampleKaiser(source.data(), 8, 8, target.data(), 4, 4);
+	for (unsigned int i = 0; i < target.size(); ++i)
+		CHECK(target[i] == source[i % 4]);
+}
+
+UNIT_TEST(TextureCookerLoadsCookedBytes)
+{
+	eastl::vector<char> image = CreateImage(12, 6, 0);
+	eastl::vector<char> cooked;
+	CHECK(TextureCooker::Cook(image.data(), (unsigned int)image.size(), MipGenerator::MF_BOX, cooked));
+
+	eastl::shared_ptr<Texture2> texture = TextureCooker::Load(
+		cooked.data(), (unsigned int)cooked.size(), image.data(), (unsigned int)image.size());
+	CHECK(texture != nullptr);
+	if (!texture)
+		return;
+
+	// The levels are the bytes which follow the header.
+	unsigned int const headerSize = (unsigned int)cooked.size() - texture->GetNumBytes();
+	CHECK(texture->GetWidth() == 12 && texture->GetHeight() == 6);
+	CHECK(texture->GetNumLevels() == 4 && texture->HasMipmaps());
+	CHECK(memcmp(texture->GetData(), cooked.data() + headerSize, texture->GetNumBytes()) == 0);
+
+	// The first level holds the image, the tga storing blue first.
+	char const* texel = texture->GetData();
+	CHECK(texel[0] == image[20] && texel[1] == image[19] && texel[2] == image[18] && texel[3] == image[21]);
+
+	// Without a source, the texture loads whatever it was cooked from.
+	CHECK(TextureCooker::Load(cooked.data(), (unsigned int)cooked.size()) != nullptr);
+}
+
+UNIT_TEST(TextureCookerRejectsOtherSource)
+{
+	eastl::vector<char> image = CreateImage(4, 4, 0);
+	eastl::vector<char> otherImage = CreateImage(4, 4, 1);
+	eastl::vector<char> cooked;
+	CHECK(TextureCooker::Cook(image.data(), (unsigned int)image.size(), MipGenerator::MF_KAISER, cooked));
+
+	CHECK(TextureCooker::Load(cooked.data(), (unsigned int)cooked.size(),
+		otherImage.data(), (unsigned int)otherImage.size()) == nullptr);
+	CHECK(TextureCooker::Load(cooked.data(), (unsigned int)cooked.size(),
+		image.data(), (unsigned int)image.size() - 1) == nullptr);
+}
+
+UNIT_TEST(TextureCookerRejectsCorruptedHeader)
+{
+	eastl::vector<char> image = CreateImage(8, 8, 0);
+	eastl::vector<char> cooked;
+	CHECK(TextureCooker::Cook(image.data(), (unsigned int)image.size(), MipGenerator::MF_BOX, cooked));
+
+	eastl::shared_ptr<Texture2> texture = TextureCooker::Load(cooked.data(), (unsigned int)cooked.size());
+	CHECK(texture != nullptr);
+	if (!texture)
+		return;
+
+	// Truncated levels or header.
+	CHECK(TextureCooker::Load(cooked.data(), (unsigned int)cooked.size() - 1) == nullptr);
+	CHECK(TextureCooker::Load(cooked.data(), 8) == nullptr);
+
+	// The header ends with the width, the height, the number of levels, the
+	// number of bytes and a reserved field.
+	unsigned int const headerSize = (unsigned int)cooked.size() - texture->GetNumBytes();
+	unsigned int const widthOffset = headerSize - 5 * sizeof(unsigned int);
+	unsigned int const numBytesOffset = headerSize - 2 * sizeof(unsigned int);
+
+	// Levels bigger than the file.
+	eastl::vector<char> oversized = cooked;
+	unsigned int const numBytes = 0x7FFFFFFF;
+	memcpy(oversized.data() + numBytesOffset, &numBytes, sizeof(numBytes));
+	CHECK(TextureCooker::Load(oversized.data(), (unsigned int)oversized.size()) == nullptr);
+
+	// A size which doesn't match the levels.
+	eastl::vector<char> resized = cooked;
+	unsigned int const width = 0x10000;
+	memcpy(resized.data() + widthOffset, &width, sizeof(width));
+	CHECK(TextureCooker::Load(resized.data(), (unsigned int)resized.size()) == nullptr);
+}
@@ -0,0 +1,58 @@
+//========================================================================
+// UnitTest.cpp : Registers the unit tests and checks their conditions.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#include "UnitTest.h"
+
+#include "Core/Logger/Logger.h"
+
+UnitTest::UnitTest(char const* name, Function function)
+	:
+	mName(name),
+	mFunction(function),
+	mNumFailures(0)
+{
+	GetTests().push_back(this);
+}
+
+eastl::vector<UnitTest*>& UnitTest::GetTests()
+{
+	// The tests register from static objects of several files, the list
+	// must exist before the first of them.
+	static eastl::vector<UnitTest*> tests;
+	return tests;
+}
+
+void UnitTest::Check(bool condition, char const* expression, char const* file, int line)
+{
+	if (!condition)
+	{
+		LogError(eastl::string(mName) + " failed: " + expression + " (" +
+			file + ", line " + eastl::to_string(line) + ")");
+		mNumFailures++;
+	}
+}
+
+unsigned int UnitTest::RunAll(eastl::string const& filter)
+{
+	unsigned int numRun = 0, numFailed = 0;
+	for (UnitTest* test : GetTests())
+	{
+		if (!filter.empty() && eastl::string(test->mName).find(filter) != 0)
+			continue;
+
+		test->mNumFailures = 0;
+		test->mFunction(*test);
+
+		numRun++;
+		if (test->mNumFailures > 0)
+			numFailed++;
+	}
+
+	LogInformation(eastl::to_string(numRun) + " tests run, " +
+		eastl::to_string(numFailed) + " failed");
+	return numFailed;
+}
@@ -0,0 +1,46 @@
+//========================================================================
+// UnitTest.h : Registers the unit tests and checks their conditions.
+//
+// Part of the GameEngine Application
+//
+//========================================================================
+
+#ifndef UNITTEST_H
+#define UNITTEST_H
+
+#include "GameEngineStd.h"
+
+// Each test is a function defined with UNIT_TEST in any file of the test
+// application, which registers it before main runs. A failed CHECK logs the
+// condition and its location as an error and the test goes on, so a run
+// reports every failure at once.
+class UnitTest
+{
+public:
+	typedef void (*Function)(UnitTest& test);
+
+	UnitTest(char const* name, Function function);
+
+	void Check(bool condition, char const* expression, char const* file, int line);
+
+	// Runs the tests whose name starts with the filter, all of them when it
+	// is empty, and returns the number of failed tests.
+	static unsigned int RunAll(eastl::string const& filter);
+
+private:
+	static eastl::vector<UnitTest*>& GetTests();
+
+	char const* mName;
+	Function mFunction;
+	unsigned int mNumFailures;
+};
+
+#define UNIT_TEST(name) \
+	static void name(UnitTest& test); \
+	static UnitTest name##UnitTest(#name, &name); \
+	static void name(UnitTest& test)
+
+#define CHECK(condition) \
+	test.Check((condition), #condition, __FILE__, __LINE__)
+
+#endif